@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include <methan/core/execution/compiled_graph.hpp>
+
+/**
+ * Per-run time of a graph of small elementwise nodes (a few layers of independent chains), where the
+ * scheduling overhead dominates the work of the kernels: evaluated from the graph, with a memory plan and
+ * compiled (sequential and concurrent).
+ *
+ * Usage: bench_compiled [elements] [repetitions] [workers]
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    template<typename Function>
+    double __best_microseconds(size_t repetitions, Function&& function)
+    {
+        double best = 1e30;
+        for(size_t r = 0; r < repetitions + 1; ++r)
+        {
+            const Clock::time_point start = Clock::now();
+            function();
+            const double elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            if(r > 0) best = std::min(best, elapsed);
+        }
+        return best;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    const int64_t count = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 256;
+    const size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+
+    Methan::ThreadPoolOptions options;
+    options.workerCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    // 8 chains of 64 nodes, joined by a sum
+    constexpr size_t chains = 8;
+    constexpr size_t depth = 64;
+    const Methan::ElementwiseOp ops[] = { Methan::ElementwiseOp::Tanh, Methan::ElementwiseOp::Relu, Methan::ElementwiseOp::Sigmoid };
+
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle result = nullptr;
+    for(size_t c = 0; c < chains; ++c)
+    {
+        Methan::NodeHandle node = x;
+        for(size_t d = 0; d < depth; ++d) node = graph.addNode(Methan::OpCode::Elementwise, {node}, Methan::ElementwisePayload{ ops[(c + d) % 3], {} });
+        result = result == nullptr ? node : graph.addNode(Methan::OpCode::Elementwise, {result, node}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} });
+    }
+    graph.buildAdjacency();
+
+    const Methan::Tensor input = Methan::Tensor::zeros(Methan::DataType::Float32, { count });
+    const Methan::InputBinding bindings[] = { { x, input } };
+    const Methan::Span<const Methan::InputBinding> inputs(bindings, 1);
+    const Methan::Span<const Methan::NodeHandle> outputs(&result, 1);
+
+    const Methan::MemoryPlan plan = Methan::planMemory(graph, Methan::Evaluator::inferSpecs(graph, inputs), outputs);
+    const Methan::CompiledGraph sequential = Methan::compile(graph, inputs, outputs);
+    Methan::CompileOptions concurrentOptions;
+    concurrentOptions.concurrent = true;
+    const Methan::CompiledGraph concurrent = Methan::compile(graph, inputs, outputs, concurrentOptions);
+
+    Methan::ExecutionFrame sequentialFrame(sequential);
+    Methan::ExecutionFrame concurrentFrame(concurrent);
+    Methan::Tensor output;
+
+    std::cout << graph.nodeCount() << " nodes of " << count << " elements, " << pool.workerCount() << " workers, best of " << repetitions << " (us per run)" << std::endl;
+    std::cout << std::left << std::setw(24) << "graph" << std::right << std::setw(12) << __best_microseconds(repetitions, [&]() { evaluator.run(graph, inputs, outputs); }) << std::endl;
+    std::cout << std::left << std::setw(24) << "memory plan" << std::right << std::setw(12) << __best_microseconds(repetitions, [&]() { evaluator.run(graph, inputs, outputs, plan); }) << std::endl;
+    std::cout << std::left << std::setw(24) << "compiled" << std::right << std::setw(12) << __best_microseconds(repetitions, [&]() {
+        sequential.run(Methan::Span<const Methan::Tensor>(&input, 1), Methan::Span<Methan::Tensor>(&output, 1), sequentialFrame, pool);
+    }) << std::endl;
+    std::cout << std::left << std::setw(24) << "compiled (concurrent)" << std::right << std::setw(12) << __best_microseconds(repetitions, [&]() {
+        concurrent.run(Methan::Span<const Methan::Tensor>(&input, 1), Methan::Span<Methan::Tensor>(&output, 1), concurrentFrame, pool);
+    }) << std::endl;
+    return 0;
+}
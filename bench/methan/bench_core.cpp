@@ -0,0 +1,148 @@
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "benchmark.hpp"
+
+#include <methan/core/graph/graph.hpp>
+#include <methan/utility/assertion.hpp>
+#include <methan/utility/enum.hpp>
+#include <methan/utility/varient.hpp>
+
+/**
+ * Cost of the building blocks used on every node of a graph: Varient construction, copy and access,
+ * EnumFlag operations, raising an exception and the non-throwing lookups. Tracked against a baseline,
+ * see benchmark.hpp for the arguments.
+ */
+
+namespace {
+
+    enum class Flag : uint32_t
+    {
+        A = 1 << 0,
+        B = 1 << 1,
+        C = 1 << 2,
+        D = 1 << 3
+    };
+
+    typedef Methan::EnumFlag<Flag> Flags;
+    METHAN_ENUMSET_OPERATORS(Flags)
+
+    // Large enough to be stored on the heap by a Varient
+    typedef std::array<double, 16> Large;
+
+    void __throw_index(size_t index, size_t size)
+    {
+        METHAN_FORCE_ASSERT_INDEX(index, size);
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    Methan::Bench::Suite suite("core");
+
+    suite.add("varient/construct/inline", [](size_t iterations) {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            Methan::Varient value(static_cast<int>(i));
+            Methan::Bench::doNotOptimize(value);
+        }
+    });
+    suite.add("varient/construct/heap", [](size_t iterations) {
+        const Large large{};
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            Methan::Varient value(large);
+            Methan::Bench::doNotOptimize(value);
+        }
+    });
+    suite.add("varient/copy/inline", [](size_t iterations) {
+        const Methan::Varient source(3.0);
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            Methan::Varient copy(source);
+            Methan::Bench::doNotOptimize(copy);
+        }
+    });
+    suite.add("varient/copy/string", [](size_t iterations) {
+        const Methan::Varient source(std::string("a node name longer than the small string buffer"));
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            Methan::Varient copy(source);
+            Methan::Bench::doNotOptimize(copy);
+        }
+    });
+    suite.add("varient/get", [](size_t iterations) {
+        const Methan::Varient value(42);
+        int sum = 0;
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            Methan::Bench::doNotOptimize(value);
+            sum += value.get<int>();
+        }
+        Methan::Bench::doNotOptimize(sum);
+    });
+    suite.add("varient/tryGet/miss", [](size_t iterations) {
+        const Methan::Varient value(42);
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            Methan::Bench::doNotOptimize(value);
+            Methan::Bench::doNotOptimize(value.tryGet<float>().ok());
+        }
+    });
+
+    suite.add("enum_flag/combine and test", [](size_t iterations) {
+        Flags flags = Flag::A;
+        size_t count = 0;
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            Methan::Bench::doNotOptimize(flags);
+            flags |= (i & 1) ? Flag::B : Flag::C;
+            flags ^= Flag::D;
+            if(flags >= (Flag::A | Flag::D)) ++count;
+            flags &= ~Flags(Flag::B);
+        }
+        Methan::Bench::doNotOptimize(count);
+    });
+
+    suite.add("exception/throw", [](size_t iterations) {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            try
+            {
+                __throw_index(i, 0);
+            }
+            catch(const Methan::Exception& e)
+            {
+                Methan::Bench::doNotOptimize(e);
+            }
+        }
+    });
+    suite.add("exception/throw and what", [](size_t iterations) {
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            try
+            {
+                __throw_index(i, 0);
+            }
+            catch(const Methan::Exception& e)
+            {
+                Methan::Bench::doNotOptimize(e.what());
+            }
+        }
+    });
+
+    Methan::Graph graph;
+    const Methan::NodeHandle named = graph.addNode(Methan::OpCode::Input);
+    const Methan::NodeHandle anonymous = graph.addNode(Methan::OpCode::Input);
+    graph.setAttribute(named, Methan::AttributeKey::Name, std::string("input"));
+    suite.add("graph/attributeAs/hit", [&](size_t iterations) {
+        for(size_t i = 0; i < iterations; ++i) Methan::Bench::doNotOptimize(graph.attributeAs<std::string>(named, Methan::AttributeKey::Name).get());
+    });
+    suite.add("graph/attributeAs/miss", [&](size_t iterations) {
+        for(size_t i = 0; i < iterations; ++i) Methan::Bench::doNotOptimize(graph.attributeAs<std::string>(anonymous, Methan::AttributeKey::Name).get());
+    });
+
+    return suite.run(argc, argv);
+}
@@ -0,0 +1,48 @@
+#include <cstdint>
+#include <string>
+
+#include "benchmark.hpp"
+
+#include <methan/core/cpu.hpp>
+#include <methan/core/kernels/elementwise.hpp>
+
+/**
+ * Elementwise kernels at every instruction set level supported by the CPU: a memory bound operation (Add)
+ * and compute bound ones (Exp, Tanh), for each floating point type. Tracked against a baseline, see
+ * benchmark.hpp for the arguments.
+ */
+
+int main(int argc, char** argv)
+{
+    Methan::Bench::Suite suite("elementwise");
+
+    constexpr int64_t count = 1 << 20;
+    const Methan::IsaLevel initial = Methan::isaLevel();
+
+    for(Methan::DataType type : { Methan::DataType::Float32, Methan::DataType::Float64, Methan::DataType::Float16 })
+    {
+        const Methan::Tensor a = Methan::Tensor::zeros(type, { count });
+        const Methan::Tensor b = Methan::Tensor::zeros(type, { count });
+        Methan::Tensor out = Methan::Tensor::zeros(type, { count });
+        for(uint32_t level = 0; level <= static_cast<uint32_t>(Methan::supportedIsaLevel()); ++level)
+        {
+            const Methan::IsaLevel isa = static_cast<Methan::IsaLevel>(level);
+            for(Methan::ElementwiseOp op : { Methan::ElementwiseOp::Add, Methan::ElementwiseOp::Exp, Methan::ElementwiseOp::Tanh })
+            {
+                suite.add("elementwise/" + Methan::to_string(op) + "/" + Methan::to_string(type) + "/" + Methan::to_string(isa), [a, b, out, type, isa, op](size_t iterations) mutable {
+                    const void* inputs[2] = { a.rawData(), b.rawData() };
+                    Methan::setIsaLevel(isa);
+                    for(size_t i = 0; i < iterations; ++i)
+                    {
+                        Methan::elementwise(op, type, static_cast<size_t>(count), Methan::Span<const void* const>(inputs, Methan::arity(op)), out.rawData());
+                    }
+                    Methan::Bench::doNotOptimize(out.rawData());
+                });
+            }
+        }
+    }
+
+    const int result = suite.run(argc, argv);
+    Methan::setIsaLevel(initial);
+    return result;
+}
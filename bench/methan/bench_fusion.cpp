@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include <methan/core/cpu.hpp>
+#include <methan/core/passes/fusion.hpp>
+
+/**
+ * Time of an activation-like chain of elementwise nodes, y = sigmoid(relu(x * a + b) * c) + x, evaluated
+ * node by node and after fusion. The inputs are all of the same shape, so that every node streams the
+ * whole tensors through memory.
+ *
+ * Usage: bench_fusion [elements] [repetitions]
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    double __best_seconds(Methan::Evaluator& evaluator, const Methan::Graph& graph, Methan::Span<const Methan::InputBinding> inputs, Methan::NodeHandle output, size_t repetitions)
+    {
+        double best = 1e30;
+        for(size_t r = 0; r < repetitions; ++r)
+        {
+            const Clock::time_point start = Clock::now();
+            evaluator.run(graph, inputs, Methan::Span<const Methan::NodeHandle>(&output, 1));
+            best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+        }
+        return best;
+    }
+
+    Methan::NodeHandle __elementwise(Methan::Graph& graph, Methan::ElementwiseOp op, std::initializer_list<Methan::NodeHandle> inputs)
+    {
+        return graph.addNode(Methan::OpCode::Elementwise, inputs, Methan::ElementwisePayload{ op, {} });
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (size_t(1) << 24);
+    const size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle a = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle c = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle shifted = __elementwise(graph, Methan::ElementwiseOp::Fma, {x, a, b});
+    Methan::NodeHandle relu = __elementwise(graph, Methan::ElementwiseOp::Relu, {shifted});
+    Methan::NodeHandle scaled = __elementwise(graph, Methan::ElementwiseOp::Mul, {relu, c});
+    Methan::NodeHandle sigmoid = __elementwise(graph, Methan::ElementwiseOp::Sigmoid, {scaled});
+    Methan::NodeHandle y = __elementwise(graph, Methan::ElementwiseOp::Add, {sigmoid, x});
+
+    const Methan::RewrittenGraph fused = Methan::fuseElementwise(graph, { y });
+    fused.graph.buildAdjacency();
+
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 1;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    std::cout << "cpu: " << Methan::to_string(Methan::cpuFeatures()) << std::endl;
+    std::cout << count << " elements, best of " << repetitions << std::endl;
+    std::cout << std::left << std::setw(10) << "type" << std::right << std::setw(14) << "nodes ms" << std::setw(14) << "fused ms" << std::setw(10) << "speedup" << std::endl;
+
+    for(Methan::DataType type : { Methan::DataType::Float32, Methan::DataType::Float64 })
+    {
+        const Methan::Shape shape({ static_cast<int64_t>(count) });
+        const Methan::InputBinding inputs[] = {
+            { x, Methan::Tensor::zeros(type, shape) },
+            { a, Methan::Tensor::zeros(type, shape) },
+            { b, Methan::Tensor::zeros(type, shape) },
+            { c, Methan::Tensor::zeros(type, shape) }
+        };
+        Methan::InputBinding fusedInputs[4];
+        for(size_t i = 0; i < 4; ++i) fusedInputs[i] = { fused.map(inputs[i].node), inputs[i].tensor };
+
+        const double nodes = __best_seconds(evaluator, graph, Methan::Span<const Methan::InputBinding>(inputs, 4), y, repetitions);
+        const double single = __best_seconds(evaluator, fused.graph, Methan::Span<const Methan::InputBinding>(fusedInputs, 4), fused.map(y), repetitions);
+
+        std::cout << std::left << std::setw(10) << Methan::to_string(type) << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << nodes * 1e3 << std::setw(14) << single * 1e3 << std::setw(10) << nodes / single << std::endl;
+    }
+
+    return 0;
+}
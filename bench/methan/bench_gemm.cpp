@@ -0,0 +1,129 @@
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+
+#include <methan/core/cpu.hpp>
+#include <methan/core/kernels/gemm.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#define METHAN_BENCH_DLOPEN
+#endif
+
+/**
+ * GEMM on square matrices at every instruction set level supported by the CPU, with a worker per hardware
+ * thread (a product of n x n matrices is 2 n^3 floating point operations). When the environment variable
+ * `METHAN_BENCH_BLAS` names a CBLAS library (e.g. `libopenblas.so`), it is loaded at run time and measured
+ * on the same problems for reference. Tracked against a baseline, see benchmark.hpp for the arguments.
+ */
+
+namespace {
+
+    typedef void (*CblasSgemm)(int, int, int, int, int, int, float, const float*, int, const float*, int, float, float*, int);
+    typedef void (*CblasDgemm)(int, int, int, int, int, int, double, const double*, int, const double*, int, double, double*, int);
+
+    // Values of the CBLAS enumerations
+    constexpr int __cblas_row_major = 101;
+    constexpr int __cblas_no_trans = 111;
+
+    struct Blas
+    {
+        CblasSgemm sgemm = nullptr;
+        CblasDgemm dgemm = nullptr;
+    };
+
+    Blas __load_blas()
+    {
+        Blas blas;
+#if defined(METHAN_BENCH_DLOPEN)
+        const char* name = std::getenv("METHAN_BENCH_BLAS");
+        if(name == nullptr) return blas;
+
+        void* library = dlopen(name, RTLD_NOW | RTLD_LOCAL);
+        if(library == nullptr)
+        {
+            std::cerr << "cannot load " << name << ": " << dlerror() << std::endl;
+            return blas;
+        }
+        blas.sgemm = reinterpret_cast<CblasSgemm>(dlsym(library, "cblas_sgemm"));
+        blas.dgemm = reinterpret_cast<CblasDgemm>(dlsym(library, "cblas_dgemm"));
+#endif
+        return blas;
+    }
+
+    template<typename T>
+    void __add_cases(Methan::Bench::Suite& suite, Methan::ThreadPool& pool, const Blas& blas, size_t size)
+    {
+        // Shared by the cases of this size
+        struct Problem
+        {
+            std::vector<T> a, b, c;
+        };
+        std::shared_ptr<Problem> problem = std::make_shared<Problem>();
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<T> distribution(-1, 1);
+        problem->a.resize(size * size);
+        problem->b.resize(size * size);
+        problem->c.resize(size * size);
+        for(T& value : problem->a) value = distribution(generator);
+        for(T& value : problem->b) value = distribution(generator);
+
+        const Methan::DataType type = Methan::DataTypeOf<T>::value;
+        const std::string suffix = "/" + std::to_string(size);
+        for(uint32_t level = 0; level <= static_cast<uint32_t>(Methan::supportedIsaLevel()); ++level)
+        {
+            // The scalar kernels are too slow to be measured on large problems
+            const Methan::IsaLevel isa = static_cast<Methan::IsaLevel>(level);
+            if(isa == Methan::IsaLevel::Scalar && size > 512) continue;
+
+            suite.add("gemm/" + Methan::to_string(type) + "/" + Methan::to_string(isa) + suffix, [&pool, problem, type, isa, size](size_t iterations) {
+                const int64_t n = static_cast<int64_t>(size);
+                Methan::setIsaLevel(isa);
+                for(size_t i = 0; i < iterations; ++i) Methan::gemm(type, size, size, size, 1.0, problem->a.data(), n, 1, problem->b.data(), n, 1, 0.0, problem->c.data(), n, pool);
+                Methan::Bench::doNotOptimize(problem->c.data());
+            });
+        }
+
+        if constexpr(sizeof(T) == 4)
+        {
+            if(blas.sgemm == nullptr) return;
+            suite.add("gemm/" + Methan::to_string(type) + "/blas" + suffix, [sgemm = blas.sgemm, problem, size](size_t iterations) {
+                const int n = static_cast<int>(size);
+                for(size_t i = 0; i < iterations; ++i) sgemm(__cblas_row_major, __cblas_no_trans, __cblas_no_trans, n, n, n, 1.0f, problem->a.data(), n, problem->b.data(), n, 0.0f, problem->c.data(), n);
+                Methan::Bench::doNotOptimize(problem->c.data());
+            });
+        }
+        else
+        {
+            if(blas.dgemm == nullptr) return;
+            suite.add("gemm/" + Methan::to_string(type) + "/blas" + suffix, [dgemm = blas.dgemm, problem, size](size_t iterations) {
+                const int n = static_cast<int>(size);
+                for(size_t i = 0; i < iterations; ++i) dgemm(__cblas_row_major, __cblas_no_trans, __cblas_no_trans, n, n, n, 1.0, problem->a.data(), n, problem->b.data(), n, 0.0, problem->c.data(), n);
+                Methan::Bench::doNotOptimize(problem->c.data());
+            });
+        }
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    Methan::Bench::Suite suite("gemm");
+
+    Methan::ThreadPool pool;
+    const Blas blas = __load_blas();
+    const Methan::IsaLevel initial = Methan::isaLevel();
+    std::cout << "cpu: " << Methan::to_string(Methan::cpuFeatures()) << ", " << pool.workerCount() << " workers" << (blas.sgemm != nullptr ? ", with a BLAS" : "") << std::endl;
+
+    for(size_t size : { 256, 512, 1024 }) __add_cases<float>(suite, pool, blas, size);
+    for(size_t size : { 256, 512, 1024 }) __add_cases<double>(suite, pool, blas, size);
+
+    const int result = suite.run(argc, argv);
+    Methan::setIsaLevel(initial);
+    return result;
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <methan/core/execution/incremental.hpp>
+
+/**
+ * Per-run time of a graph of many parameters (each transformed by a chain of elementwise nodes, the chains
+ * being reduced by a balanced tree of additions) when a single parameter changes between runs: evaluated
+ * from scratch and incrementally.
+ *
+ * Usage: bench_incremental [elements] [repetitions] [workers]
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    template<typename Function>
+    double __best_microseconds(size_t repetitions, Function&& function)
+    {
+        double best = 1e30;
+        for(size_t r = 0; r < repetitions + 1; ++r)
+        {
+            const Clock::time_point start = Clock::now();
+            function(r);
+            const double elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            if(r > 0) best = std::min(best, elapsed);
+        }
+        return best;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    const int64_t count = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 1024;
+    const size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+
+    Methan::ThreadPoolOptions options;
+    options.workerCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    // 256 parameters through chains of 16 nodes
+    constexpr size_t parameterCount = 256;
+    constexpr size_t depth = 16;
+    const Methan::ElementwiseOp ops[] = { Methan::ElementwiseOp::Tanh, Methan::ElementwiseOp::Relu, Methan::ElementwiseOp::Sigmoid };
+
+    Methan::Graph graph;
+    std::vector<Methan::NodeHandle> parameters;
+    std::vector<Methan::NodeHandle> level;
+    for(size_t p = 0; p < parameterCount; ++p)
+    {
+        Methan::NodeHandle node = graph.addNode(Methan::OpCode::Input);
+        parameters.push_back(node);
+        for(size_t d = 0; d < depth; ++d) node = graph.addNode(Methan::OpCode::Elementwise, {node}, Methan::ElementwisePayload{ ops[(p + d) % 3], {} });
+        level.push_back(node);
+    }
+    while(level.size() > 1)
+    {
+        std::vector<Methan::NodeHandle> next;
+        for(size_t i = 0; i < level.size(); i += 2) next.push_back(graph.addNode(Methan::OpCode::Elementwise, {level[i], level[i + 1]}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} }));
+        level.swap(next);
+    }
+    const Methan::NodeHandle result = level[0];
+    graph.buildAdjacency();
+
+    // Two values per parameter, the runs alternate between them for one parameter at a time
+    std::vector<Methan::Tensor> values[2];
+    for(size_t p = 0; p < parameterCount; ++p)
+    {
+        for(size_t v = 0; v < 2; ++v)
+        {
+            Methan::Tensor tensor(Methan::DataType::Float32, { count });
+            std::fill(tensor.data<float>(), tensor.data<float>() + count, static_cast<float>(p + v) / parameterCount);
+            values[v].push_back(tensor);
+        }
+    }
+    std::vector<Methan::InputBinding> bindings;
+    for(size_t p = 0; p < parameterCount; ++p) bindings.push_back({ parameters[p], values[0][p] });
+
+    Methan::IncrementalEvaluator incremental(graph, pool);
+    for(size_t p = 0; p < parameterCount; ++p) incremental.setInput(parameters[p], values[0][p]);
+    incremental.evaluate({ result });
+
+    std::cout << graph.nodeCount() << " nodes of " << count << " elements, " << pool.workerCount() << " workers, best of " << repetitions << " (us per run)" << std::endl;
+    std::cout << std::left << std::setw(24) << "from scratch" << std::right << std::setw(12) << __best_microseconds(repetitions, [&](size_t r) {
+        const size_t p = r % parameterCount;
+        bindings[p].tensor = values[(r / parameterCount + 1) % 2][p];
+        evaluator.run(graph, Methan::Span<const Methan::InputBinding>(bindings.data(), bindings.size()), Methan::Span<const Methan::NodeHandle>(&result, 1));
+    }) << std::endl;
+    std::cout << std::left << std::setw(24) << "incremental" << std::right << std::setw(12) << __best_microseconds(repetitions, [&](size_t r) {
+        const size_t p = r % parameterCount;
+        incremental.setInput(parameters[p], values[(r / parameterCount + 1) % 2][p]);
+        incremental.evaluate({ result });
+    }) << std::endl;
+    return 0;
+}
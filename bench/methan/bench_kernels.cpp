@@ -0,0 +1,73 @@
+#include <cstdint>
+
+#include "benchmark.hpp"
+
+#include <methan/core/execution/compiled_graph.hpp>
+#include <methan/core/kernels/elementwise.hpp>
+#include <methan/core/kernels/gemm.hpp>
+
+/**
+ * Kernels and graph execution at sizes small enough to run on every change: elementwise operations, a
+ * GEMM and the run of a compiled graph. Tracked against a baseline, see benchmark.hpp for the arguments.
+ */
+
+int main(int argc, char** argv)
+{
+    Methan::Bench::Suite suite("kernels");
+
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 1;
+    Methan::ThreadPool pool(options);
+
+    constexpr int64_t count = 1 << 16;
+    const Methan::Tensor a = Methan::Tensor::zeros(Methan::DataType::Float32, { count });
+    const Methan::Tensor b = Methan::Tensor::zeros(Methan::DataType::Float32, { count });
+    Methan::Tensor out = Methan::Tensor::zeros(Methan::DataType::Float32, { count });
+    const void* inputs[2] = { a.rawData(), b.rawData() };
+
+    for(Methan::ElementwiseOp op : { Methan::ElementwiseOp::Add, Methan::ElementwiseOp::Exp, Methan::ElementwiseOp::Tanh })
+    {
+        suite.add("elementwise/" + Methan::to_string(op) + "/f32/65536", [&, op](size_t iterations) {
+            for(size_t i = 0; i < iterations; ++i)
+            {
+                Methan::elementwise(op, Methan::DataType::Float32, static_cast<size_t>(count), Methan::Span<const void* const>(inputs, Methan::arity(op)), out.rawData());
+            }
+            Methan::Bench::doNotOptimize(out.rawData());
+        });
+    }
+
+    for(int64_t size : { 64, 256 })
+    {
+        suite.add("matmul/f32/" + std::to_string(size), [&pool, size](size_t iterations) {
+            const Methan::Tensor left = Methan::Tensor::zeros(Methan::DataType::Float32, { size, size });
+            const Methan::Tensor right = Methan::Tensor::zeros(Methan::DataType::Float32, { size, size });
+            Methan::Tensor product = Methan::Tensor::zeros(Methan::DataType::Float32, { size, size });
+            for(size_t i = 0; i < iterations; ++i) Methan::matmul(left, right, product, 1.0, 0.0, pool);
+            Methan::Bench::doNotOptimize(product.rawData());
+        });
+    }
+
+    // 4 chains of 16 small elementwise nodes joined by a sum: the per-node overhead dominates
+    Methan::Graph graph;
+    const Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle result = nullptr;
+    for(size_t c = 0; c < 4; ++c)
+    {
+        Methan::NodeHandle node = x;
+        for(size_t d = 0; d < 16; ++d) node = graph.addNode(Methan::OpCode::Elementwise, {node}, Methan::ElementwisePayload{ (c + d) % 2 ? Methan::ElementwiseOp::Relu : Methan::ElementwiseOp::Tanh, {} });
+        result = result == nullptr ? node : graph.addNode(Methan::OpCode::Elementwise, {result, node}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} });
+    }
+    graph.buildAdjacency();
+
+    const Methan::Tensor input = Methan::Tensor::zeros(Methan::DataType::Float32, { 256 });
+    const Methan::InputBinding bindings[] = { { x, input } };
+    const Methan::CompiledGraph compiled = Methan::compile(graph, Methan::Span<const Methan::InputBinding>(bindings, 1), Methan::Span<const Methan::NodeHandle>(&result, 1));
+    Methan::ExecutionFrame frame(compiled);
+    Methan::Tensor output;
+    suite.add("compiled_graph/run/68 nodes", [&](size_t iterations) {
+        for(size_t i = 0; i < iterations; ++i) compiled.run(Methan::Span<const Methan::Tensor>(&input, 1), Methan::Span<Methan::Tensor>(&output, 1), frame, pool);
+        Methan::Bench::doNotOptimize(output.rawData());
+    });
+
+    return suite.run(argc, argv);
+}
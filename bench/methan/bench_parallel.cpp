@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include <methan/core/execution/parallel.hpp>
+
+/**
+ * Time of a large reduction (sum of doubles) and of an inclusive scan, sequential and with
+ * parallel_reduce / parallel_scan on the pool.
+ *
+ * Usage: bench_parallel [elements] [repetitions] [workers]
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    template<typename Function>
+    double __best_milliseconds(size_t repetitions, Function&& function)
+    {
+        double best = 1e30;
+        for(size_t r = 0; r < repetitions + 1; ++r)
+        {
+            const Clock::time_point start = Clock::now();
+            function();
+            const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if(r > 0) best = std::min(best, elapsed);
+        }
+        return best;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (size_t(1) << 25);
+    const size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+    Methan::ThreadPoolOptions options;
+    options.workerCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+    Methan::ThreadPool pool(options);
+
+    std::vector<double> values(count);
+    for(size_t i = 0; i < count; ++i) values[i] = static_cast<double>(i % 1000) * 1e-3;
+    std::vector<double> prefixes(count);
+
+    const auto sum = [&](size_t begin, size_t end) { return std::accumulate(values.begin() + begin, values.begin() + end, 0.0); };
+    const auto add = [](double a, double b) { return a + b; };
+    const auto scan = [&](size_t begin, size_t end, double prefix) {
+        for(size_t i = begin; i < end; ++i) prefixes[i] = prefix += values[i];
+        return prefix;
+    };
+    volatile double sink = 0.0;
+
+    std::cout << count << " doubles, " << pool.workerCount() << " workers, best of " << repetitions << " (ms)" << std::endl;
+    std::cout << std::left << std::setw(24) << "reduce (sequential)" << std::right << std::setw(12) << __best_milliseconds(repetitions, [&]() { sink = sum(0, count); }) << std::endl;
+    std::cout << std::left << std::setw(24) << "parallel_reduce" << std::right << std::setw(12) << __best_milliseconds(repetitions, [&]() {
+        sink = Methan::parallel_reduce(0, count, 0.0, sum, add, pool, 4096);
+    }) << std::endl;
+    std::cout << std::left << std::setw(24) << "scan (sequential)" << std::right << std::setw(12) << __best_milliseconds(repetitions, [&]() { sink = scan(0, count, 0.0); }) << std::endl;
+    std::cout << std::left << std::setw(24) << "parallel_scan" << std::right << std::setw(12) << __best_milliseconds(repetitions, [&]() {
+        sink = Methan::parallel_scan(0, count, 0.0, sum, scan, add, pool, 4096);
+    }) << std::endl;
+    (void) sink;
+    return 0;
+}
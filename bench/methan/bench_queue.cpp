@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <methan/utility/mpmc_queue.hpp>
+#include <methan/utility/spsc_queue.hpp>
+
+/**
+ * Throughput (millions of elements per second) of MpmcQueue and SpscQueue against a std::deque guarded by
+ * a mutex, with one producer and one consumer, then with several of each.
+ *
+ * Usage: bench_queue [elements] [threads per side] [repetitions]
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Bounded std::deque behind a mutex, with the interface of the lock-free queues
+     */
+    class LockedQueue
+    {
+    public:
+        explicit LockedQueue(size_t capacity)
+        : m_capacity(capacity)
+        {}
+
+        inline bool tryPush(uint64_t value)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_values.size() >= m_capacity) return false;
+            m_values.push_back(value);
+            return true;
+        }
+
+        inline bool tryPop(uint64_t& value)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_values.empty()) return false;
+            value = m_values.front();
+            m_values.pop_front();
+            return true;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::deque<uint64_t> m_values;
+        size_t m_capacity;
+    };
+
+    /**
+     * @brief Millions of elements transferred per second through a new queue, best of the repetitions
+     */
+    template<typename Queue>
+    double __throughput(size_t count, size_t producers, size_t consumers, size_t repetitions)
+    {
+        double best = 0.0;
+        for(size_t r = 0; r < repetitions; ++r)
+        {
+            Queue queue(1024);
+            std::atomic<size_t> remaining{count};
+            std::atomic<uint64_t> checksum{0};
+            std::vector<std::thread> threads;
+
+            const Clock::time_point start = Clock::now();
+            for(size_t p = 0; p < producers; ++p)
+            {
+                threads.emplace_back([&, p]() {
+                    for(size_t i = p; i < count; i += producers)
+                    {
+                        while(!queue.tryPush(i)) std::this_thread::yield();
+                    }
+                });
+            }
+            for(size_t c = 0; c < consumers; ++c)
+            {
+                threads.emplace_back([&]() {
+                    uint64_t sum = 0;
+                    uint64_t value;
+                    while(remaining.load(std::memory_order_relaxed) > 0)
+                    {
+                        if(queue.tryPop(value))
+                        {
+                            sum += value;
+                            remaining.fetch_sub(1, std::memory_order_relaxed);
+                        }
+                        else
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                    checksum.fetch_add(sum);
+                });
+            }
+            for(std::thread& thread : threads) thread.join();
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            if(checksum.load() != uint64_t(count) * (count - 1) / 2)
+            {
+                std::cerr << "Elements were lost" << std::endl;
+                std::exit(1);
+            }
+            best = std::max(best, static_cast<double>(count) / seconds * 1e-6);
+        }
+        return best;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    const size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::max<size_t>(2, std::thread::hardware_concurrency() / 2);
+    const size_t repetitions = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 3;
+
+    std::cout << count << " elements, best of " << repetitions << " (Melements/s)" << std::endl;
+    std::cout << std::left << std::setw(32) << "1 -> 1 std::deque + mutex" << std::right << std::setw(12) << __throughput<LockedQueue>(count, 1, 1, repetitions) << std::endl;
+    std::cout << std::left << std::setw(32) << "1 -> 1 MpmcQueue" << std::right << std::setw(12) << __throughput<Methan::MpmcQueue<uint64_t>>(count, 1, 1, repetitions) << std::endl;
+    std::cout << std::left << std::setw(32) << "1 -> 1 SpscQueue" << std::right << std::setw(12) << __throughput<Methan::SpscQueue<uint64_t>>(count, 1, 1, repetitions) << std::endl;
+
+    const std::string label = std::to_string(threads) + " -> " + std::to_string(threads);
+    std::cout << std::left << std::setw(32) << label + " std::deque + mutex" << std::right << std::setw(12) << __throughput<LockedQueue>(count, threads, threads, repetitions) << std::endl;
+    std::cout << std::left << std::setw(32) << label + " MpmcQueue" << std::right << std::setw(12) << __throughput<Methan::MpmcQueue<uint64_t>>(count, threads, threads, repetitions) << std::endl;
+    return 0;
+}
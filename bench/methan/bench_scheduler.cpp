@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "benchmark.hpp"
+
+#include <methan/core/execution/executor.hpp>
+
+/**
+ * Makespan of the schedule policies on a wide-and-deep graph: many short chains of unit cost nodes
+ * (created first, hence dispatched first in FIFO order) next to one long chain whose length matches
+ * the amount of short work per worker. A policy that starts the long chain late pays for it at the tail,
+ * the critical path policy starts it first. Tracked against a baseline, see benchmark.hpp for the arguments.
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    const char* __policy_name(Methan::SchedulePolicy policy)
+    {
+        switch(policy)
+        {
+        case Methan::SchedulePolicy::WorkStealing: return "work-stealing";
+        case Methan::SchedulePolicy::Fifo: return "fifo";
+        case Methan::SchedulePolicy::Lifo: return "lifo";
+        case Methan::SchedulePolicy::CriticalPath: return "critical-path";
+        }
+        return "unknown";
+    }
+
+    Methan::Graph __wide_and_deep_graph(size_t width, size_t shortDepth, size_t longDepth)
+    {
+        Methan::Graph graph;
+        for(size_t i = 0; i < width; ++i)
+        {
+            Methan::NodeHandle previous = graph.addNode(Methan::OpCode::Input);
+            for(size_t d = 1; d < shortDepth; ++d) previous = graph.addNode(Methan::OpCode::Custom, {previous});
+        }
+
+        Methan::NodeHandle previous = graph.addNode(Methan::OpCode::Input);
+        for(size_t d = 1; d < longDepth; ++d) previous = graph.addNode(Methan::OpCode::Custom, {previous});
+
+        graph.isAcyclic();
+        return graph;
+    }
+
+    void __spin(const Methan::Graph& graph, Methan::NodeHandle node, std::chrono::microseconds unit)
+    {
+        const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(unit * Methan::nodeCost(graph, node));
+        while(Clock::now() < end) {}
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    Methan::Bench::Suite suite("scheduler");
+
+    const size_t workers = std::max(2u, std::thread::hardware_concurrency());
+    const std::chrono::microseconds unit(20);
+    const size_t longDepth = 200;
+    const size_t shortDepth = 50;
+    const size_t width = 4 * workers;
+    const Methan::Graph graph = __wide_and_deep_graph(width, shortDepth, longDepth);
+
+    const double work = static_cast<double>(graph.nodeCount());
+    const double lowerBound = std::max(static_cast<double>(longDepth), work / static_cast<double>(workers)) * static_cast<double>(unit.count()) * 1000.0;
+    std::cout << "graph: " << graph.nodeCount() << " nodes, " << graph.edgeCount() << " edges, " << workers << " workers, unit " << unit.count() << "us, "
+              << "lower bound " << std::fixed << std::setprecision(0) << lowerBound << " ns" << std::endl;
+
+    Methan::ThreadPoolOptions options;
+    options.workerCount = workers;
+    Methan::ThreadPool pool(options);
+    Methan::Executor executor(pool);
+
+    for(Methan::SchedulePolicy policy : { Methan::SchedulePolicy::Fifo, Methan::SchedulePolicy::Lifo, Methan::SchedulePolicy::WorkStealing, Methan::SchedulePolicy::CriticalPath })
+    {
+        suite.add(std::string("makespan/") + __policy_name(policy), [&, policy](size_t iterations) {
+            executor.setPolicy(policy);
+            for(size_t i = 0; i < iterations; ++i) executor.run(graph, [&](Methan::NodeHandle node) { __spin(graph, node, unit); });
+        });
+    }
+
+    return suite.run(argc, argv);
+}
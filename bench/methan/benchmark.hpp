@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Harness of the tracked benchmarks: a suite of named cases, each timed over `--repetitions` batches of
+ * enough iterations to last `--min-time`, reported as the median and the best time per iteration. The
+ * results can be written as JSON and compared against a previous run on their best time (the least
+ * sensitive to the load of the machine), a case slower than the baseline by more than `--threshold`
+ * percent failing the run.
+ *
+ * Usage: <benchmark> [--filter text] [--repetitions n] [--min-time ms] [--json file] [--baseline file] [--threshold percent]
+ */
+
+namespace Methan::Bench {
+
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Keep the compiler from optimizing `value` (or the computation of it) away
+     */
+    template<typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        static volatile const void* sink;
+        sink = &value;
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    /**
+     * @brief Body of a case: run the measured operation `iterations` times
+     */
+    typedef std::function<void(size_t iterations)> Body;
+
+    struct Measure
+    {
+        std::string name;
+        size_t iterations;
+        size_t repetitions;
+        double nsPerOp;
+        double minNsPerOp;
+    };
+
+    /**
+     * @brief Read the best time per iteration of the cases of a file written by `writeJson`, by name. A missing
+     * file is an empty baseline (a new benchmark).
+     */
+    inline std::map<std::string, double> readJson(const std::string& path)
+    {
+        std::map<std::string, double> baseline;
+        std::ifstream file(path);
+        if(!file) return baseline;
+
+        // One case per line, as written by writeJson
+        std::string line;
+        while(std::getline(file, line))
+        {
+            const size_t name = line.find("\"name\":\"");
+            const size_t time = line.find("\"min_ns_per_op\":");
+            if(name == std::string::npos || time == std::string::npos) continue;
+
+            const size_t begin = name + 8;
+            const size_t end = line.find('"', begin);
+            baseline[line.substr(begin, end - begin)] = std::strtod(line.c_str() + time + 16, nullptr);
+        }
+        return baseline;
+    }
+
+    inline void writeJson(std::ostream& stream, const std::string& suite, const std::vector<Measure>& measures)
+    {
+        stream << "{\"suite\":\"" << suite << "\",\"benchmarks\":[\n";
+        for(size_t i = 0; i < measures.size(); ++i)
+        {
+            const Measure& measure = measures[i];
+            stream << "{\"name\":\"" << measure.name << "\",\"iterations\":" << measure.iterations
+                   << ",\"repetitions\":" << measure.repetitions << std::fixed << std::setprecision(3)
+                   << ",\"ns_per_op\":" << measure.nsPerOp << ",\"min_ns_per_op\":" << measure.minNsPerOp << "}"
+                   << (i + 1 < measures.size() ? ",\n" : "\n");
+        }
+        stream << "]}" << std::endl;
+    }
+
+    class Suite
+    {
+    public:
+        explicit Suite(std::string name)
+        : m_name(std::move(name))
+        {}
+
+        /**
+         * @brief Add a case, the names are written as is in the JSON and must not contain quotes
+         */
+        inline void add(std::string name, Body body)
+        {
+            m_cases.emplace_back(std::move(name), std::move(body));
+        }
+
+        /**
+         * @brief Run the cases selected by the arguments of the program
+         *
+         * @return int the exit code of the program: 1 on a regression or an invalid argument, 0 otherwise
+         */
+        inline int run(int argc, char** argv)
+        {
+            std::string filter;
+            std::string json;
+            std::string baselinePath;
+            size_t repetitions = 5;
+            double minTime = 20.0;
+            double threshold = 10.0;
+            for(int i = 1; i < argc; ++i)
+            {
+                const std::string argument = argv[i];
+                if(i + 1 >= argc)
+                {
+                    std::cerr << "Missing value of " << argument << std::endl;
+                    return 1;
+                }
+                const char* value = argv[++i];
+                if(argument == "--filter") filter = value;
+                else if(argument == "--json") json = value;
+                else if(argument == "--baseline") baselinePath = value;
+                else if(argument == "--repetitions") repetitions = std::max<size_t>(1, std::strtoul(value, nullptr, 10));
+                else if(argument == "--min-time") minTime = std::strtod(value, nullptr);
+                else if(argument == "--threshold") threshold = std::strtod(value, nullptr);
+                else
+                {
+                    std::cerr << "Unknown argument " << argument << std::endl;
+                    return 1;
+                }
+            }
+
+            const std::map<std::string, double> baseline = baselinePath.empty() ? std::map<std::string, double>() : readJson(baselinePath);
+
+            std::cout << m_name << ": " << repetitions << " batches of at least " << minTime << " ms (ns per iteration)" << std::endl;
+            std::cout << std::left << std::setw(40) << "case" << std::right << std::setw(14) << "median" << std::setw(14) << "best";
+            if(!baselinePath.empty()) std::cout << std::setw(14) << "baseline" << std::setw(11) << "change";
+            std::cout << std::endl;
+            std::vector<Measure> measures;
+            size_t regressions = 0;
+            for(const std::pair<std::string, Body>& entry : m_cases)
+            {
+                if(entry.first.find(filter) == std::string::npos) continue;
+
+                const Measure measure = __measure(entry.first, entry.second, repetitions, minTime);
+                measures.push_back(measure);
+                std::cout << std::left << std::setw(40) << measure.name << std::right << std::fixed << std::setprecision(2) << std::setw(14) << measure.nsPerOp << std::setw(14) << measure.minNsPerOp;
+
+                const auto reference = baseline.find(measure.name);
+                if(reference != baseline.end())
+                {
+                    const double change = (measure.minNsPerOp / reference->second - 1.0) * 100.0;
+                    const bool regressed = change > threshold;
+                    if(regressed) ++regressions;
+                    std::cout << std::setw(14) << reference->second << std::showpos << std::setw(10) << change << "%" << std::noshowpos << (regressed ? "  REGRESSION" : "");
+                }
+                else if(!baselinePath.empty())
+                {
+                    std::cout << "  (not in the baseline)";
+                }
+                std::cout << std::endl;
+            }
+
+            if(!json.empty())
+            {
+                std::ofstream file(json);
+                writeJson(file, m_name, measures);
+                if(!file)
+                {
+                    std::cerr << "Cannot write " << json << std::endl;
+                    return 1;
+                }
+            }
+
+            if(regressions > 0)
+            {
+                std::cout << regressions << " case(s) slower than the baseline by more than " << threshold << "%" << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+
+    private:
+        static inline double __elapsed_ns(const Body& body, size_t iterations)
+        {
+            const Clock::time_point start = Clock::now();
+            body(iterations);
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+
+        static inline Measure __measure(const std::string& name, const Body& body, size_t repetitions, double minTime)
+        {
+            // Grow the batch until it lasts long enough for the clock to be precise
+            const double target = minTime * 1e6;
+            size_t iterations = 1;
+            double elapsed = __elapsed_ns(body, iterations);
+            while(elapsed < target && iterations < (size_t(1) << 40))
+            {
+                const double scale = elapsed > 0.0 ? std::min(10.0, std::max(2.0, 1.2 * target / elapsed)) : 10.0;
+                iterations = static_cast<size_t>(std::ceil(static_cast<double>(iterations) * scale));
+                elapsed = __elapsed_ns(body, iterations);
+            }
+
+            std::vector<double> times(repetitions);
+            for(double& time : times) time = __elapsed_ns(body, iterations) / static_cast<double>(iterations);
+            std::sort(times.begin(), times.end());
+
+            return Measure{ name, iterations, repetitions, times[times.size() / 2], times.front() };
+        }
+
+        std::string m_name;
+        std::vector<std::pair<std::string, Body>> m_cases;
+    };
+
+}
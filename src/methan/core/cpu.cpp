@@ -0,0 +1,180 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include <methan/core/cpu.hpp>
+
+#if defined(METHAN_ARCH_X86)
+#if defined(METHAN_COMPILER_MSC)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+
+#if defined(METHAN_ARCH_X86)
+    inline void __query_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t registers[4])
+    {
+#if defined(METHAN_COMPILER_MSC)
+        int values[4];
+        __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for(int i = 0; i < 4; ++i) registers[i] = static_cast<uint32_t>(values[i]);
+#else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    }
+
+    inline uint64_t __read_xcr(uint32_t index)
+    {
+#if defined(METHAN_COMPILER_MSC)
+        return _xgetbv(index);
+#else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+#endif
+
+    Methan::CpuFeatures __detect_features()
+    {
+        Methan::CpuFeatures features;
+
+#if defined(METHAN_ARCH_X86)
+        uint32_t registers[4] = { 0, 0, 0, 0 };
+        __query_cpuid(0, 0, registers);
+        const uint32_t maxLeaf = registers[0];
+        if(maxLeaf < 1) return features;
+
+        __query_cpuid(1, 0, registers);
+        const uint32_t ecx1 = registers[2];
+        const uint32_t edx1 = registers[3];
+        if(edx1 & (1u << 26)) features |= Methan::CpuFeature::SSE2;
+        if(ecx1 & (1u << 0)) features |= Methan::CpuFeature::SSE3;
+        if(ecx1 & (1u << 9)) features |= Methan::CpuFeature::SSSE3;
+        if(ecx1 & (1u << 19)) features |= Methan::CpuFeature::SSE41;
+        if(ecx1 & (1u << 20)) features |= Methan::CpuFeature::SSE42;
+
+        // The AVX registers are only usable if the operating system saves them (OSXSAVE + XCR0)
+        const bool osxsave = (ecx1 & (1u << 27)) != 0;
+        const uint64_t xcr0 = osxsave ? __read_xcr(0) : 0;
+        const bool ymmState = (xcr0 & 0x6) == 0x6;
+        const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+
+        if(!ymmState) return features;
+        if(ecx1 & (1u << 28)) features |= Methan::CpuFeature::AVX;
+        if(ecx1 & (1u << 12)) features |= Methan::CpuFeature::FMA;
+        if(ecx1 & (1u << 29)) features |= Methan::CpuFeature::F16C;
+
+        if(maxLeaf < 7) return features;
+        __query_cpuid(7, 0, registers);
+        const uint32_t ebx7 = registers[1];
+        if(ebx7 & (1u << 5)) features |= Methan::CpuFeature::AVX2;
+
+        if(!zmmState) return features;
+        if(ebx7 & (1u << 16)) features |= Methan::CpuFeature::AVX512F;
+        if(ebx7 & (1u << 17)) features |= Methan::CpuFeature::AVX512DQ;
+        if(ebx7 & (1u << 30)) features |= Methan::CpuFeature::AVX512BW;
+        if(ebx7 & (1u << 31)) features |= Methan::CpuFeature::AVX512VL;
+#elif defined(METHAN_ARCH_ARM64)
+        features |= Methan::CpuFeature::NEON;
+#endif
+
+        return features;
+    }
+
+    Methan::IsaLevel __supported_level(Methan::CpuFeatures features)
+    {
+        Methan::IsaLevel level = Methan::IsaLevel::Scalar;
+        if(features >= Methan::CpuFeature::SSE2) level = Methan::IsaLevel::SSE2;
+#if defined(METHAN_DISPATCH_AVX2)
+        if(level == Methan::IsaLevel::SSE2 && features >= (Methan::CpuFeature::AVX2 | Methan::CpuFeature::FMA | Methan::CpuFeature::F16C)) level = Methan::IsaLevel::AVX2;
+#endif
+#if defined(METHAN_DISPATCH_AVX512)
+        if(level == Methan::IsaLevel::AVX2 && features >= Methan::CpuFeature::AVX512F) level = Methan::IsaLevel::AVX512;
+#endif
+        return level;
+    }
+
+    Methan::IsaLevel __initial_level()
+    {
+        Methan::IsaLevel level = Methan::supportedIsaLevel();
+
+        const char* requested = std::getenv("METHAN_ISA");
+        if(requested == nullptr) return level;
+
+        Methan::IsaLevel cap = level;
+        if(std::strcmp(requested, "scalar") == 0) cap = Methan::IsaLevel::Scalar;
+        else if(std::strcmp(requested, "sse2") == 0) cap = Methan::IsaLevel::SSE2;
+        else if(std::strcmp(requested, "avx2") == 0) cap = Methan::IsaLevel::AVX2;
+        else if(std::strcmp(requested, "avx512") == 0) cap = Methan::IsaLevel::AVX512;
+
+        return cap < level ? cap : level;
+    }
+
+    std::atomic<Methan::IsaLevel>& __current_level()
+    {
+        static std::atomic<Methan::IsaLevel> level(__initial_level());
+        return level;
+    }
+
+}
+
+METHAN_API Methan::CpuFeatures Methan::cpuFeatures()
+{
+    static const CpuFeatures features = __detect_features();
+    return features;
+}
+
+METHAN_API std::string Methan::to_string(CpuFeatures features)
+{
+    static const struct { CpuFeature feature; const char* name; } names[] = {
+        { CpuFeature::SSE2, "sse2" }, { CpuFeature::SSE3, "sse3" }, { CpuFeature::SSSE3, "ssse3" },
+        { CpuFeature::SSE41, "sse4.1" }, { CpuFeature::SSE42, "sse4.2" }, { CpuFeature::AVX, "avx" },
+        { CpuFeature::AVX2, "avx2" }, { CpuFeature::FMA, "fma" }, { CpuFeature::F16C, "f16c" },
+        { CpuFeature::AVX512F, "avx512f" }, { CpuFeature::AVX512DQ, "avx512dq" }, { CpuFeature::AVX512BW, "avx512bw" },
+        { CpuFeature::AVX512VL, "avx512vl" }, { CpuFeature::NEON, "neon" }
+    };
+
+    std::string result;
+    for(const auto& entry : names)
+    {
+        if(!(features & entry.feature)) continue;
+        if(!result.empty()) result += ' ';
+        result += entry.name;
+    }
+    return result;
+}
+
+METHAN_API std::string Methan::to_string(IsaLevel level)
+{
+    switch(level)
+    {
+    case IsaLevel::Scalar: return "scalar";
+    case IsaLevel::SSE2: return "sse2";
+    case IsaLevel::AVX2: return "avx2";
+    case IsaLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+METHAN_API Methan::IsaLevel Methan::supportedIsaLevel()
+{
+    static const IsaLevel level = __supported_level(cpuFeatures());
+    return level;
+}
+
+METHAN_API Methan::IsaLevel Methan::isaLevel() noexcept
+{
+    return __current_level().load(std::memory_order_relaxed);
+}
+
+METHAN_API Methan::IsaLevel Methan::setIsaLevel(IsaLevel level)
+{
+    const IsaLevel supported = supportedIsaLevel();
+    if(level > supported) level = supported;
+    __current_level().store(level, std::memory_order_relaxed);
+    return level;
+}
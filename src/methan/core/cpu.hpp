@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <methan/core/except.hpp>
+#include <methan/utility/enum.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Instruction set extensions of the CPU running the program, detected at run time. The AVX
+     * family is only reported when the operating system also saves the corresponding registers.
+     */
+    enum class CpuFeature : uint32_t
+    {
+        SSE2     = 1 << 0,
+        SSE3     = 1 << 1,
+        SSSE3    = 1 << 2,
+        SSE41    = 1 << 3,
+        SSE42    = 1 << 4,
+        AVX      = 1 << 5,
+        AVX2     = 1 << 6,
+        FMA      = 1 << 7,
+        F16C     = 1 << 8,
+        AVX512F  = 1 << 9,
+        AVX512DQ = 1 << 10,
+        AVX512BW = 1 << 11,
+        AVX512VL = 1 << 12,
+        NEON     = 1 << 13
+    };
+
+    typedef EnumFlag<CpuFeature> CpuFeatures;
+    METHAN_ENUMSET_OPERATORS(CpuFeatures)
+
+    /**
+     * @brief Return the features of the CPU (detected once, on the first call)
+     */
+    METHAN_API CpuFeatures cpuFeatures();
+
+    METHAN_API std::string to_string(CpuFeatures features);
+
+    /**
+     * @brief Families of kernel implementations, each level requires the features of the previous ones
+     *
+     * - `SSE2`: SSE2 (the x86-64 baseline)
+     * - `AVX2`: AVX2, FMA and F16C
+     * - `AVX512`: AVX-512F on top of AVX2
+     */
+    enum class IsaLevel : uint32_t
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    METHAN_API std::string to_string(IsaLevel level);
+
+    /**
+     * @brief Best level supported by the CPU (and compiled in the library, see METHAN_ENABLE_DISPATCH)
+     */
+    METHAN_API IsaLevel supportedIsaLevel();
+
+    /**
+     * @brief Level used to select the kernels. Defaults to the supported level, lowered by the environment
+     * variable `METHAN_ISA` (`scalar`, `sse2`, `avx2` or `avx512`) if set.
+     */
+    METHAN_API IsaLevel isaLevel() noexcept;
+
+    /**
+     * @brief Select the kernels of a lower level (e.g. to compare implementations), the level is clamped
+     * to the supported one. Returns the level actually selected.
+     */
+    METHAN_API IsaLevel setIsaLevel(IsaLevel level);
+
+    /**
+     * @brief Table of the implementations of a kernel for each IsaLevel, the levels that are not
+     * implemented (or not compiled) are left null. The scalar implementation is mandatory.
+     *
+     * @tparam Function a function pointer type
+     */
+    template<typename Function>
+    struct Dispatch
+    {
+        Function scalar;
+        Function sse2;
+        Function avx2;
+        Function avx512;
+
+        /**
+         * @brief Return the best implementation available at the given level
+         */
+        constexpr Function resolve(IsaLevel level) const noexcept
+        {
+            if(level >= IsaLevel::AVX512 && avx512 != nullptr) return avx512;
+            if(level >= IsaLevel::AVX2 && avx2 != nullptr) return avx2;
+            if(level >= IsaLevel::SSE2 && sse2 != nullptr) return sse2;
+            return scalar;
+        }
+
+        inline Function operator()() const noexcept
+        {
+            return resolve(isaLevel());
+        }
+    };
+
+}
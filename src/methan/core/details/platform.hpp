@@ -93,4 +93,27 @@
 #define METHAN_SUPPORT_AVX_FMA
 #endif
 
+/** Detect the Architecture **/
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define METHAN_ARCH_X86_64
+#define METHAN_ARCH_X86
+#elif defined(__i386__) || defined(_M_IX86)
+#define METHAN_ARCH_X86_32
+#define METHAN_ARCH_X86
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define METHAN_ARCH_ARM64
+#endif
+
+/** Hardware constant(s) **/
+#define METHAN_CACHE_LINE_SIZE         64
 
+/* Width (in bytes) of the widest vector register available at compile time */
+#if defined(METHAN_SUPPORT_AVX512F)
+#define METHAN_SIMD_WIDTH              64
+#elif defined(METHAN_SUPPORT_AVX)
+#define METHAN_SIMD_WIDTH              32
+#elif defined(METHAN_SUPPORT_SSE2) || defined(METHAN_ARCH_ARM64)
+#define METHAN_SIMD_WIDTH              16
+#else
+#define METHAN_SIMD_WIDTH              8
+#endif
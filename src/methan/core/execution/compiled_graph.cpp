@@ -0,0 +1,489 @@
+#include <algorithm>
+#include <string>
+
+#include <methan/core/execution/compiled_graph.hpp>
+#include <methan/core/kernels/gemm.hpp>
+#include <methan/core/passes/rewrite.hpp>
+#include <methan/core/profiler.hpp>
+#include <methan/utility/exception.hpp>
+
+namespace {
+
+    // Operands gathered on the stack, the instructions with more operands use the heap
+    constexpr size_t __inline_operands = 4;
+
+    /**
+     * @brief Copy of the tensors of the operands of an instruction, for the kernels taking a span of tensors
+     */
+    class GatheredOperands
+    {
+    public:
+        GatheredOperands(const Methan::CompiledGraph& graph, const Methan::CompiledInstruction& instruction, const Methan::Tensor* values)
+        : m_tensors(m_local),
+        m_count(instruction.operandCount)
+        {
+            if(m_count > __inline_operands)
+            {
+                m_spilled.resize(m_count);
+                m_tensors = m_spilled.data();
+            }
+
+            const Methan::Span<const Methan::NodeIndex> operands = graph.operands(instruction);
+            for(size_t i = 0; i < m_count; ++i) m_tensors[i] = values[operands[i]];
+        }
+
+        inline Methan::Span<const Methan::Tensor> span() const noexcept
+        {
+            return Methan::Span<const Methan::Tensor>(m_tensors, m_count);
+        }
+
+    private:
+        Methan::Tensor m_local[__inline_operands];
+        std::vector<Methan::Tensor> m_spilled;
+        Methan::Tensor* m_tensors;
+        size_t m_count;
+    };
+
+    void __elementwise_kernel(const Methan::CompiledGraph& graph, const Methan::CompiledInstruction& instruction, Methan::Tensor* values, Methan::ThreadPool&)
+    {
+        METHAN_PROFILE_NODE("Elementwise", instruction.output);
+        Methan::Tensor& output = values[instruction.output];
+        if(instruction.offset != Methan::MemoryPlan::Unplanned && instruction.sameShapes)
+        {
+            // Planned results and operands of the same shape only have to be contiguous (an input may not be)
+            const Methan::Span<const Methan::NodeIndex> operands = graph.operands(instruction);
+            const void* pointers[3] = { nullptr, nullptr, nullptr };
+            bool contiguous = true;
+            for(size_t i = 0; i < operands.size(); ++i)
+            {
+                contiguous = contiguous && values[operands[i]].isContiguous();
+                pointers[i] = values[operands[i]].rawData();
+            }
+
+            if(contiguous)
+            {
+                Methan::elementwise(instruction.elementwise.op, output.dtype(), static_cast<size_t>(output.elementCount()), Methan::Span<const void* const>(pointers, operands.size()), output.rawData(), instruction.elementwise.params);
+                return;
+            }
+        }
+
+        const GatheredOperands operands(graph, instruction, values);
+        if(instruction.offset != Methan::MemoryPlan::Unplanned) Methan::elementwise(instruction.elementwise.op, operands.span(), output, instruction.elementwise.params);
+        else output = Methan::elementwise(instruction.elementwise.op, operands.span(), instruction.elementwise.params);
+    }
+
+    void __fused_kernel(const Methan::CompiledGraph& graph, const Methan::CompiledInstruction& instruction, Methan::Tensor* values, Methan::ThreadPool&)
+    {
+        METHAN_PROFILE_NODE("FusedElementwise", instruction.output);
+        const GatheredOperands operands(graph, instruction, values);
+        Methan::Tensor& output = values[instruction.output];
+        if(instruction.offset != Methan::MemoryPlan::Unplanned) Methan::elementwise(graph.program(instruction), operands.span(), output);
+        else output = Methan::elementwise(graph.program(instruction), operands.span());
+    }
+
+    void __matmul_kernel(const Methan::CompiledGraph& graph, const Methan::CompiledInstruction& instruction, Methan::Tensor* values, Methan::ThreadPool& pool)
+    {
+        METHAN_PROFILE_NODE("MatMul", instruction.output);
+        const Methan::Span<const Methan::NodeIndex> operands = graph.operands(instruction);
+        const Methan::Tensor a = instruction.matmul.transposeA ? values[operands[0]].transpose(0, 1) : values[operands[0]];
+        const Methan::Tensor b = instruction.matmul.transposeB ? values[operands[1]].transpose(0, 1) : values[operands[1]];
+
+        Methan::Tensor& output = values[instruction.output];
+        if(instruction.offset == Methan::MemoryPlan::Unplanned) output = Methan::Tensor(a.dtype(), { a.dim(0), b.dim(1) });
+        Methan::matmul(a, b, output, instruction.matmul.alpha, 0.0, pool);
+    }
+
+    void __custom_kernel(const Methan::CompiledGraph& graph, const Methan::CompiledInstruction& instruction, Methan::Tensor* values, Methan::ThreadPool&)
+    {
+        METHAN_PROFILE_NODE("Custom", instruction.output);
+        const GatheredOperands operands(graph, instruction, values);
+        values[instruction.output] = graph.customOperation(instruction)(operands.span());
+    }
+
+    /**
+     * @brief The exception being handled, wrapped into an `ExecutionError` if it is not a Methan::Exception
+     */
+    std::exception_ptr __current_exception()
+    {
+        try
+        {
+            throw;
+        }
+        catch(const Methan::Exception&)
+        {
+            return std::current_exception();
+        }
+        catch(const std::exception& e)
+        {
+            return std::make_exception_ptr(Methan::Exception(std::string("A node raised an exception: ") + e.what(), METHAN_EXPAND(__FILE__), METHAN_EXPAND(__LINE__), Methan::ExceptionType::ExecutionError));
+        }
+        catch(...)
+        {
+            return std::make_exception_ptr(Methan::Exception("A node raised an unknown exception", METHAN_EXPAND(__FILE__), METHAN_EXPAND(__LINE__), Methan::ExceptionType::ExecutionError));
+        }
+    }
+
+    /**
+     * @brief Copy of the nodes of the graph the outputs depend on
+     */
+    Methan::RewrittenGraph __live_subgraph(const Methan::Graph& graph, Methan::Span<const Methan::NodeHandle> outputs)
+    {
+        std::vector<bool> live(graph.nodeCount(), false);
+        std::vector<Methan::NodeIndex> stack;
+        for(size_t i = 0; i < outputs.size(); ++i)
+        {
+            METHAN_FORCE_ASSERT(graph.contains(outputs[i]), Methan::ExceptionType::IllegalArgument, "The requested output is not a node of the graph");
+            stack.push_back(Methan::Graph::index(outputs[i]));
+        }
+        while(!stack.empty())
+        {
+            const Methan::NodeIndex node = stack.back();
+            stack.pop_back();
+            if(live[node]) continue;
+            live[node] = true;
+            for(Methan::NodeIndex input : graph.inputs(Methan::Graph::handle(node))) stack.push_back(input);
+        }
+
+        Methan::RewrittenGraph result;
+        result.mapping.assign(graph.nodeCount(), nullptr);
+        std::vector<Methan::NodeHandle> inputs;
+        for(Methan::NodeIndex node : graph.topologicalOrder())
+        {
+            if(!live[node]) continue;
+            inputs.clear();
+            for(Methan::NodeIndex input : graph.inputs(Methan::Graph::handle(node))) inputs.push_back(result.mapping[input]);
+            result.mapping[node] = Methan::copyNode(graph, Methan::Graph::handle(node), result.graph, Methan::Span<const Methan::NodeHandle>(inputs.data(), inputs.size()));
+        }
+        return result;
+    }
+
+    void __check_node(const Methan::Graph& graph, Methan::NodeHandle node)
+    {
+        const Methan::Varient& payload = graph.payload(node);
+        const std::string name = "The node " + std::to_string(Methan::Graph::index(node));
+
+        switch(graph.op(node))
+        {
+        case Methan::OpCode::Input:
+            return;
+        case Methan::OpCode::Constant:
+            METHAN_FORCE_ASSERT(payload.is<Methan::Tensor>(), Methan::ExceptionType::IllegalArgument, name + ": the payload of a Constant node must be a Tensor");
+            return;
+        case Methan::OpCode::Custom:
+            METHAN_FORCE_ASSERT(payload.is<Methan::CustomOperation>(), Methan::ExceptionType::IllegalArgument, name + ": the payload of a Custom node must be a CustomOperation");
+            return;
+        case Methan::OpCode::Elementwise:
+            METHAN_FORCE_ASSERT(payload.is<Methan::ElementwisePayload>(), Methan::ExceptionType::IllegalArgument, name + ": the payload of an Elementwise node must be an ElementwisePayload");
+            METHAN_FORCE_ASSERT(graph.inDegree(node) == Methan::arity(payload.get<Methan::ElementwisePayload>().op), Methan::ExceptionType::IllegalArgument, name + ": wrong number of inputs for " + Methan::to_string(payload.get<Methan::ElementwisePayload>().op));
+            return;
+        case Methan::OpCode::FusedElementwise:
+            METHAN_FORCE_ASSERT(payload.is<Methan::FusedElementwisePayload>() && !payload.get<Methan::FusedElementwisePayload>().program.empty(), Methan::ExceptionType::IllegalArgument, name + ": the payload of a FusedElementwise node must be a non-empty FusedElementwisePayload");
+            return;
+        case Methan::OpCode::MatMul:
+            METHAN_FORCE_ASSERT(payload.isEmpty() || payload.is<Methan::MatMulPayload>(), Methan::ExceptionType::IllegalArgument, name + ": the payload of a MatMul node must be a MatMulPayload");
+            METHAN_FORCE_ASSERT(graph.inDegree(node) == 2, Methan::ExceptionType::IllegalArgument, name + ": a MatMul node expects 2 inputs");
+            return;
+        }
+        METHAN_THROW_EXCEPTION(name + " has an unknown operation", Methan::ExceptionType::IllegalArgument);
+    }
+
+}
+
+METHAN_API Methan::CompiledGraph Methan::CompiledGraph::compile(const Graph& source, Span<const InputBinding> inputs, Span<const NodeHandle> outputs, const CompileOptions& options)
+{
+    const RewrittenGraph live = __live_subgraph(source, outputs);
+    const Graph& graph = live.graph;
+    const size_t nodeCount = graph.nodeCount();
+
+    CompiledGraph compiled;
+    compiled.m_concurrent = options.concurrent;
+
+    // Inputs that do not contribute to the outputs are accepted, and ignored
+    std::vector<InputBinding> bindings;
+    std::vector<bool> bound(nodeCount, false);
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(source.contains(inputs[i].node) && source.op(inputs[i].node) == OpCode::Input, Methan::ExceptionType::IllegalArgument, "Tensors can only be bound to the Input nodes of the graph");
+        const NodeHandle node = live.map(inputs[i].node);
+        compiled.m_inputs.push_back(node != nullptr ? Graph::index(node) : Graph::InvalidIndex);
+        if(node == nullptr) continue;
+
+        bindings.push_back({ node, inputs[i].tensor });
+        bound[Graph::index(node)] = true;
+    }
+
+    std::vector<NodeHandle> results;
+    for(size_t i = 0; i < outputs.size(); ++i)
+    {
+        results.push_back(live.map(outputs[i]));
+        compiled.m_outputs.push_back(Graph::index(results.back()));
+    }
+
+    for(NodeIndex node = 0; node < nodeCount; ++node)
+    {
+        const NodeHandle handle = Graph::handle(node);
+        METHAN_FORCE_ASSERT(graph.op(handle) != OpCode::Input || bound[node], Methan::ExceptionType::IllegalArgument, "An Input node the outputs depend on is not bound");
+        __check_node(graph, handle);
+        if(graph.op(handle) == OpCode::Constant) compiled.m_constants.emplace_back(node, graph.payload(handle).get<Tensor>());
+    }
+
+    std::vector<TensorSpec> specs = Evaluator::inferSpecs(graph, Span<const InputBinding>(bindings.data(), bindings.size()));
+    if(options.concurrent)
+    {
+        compiled.m_plan.order = graph.topologicalOrder();
+        compiled.m_plan.specs = std::move(specs);
+        compiled.m_plan.offsets.assign(nodeCount, MemoryPlan::Unplanned);
+        compiled.m_plan.inPlace.assign(nodeCount, Graph::InvalidIndex);
+    }
+    else
+    {
+        compiled.m_plan = planMemory(graph, std::move(specs), Span<const NodeHandle>(results.data(), results.size()));
+    }
+    const MemoryPlan& plan = compiled.m_plan;
+
+    compiled.m_inputSpecs.resize(inputs.size());
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        if(compiled.m_inputs[i] != Graph::InvalidIndex) compiled.m_inputSpecs[i] = plan.specs[compiled.m_inputs[i]];
+    }
+
+    // Lower the operations to instructions, in execution order
+    std::vector<uint32_t> instructionOf(nodeCount, ~uint32_t(0));
+    for(NodeIndex node : plan.order)
+    {
+        const NodeHandle handle = Graph::handle(node);
+        const Varient& payload = graph.payload(handle);
+
+        CompiledInstruction instruction = {};
+        instruction.output = node;
+        instruction.offset = plan.offsets[node];
+        switch(graph.op(handle))
+        {
+        case OpCode::Input:
+        case OpCode::Constant:
+            continue;
+        case OpCode::Custom:
+            instruction.kernel = &__custom_kernel;
+            instruction.extra = static_cast<uint32_t>(compiled.m_customs.size());
+            compiled.m_customs.push_back(payload.get<CustomOperation>());
+            break;
+        case OpCode::Elementwise:
+            instruction.kernel = &__elementwise_kernel;
+            instruction.elementwise = payload.get<ElementwisePayload>();
+            break;
+        case OpCode::FusedElementwise:
+        {
+            const std::vector<ElementwiseInstruction>& program = payload.get<FusedElementwisePayload>().program;
+            instruction.kernel = &__fused_kernel;
+            instruction.extra = static_cast<uint32_t>(compiled.m_programs.size());
+            instruction.extraCount = static_cast<uint32_t>(program.size());
+            compiled.m_programs.insert(compiled.m_programs.end(), program.begin(), program.end());
+            break;
+        }
+        case OpCode::MatMul:
+            instruction.kernel = &__matmul_kernel;
+            if(payload.isNonEmpty()) instruction.matmul = payload.get<MatMulPayload>();
+            break;
+        }
+
+        instruction.firstOperand = static_cast<uint32_t>(compiled.m_operands.size());
+        instruction.sameShapes = plan.specs[node].known;
+        for(NodeIndex input : graph.inputs(handle))
+        {
+            compiled.m_operands.push_back(input);
+            if(instructionOf[input] != ~uint32_t(0)) ++instruction.dependencyCount;
+            instruction.sameShapes = instruction.sameShapes && plan.specs[input].known && plan.specs[input].shape == plan.specs[node].shape;
+        }
+        instruction.operandCount = static_cast<uint32_t>(compiled.m_operands.size() - instruction.firstOperand);
+
+        instructionOf[node] = static_cast<uint32_t>(compiled.m_instructions.size());
+        if(instruction.dependencyCount == 0) compiled.m_roots.push_back(instructionOf[node]);
+        compiled.m_instructions.push_back(instruction);
+    }
+
+    for(CompiledInstruction& instruction : compiled.m_instructions)
+    {
+        instruction.firstConsumer = static_cast<uint32_t>(compiled.m_consumers.size());
+        for(NodeIndex consumer : graph.outputs(Graph::handle(instruction.output))) compiled.m_consumers.push_back(instructionOf[consumer]);
+        instruction.consumerCount = static_cast<uint32_t>(compiled.m_consumers.size() - instruction.firstConsumer);
+    }
+
+    // The tensors that are neither planned, constant nor requested are released after their last use, the
+    // inputs and the outputs at the end of the run
+    std::vector<bool> requested(nodeCount, false);
+    for(NodeIndex output : compiled.m_outputs) requested[output] = true;
+
+    std::vector<uint32_t> lastUses(nodeCount, ~uint32_t(0));
+    for(uint32_t i = 0; i < compiled.m_instructions.size(); ++i)
+    {
+        const CompiledInstruction& instruction = compiled.m_instructions[i];
+        for(uint32_t o = 0; o < instruction.operandCount; ++o) lastUses[compiled.m_operands[instruction.firstOperand + o]] = i;
+    }
+
+    std::vector<std::vector<NodeIndex>> releases(compiled.m_instructions.size());
+    for(NodeIndex node = 0; node < nodeCount; ++node)
+    {
+        const OpCode op = graph.op(Graph::handle(node));
+        if(op == OpCode::Constant || plan.offsets[node] != MemoryPlan::Unplanned) continue;
+
+        if(op == OpCode::Input || requested[node] || options.concurrent || lastUses[node] == ~uint32_t(0)) compiled.m_finalReleases.push_back(node);
+        else releases[lastUses[node]].push_back(node);
+    }
+    for(uint32_t i = 0; i < compiled.m_instructions.size(); ++i)
+    {
+        CompiledInstruction& instruction = compiled.m_instructions[i];
+        instruction.firstRelease = static_cast<uint32_t>(compiled.m_releases.size());
+        instruction.releaseCount = static_cast<uint32_t>(releases[i].size());
+        compiled.m_releases.insert(compiled.m_releases.end(), releases[i].begin(), releases[i].end());
+    }
+
+    return compiled;
+}
+
+METHAN_API void Methan::CompiledGraph::run(Span<const Tensor> inputs, Span<Tensor> outputs, ExecutionFrame& frame, ThreadPool& pool) const
+{
+    METHAN_PROFILE_SCOPE("CompiledGraph::run");
+    METHAN_FORCE_ASSERT(&frame.graph() == this, Methan::ExceptionType::IllegalArgument, "The execution frame was not created for this graph");
+    METHAN_FORCE_ASSERT(inputs.size() == m_inputs.size(), Methan::ExceptionType::IllegalArgument, "Expected " + std::to_string(m_inputs.size()) + " inputs, got " + std::to_string(inputs.size()));
+    METHAN_FORCE_ASSERT(outputs.size() == m_outputs.size(), Methan::ExceptionType::IllegalArgument, "Expected " + std::to_string(m_outputs.size()) + " outputs, got " + std::to_string(outputs.size()));
+
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        if(m_inputs[i] == Graph::InvalidIndex) continue;
+        const TensorSpec& spec = m_inputSpecs[i];
+        METHAN_FORCE_ASSERT(inputs[i].dtype() == spec.dtype && inputs[i].shape() == spec.shape, Methan::ExceptionType::IllegalArgument, "The input " + std::to_string(i) + " does not have the type and shape the graph was compiled for");
+        frame.m_values[m_inputs[i]] = inputs[i];
+    }
+
+    try
+    {
+        if(m_concurrent)
+        {
+            frame.m_pool = &pool;
+            frame.m_cancelled.store(false, std::memory_order_relaxed);
+            frame.m_error = nullptr;
+            for(size_t i = 0; i < m_instructions.size(); ++i) frame.m_pending[i].store(m_instructions[i].dependencyCount, std::memory_order_relaxed);
+
+            frame.m_group.add(m_instructions.size());
+            for(uint32_t root : m_roots) pool.submit(&frame.m_jobs[root]);
+            pool.wait(frame.m_group);
+            if(frame.m_error) std::rethrow_exception(frame.m_error);
+        }
+        else
+        {
+            for(const CompiledInstruction& instruction : m_instructions)
+            {
+                frame.invoke(instruction, pool);
+                for(uint32_t i = 0; i < instruction.releaseCount; ++i) frame.m_values[m_releases[instruction.firstRelease + i]] = Tensor();
+            }
+        }
+    }
+    catch(...)
+    {
+        const std::exception_ptr error = __current_exception();
+        for(NodeIndex node : m_releases) frame.m_values[node] = Tensor();
+        frame.release();
+        std::rethrow_exception(error);
+    }
+
+    for(size_t i = 0; i < outputs.size(); ++i) outputs[i] = frame.m_values[m_outputs[i]];
+    frame.release();
+}
+
+METHAN_API std::vector<Methan::Tensor> Methan::CompiledGraph::run(Span<const Tensor> inputs, ThreadPool& pool) const
+{
+    ExecutionFrame frame(*this);
+    std::vector<Tensor> outputs(m_outputs.size());
+    run(inputs, Span<Tensor>(outputs.data(), outputs.size()), frame, pool);
+    return outputs;
+}
+
+METHAN_API Methan::ExecutionFrame::ExecutionFrame(const CompiledGraph& graph)
+: m_graph(&graph),
+m_values(graph.m_plan.specs.size()),
+m_pool(nullptr),
+m_cancelled(false)
+{
+    for(const std::pair<NodeIndex, Tensor>& constant : graph.m_constants) m_values[constant.first] = constant.second;
+
+    // The planned tensors are views of the slab, written by every run
+    const MemoryPlan& plan = graph.m_plan;
+    if(plan.slabSize > 0) m_slab = std::make_shared<Buffer>(plan.slabSize);
+    for(const CompiledInstruction& instruction : graph.m_instructions)
+    {
+        if(instruction.offset == MemoryPlan::Unplanned) continue;
+        const TensorSpec& spec = plan.specs[instruction.output];
+        m_values[instruction.output] = Tensor(m_slab, instruction.offset, spec.dtype, spec.shape);
+    }
+
+    if(graph.m_concurrent)
+    {
+        m_pending.reset(new std::atomic<uint32_t>[graph.m_instructions.size()]);
+        m_jobs.resize(graph.m_instructions.size());
+        for(uint32_t i = 0; i < m_jobs.size(); ++i)
+        {
+            m_jobs[i].execute = &ExecutionFrame::execute;
+            m_jobs[i].frame = this;
+            m_jobs[i].instruction = i;
+        }
+    }
+}
+
+void Methan::ExecutionFrame::invoke(const CompiledInstruction& instruction, ThreadPool& pool)
+{
+    instruction.kernel(*m_graph, instruction, m_values.data(), pool);
+
+    // A custom operation may return a view of its inputs, whose storage is reused later
+    Tensor& output = m_values[instruction.output];
+    if(m_slab != nullptr && instruction.offset == MemoryPlan::Unplanned && output.buffer() == m_slab) output = output.clone();
+}
+
+void Methan::ExecutionFrame::release()
+{
+    for(NodeIndex node : m_graph->m_finalReleases) m_values[node] = Tensor();
+}
+
+void Methan::ExecutionFrame::fail(std::exception_ptr exception)
+{
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    if(!m_error) m_error = exception;
+    m_cancelled.store(true, std::memory_order_relaxed);
+}
+
+void Methan::ExecutionFrame::execute(Job* job)
+{
+    InstructionJob* current = static_cast<InstructionJob*>(job);
+    ExecutionFrame& frame = *current->frame;
+    const CompiledGraph& graph = *frame.m_graph;
+
+    while(current != nullptr)
+    {
+        const CompiledInstruction& instruction = graph.m_instructions[current->instruction];
+        if(!frame.m_cancelled.load(std::memory_order_relaxed))
+        {
+            try
+            {
+                frame.invoke(instruction, *frame.m_pool);
+            }
+            catch(...)
+            {
+                frame.fail(__current_exception());
+            }
+        }
+
+        // Continue with the first consumer that becomes ready, publish the others for the thieves
+        InstructionJob* next = nullptr;
+        for(uint32_t i = 0; i < instruction.consumerCount; ++i)
+        {
+            const uint32_t consumer = graph.m_consumers[instruction.firstConsumer + i];
+            if(frame.m_pending[consumer].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                if(next != nullptr) frame.m_pool->submit(next);
+                next = &frame.m_jobs[consumer];
+            }
+        }
+
+        frame.m_group.done();
+        current = next;
+    }
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/execution/memory_plan.hpp>
+#include <methan/core/execution/thread_pool.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/tensor/tensor.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    class CompiledGraph;
+    class ExecutionFrame;
+
+    /**
+     * @brief Options of CompiledGraph::compile
+     */
+    struct CompileOptions
+    {
+        /**
+         * @brief Execute the independent nodes concurrently. The tensors of the nodes are then allocated by
+         * the nodes themselves, as the memory plan requires a sequential execution.
+         */
+        bool concurrent = false;
+    };
+
+    /**
+     * @brief Instruction of a CompiledGraph, the execution of a node with everything resolved at compile
+     * time: the kernel, the payload, the slots of the operands and the place of the result.
+     */
+    struct CompiledInstruction
+    {
+        /**
+         * @brief Compute the result of the instruction, `values` are the tensors of the slots of the run
+         */
+        typedef void (*Kernel)(const CompiledGraph& graph, const CompiledInstruction& instruction, Tensor* values, ThreadPool& pool);
+
+        Kernel kernel;
+
+        /**
+         * @brief Slot of the result, each compiled node has its own slot
+         */
+        NodeIndex output;
+
+        /**
+         * @brief Range of the slots of the operands in the operand table of the graph
+         */
+        uint32_t firstOperand;
+        uint32_t operandCount;
+
+        /**
+         * @brief Range of the slots released after the instruction (sequential execution) in the release
+         * table of the graph
+         */
+        uint32_t firstRelease;
+        uint32_t releaseCount;
+
+        /**
+         * @brief Range of the instructions consuming the result (concurrent execution) in the consumer table
+         * of the graph, and number of instructions producing the operands
+         */
+        uint32_t firstConsumer;
+        uint32_t consumerCount;
+        uint32_t dependencyCount;
+
+        /**
+         * @brief Offset of the result in the slab, `MemoryPlan::Unplanned` if the kernel allocates it
+         */
+        size_t offset;
+
+        /**
+         * @brief Whether every operand has the shape of the result, the elementwise kernels then work on the
+         * raw buffers when the operands are contiguous
+         */
+        bool sameShapes;
+
+        // Parameters of the operation, the programs and the custom operations are stored by the graph (see
+        // CompiledGraph::program and CompiledGraph::customOperation)
+        ElementwisePayload elementwise;
+        MatMulPayload matmul;
+        uint32_t extra;
+        uint32_t extraCount;
+    };
+
+    /**
+     * @brief Immutable form of a graph specialized for the types and shapes of its inputs, made to be executed
+     * many times with little overhead (see Methan::compile). The nodes are lowered to a flat array of
+     * CompiledInstruction in execution order; a run walks this array instead of the graph, without checking
+     * the payloads nor allocating the tensors placed in the slab of the memory plan.
+     *
+     * The inputs and outputs are given by position, in the order of the compilation. A CompiledGraph may be
+     * run concurrently by several threads, each with its own ExecutionFrame.
+     */
+    class CompiledGraph
+    {
+    public:
+        METHAN_DISABLE_COPY(CompiledGraph);
+
+        CompiledGraph(CompiledGraph&&) = default;
+        CompiledGraph& operator=(CompiledGraph&&) = default;
+
+        /**
+         * @brief Compile the graph for inputs of the types and shapes of the given tensors (their values are
+         * not used), computing the given outputs. The graph is expected to be optimised beforehand (see
+         * foldConstants, eliminateCommonSubexpressions and fuseElementwise); the nodes that do not contribute
+         * to the outputs are not compiled.
+         *
+         * The payloads are checked once, an `IllegalArgument` exception is raised for an invalid node or an
+         * unbound `Input` node. Unless the execution is concurrent, the intermediate tensors are placed in a
+         * slab (see planMemory) and the nodes are executed in the order of the plan.
+         */
+        METHAN_API static CompiledGraph compile(const Graph& graph, Span<const InputBinding> inputs, Span<const NodeHandle> outputs, const CompileOptions& options = CompileOptions());
+
+        /**
+         * @brief Execute the graph on the given inputs and write the outputs. The inputs must have the types
+         * and shapes the graph was compiled for, the frame must have been created for this graph and must not
+         * be used by another run at the same time. The first exception raised by a node is rethrown as with
+         * Executor::run, the exceptions that are not a `Methan::Exception` are wrapped into an `ExecutionError`.
+         */
+        METHAN_API void run(Span<const Tensor> inputs, Span<Tensor> outputs, ExecutionFrame& frame, ThreadPool& pool = ThreadPool::global()) const;
+
+        /**
+         * @brief Same as above with a temporary frame, return the outputs
+         */
+        METHAN_API std::vector<Tensor> run(Span<const Tensor> inputs, ThreadPool& pool = ThreadPool::global()) const;
+
+        inline std::vector<Tensor> run(std::initializer_list<Tensor> inputs, ThreadPool& pool = ThreadPool::global()) const
+        {
+            return run(Span<const Tensor>(inputs.begin(), inputs.size()), pool);
+        }
+
+        inline Span<const CompiledInstruction> instructions() const noexcept
+        {
+            return Span<const CompiledInstruction>(m_instructions.data(), m_instructions.size());
+        }
+
+        /**
+         * @brief Slots of the operands of an instruction
+         */
+        inline Span<const NodeIndex> operands(const CompiledInstruction& instruction) const noexcept
+        {
+            return Span<const NodeIndex>(m_operands.data() + instruction.firstOperand, instruction.operandCount);
+        }
+
+        /**
+         * @brief Program of a `FusedElementwise` instruction
+         */
+        inline Span<const ElementwiseInstruction> program(const CompiledInstruction& instruction) const
+        {
+            METHAN_ASSERT_INDEX(instruction.extra + instruction.extraCount - 1, m_programs.size());
+            return Span<const ElementwiseInstruction>(m_programs.data() + instruction.extra, instruction.extraCount);
+        }
+
+        /**
+         * @brief Operation of a `Custom` instruction
+         */
+        inline const CustomOperation& customOperation(const CompiledInstruction& instruction) const
+        {
+            METHAN_ASSERT_INDEX(instruction.extra, m_customs.size());
+            return m_customs[instruction.extra];
+        }
+
+        inline const MemoryPlan& memoryPlan() const noexcept
+        {
+            return m_plan;
+        }
+
+        inline bool isConcurrent() const noexcept
+        {
+            return m_concurrent;
+        }
+
+        inline size_t inputCount() const noexcept
+        {
+            return m_inputs.size();
+        }
+
+        inline size_t outputCount() const noexcept
+        {
+            return m_outputs.size();
+        }
+
+    private:
+        friend class ExecutionFrame;
+
+        CompiledGraph() = default;
+
+        std::vector<CompiledInstruction> m_instructions;
+        std::vector<uint32_t> m_roots;
+
+        // Tables referenced by the instructions
+        std::vector<NodeIndex> m_operands;
+        std::vector<NodeIndex> m_releases;
+        std::vector<uint32_t> m_consumers;
+        std::vector<ElementwiseInstruction> m_programs;
+        std::vector<CustomOperation> m_customs;
+
+        // Slots of the inputs (`Graph::InvalidIndex` for those the outputs do not depend on) and of the outputs,
+        // by position, and the slots released at the end of a run
+        std::vector<NodeIndex> m_inputs;
+        std::vector<TensorSpec> m_inputSpecs;
+        std::vector<NodeIndex> m_outputs;
+        std::vector<NodeIndex> m_finalReleases;
+
+        // Tensors of the `Constant` nodes, by slot
+        std::vector<std::pair<NodeIndex, Tensor>> m_constants;
+
+        MemoryPlan m_plan;
+        bool m_concurrent = false;
+    };
+
+    /**
+     * @brief Storage of the runs of a CompiledGraph: the slab, the tensors of the nodes and the counters of the
+     * concurrent execution. Reusing a frame across runs avoids every allocation but those of the tensors
+     * that are not planned.
+     */
+    class ExecutionFrame
+    {
+    public:
+        METHAN_API explicit ExecutionFrame(const CompiledGraph& graph);
+
+        METHAN_DISABLE_COPY_MOVE(ExecutionFrame);
+
+        inline const CompiledGraph& graph() const noexcept
+        {
+            return *m_graph;
+        }
+
+    private:
+        friend class CompiledGraph;
+
+        struct InstructionJob : public Job
+        {
+            ExecutionFrame* frame;
+            uint32_t instruction;
+        };
+
+        void invoke(const CompiledInstruction& instruction, ThreadPool& pool);
+        void release();
+        void fail(std::exception_ptr exception);
+        static void execute(Job* job);
+
+        const CompiledGraph* m_graph;
+        std::shared_ptr<Buffer> m_slab;
+        std::vector<Tensor> m_values;
+
+        // Concurrent execution
+        ThreadPool* m_pool;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_pending;
+        std::vector<InstructionJob> m_jobs;
+        WaitGroup m_group;
+        std::atomic<bool> m_cancelled;
+        std::mutex m_errorMutex;
+        std::exception_ptr m_error;
+    };
+
+    /**
+     * @brief Compile the graph for repeated executions, see CompiledGraph::compile
+     */
+    inline CompiledGraph compile(const Graph& graph, Span<const InputBinding> inputs, Span<const NodeHandle> outputs, const CompileOptions& options = CompileOptions())
+    {
+        return CompiledGraph::compile(graph, inputs, outputs, options);
+    }
+
+    inline CompiledGraph compile(const Graph& graph, std::initializer_list<InputBinding> inputs, std::initializer_list<NodeHandle> outputs, const CompileOptions& options = CompileOptions())
+    {
+        return CompiledGraph::compile(graph, Span<const InputBinding>(inputs.begin(), inputs.size()), Span<const NodeHandle>(outputs.begin(), outputs.size()), options);
+    }
+
+}
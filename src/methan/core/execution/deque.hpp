@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/utility/assertion.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Chase-Lev work-stealing deque (using the memory orderings of Lê et al., "Correct and Efficient
+     * Work-Stealing for Weak Memory Models"). A single owner thread pushes and pops at the bottom while any
+     * number of thieves steal from the top. The ring grows when full; retired rings are kept alive until
+     * the deque is destroyed since a thief may still be reading them.
+     *
+     * @tparam T a trivially copyable type (typically a pointer)
+     */
+    template<typename T>
+    class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "The elements of a WorkStealingDeque must be trivially copyable");
+
+        struct Ring
+        {
+            explicit Ring(int64_t capacity)
+            : mask(capacity - 1),
+            slots(new std::atomic<T>[static_cast<size_t>(capacity)])
+            {}
+
+            inline T load(int64_t index) const noexcept
+            {
+                return slots[index & mask].load(std::memory_order_relaxed);
+            }
+
+            inline void store(int64_t index, T value) noexcept
+            {
+                slots[index & mask].store(value, std::memory_order_relaxed);
+            }
+
+            inline int64_t capacity() const noexcept
+            {
+                return mask + 1;
+            }
+
+            int64_t mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+        };
+
+    public:
+        explicit WorkStealingDeque(int64_t capacity = 256)
+        : m_top(0),
+        m_bottom(0)
+        {
+            METHAN_FORCE_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0, Methan::ExceptionType::IllegalArgument, "The capacity of the deque must be a power of two");
+            m_rings.emplace_back(new Ring(capacity));
+            m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+        }
+
+        METHAN_DISABLE_COPY_MOVE(WorkStealingDeque);
+
+        /**
+         * @brief Push an element at the bottom of the deque (owner only)
+         */
+        inline void push(T value)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const int64_t top = m_top.load(std::memory_order_acquire);
+            Ring* ring = m_ring.load(std::memory_order_relaxed);
+
+            if(bottom - top > ring->capacity() - 1) ring = __grow(ring, top, bottom);
+
+            ring->store(bottom, value);
+            m_bottom.store(bottom + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Pop an element from the bottom of the deque (owner only)
+         *
+         * @return bool false if the deque was empty
+         */
+        inline bool pop(T& value)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            Ring* ring = m_ring.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+
+            if(top > bottom)
+            {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            value = ring->load(bottom);
+            if(top == bottom)
+            {
+                // Last element, race against the thieves
+                const bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return won;
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Steal an element from the top of the deque (any thread)
+         *
+         * @return bool false if the deque was empty or if the steal lost a race
+         */
+        inline bool steal(T& value)
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+            if(top >= bottom) return false;
+
+            Ring* ring = m_ring.load(std::memory_order_acquire);
+            value = ring->load(top);
+            return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Approximation of the number of elements in the deque
+         */
+        inline int64_t size() const noexcept
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const int64_t top = m_top.load(std::memory_order_relaxed);
+            return bottom > top ? bottom - top : 0;
+        }
+
+        inline bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+    private:
+        Ring* __grow(Ring* ring, int64_t top, int64_t bottom)
+        {
+            Ring* bigger = new Ring(ring->capacity() * 2);
+            for(int64_t i = top; i < bottom; ++i) bigger->store(i, ring->load(i));
+
+            m_rings.emplace_back(bigger);
+            m_ring.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<int64_t> m_top;
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom;
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<Ring*> m_ring;
+        std::vector<std::unique_ptr<Ring>> m_rings;
+    };
+
+}
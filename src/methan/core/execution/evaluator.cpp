@@ -0,0 +1,298 @@
+#include <algorithm>
+
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/kernels/gemm.hpp>
+#include <methan/core/profiler.hpp>
+
+namespace {
+
+    struct MatMulOperands
+    {
+        Methan::Tensor a, b;
+        double alpha;
+    };
+
+    MatMulOperands __matmul_operands(const Methan::Graph& graph, Methan::NodeHandle node, Methan::Span<const Methan::Tensor> inputs)
+    {
+        const Methan::Varient& payload = graph.payload(node);
+        METHAN_FORCE_ASSERT(inputs.size() == 2, Methan::ExceptionType::IllegalArgument, "A MatMul node expects 2 inputs, got " + std::to_string(inputs.size()));
+        METHAN_FORCE_ASSERT(payload.isEmpty() || payload.is<Methan::MatMulPayload>(), Methan::ExceptionType::IllegalArgument, "The payload of a MatMul node must be a MatMulPayload");
+        const Methan::MatMulPayload operation = payload.isEmpty() ? Methan::MatMulPayload() : payload.get<Methan::MatMulPayload>();
+
+        MatMulOperands operands;
+        operands.a = operation.transposeA ? inputs[0].transpose(0, 1) : inputs[0];
+        operands.b = operation.transposeB ? inputs[1].transpose(0, 1) : inputs[1];
+        operands.alpha = operation.alpha;
+        METHAN_FORCE_ASSERT(operands.a.rank() == 2 && operands.b.rank() == 2, Methan::ExceptionType::IllegalArgument, "Matrix multiplication expects tensors of rank 2");
+        return operands;
+    }
+
+    /**
+     * @brief Compute the tensor of a planned node into its place in the slab
+     */
+    void __evaluate_into(const Methan::Graph& graph, Methan::NodeHandle node, Methan::Span<const Methan::Tensor> inputs, Methan::Tensor& output, Methan::ThreadPool& pool)
+    {
+        const Methan::Varient& payload = graph.payload(node);
+
+        switch(graph.op(node))
+        {
+        case Methan::OpCode::Elementwise:
+        {
+            METHAN_FORCE_ASSERT(payload.is<Methan::ElementwisePayload>(), Methan::ExceptionType::IllegalArgument, "The payload of an Elementwise node must be an ElementwisePayload");
+            const Methan::ElementwisePayload& operation = payload.get<Methan::ElementwisePayload>();
+            Methan::elementwise(operation.op, inputs, output, operation.params);
+            return;
+        }
+
+        case Methan::OpCode::FusedElementwise:
+        {
+            METHAN_FORCE_ASSERT(payload.is<Methan::FusedElementwisePayload>(), Methan::ExceptionType::IllegalArgument, "The payload of a FusedElementwise node must be a FusedElementwisePayload");
+            const std::vector<Methan::ElementwiseInstruction>& program = payload.get<Methan::FusedElementwisePayload>().program;
+            Methan::elementwise(Methan::Span<const Methan::ElementwiseInstruction>(program.data(), program.size()), inputs, output);
+            return;
+        }
+
+        case Methan::OpCode::MatMul:
+        {
+            const MatMulOperands operands = __matmul_operands(graph, node, inputs);
+            Methan::matmul(operands.a, operands.b, output, operands.alpha, 0.0, pool);
+            return;
+        }
+
+        default:
+            break;
+        }
+
+        METHAN_THROW_EXCEPTION("The node " + std::to_string(Methan::Graph::index(node)) + " cannot be planned", Methan::ExceptionType::IllegalArgument);
+    }
+
+}
+
+METHAN_API Methan::Evaluator::Evaluator(ThreadPool& pool, SchedulePolicy policy)
+: m_executor(pool, policy)
+{}
+
+METHAN_API std::vector<Methan::Tensor> Methan::Evaluator::run(const Graph& graph, Span<const InputBinding> inputs, Span<const NodeHandle> outputs)
+{
+    for(size_t i = 0; i < outputs.size(); ++i) METHAN_FORCE_ASSERT(graph.contains(outputs[i]), Methan::ExceptionType::IllegalArgument, "The requested output is not a node of the graph");
+
+    std::vector<Tensor> values(graph.nodeCount());
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(graph.contains(inputs[i].node) && graph.op(inputs[i].node) == OpCode::Input, Methan::ExceptionType::IllegalArgument, "Tensors can only be bound to the Input nodes of the graph");
+        values[Graph::index(inputs[i].node)] = inputs[i].tensor;
+    }
+
+    ThreadPool& pool = m_executor.pool();
+    m_executor.run(graph, [&](NodeHandle node) {
+        const NodeIndex index = Graph::index(node);
+        if(graph.op(node) == OpCode::Input)
+        {
+            METHAN_FORCE_ASSERT(!values[index].isEmpty(), Methan::ExceptionType::IllegalArgument, "The Input node " + std::to_string(index) + " is not bound to a tensor");
+            return;
+        }
+
+        // The inputs are done (and never written again) before the node is executed
+        const Span<const NodeIndex> predecessors = graph.inputs(node);
+        std::vector<Tensor> operands;
+        operands.reserve(predecessors.size());
+        for(size_t i = 0; i < predecessors.size(); ++i) operands.push_back(values[predecessors[i]]);
+
+        values[index] = evaluateNode(graph, node, Span<const Tensor>(operands.data(), operands.size()), pool);
+    });
+
+    std::vector<Tensor> results;
+    results.reserve(outputs.size());
+    for(size_t i = 0; i < outputs.size(); ++i) results.push_back(values[Graph::index(outputs[i])]);
+    return results;
+}
+
+METHAN_API std::vector<Methan::Tensor> Methan::Evaluator::run(const Graph& graph, Span<const InputBinding> inputs, Span<const NodeHandle> outputs, const MemoryPlan& plan)
+{
+    METHAN_FORCE_ASSERT(plan.offsets.size() == graph.nodeCount() && plan.order.size() == graph.nodeCount(), Methan::ExceptionType::IllegalArgument, "The memory plan was not made for this graph");
+    for(size_t i = 0; i < outputs.size(); ++i) METHAN_FORCE_ASSERT(graph.contains(outputs[i]) && !plan.isPlanned(outputs[i]), Methan::ExceptionType::IllegalArgument, "The requested output is not an output of the memory plan");
+
+    std::vector<Tensor> values(graph.nodeCount());
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(graph.contains(inputs[i].node) && graph.op(inputs[i].node) == OpCode::Input, Methan::ExceptionType::IllegalArgument, "Tensors can only be bound to the Input nodes of the graph");
+        const NodeIndex index = Graph::index(inputs[i].node);
+        const TensorSpec& spec = plan.specs[index];
+        METHAN_FORCE_ASSERT(!spec.known || (spec.dtype == inputs[i].tensor.dtype() && spec.shape == inputs[i].tensor.shape()), Methan::ExceptionType::IllegalArgument, "The tensor bound to the Input node " + std::to_string(index) + " does not match the memory plan");
+        values[index] = inputs[i].tensor;
+    }
+
+    // The tensors that are not planned are released after their last use, unless they are requested
+    std::vector<size_t> remaining(graph.nodeCount());
+    for(NodeIndex i = 0; i < graph.nodeCount(); ++i) remaining[i] = graph.outDegree(Graph::handle(i));
+    for(size_t i = 0; i < outputs.size(); ++i) remaining[Graph::index(outputs[i])] = ~size_t(0);
+
+    const std::shared_ptr<Buffer> slab = std::make_shared<Buffer>(plan.slabSize);
+    ThreadPool& pool = m_executor.pool();
+    std::vector<Tensor> operands;
+    for(NodeIndex index : plan.order)
+    {
+        const NodeHandle node = Graph::handle(index);
+        if(graph.op(node) == OpCode::Input)
+        {
+            METHAN_FORCE_ASSERT(!values[index].isEmpty(), Methan::ExceptionType::IllegalArgument, "The Input node " + std::to_string(index) + " is not bound to a tensor");
+            continue;
+        }
+
+        const Span<const NodeIndex> predecessors = graph.inputs(node);
+        operands.clear();
+        for(size_t i = 0; i < predecessors.size(); ++i) operands.push_back(values[predecessors[i]]);
+        const Span<const Tensor> arguments(operands.data(), operands.size());
+
+        if(plan.offsets[index] != MemoryPlan::Unplanned)
+        {
+            const TensorSpec& spec = plan.specs[index];
+            Tensor output(slab, plan.offsets[index], spec.dtype, spec.shape);
+            __evaluate_into(graph, node, arguments, output, pool);
+            values[index] = std::move(output);
+        }
+        else
+        {
+            // A custom operation may return a view of its inputs, whose storage is reused later
+            values[index] = evaluateNode(graph, node, arguments, pool);
+            if(values[index].buffer() == slab) values[index] = values[index].clone();
+        }
+
+        for(NodeIndex predecessor : predecessors)
+        {
+            if(--remaining[predecessor] == 0) values[predecessor] = Tensor();
+        }
+    }
+
+    std::vector<Tensor> results;
+    results.reserve(outputs.size());
+    for(size_t i = 0; i < outputs.size(); ++i) results.push_back(values[Graph::index(outputs[i])]);
+    return results;
+}
+
+METHAN_API std::vector<Methan::TensorSpec> Methan::Evaluator::inferSpecs(const Graph& graph, Span<const InputBinding> inputs)
+{
+    std::vector<TensorSpec> specs(graph.nodeCount());
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(graph.contains(inputs[i].node), Methan::ExceptionType::IllegalArgument, "Tensors can only be bound to the Input nodes of the graph");
+        specs[Graph::index(inputs[i].node)] = { true, inputs[i].tensor.dtype(), inputs[i].tensor.shape() };
+    }
+
+    std::vector<Shape> shapes;
+    for(NodeIndex index : graph.topologicalOrder())
+    {
+        const NodeHandle node = Graph::handle(index);
+        const Span<const NodeIndex> predecessors = graph.inputs(node);
+        const Varient& payload = graph.payload(node);
+        TensorSpec& spec = specs[index];
+
+        // Nodes with unknown inputs or an invalid payload stay unknown, their evaluation reports the errors
+        const bool ready = std::all_of(predecessors.begin(), predecessors.end(), [&](NodeIndex input) {
+            return specs[input].known && specs[input].dtype == specs[predecessors[0]].dtype;
+        });
+        if(!ready || graph.op(node) == OpCode::Input) continue;
+
+        switch(graph.op(node))
+        {
+        case OpCode::Constant:
+            if(payload.is<Tensor>()) spec = { true, payload.get<Tensor>().dtype(), payload.get<Tensor>().shape() };
+            break;
+
+        case OpCode::Elementwise:
+        {
+            if(!payload.is<ElementwisePayload>() || predecessors.size() != arity(payload.get<ElementwisePayload>().op)) break;
+            shapes.clear();
+            for(NodeIndex input : predecessors) shapes.push_back(specs[input].shape);
+            spec = { true, specs[predecessors[0]].dtype, broadcastShape(Span<const Shape>(shapes.data(), shapes.size())) };
+            break;
+        }
+
+        case OpCode::FusedElementwise:
+        {
+            if(!payload.is<FusedElementwisePayload>() || predecessors.empty()) break;
+            const std::vector<ElementwiseInstruction>& program = payload.get<FusedElementwisePayload>().program;
+            shapes.clear();
+            for(NodeIndex input : predecessors) shapes.push_back(specs[input].shape);
+
+            bool valid = !program.empty();
+            for(size_t j = 0; valid && j < program.size(); ++j)
+            {
+                Shape operands[3];
+                for(size_t o = 0; o < arity(program[j].op); ++o)
+                {
+                    valid = valid && program[j].operands[o] < shapes.size();
+                    if(valid) operands[o] = shapes[program[j].operands[o]];
+                }
+                if(valid) shapes.push_back(broadcastShape(Span<const Shape>(operands, arity(program[j].op))));
+            }
+            if(valid) spec = { true, specs[predecessors[0]].dtype, shapes.back() };
+            break;
+        }
+
+        case OpCode::MatMul:
+        {
+            if(predecessors.size() != 2 || !(payload.isEmpty() || payload.is<MatMulPayload>())) break;
+            const MatMulPayload operation = payload.isEmpty() ? MatMulPayload() : payload.get<MatMulPayload>();
+            const Shape& a = specs[predecessors[0]].shape;
+            const Shape& b = specs[predecessors[1]].shape;
+            if(a.rank() != 2 || b.rank() != 2) break;
+            spec = { true, specs[predecessors[0]].dtype, { a[operation.transposeA ? 1 : 0], b[operation.transposeB ? 0 : 1] } };
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+    return specs;
+}
+
+METHAN_API Methan::Tensor Methan::Evaluator::evaluateNode(const Graph& graph, NodeHandle node, Span<const Tensor> inputs, ThreadPool& pool)
+{
+    const Varient& payload = graph.payload(node);
+
+    switch(graph.op(node))
+    {
+    case OpCode::Input:
+        break;
+
+    case OpCode::Constant:
+        METHAN_FORCE_ASSERT(payload.is<Tensor>(), Methan::ExceptionType::IllegalArgument, "The payload of a Constant node must be a Tensor");
+        return payload.get<Tensor>();
+
+    case OpCode::Custom:
+    {
+        METHAN_PROFILE_NODE("Custom", Graph::index(node));
+        METHAN_FORCE_ASSERT(payload.is<CustomOperation>(), Methan::ExceptionType::IllegalArgument, "The payload of a Custom node must be a CustomOperation");
+        return payload.get<CustomOperation>()(inputs);
+    }
+
+    case OpCode::Elementwise:
+    {
+        METHAN_PROFILE_NODE("Elementwise", Graph::index(node));
+        METHAN_FORCE_ASSERT(payload.is<ElementwisePayload>(), Methan::ExceptionType::IllegalArgument, "The payload of an Elementwise node must be an ElementwisePayload");
+        const ElementwisePayload& operation = payload.get<ElementwisePayload>();
+        return elementwise(operation.op, inputs, operation.params);
+    }
+
+    case OpCode::FusedElementwise:
+    {
+        METHAN_PROFILE_NODE("FusedElementwise", Graph::index(node));
+        METHAN_FORCE_ASSERT(payload.is<FusedElementwisePayload>(), Methan::ExceptionType::IllegalArgument, "The payload of a FusedElementwise node must be a FusedElementwisePayload");
+        const std::vector<ElementwiseInstruction>& program = payload.get<FusedElementwisePayload>().program;
+        return elementwise(Span<const ElementwiseInstruction>(program.data(), program.size()), inputs);
+    }
+
+    case OpCode::MatMul:
+    {
+        METHAN_PROFILE_NODE("MatMul", Graph::index(node));
+        const MatMulOperands operands = __matmul_operands(graph, node, inputs);
+        Tensor c(operands.a.dtype(), { operands.a.dim(0), operands.b.dim(1) });
+        matmul(operands.a, operands.b, c, operands.alpha, 0.0, pool);
+        return c;
+    }
+    }
+
+    METHAN_THROW_EXCEPTION("The node " + std::to_string(Graph::index(node)) + " cannot be evaluated", Methan::ExceptionType::IllegalArgument);
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/executor.hpp>
+#include <methan/core/execution/memory_plan.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/kernels/elementwise.hpp>
+#include <methan/core/tensor/tensor.hpp>
+#include <methan/utility/hash.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Payload of the `Elementwise` nodes
+     */
+    struct ElementwisePayload
+    {
+        ElementwiseOp op;
+        ElementwiseParams params;
+    };
+
+    inline bool operator==(const ElementwisePayload& first, const ElementwisePayload& second) noexcept
+    {
+        return first.op == second.op && first.params == second.params;
+    }
+
+    /**
+     * @brief Payload of the `FusedElementwise` nodes, the program is evaluated on the inputs of the node
+     * (see Methan::elementwise)
+     */
+    struct FusedElementwisePayload
+    {
+        std::vector<ElementwiseInstruction> program;
+    };
+
+    inline bool operator==(const FusedElementwisePayload& first, const FusedElementwisePayload& second) noexcept
+    {
+        return first.program == second.program;
+    }
+
+    /**
+     * @brief Payload of the `MatMul` nodes, alpha * op(A) * op(B) where op transposes the operand if
+     * requested. A node without payload computes the plain product.
+     */
+    struct MatMulPayload
+    {
+        double alpha = 1.0;
+        bool transposeA = false;
+        bool transposeB = false;
+    };
+
+    inline bool operator==(const MatMulPayload& first, const MatMulPayload& second) noexcept
+    {
+        return first.alpha == second.alpha && first.transposeA == second.transposeA && first.transposeB == second.transposeB;
+    }
+
+    /**
+     * @brief Payload of the `Custom` nodes, compute the result of the node from the tensors of its inputs
+     */
+    typedef std::function<Tensor(Span<const Tensor>)> CustomOperation;
+
+    /**
+     * @brief Tensor bound to an `Input` node for an evaluation
+     */
+    struct InputBinding
+    {
+        NodeHandle node;
+        Tensor tensor;
+    };
+
+    /**
+     * @brief Evaluate graphs of tensor operations on a ThreadPool. Every node computes a Tensor from the
+     * tensors of its inputs (in the order of the edges):
+     *
+     * - `Input`: the tensor bound to the node
+     * - `Constant`: the Tensor of the payload
+     * - `Custom`: the result of the CustomOperation of the payload
+     * - `Elementwise`: Methan::elementwise with the ElementwisePayload
+     * - `MatMul`: Methan::matmul of the two inputs with the (optional) MatMulPayload
+     * - `FusedElementwise`: the program of the FusedElementwisePayload
+     *
+     * Independent nodes are executed concurrently by the Executor, the kernels of a node (such as the
+     * matrix multiply) are themselves parallelized over the same pool.
+     */
+    class Evaluator
+    {
+    public:
+        METHAN_API explicit Evaluator(ThreadPool& pool = ThreadPool::global(), SchedulePolicy policy = SchedulePolicy::WorkStealing);
+
+        /**
+         * @brief Evaluate the graph and return the tensors of the `outputs` nodes (in the same order). Every
+         * `Input` node of the graph must be bound. An exception raised by a node is rethrown (see Executor::run).
+         */
+        METHAN_API std::vector<Tensor> run(const Graph& graph, Span<const InputBinding> inputs, Span<const NodeHandle> outputs);
+
+        inline std::vector<Tensor> run(const Graph& graph, std::initializer_list<InputBinding> inputs, std::initializer_list<NodeHandle> outputs)
+        {
+            return run(graph, Span<const InputBinding>(inputs.begin(), inputs.size()), Span<const NodeHandle>(outputs.begin(), outputs.size()));
+        }
+
+        /**
+         * @brief Evaluate the graph with a memory plan made for the types and shapes of the given inputs (see
+         * planMemory and inferSpecs). The nodes are executed one at a time in the order of the plan, their
+         * kernels are still parallelized over the pool, and the planned tensors live in a single slab
+         * allocated for the run. The tensors of the other nodes are released after their last use.
+         */
+        METHAN_API std::vector<Tensor> run(const Graph& graph, Span<const InputBinding> inputs, Span<const NodeHandle> outputs, const MemoryPlan& plan);
+
+        inline std::vector<Tensor> run(const Graph& graph, std::initializer_list<InputBinding> inputs, std::initializer_list<NodeHandle> outputs, const MemoryPlan& plan)
+        {
+            return run(graph, Span<const InputBinding>(inputs.begin(), inputs.size()), Span<const NodeHandle>(outputs.begin(), outputs.size()), plan);
+        }
+
+        /**
+         * @brief Type and shape of the tensor of every node of the graph for the given inputs, as far as they
+         * can be known without evaluating it (the results of `Custom` nodes are not)
+         */
+        METHAN_API static std::vector<TensorSpec> inferSpecs(const Graph& graph, Span<const InputBinding> inputs);
+
+        inline static std::vector<TensorSpec> inferSpecs(const Graph& graph, std::initializer_list<InputBinding> inputs)
+        {
+            return inferSpecs(graph, Span<const InputBinding>(inputs.begin(), inputs.size()));
+        }
+
+        /**
+         * @brief Compute the tensor of a node (other than `Input`) from the tensors of its inputs
+         */
+        METHAN_API static Tensor evaluateNode(const Graph& graph, NodeHandle node, Span<const Tensor> inputs, ThreadPool& pool = ThreadPool::global());
+
+        inline Executor& executor() noexcept
+        {
+            return m_executor;
+        }
+
+    private:
+        Executor m_executor;
+    };
+
+}
+
+namespace std {
+
+    template<>
+    struct hash<Methan::ElementwisePayload>
+    {
+        inline size_t operator()(const Methan::ElementwisePayload& payload) const noexcept
+        {
+            return Methan::hash_values(0, payload.op, payload.params);
+        }
+    };
+
+    template<>
+    struct hash<Methan::FusedElementwisePayload>
+    {
+        inline size_t operator()(const Methan::FusedElementwisePayload& payload) const noexcept
+        {
+            size_t seed = payload.program.size();
+            for(const Methan::ElementwiseInstruction& instruction : payload.program) seed = Methan::hash_values(seed, instruction);
+            return seed;
+        }
+    };
+
+    template<>
+    struct hash<Methan::MatMulPayload>
+    {
+        inline size_t operator()(const Methan::MatMulPayload& payload) const noexcept
+        {
+            return Methan::hash_values(0, payload.alpha, payload.transposeA, payload.transposeB);
+        }
+    };
+
+}
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <methan/core/execution/executor.hpp>
+#include <methan/core/log.hpp>
+#include <methan/core/profiler.hpp>
+#include <methan/utility/arena.hpp>
+#include <methan/utility/exception.hpp>
+
+namespace {
+
+    struct GraphRun;
+
+    struct NodeJob : public Methan::Job
+    {
+        GraphRun* run;
+        Methan::NodeIndex node;
+    };
+
+    struct SeedJob : public Methan::Job
+    {
+        GraphRun* run;
+        size_t begin;
+        size_t end;
+    };
+
+    /**
+     * @brief Nodes of a run that are ready to be executed, ordered by the schedule policy. Every node is
+     * pushed exactly once, so the set lives in a buffer of one slot per node allocated up front: FIFO pops
+     * at the head, LIFO at the tail and the critical path policy keeps the slots in use as a heap.
+     */
+    class ReadySet
+    {
+    public:
+        explicit ReadySet(std::pmr::memory_resource* resource)
+        : m_nodes(resource)
+        {}
+
+        void reset(Methan::SchedulePolicy policy, size_t nodeCount, std::vector<double> priorities)
+        {
+            m_policy = policy;
+            m_priorities = std::move(priorities);
+            m_nodes.resize(nodeCount);
+            m_head = 0;
+            m_tail = 0;
+        }
+
+        void push(Methan::NodeIndex node)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_nodes[m_tail++] = node;
+            if(m_policy == Methan::SchedulePolicy::CriticalPath) std::push_heap(m_nodes.begin(), m_nodes.begin() + m_tail, Compare { &m_priorities });
+        }
+
+        Methan::NodeIndex pop()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            switch(m_policy)
+            {
+            case Methan::SchedulePolicy::CriticalPath:
+                std::pop_heap(m_nodes.begin(), m_nodes.begin() + m_tail, Compare { &m_priorities });
+                return m_nodes[--m_tail];
+            case Methan::SchedulePolicy::Lifo:
+                return m_nodes[--m_tail];
+            default:
+                return m_nodes[m_head++];
+            }
+        }
+
+    private:
+        struct Compare
+        {
+            const std::vector<double>* priorities;
+
+            // Max-heap on the priority, the oldest node (lowest index) first on ties
+            inline bool operator()(Methan::NodeIndex a, Methan::NodeIndex b) const noexcept
+            {
+                const double pa = (*priorities)[a];
+                const double pb = (*priorities)[b];
+                return pa < pb || (pa == pb && a > b);
+            }
+        };
+
+        Methan::SchedulePolicy m_policy = Methan::SchedulePolicy::Fifo;
+        std::vector<double> m_priorities;
+        std::mutex m_mutex;
+        std::pmr::vector<Methan::NodeIndex> m_nodes;
+        size_t m_head = 0;
+        size_t m_tail = 0;
+    };
+
+    /**
+     * @brief Bookkeeping of a single Executor::run, allocated from the scratch arena of the calling thread
+     */
+    struct GraphRun
+    {
+        GraphRun(size_t nodeCount, std::pmr::memory_resource* resource)
+        : pending(nodeCount, resource),
+        jobs(nodeCount, resource),
+        roots(resource),
+        seeds(resource),
+        ready(resource)
+        {}
+
+        const Methan::Graph* graph;
+        const Methan::Executor::NodeFunction* function;
+        Methan::ThreadPool* pool;
+
+        std::pmr::vector<std::atomic<uint32_t>> pending;
+        std::pmr::vector<NodeJob> jobs;
+        std::pmr::vector<Methan::NodeIndex> roots;
+        std::pmr::vector<SeedJob> seeds;
+        ReadySet ready;
+        Methan::WaitGroup group;
+
+        std::atomic<bool> cancelled;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        void fail(std::exception_ptr exception)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if(!error) error = exception;
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        void invoke(Methan::NodeIndex node)
+        {
+            if(cancelled.load(std::memory_order_relaxed)) return;
+
+            METHAN_PROFILE_NODE("Executor::node", node);
+            try
+            {
+                (*function)(Methan::Graph::handle(node));
+            }
+            catch(const Methan::Exception& e)
+            {
+                METHAN_LOG_DEBUG("The node {} failed: {}", node, e.what());
+                fail(std::current_exception());
+            }
+            catch(const std::exception& e)
+            {
+                METHAN_LOG_DEBUG("The node {} failed: {}", node, e.what());
+                fail(std::make_exception_ptr(Methan::Exception(std::string("A node raised an exception: ") + e.what(), METHAN_EXPAND(__FILE__), METHAN_EXPAND(__LINE__), Methan::ExceptionType::ExecutionError)));
+            }
+            catch(...)
+            {
+                fail(std::make_exception_ptr(Methan::Exception("A node raised an unknown exception", METHAN_EXPAND(__FILE__), METHAN_EXPAND(__LINE__), Methan::ExceptionType::ExecutionError)));
+            }
+        }
+    };
+
+    void __execute_node(Methan::Job* job)
+    {
+        NodeJob* current = static_cast<NodeJob*>(job);
+        GraphRun& run = *current->run;
+
+        while(current != nullptr)
+        {
+            run.invoke(current->node);
+
+            // Continue with the first output that becomes ready, publish the others for the thieves
+            NodeJob* next = nullptr;
+            for(Methan::NodeIndex output : run.graph->outputs(Methan::Graph::handle(current->node)))
+            {
+                if(run.pending[output].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    if(next != nullptr) run.pool->submit(next);
+                    next = &run.jobs[output];
+                }
+            }
+
+            run.group.done();
+            current = next;
+        }
+    }
+
+    void __execute_ordered(Methan::Job* job)
+    {
+        // Jobs are only tokens: one is submitted for each node pushed on the ready set (after the push),
+        // the node actually executed is the best one at the time the job runs
+        GraphRun& run = *static_cast<NodeJob*>(job)->run;
+        const Methan::NodeIndex node = run.ready.pop();
+
+        run.invoke(node);
+
+        for(Methan::NodeIndex output : run.graph->outputs(Methan::Graph::handle(node)))
+        {
+            if(run.pending[output].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                run.ready.push(output);
+                run.pool->submit(&run.jobs[output]);
+            }
+        }
+
+        run.group.done();
+    }
+
+    void __execute_seed(Methan::Job* job)
+    {
+        SeedJob* seed = static_cast<SeedJob*>(job);
+        GraphRun& run = *seed->run;
+
+        for(size_t i = seed->begin; i < seed->end; ++i) run.pool->submit(&run.jobs[run.roots[i]]);
+        run.group.done();
+    }
+
+}
+
+METHAN_API Methan::Executor::Executor(ThreadPool& pool, SchedulePolicy policy)
+: m_pool(&pool),
+m_policy(policy)
+{}
+
+METHAN_API void Methan::Executor::run(const Graph& graph, const NodeFunction& function)
+{
+    METHAN_PROFILE_SCOPE("Executor::run");
+    const size_t nodeCount = graph.nodeCount();
+    if(nodeCount == 0) return;
+
+    // The adjacency is read concurrently by the workers, it must be up-to-date before they start. A cycle
+    // would never complete, raise an exception instead of waiting forever.
+    graph.buildAdjacency();
+    METHAN_FORCE_ASSERT(graph.isAcyclic(), Methan::ExceptionType::IllegalState, "The graph contains a cycle");
+
+    // Everything the run allocates is released at once when the scope is left. Nested runs executed by
+    // this thread while it waits are scoped the same way and are done before this run returns.
+    ArenaScope scope(scratchArena());
+    GraphRun run(nodeCount, &scope.arena());
+    run.graph = &graph;
+    run.function = &function;
+    run.pool = m_pool;
+    run.cancelled.store(false, std::memory_order_relaxed);
+
+    const bool ordered = m_policy != SchedulePolicy::WorkStealing;
+    if(ordered) run.ready.reset(m_policy, nodeCount, m_policy == SchedulePolicy::CriticalPath ? criticalPathLengths(graph) : std::vector<double>());
+
+    for(size_t i = 0; i < nodeCount; ++i)
+    {
+        const NodeIndex node = static_cast<NodeIndex>(i);
+        const size_t inDegree = graph.inDegree(Graph::handle(node));
+        run.pending[i].store(static_cast<uint32_t>(inDegree), std::memory_order_relaxed);
+        run.jobs[i].execute = ordered ? &__execute_ordered : &__execute_node;
+        run.jobs[i].run = &run;
+        run.jobs[i].node = node;
+        if(inDegree == 0)
+        {
+            run.roots.push_back(node);
+            if(ordered) run.ready.push(node);
+        }
+    }
+
+    // The roots are distributed by seed jobs, one per worker, so that each worker fills its own deque
+    // instead of having every root go through the shared injection queue
+    const size_t seedCount = std::min(m_pool->workerCount(), run.roots.size());
+    METHAN_LOG_TRACE("Executor::run: {} nodes, {} roots, {} seeds, policy {}", nodeCount, run.roots.size(), seedCount, m_policy);
+    const size_t rootsPerSeed = (run.roots.size() + seedCount - 1) / seedCount;
+    run.seeds.resize(seedCount);
+    run.group.add(nodeCount + seedCount);
+
+    for(size_t i = 0; i < seedCount; ++i)
+    {
+        run.seeds[i].execute = &__execute_seed;
+        run.seeds[i].run = &run;
+        run.seeds[i].begin = i * rootsPerSeed;
+        run.seeds[i].end = std::min(run.roots.size(), (i + 1) * rootsPerSeed);
+    }
+
+    for(SeedJob& seed : run.seeds) m_pool->submit(&seed);
+    m_pool->wait(run.group);
+
+    if(run.error) std::rethrow_exception(run.error);
+}
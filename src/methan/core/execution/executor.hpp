@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/schedule.hpp>
+#include <methan/core/execution/thread_pool.hpp>
+#include <methan/core/graph/graph.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Execute the nodes of a graph on a ThreadPool, each node being executed as soon as all of its
+     * inputs are done. The order in which ready nodes are dispatched depends on the SchedulePolicy.
+     *
+     * With `WorkStealing`, a node whose execution makes one of its outputs ready continues with that output
+     * directly (without going through its deque), the other ready outputs are pushed on its deque where
+     * idle workers can steal them. The other policies keep the ready nodes of a run in a shared ready set
+     * ordered by the policy, every job submitted to the pool executing the best ready node at the time it
+     * runs.
+     */
+    class Executor
+    {
+    public:
+        typedef std::function<void(NodeHandle)> NodeFunction;
+
+        METHAN_API explicit Executor(ThreadPool& pool = ThreadPool::global(), SchedulePolicy policy = SchedulePolicy::WorkStealing);
+
+        /**
+         * @brief Call `function` once for every node of the graph, in dependency order, and wait for the
+         * whole graph to be executed. Once a node raised an exception the remaining nodes are skipped and
+         * the exception is rethrown to the caller. Exceptions that are not a `Methan::Exception` are
+         * wrapped into an exception of type `ExecutionError`.
+         *
+         * The graph is prepared (adjacency and cycle check) by the call, a graph that is run concurrently
+         * by several threads must be prepared beforehand (see Graph).
+         */
+        METHAN_API void run(const Graph& graph, const NodeFunction& function);
+
+        inline ThreadPool& pool() const noexcept
+        {
+            return *m_pool;
+        }
+
+        inline SchedulePolicy policy() const noexcept
+        {
+            return m_policy;
+        }
+
+        inline void setPolicy(SchedulePolicy policy) noexcept
+        {
+            m_policy = policy;
+        }
+
+    private:
+        ThreadPool* m_pool;
+        SchedulePolicy m_policy;
+    };
+
+}
@@ -0,0 +1,231 @@
+#include <algorithm>
+
+#include <methan/core/execution/incremental.hpp>
+
+namespace {
+
+    /**
+     * @brief Bytes accounted to the cache for the tensor of a node, the inputs belong to the caller and the
+     * constants to the graph
+     */
+    size_t __cached_bytes(const Methan::Graph& graph, Methan::NodeIndex node, const Methan::Tensor& tensor)
+    {
+        const Methan::OpCode op = graph.op(Methan::Graph::handle(node));
+        if(op == Methan::OpCode::Input || op == Methan::OpCode::Constant) return 0;
+        return static_cast<size_t>(tensor.elementCount()) * tensor.elementSize();
+    }
+
+    void __check_node(const Methan::Graph& graph, Methan::NodeHandle node)
+    {
+        METHAN_FORCE_ASSERT(graph.contains(node), Methan::ExceptionType::IllegalArgument, "The node is not a node of the graph");
+        METHAN_FORCE_ASSERT(graph.op(node) != Methan::OpCode::Input, Methan::ExceptionType::IllegalArgument, "The tensor of an Input node is not cached, it is set with setInput");
+    }
+
+}
+
+METHAN_API Methan::IncrementalEvaluator::IncrementalEvaluator(const Graph& graph, ThreadPool& pool)
+: m_graph(&graph),
+m_pool(&pool),
+m_edgeCount(0),
+m_clock(0),
+m_budget(Unlimited),
+m_cachedBytes(0),
+m_lastComputed(0)
+{
+    __sync();
+}
+
+METHAN_API void Methan::IncrementalEvaluator::setInput(NodeHandle node, Tensor tensor)
+{
+    METHAN_FORCE_ASSERT(m_graph->contains(node) && m_graph->op(node) == OpCode::Input, Methan::ExceptionType::IllegalArgument, "Tensors can only be bound to the Input nodes of the graph");
+    METHAN_FORCE_ASSERT(!tensor.isEmpty(), Methan::ExceptionType::IllegalArgument, "Cannot bind an empty tensor to an Input node");
+    __sync();
+
+    const NodeIndex index = Graph::index(node);
+    m_values[index] = std::move(tensor);
+    m_valid[index] = true;
+    __invalidate(index, false);
+}
+
+METHAN_API void Methan::IncrementalEvaluator::invalidate(NodeHandle node)
+{
+    __check_node(*m_graph, node);
+    __sync();
+    __invalidate(Graph::index(node), true);
+}
+
+METHAN_API std::vector<Methan::Tensor> Methan::IncrementalEvaluator::evaluate(Span<const NodeHandle> outputs)
+{
+    __sync();
+    const Graph& graph = *m_graph;
+    const uint64_t epoch = ++m_clock;
+
+    // Walk up from the outputs to the cached nodes, collecting the nodes to compute
+    std::vector<NodeIndex> stack;
+    std::vector<NodeIndex> pending;
+    for(size_t i = 0; i < outputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(graph.contains(outputs[i]), Methan::ExceptionType::IllegalArgument, "The requested output is not a node of the graph");
+        const NodeIndex index = Graph::index(outputs[i]);
+        if(m_visits[index] == epoch) continue;
+        m_visits[index] = epoch;
+        stack.push_back(index);
+    }
+    while(!stack.empty())
+    {
+        const NodeIndex index = stack.back();
+        stack.pop_back();
+        m_lastUses[index] = epoch;
+        if(m_valid[index]) continue;
+
+        const NodeHandle node = Graph::handle(index);
+        METHAN_FORCE_ASSERT(graph.op(node) != OpCode::Input, Methan::ExceptionType::IllegalArgument, "The Input node " + std::to_string(index) + " is not bound to a tensor");
+        pending.push_back(index);
+        for(NodeIndex input : graph.inputs(node))
+        {
+            if(m_visits[input] == epoch) continue;
+            m_visits[input] = epoch;
+            stack.push_back(input);
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [this](NodeIndex a, NodeIndex b) { return m_positions[a] < m_positions[b]; });
+
+    m_lastComputed = 0;
+    std::vector<Tensor> operands;
+    try
+    {
+        for(NodeIndex index : pending)
+        {
+            const NodeHandle node = Graph::handle(index);
+            operands.clear();
+            for(NodeIndex input : graph.inputs(node)) operands.push_back(m_values[input]);
+
+            m_values[index] = Evaluator::evaluateNode(graph, node, Span<const Tensor>(operands.data(), operands.size()), *m_pool);
+            m_valid[index] = true;
+            m_cachedBytes += __cached_bytes(graph, index, m_values[index]);
+            ++m_lastComputed;
+        }
+    }
+    catch(...)
+    {
+        __trim();
+        throw;
+    }
+
+    std::vector<Tensor> results;
+    results.reserve(outputs.size());
+    for(size_t i = 0; i < outputs.size(); ++i) results.push_back(m_values[Graph::index(outputs[i])]);
+    __trim();
+    return results;
+}
+
+METHAN_API void Methan::IncrementalEvaluator::pin(NodeHandle node)
+{
+    __check_node(*m_graph, node);
+    __sync();
+    m_pinned[Graph::index(node)] = true;
+}
+
+METHAN_API void Methan::IncrementalEvaluator::unpin(NodeHandle node)
+{
+    __check_node(*m_graph, node);
+    __sync();
+    m_pinned[Graph::index(node)] = false;
+    __trim();
+}
+
+METHAN_API void Methan::IncrementalEvaluator::evict(NodeHandle node)
+{
+    __check_node(*m_graph, node);
+    __sync();
+    __drop(Graph::index(node));
+}
+
+METHAN_API void Methan::IncrementalEvaluator::clearCache()
+{
+    __sync();
+    for(NodeIndex index = 0; index < m_values.size(); ++index)
+    {
+        if(m_graph->op(Graph::handle(index)) != OpCode::Input) __drop(index);
+    }
+}
+
+METHAN_API void Methan::IncrementalEvaluator::setMemoryBudget(size_t bytes)
+{
+    m_budget = bytes;
+    __trim();
+}
+
+void Methan::IncrementalEvaluator::__sync()
+{
+    const Graph& graph = *m_graph;
+    const size_t nodeCount = graph.nodeCount();
+    if(nodeCount == m_values.size() && graph.edgeCount() == m_edgeCount) return;
+
+    const std::vector<NodeIndex> order = graph.topologicalOrder();
+    m_positions.resize(nodeCount);
+    for(size_t i = 0; i < order.size(); ++i) m_positions[order[i]] = i;
+
+    const size_t previous = m_values.size();
+    m_values.resize(nodeCount);
+    m_valid.resize(nodeCount, false);
+    m_pinned.resize(nodeCount, false);
+    m_lastUses.resize(nodeCount, 0);
+    m_visits.resize(nodeCount, 0);
+    m_inDegrees.resize(nodeCount, 0);
+
+    // The edges are only appended, a node whose in-degree changed has new inputs
+    for(NodeIndex index = 0; index < nodeCount; ++index)
+    {
+        const size_t inDegree = graph.inDegree(Graph::handle(index));
+        if(index < previous && inDegree != m_inDegrees[index]) __invalidate(index, true);
+        m_inDegrees[index] = inDegree;
+    }
+    m_edgeCount = graph.edgeCount();
+}
+
+void Methan::IncrementalEvaluator::__drop(NodeIndex index)
+{
+    if(!m_valid[index]) return;
+    m_cachedBytes -= __cached_bytes(*m_graph, index, m_values[index]);
+    m_values[index] = Tensor();
+    m_valid[index] = false;
+}
+
+void Methan::IncrementalEvaluator::__invalidate(NodeIndex index, bool self)
+{
+    // The walk goes through the nodes that are not cached, as the nodes downstream of an evicted node may be
+    const uint64_t epoch = ++m_clock;
+    std::vector<NodeIndex> stack(1, index);
+    m_visits[index] = epoch;
+    if(self) __drop(index);
+    while(!stack.empty())
+    {
+        const NodeIndex current = stack.back();
+        stack.pop_back();
+        for(NodeIndex consumer : m_graph->outputs(Graph::handle(current)))
+        {
+            if(m_visits[consumer] == epoch) continue;
+            m_visits[consumer] = epoch;
+            __drop(consumer);
+            stack.push_back(consumer);
+        }
+    }
+}
+
+void Methan::IncrementalEvaluator::__trim()
+{
+    if(m_cachedBytes <= m_budget) return;
+
+    std::vector<NodeIndex> candidates;
+    for(NodeIndex index = 0; index < m_values.size(); ++index)
+    {
+        if(m_valid[index] && !m_pinned[index] && __cached_bytes(*m_graph, index, m_values[index]) > 0) candidates.push_back(index);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [this](NodeIndex a, NodeIndex b) { return m_lastUses[a] < m_lastUses[b]; });
+    for(NodeIndex index : candidates)
+    {
+        if(m_cachedBytes <= m_budget) break;
+        __drop(index);
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/execution/thread_pool.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/tensor/tensor.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Evaluate a graph repeatedly, keeping the tensors of its nodes between evaluations so that only the
+     * nodes downstream of the inputs that changed are computed again.
+     *
+     * Setting an input drops the cached tensors of the nodes depending on it. An evaluation then computes the
+     * requested outputs and, recursively, the inputs they need that are not cached; every tensor it computes
+     * is cached. The cache can be bounded by a memory budget: after each evaluation the least recently used
+     * tensors are evicted until the cached tensors fit in it, except those pinned. An evicted tensor is
+     * computed again from its inputs when needed.
+     *
+     * The nodes are assumed to be pure: a `Custom` node is only computed again when its inputs change, or
+     * when it is invalidated. Nodes may be appended to the graph between evaluations; the nodes whose inputs
+     * changed are invalidated. The nodes are computed one at a time in topological order, their kernels are
+     * parallelized over the pool. This class is not thread-safe.
+     */
+    class IncrementalEvaluator
+    {
+    public:
+        static constexpr size_t Unlimited = ~size_t(0);
+
+        METHAN_API explicit IncrementalEvaluator(const Graph& graph, ThreadPool& pool = ThreadPool::global());
+
+        /**
+         * @brief Bind a tensor to an `Input` node, the tensors of the nodes depending on it are dropped
+         */
+        METHAN_API void setInput(NodeHandle node, Tensor tensor);
+
+        /**
+         * @brief Drop the tensor of a node (other than `Input`) and of every node depending on it, e.g. when a
+         * `Custom` node reads a state that changed
+         */
+        METHAN_API void invalidate(NodeHandle node);
+
+        /**
+         * @brief Return the tensors of the `outputs` nodes (in the same order), computing only those that are
+         * not cached. An exception raised by a node is rethrown, the tensors computed before it stay cached.
+         */
+        METHAN_API std::vector<Tensor> evaluate(Span<const NodeHandle> outputs);
+
+        inline std::vector<Tensor> evaluate(std::initializer_list<NodeHandle> outputs)
+        {
+            return evaluate(Span<const NodeHandle>(outputs.begin(), outputs.size()));
+        }
+
+        /**
+         * @brief Never evict the tensor of the node to meet the memory budget (it is still dropped when the
+         * node is invalidated)
+         */
+        METHAN_API void pin(NodeHandle node);
+
+        METHAN_API void unpin(NodeHandle node);
+
+        /**
+         * @brief Drop the cached tensor of a node (other than `Input`), it is computed again when needed
+         */
+        METHAN_API void evict(NodeHandle node);
+
+        /**
+         * @brief Drop every cached tensor, the inputs stay bound
+         */
+        METHAN_API void clearCache();
+
+        /**
+         * @brief Bound the size (in bytes) of the cached tensors, evicting the least recently used ones now
+         * if needed. The tensors of an evaluation are all kept until it completes.
+         */
+        METHAN_API void setMemoryBudget(size_t bytes);
+
+        inline size_t memoryBudget() const noexcept
+        {
+            return m_budget;
+        }
+
+        /**
+         * @brief Size (in bytes) of the cached tensors, the inputs and the constants excluded
+         */
+        inline size_t cachedBytes() const noexcept
+        {
+            return m_cachedBytes;
+        }
+
+        inline bool isCached(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(Graph::index(node), m_graph->nodeCount());
+            return Graph::index(node) < m_valid.size() && m_valid[Graph::index(node)];
+        }
+
+        inline bool isPinned(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(Graph::index(node), m_graph->nodeCount());
+            return Graph::index(node) < m_pinned.size() && m_pinned[Graph::index(node)];
+        }
+
+        /**
+         * @brief Number of nodes computed by the last evaluation
+         */
+        inline size_t lastComputedCount() const noexcept
+        {
+            return m_lastComputed;
+        }
+
+        inline const Graph& graph() const noexcept
+        {
+            return *m_graph;
+        }
+
+    private:
+        void __sync();
+        void __drop(NodeIndex node);
+        void __invalidate(NodeIndex node, bool self);
+        void __trim();
+
+        const Graph* m_graph;
+        ThreadPool* m_pool;
+
+        // Position of the nodes in a topological order, and in-degree of the nodes and edge count of the graph
+        // when it was computed
+        std::vector<size_t> m_positions;
+        std::vector<size_t> m_inDegrees;
+        size_t m_edgeCount;
+
+        // State of every node, the tensor is cached when the node is valid
+        std::vector<Tensor> m_values;
+        std::vector<bool> m_valid;
+        std::vector<bool> m_pinned;
+        std::vector<uint64_t> m_lastUses;
+        std::vector<uint64_t> m_visits;
+
+        uint64_t m_clock;
+        size_t m_budget;
+        size_t m_cachedBytes;
+        size_t m_lastComputed;
+    };
+
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+
+#include <methan/core/execution/memory_plan.hpp>
+
+namespace {
+
+    /**
+     * @brief Storage shared by a tensor and the nodes executed in place over it
+     */
+    struct PlannedBuffer
+    {
+        size_t size;
+        size_t first, last;
+        size_t offset;
+    };
+
+    inline size_t __round_up(size_t value, size_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    inline bool __is_plannable(Methan::OpCode op)
+    {
+        return op == Methan::OpCode::Elementwise || op == Methan::OpCode::FusedElementwise || op == Methan::OpCode::MatMul;
+    }
+
+    /**
+     * @brief Best-fit offset of the buffer among the placed buffers whose live range overlaps its own
+     */
+    size_t __best_fit(const std::vector<PlannedBuffer>& buffers, const std::vector<size_t>& placed, const PlannedBuffer& buffer)
+    {
+        std::vector<const PlannedBuffer*> overlapping;
+        for(size_t index : placed)
+        {
+            const PlannedBuffer& other = buffers[index];
+            if(other.first <= buffer.last && buffer.first <= other.last) overlapping.push_back(&other);
+        }
+        std::sort(overlapping.begin(), overlapping.end(), [](const PlannedBuffer* a, const PlannedBuffer* b) { return a->offset < b->offset; });
+
+        size_t best = Methan::MemoryPlan::Unplanned;
+        size_t bestGap = Methan::MemoryPlan::Unplanned;
+        size_t end = 0;
+        for(const PlannedBuffer* other : overlapping)
+        {
+            if(other->offset > end)
+            {
+                const size_t gap = other->offset - end;
+                if(gap >= buffer.size && gap < bestGap)
+                {
+                    best = end;
+                    bestGap = gap;
+                }
+            }
+            end = std::max(end, other->offset + other->size);
+        }
+        return best != Methan::MemoryPlan::Unplanned ? best : end;
+    }
+
+}
+
+METHAN_API Methan::MemoryPlan Methan::planMemory(const Graph& graph, std::vector<TensorSpec> specs, Span<const NodeHandle> outputs, Span<const NodeIndex> order)
+{
+    const size_t nodeCount = graph.nodeCount();
+    METHAN_FORCE_ASSERT(specs.size() == nodeCount, Methan::ExceptionType::IllegalArgument, "Expected a spec for each of the " + std::to_string(nodeCount) + " nodes, got " + std::to_string(specs.size()));
+
+    MemoryPlan plan;
+    plan.order = order.empty() ? graph.topologicalOrder() : std::vector<NodeIndex>(order.begin(), order.end());
+    plan.specs = std::move(specs);
+    plan.offsets.assign(nodeCount, MemoryPlan::Unplanned);
+    plan.inPlace.assign(nodeCount, Graph::InvalidIndex);
+
+    // Position of every node in the order, which must be a topological order of the graph
+    std::vector<size_t> positions(nodeCount, MemoryPlan::Unplanned);
+    METHAN_FORCE_ASSERT(plan.order.size() == nodeCount, Methan::ExceptionType::IllegalArgument, "The execution order must contain every node of the graph once");
+    for(size_t position = 0; position < nodeCount; ++position)
+    {
+        const NodeIndex node = plan.order[position];
+        METHAN_FORCE_ASSERT(node < nodeCount && positions[node] == MemoryPlan::Unplanned, Methan::ExceptionType::IllegalArgument, "The execution order must contain every node of the graph once");
+        positions[node] = position;
+    }
+
+    std::vector<bool> kept(nodeCount, false);
+    for(size_t i = 0; i < outputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(graph.contains(outputs[i]), Methan::ExceptionType::IllegalArgument, "The requested output is not a node of the graph");
+        kept[Graph::index(outputs[i])] = true;
+    }
+
+    // Live ranges, in positions of the order: from the node to its last consumer
+    std::vector<size_t> lastUses(nodeCount);
+    for(NodeIndex node = 0; node < nodeCount; ++node)
+    {
+        lastUses[node] = positions[node];
+        for(NodeIndex input : graph.inputs(Graph::handle(node)))
+        {
+            METHAN_FORCE_ASSERT(positions[input] < positions[node], Methan::ExceptionType::IllegalArgument, "The node " + std::to_string(node) + " is executed before its input " + std::to_string(input));
+            lastUses[input] = std::max(lastUses[input], positions[node]);
+        }
+    }
+
+    std::vector<size_t> bufferOf(nodeCount, MemoryPlan::Unplanned);
+    std::vector<PlannedBuffer> buffers;
+    for(NodeIndex node : plan.order)
+    {
+        const NodeHandle handle = Graph::handle(node);
+        const TensorSpec& spec = plan.specs[node];
+        if(kept[node] || !spec.known || spec.byteSize() == 0 || !__is_plannable(graph.op(handle))) continue;
+        plan.plannedSize += spec.byteSize();
+
+        // An elementwise node writes over an input of the same size that dies at it
+        if(graph.op(handle) != OpCode::MatMul)
+        {
+            for(NodeIndex input : graph.inputs(handle))
+            {
+                const TensorSpec& inputSpec = plan.specs[input];
+                if(bufferOf[input] == MemoryPlan::Unplanned || lastUses[input] != positions[node] || inputSpec.dtype != spec.dtype || inputSpec.byteSize() != spec.byteSize()) continue;
+
+                bufferOf[node] = bufferOf[input];
+                buffers[bufferOf[node]].last = lastUses[node];
+                plan.inPlace[node] = input;
+                break;
+            }
+            if(bufferOf[node] != MemoryPlan::Unplanned) continue;
+        }
+
+        bufferOf[node] = buffers.size();
+        buffers.push_back({ __round_up(spec.byteSize(), Buffer::Alignment), positions[node], lastUses[node], 0 });
+    }
+
+    // Largest buffers first, each in the best gap left by those already placed
+    std::vector<size_t> sorted(buffers.size());
+    for(size_t i = 0; i < sorted.size(); ++i) sorted[i] = i;
+    std::sort(sorted.begin(), sorted.end(), [&buffers](size_t a, size_t b) {
+        return buffers[a].size != buffers[b].size ? buffers[a].size > buffers[b].size : buffers[a].first < buffers[b].first;
+    });
+
+    std::vector<size_t> placed;
+    placed.reserve(buffers.size());
+    for(size_t index : sorted)
+    {
+        PlannedBuffer& buffer = buffers[index];
+        buffer.offset = __best_fit(buffers, placed, buffer);
+        plan.slabSize = std::max(plan.slabSize, buffer.offset + buffer.size);
+        placed.push_back(index);
+    }
+
+    for(NodeIndex node = 0; node < nodeCount; ++node)
+    {
+        if(bufferOf[node] != MemoryPlan::Unplanned) plan.offsets[node] = buffers[bufferOf[node]].offset;
+    }
+    return plan;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/tensor/tensor.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Type and shape of the tensor computed by a node, if they are known before the evaluation
+     */
+    struct TensorSpec
+    {
+        bool known = false;
+        DataType dtype = DataType::Float32;
+        Shape shape;
+
+        inline size_t byteSize() const noexcept
+        {
+            return static_cast<size_t>(shape.elementCount()) * sizeOf(dtype);
+        }
+    };
+
+    /**
+     * @brief Placement of the intermediate tensors of a graph in a single slab of memory, for a given
+     * execution order (see planMemory and Evaluator::run)
+     */
+    struct MemoryPlan
+    {
+        static constexpr size_t Unplanned = ~size_t(0);
+
+        /**
+         * @brief Order in which the nodes are executed
+         */
+        std::vector<NodeIndex> order;
+
+        /**
+         * @brief Type and shape of the tensor of every node
+         */
+        std::vector<TensorSpec> specs;
+
+        /**
+         * @brief Offset (in bytes) of the tensor of every node in the slab, `Unplanned` for the nodes whose
+         * tensor is allocated on its own
+         */
+        std::vector<size_t> offsets;
+
+        /**
+         * @brief The input whose storage is overwritten by every node (`Graph::InvalidIndex` if none)
+         */
+        std::vector<NodeIndex> inPlace;
+
+        /**
+         * @brief Size (in bytes) of the slab
+         */
+        size_t slabSize = 0;
+
+        /**
+         * @brief Total size (in bytes) of the planned tensors, the memory they would take without reuse
+         */
+        size_t plannedSize = 0;
+
+        inline bool isPlanned(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(Graph::index(node), offsets.size());
+            return offsets[Graph::index(node)] != Unplanned;
+        }
+    };
+
+    /**
+     * @brief Plan the memory of the intermediate tensors of a graph executed sequentially in the given order
+     * (a topological order of the graph is used if it is empty).
+     *
+     * The tensors of the `Elementwise`, `FusedElementwise` and `MatMul` nodes whose spec is known are
+     * placed in a shared slab, except those of the `outputs` that outlive the evaluation. Every tensor is
+     * live from the execution of its node to the execution of its last consumer; the tensors are placed by
+     * decreasing size, each at the offset of the smallest gap left by the tensors whose live range overlaps
+     * its own (best-fit). An elementwise node overwrites the storage of an input of the same size that is
+     * not read after it (in-place execution).
+     */
+    METHAN_API MemoryPlan planMemory(const Graph& graph, std::vector<TensorSpec> specs, Span<const NodeHandle> outputs, Span<const NodeIndex> order = Span<const NodeIndex>());
+
+    inline MemoryPlan planMemory(const Graph& graph, std::vector<TensorSpec> specs, std::initializer_list<NodeHandle> outputs)
+    {
+        return planMemory(graph, std::move(specs), Span<const NodeHandle>(outputs.begin(), outputs.size()));
+    }
+
+}
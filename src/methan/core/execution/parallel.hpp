@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/thread_pool.hpp>
+
+namespace Methan {
+
+    namespace details {
+
+        /**
+         * @brief Number of times a range is halved before running on the thread that received it: enough for
+         * 4 chunks per worker. A range stolen by another worker gets the same budget again, so that the work
+         * is split further only where the workers are starving.
+         */
+        inline size_t splitDepth(size_t workerCount) noexcept
+        {
+            size_t depth = 2;
+            while((size_t(1) << (depth - 2)) < workerCount) ++depth;
+            return depth;
+        }
+
+        /**
+         * @brief Run `left` on the calling thread and `right` as a job of the pool, return when both are done.
+         * The first exception raised (by `left`, then `right`) is rethrown. A worker waiting for `right`
+         * executes other jobs, usually `right` itself when it was not stolen.
+         */
+        template<typename Left, typename Right>
+        void forkJoin(Left&& left, Right&& right, ThreadPool& pool)
+        {
+            struct RightJob : public Job
+            {
+                Right* function;
+                WaitGroup group;
+                std::exception_ptr error;
+            } job;
+            job.function = &right;
+            job.group.add();
+            job.execute = [](Job* base) {
+                RightJob* self = static_cast<RightJob*>(base);
+                try
+                {
+                    (*self->function)();
+                }
+                catch(...)
+                {
+                    self->error = std::current_exception();
+                }
+                self->group.done();
+            };
+            pool.submit(&job);
+
+            std::exception_ptr error;
+            try
+            {
+                left();
+            }
+            catch(...)
+            {
+                error = std::current_exception();
+            }
+            pool.wait(job.group);
+            if(error) std::rethrow_exception(error);
+            if(job.error) std::rethrow_exception(job.error);
+        }
+
+        template<typename Body>
+        void parallelRange(size_t begin, size_t end, size_t grain, size_t depth, size_t stolenDepth, Body& body, ThreadPool& pool)
+        {
+            if(end - begin < 2 * grain || depth == 0)
+            {
+                body(begin, end);
+                return;
+            }
+
+            const size_t middle = begin + (end - begin) / 2;
+            const int owner = pool.currentWorkerIndex();
+            forkJoin([&]() { parallelRange(begin, middle, grain, depth - 1, stolenDepth, body, pool); },
+                     [&]() {
+                         const size_t budget = pool.currentWorkerIndex() == owner ? depth - 1 : std::max(depth - 1, stolenDepth);
+                         parallelRange(middle, end, grain, budget, stolenDepth, body, pool);
+                     },
+                     pool);
+        }
+
+        template<typename T, typename Map, typename Combine>
+        T parallelReduce(size_t begin, size_t end, size_t grain, size_t depth, size_t stolenDepth, Map& map, Combine& combine, ThreadPool& pool)
+        {
+            if(end - begin < 2 * grain || depth == 0) return map(begin, end);
+
+            const size_t middle = begin + (end - begin) / 2;
+            const int owner = pool.currentWorkerIndex();
+            std::optional<T> left, right;
+            forkJoin([&]() { left.emplace(parallelReduce<T>(begin, middle, grain, depth - 1, stolenDepth, map, combine, pool)); },
+                     [&]() {
+                         const size_t budget = pool.currentWorkerIndex() == owner ? depth - 1 : std::max(depth - 1, stolenDepth);
+                         right.emplace(parallelReduce<T>(middle, end, grain, budget, stolenDepth, map, combine, pool));
+                     },
+                     pool);
+            return combine(std::move(*left), std::move(*right));
+        }
+
+    }
+
+    /**
+     * @brief Call `body(chunkBegin, chunkEnd)` on disjoint chunks covering [begin, end), concurrently on the
+     * workers of the pool and the calling thread. The range is halved recursively into jobs (see
+     * details::splitDepth) down to chunks of at least `grain` iterations; the halves are pushed on the deque
+     * of the worker, so a call from a kernel running on the pool (such as a node of a graph) shares the
+     * workers instead of oversubscribing the cores.
+     *
+     * Every chunk is executed even if another one raises an exception, the first exception is rethrown.
+     */
+    template<typename Body>
+    void parallel_for(size_t begin, size_t end, Body&& body, ThreadPool& pool = ThreadPool::global(), size_t grain = 1)
+    {
+        if(begin >= end) return;
+        const size_t depth = pool.workerCount() > 1 ? details::splitDepth(pool.workerCount()) : 0;
+        details::parallelRange(begin, end, std::max<size_t>(grain, 1), depth, depth, body, pool);
+    }
+
+    /**
+     * @brief Reduce [begin, end) with `map(chunkBegin, chunkEnd)`, returning the value of a chunk, and
+     * `combine(left, right)`, which must be associative. The chunks are split and executed as with
+     * parallel_for, and combined in the order of the range; `identity` is returned for an empty range.
+     *
+     * The chunks depend on the scheduling, a floating point reduction may differ by rounding between calls.
+     */
+    template<typename T, typename Map, typename Combine>
+    T parallel_reduce(size_t begin, size_t end, T identity, Map&& map, Combine&& combine, ThreadPool& pool = ThreadPool::global(), size_t grain = 1)
+    {
+        if(begin >= end) return identity;
+        const size_t depth = pool.workerCount() > 1 ? details::splitDepth(pool.workerCount()) : 0;
+        return details::parallelReduce<T>(begin, end, std::max<size_t>(grain, 1), depth, depth, map, combine, pool);
+    }
+
+    /**
+     * @brief Inclusive scan of [begin, end) in two passes over fixed chunks: `reduce(chunkBegin, chunkEnd)`
+     * returns the total of a chunk, then `scan(chunkBegin, chunkEnd, prefix)` writes the results of the chunk
+     * starting from `prefix` (the combination of the totals of the previous chunks, `identity` for the first
+     * one) and returns the combination of `prefix` and the total of the chunk. `combine` must be associative.
+     * Return the total of the range.
+     *
+     * The chunks only depend on the size of the range and the number of workers, the results of a floating
+     * point scan are the same between calls.
+     */
+    template<typename T, typename Reduce, typename Scan, typename Combine>
+    T parallel_scan(size_t begin, size_t end, T identity, Reduce&& reduce, Scan&& scan, Combine&& combine, ThreadPool& pool = ThreadPool::global(), size_t grain = 1)
+    {
+        if(begin >= end) return identity;
+        const size_t count = end - begin;
+        const size_t chunkCount = std::max<size_t>(1, std::min(count / std::max<size_t>(grain, 1), 4 * pool.workerCount()));
+        if(chunkCount == 1 || pool.workerCount() == 1) return scan(begin, end, std::move(identity));
+        const auto chunkBegin = [&](size_t chunk) { return begin + count * chunk / chunkCount; };
+
+        // Totals of the chunks (the last one is not needed), turned into the prefix of each chunk
+        std::vector<std::optional<T>> totals(chunkCount - 1);
+        parallel_for(0, chunkCount - 1, [&](size_t first, size_t last) {
+            for(size_t chunk = first; chunk < last; ++chunk) totals[chunk].emplace(reduce(chunkBegin(chunk), chunkBegin(chunk + 1)));
+        }, pool);
+
+        std::vector<T> prefixes;
+        prefixes.reserve(chunkCount);
+        prefixes.push_back(std::move(identity));
+        for(size_t chunk = 0; chunk + 1 < chunkCount; ++chunk) prefixes.push_back(combine(prefixes.back(), std::move(*totals[chunk])));
+
+        std::optional<T> total;
+        parallel_for(0, chunkCount, [&](size_t first, size_t last) {
+            for(size_t chunk = first; chunk < last; ++chunk)
+            {
+                if(chunk + 1 < chunkCount) scan(chunkBegin(chunk), chunkBegin(chunk + 1), prefixes[chunk]);
+                else total.emplace(scan(chunkBegin(chunk), end, prefixes[chunk]));
+            }
+        }, pool);
+        return std::move(*total);
+    }
+
+}
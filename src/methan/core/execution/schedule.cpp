@@ -0,0 +1,49 @@
+#include <algorithm>
+
+#include <methan/core/execution/schedule.hpp>
+
+namespace {
+
+    template<typename T>
+    inline bool __read_cost(const Methan::Varient& value, double& cost)
+    {
+        const Methan::Result<const T&> read = value.tryGet<T>();
+        if(read) cost = static_cast<double>(read.value());
+        return read.ok();
+    }
+
+    template<typename T, typename U, typename... Ts>
+    inline bool __read_cost(const Methan::Varient& value, double& cost)
+    {
+        return __read_cost<T>(value, cost) || __read_cost<U, Ts...>(value, cost);
+    }
+
+}
+
+METHAN_API double Methan::nodeCost(const Graph& graph, NodeHandle node)
+{
+    const Varient* value = graph.attribute(node, AttributeKey::Cost);
+    if(value == nullptr) return 1.0;
+
+    double cost = 0.0;
+    const bool isArithmetic = __read_cost<double, float, int, unsigned int, long, unsigned long, long long, unsigned long long>(*value, cost);
+    METHAN_FORCE_ASSERT(isArithmetic, Methan::ExceptionType::IllegalArgument, "The cost of a node must be of an arithmetic type");
+    return cost;
+}
+
+METHAN_API std::vector<double> Methan::criticalPathLengths(const Graph& graph)
+{
+    const std::vector<NodeIndex> order = graph.topologicalOrder();
+    std::vector<double> lengths(graph.nodeCount(), 0.0);
+
+    // Walk the graph from the sinks up to the sources, every output being done before its inputs
+    for(auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        const NodeHandle node = Graph::handle(*it);
+        double longest = 0.0;
+        for(NodeIndex output : graph.outputs(node)) longest = std::max(longest, lengths[output]);
+        lengths[*it] = nodeCost(graph, node) + longest;
+    }
+
+    return lengths;
+}
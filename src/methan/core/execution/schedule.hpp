@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/graph/graph.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Order in which the ready nodes of a graph are dispatched by the Executor
+     *
+     * - `WorkStealing`: each worker runs the nodes it made ready first (depth first), idle workers steal the
+     *   oldest ready nodes of the others. No global order, lowest overhead.
+     * - `Fifo`: ready nodes are dispatched in the order they became ready (breadth first)
+     * - `Lifo`: the most recently readied node is dispatched first (depth first)
+     * - `CriticalPath`: the ready node with the longest remaining path to a sink (weighted by the `Cost`
+     *   attribute of the nodes) is dispatched first
+     */
+    enum class SchedulePolicy : uint32_t
+    {
+        WorkStealing,
+        Fifo,
+        Lifo,
+        CriticalPath
+    };
+
+    /**
+     * @brief Return the estimated cost of the node, as given by its `AttributeKey::Cost` attribute. Nodes
+     * without cost attribute have a cost of 1. An `IllegalArgument` exception is raised if the attribute
+     * is not of an arithmetic type.
+     */
+    METHAN_API double nodeCost(const Graph& graph, NodeHandle node);
+
+    /**
+     * @brief Compute for every node the length of the longest path starting at that node (the node cost
+     * included) and ending at a sink of the graph, in linear time. The result is indexed by NodeIndex.
+     */
+    METHAN_API std::vector<double> criticalPathLengths(const Graph& graph);
+
+}
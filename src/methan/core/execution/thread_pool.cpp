@@ -0,0 +1,278 @@
+#include <algorithm>
+
+#include <methan/core/execution/thread_pool.hpp>
+#include <methan/core/log.hpp>
+#include <methan/utility/spin.hpp>
+
+#if defined(METHAN_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+    struct CurrentWorker
+    {
+        const Methan::ThreadPool* pool;
+        size_t index;
+    };
+
+    thread_local CurrentWorker t_currentWorker = { nullptr, 0 };
+
+    inline uint64_t __next_random(uint64_t& state) noexcept
+    {
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    void __pin_current_thread(const std::vector<int>& cpus)
+    {
+#if defined(METHAN_OS_LINUX)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for(int cpu : cpus) if(cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void) cpus;
+#endif
+    }
+
+}
+
+METHAN_API void Methan::WaitGroup::done(size_t count)
+{
+    size_t current = m_count.load(std::memory_order_relaxed);
+    while(current > count)
+    {
+        if(m_count.compare_exchange_weak(current, current - count, std::memory_order_acq_rel, std::memory_order_relaxed)) return;
+    }
+
+    // Last decrement, performed under the lock so that a waiter cannot observe the end of the group (and
+    // destroy it) before the notification is over
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_count.fetch_sub(count, std::memory_order_acq_rel);
+    m_condition.notify_all();
+}
+
+METHAN_API void Methan::WaitGroup::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return finished(); });
+}
+
+METHAN_API Methan::ThreadPool::ThreadPool(const ThreadPoolOptions& options)
+: m_injectionSize(0),
+m_sleeping(0),
+m_stop(false)
+{
+    size_t workerCount = options.workerCount;
+    if(workerCount == 0) workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    m_workers.reserve(workerCount);
+    for(size_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(new details::Worker());
+        m_workers.back()->random = 0x9E3779B97F4A7C15ull * (i + 1);
+        m_workers.back()->node = 0;
+    }
+
+    // Spread the workers over the nodes in proportion to their CPUs, in contiguous groups
+    const NumaTopology* topology = nullptr;
+    if(options.numaAware)
+    {
+        topology = options.topology.nodes.empty() ? &numaTopology() : &options.topology;
+        size_t cpuCount = 0;
+        for(const NumaNode& node : topology->nodes) cpuCount += node.cpus.size();
+        for(size_t i = 0; i < workerCount; ++i)
+        {
+            const size_t position = (2 * i + 1) * cpuCount / (2 * workerCount);
+            size_t node = 0;
+            for(size_t first = topology->nodes[0].cpus.size(); first <= position && node + 1 < topology->nodeCount(); first += topology->nodes[node].cpus.size()) ++node;
+            m_workers[i]->node = node;
+        }
+        m_nodeWorkers.resize(topology->nodeCount());
+    }
+    else
+    {
+        m_nodeWorkers.resize(1);
+    }
+    for(const std::unique_ptr<details::Worker>& worker : m_workers) m_nodeWorkers[worker->node].push_back(worker.get());
+
+    for(size_t i = 0; i < workerCount; ++i)
+    {
+        std::vector<int> cpus;
+        if(options.pinWorkers) cpus.push_back(options.cpus.empty() ? static_cast<int>(i % std::max(1u, std::thread::hardware_concurrency())) : options.cpus[i % options.cpus.size()]);
+        else if(options.numaAware) cpus = topology->nodes[m_workers[i]->node].cpus;
+
+        m_workers[i]->thread = std::thread([this, i, cpus]() {
+            if(!cpus.empty()) __pin_current_thread(cpus);
+            __workerLoop(i);
+        });
+    }
+    METHAN_LOG_DEBUG("Thread pool started with {} workers on {} nodes (pinned: {}, NUMA-aware: {})", workerCount, m_nodeWorkers.size(), options.pinWorkers, options.numaAware);
+}
+
+METHAN_API Methan::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop.store(true, std::memory_order_release);
+    }
+    m_sleepCondition.notify_all();
+
+    for(std::unique_ptr<details::Worker>& worker : m_workers) worker->thread.join();
+}
+
+METHAN_API void Methan::ThreadPool::submit(Job* job)
+{
+    if(t_currentWorker.pool == this)
+    {
+        m_workers[t_currentWorker.index]->deque.push(job);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        m_injection.push_back(job);
+        m_injectionSize.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    __notify();
+}
+
+METHAN_API void Methan::ThreadPool::wait(WaitGroup& group)
+{
+    if(t_currentWorker.pool == this)
+    {
+        details::Worker* self = m_workers[t_currentWorker.index].get();
+        Backoff backoff;
+        while(!group.finished())
+        {
+            if(Job* job = __findJob(self))
+            {
+                job->execute(job);
+                backoff.reset();
+            }
+            else
+            {
+                backoff.pause();
+            }
+        }
+    }
+
+    // Also synchronize with the thread that finished the group
+    group.wait();
+}
+
+METHAN_API int Methan::ThreadPool::currentWorkerIndex() const noexcept
+{
+    return t_currentWorker.pool == this ? static_cast<int>(t_currentWorker.index) : -1;
+}
+
+METHAN_API Methan::ThreadPool& Methan::ThreadPool::global()
+{
+    static ThreadPool pool([]() {
+        ThreadPoolOptions options;
+        options.numaAware = numaTopology().nodeCount() > 1;
+        return options;
+    }());
+    return pool;
+}
+
+void Methan::ThreadPool::__workerLoop(size_t index)
+{
+    t_currentWorker = { this, index };
+    details::Worker* self = m_workers[index].get();
+    Backoff backoff;
+
+    while(true)
+    {
+        if(Job* job = __findJob(self))
+        {
+            job->execute(job);
+            backoff.reset();
+            continue;
+        }
+
+        if(m_stop.load(std::memory_order_acquire)) break;
+
+        if(!backoff.isSaturated())
+        {
+            backoff.pause();
+            continue;
+        }
+
+        // Announce that we are going to sleep before checking one last time for work, `__notify` does the
+        // opposite so at least one of the two sides sees the other
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(!__hasWork() && !m_stop.load(std::memory_order_acquire)) m_sleepCondition.wait(lock);
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+        backoff.reset();
+    }
+
+    t_currentWorker = { nullptr, 0 };
+}
+
+Methan::Job* Methan::ThreadPool::__findJob(details::Worker* self)
+{
+    Job* job = nullptr;
+    if(self->deque.pop(job)) return job;
+
+    if(m_injectionSize.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        if(!m_injection.empty())
+        {
+            job = m_injection.front();
+            m_injection.pop_front();
+            m_injectionSize.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    const size_t workerCount = m_workers.size();
+    if(workerCount < 2) return nullptr;
+
+    // Workers of the same node first
+    const std::vector<details::Worker*>& neighbours = m_nodeWorkers[self->node];
+    if(m_nodeWorkers.size() > 1 && neighbours.size() > 1)
+    {
+        for(size_t attempt = 0; attempt < 2 * neighbours.size(); ++attempt)
+        {
+            details::Worker* victim = neighbours[__next_random(self->random) % neighbours.size()];
+            if(victim != self && victim->deque.steal(job)) return job;
+        }
+    }
+
+    for(size_t attempt = 0; attempt < 2 * workerCount; ++attempt)
+    {
+        details::Worker* victim = m_workers[__next_random(self->random) % workerCount].get();
+        if(victim != self && victim->deque.steal(job)) return job;
+    }
+
+    return nullptr;
+}
+
+bool Methan::ThreadPool::__hasWork() const noexcept
+{
+    if(m_injectionSize.load(std::memory_order_relaxed) > 0) return true;
+    for(const std::unique_ptr<details::Worker>& worker : m_workers)
+    {
+        if(!worker->deque.empty()) return true;
+    }
+    return false;
+}
+
+void Methan::ThreadPool::__notify()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(m_sleeping.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.notify_one();
+    }
+}
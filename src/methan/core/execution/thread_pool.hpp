@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/deque.hpp>
+#include <methan/core/numa.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Unit of work executed by a ThreadPool. Jobs are intrusive: the owner of the job is responsible
+     * for its lifetime, which must exceed its execution. A job must not let an exception escape.
+     */
+    struct Job
+    {
+        void (*execute)(Job* job);
+    };
+
+    /**
+     * @brief Counter of outstanding jobs that can be waited upon
+     */
+    class WaitGroup
+    {
+    public:
+        explicit WaitGroup(size_t count = 0) noexcept
+        : m_count(count)
+        {}
+
+        METHAN_DISABLE_COPY_MOVE(WaitGroup);
+
+        inline void add(size_t count = 1) noexcept
+        {
+            m_count.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Mark `count` jobs as done, waking up the waiters when the counter reaches zero
+         */
+        METHAN_API void done(size_t count = 1);
+
+        /**
+         * @brief Block the calling thread until the counter reaches zero
+         */
+        METHAN_API void wait();
+
+        inline bool finished() const noexcept
+        {
+            return m_count.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        std::atomic<size_t> m_count;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+    };
+
+    struct ThreadPoolOptions
+    {
+        /**
+         * @brief Number of worker threads, 0 means one worker per hardware thread
+         */
+        size_t workerCount = 0;
+
+        /**
+         * @brief Pin the worker threads to a CPU (Linux only). Worker `i` is pinned to `cpus[i % cpus.size()]`
+         * or to the CPU `i` if `cpus` is empty.
+         */
+        bool pinWorkers = false;
+        std::vector<int> cpus;
+
+        /**
+         * @brief Spread the workers over the NUMA nodes in proportion to their CPUs, pin each worker to the
+         * CPUs of its node (unless `pinWorkers` is set) and let the idle workers steal the jobs of their own
+         * node before those of the others
+         */
+        bool numaAware = false;
+
+        /**
+         * @brief Topology used when `numaAware` is set, the detected one (see numaTopology) if it has no node
+         */
+        NumaTopology topology;
+    };
+
+    namespace details {
+
+        struct alignas(METHAN_CACHE_LINE_SIZE) Worker
+        {
+            WorkStealingDeque<Job*> deque;
+            uint64_t random;
+            size_t node;
+            std::thread thread;
+        };
+
+    }
+
+    /**
+     * @brief Pool of worker threads scheduling jobs by work stealing. Each worker owns a Chase-Lev deque:
+     * jobs submitted from a worker are pushed on its own deque and popped in LIFO order, idle workers steal
+     * the oldest jobs of randomly chosen victims. Jobs submitted from outside the pool go through a shared
+     * injection queue. Idle workers spin, then yield, then sleep until new work is submitted.
+     *
+     * A NUMA-aware pool (see ThreadPoolOptions::numaAware) groups the workers by node: a victim is first
+     * chosen among the workers of the same node, so that the jobs (and the data they produced) stay on the
+     * node as long as it has work.
+     */
+    class ThreadPool
+    {
+    public:
+        METHAN_API explicit ThreadPool(const ThreadPoolOptions& options = ThreadPoolOptions());
+
+        /**
+         * @brief Stop the worker threads once every job already submitted has been executed
+         */
+        METHAN_API ~ThreadPool();
+
+        METHAN_DISABLE_COPY_MOVE(ThreadPool);
+
+        /**
+         * @brief Schedule the job for execution
+         */
+        METHAN_API void submit(Job* job);
+
+        /**
+         * @brief Wait until the group is finished. When called from a worker of this pool, the worker keeps
+         * executing jobs while waiting instead of blocking.
+         */
+        METHAN_API void wait(WaitGroup& group);
+
+        /**
+         * @brief Return the index of the calling worker thread, or -1 if the calling thread is not a worker
+         * of this pool
+         */
+        METHAN_API int currentWorkerIndex() const noexcept;
+
+        inline size_t workerCount() const noexcept
+        {
+            return m_workers.size();
+        }
+
+        /**
+         * @brief Number of NUMA nodes the workers are spread over (1 unless the pool is NUMA-aware)
+         */
+        inline size_t nodeCount() const noexcept
+        {
+            return m_nodeWorkers.size();
+        }
+
+        /**
+         * @brief Index of the node of a worker, in the topology of the pool
+         */
+        inline size_t workerNode(size_t worker) const
+        {
+            METHAN_ASSERT_INDEX(worker, m_workers.size());
+            return m_workers[worker]->node;
+        }
+
+        /**
+         * @brief Return the pool shared by default by the whole library (one worker per hardware thread,
+         * NUMA-aware on machines with several nodes)
+         */
+        METHAN_API static ThreadPool& global();
+
+    private:
+        void __workerLoop(size_t index);
+        Job* __findJob(details::Worker* self);
+        bool __hasWork() const noexcept;
+        void __notify();
+
+        std::vector<std::unique_ptr<details::Worker>> m_workers;
+        std::vector<std::vector<details::Worker*>> m_nodeWorkers;
+
+        std::mutex m_injectionMutex;
+        std::deque<Job*> m_injection;
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<size_t> m_injectionSize;
+
+        std::mutex m_sleepMutex;
+        std::condition_variable m_sleepCondition;
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<size_t> m_sleeping;
+        std::atomic<bool> m_stop;
+    };
+
+}
@@ -0,0 +1,190 @@
+#include <methan/core/graph/graph.hpp>
+
+METHAN_API Methan::Graph::Graph(std::pmr::memory_resource* resource)
+: m_ops(resource),
+m_payloads(resource),
+m_attributeHeads(resource),
+m_attributeKeys(resource),
+m_attributeNexts(resource),
+m_attributeValues(resource),
+m_edgeSources(resource),
+m_edgeTargets(resource),
+m_adjacencyDirty(true),
+m_acyclic(-1),
+m_inputOffsets(resource),
+m_inputs(resource),
+m_outputOffsets(resource),
+m_outputs(resource)
+{}
+
+METHAN_API void Methan::Graph::reserve(size_t nodeCount, size_t edgeCount)
+{
+    m_ops.reserve(nodeCount);
+    m_payloads.reserve(nodeCount);
+    m_attributeHeads.reserve(nodeCount);
+    m_edgeSources.reserve(edgeCount);
+    m_edgeTargets.reserve(edgeCount);
+}
+
+METHAN_API void Methan::Graph::clear()
+{
+    m_ops.clear();
+    m_payloads.clear();
+    m_attributeHeads.clear();
+    m_attributeKeys.clear();
+    m_attributeNexts.clear();
+    m_attributeValues.clear();
+    m_edgeSources.clear();
+    m_edgeTargets.clear();
+    m_adjacencyDirty = true;
+    m_acyclic = -1;
+}
+
+METHAN_API Methan::NodeHandle Methan::Graph::addNode(OpCode op, Span<const NodeHandle> inputs, Varient payload)
+{
+    METHAN_FORCE_ASSERT(m_ops.size() < InvalidIndex, Methan::ExceptionType::IllegalState, "The graph cannot hold more nodes");
+#if defined(METHAN_DEBUG) || defined(METHAN_FORCE_ASSERTION)
+    for(NodeHandle input : inputs) METHAN_ASSERT(contains(input), Methan::ExceptionType::IllegalArgument, "The input node does not belong to the graph");
+#endif
+
+    const NodeIndex node = static_cast<NodeIndex>(m_ops.size());
+    m_ops.push_back(op);
+    m_payloads.push_back(std::move(payload));
+    m_attributeHeads.push_back(InvalidIndex);
+
+    for(NodeHandle input : inputs)
+    {
+        m_edgeSources.push_back(index(input));
+        m_edgeTargets.push_back(node);
+    }
+
+    m_adjacencyDirty = true;
+    m_acyclic = -1;
+    return handle(node);
+}
+
+METHAN_API void Methan::Graph::addEdge(NodeHandle from, NodeHandle to)
+{
+    METHAN_ASSERT(contains(from), Methan::ExceptionType::IllegalArgument, "The source node does not belong to the graph");
+    METHAN_ASSERT(contains(to), Methan::ExceptionType::IllegalArgument, "The target node does not belong to the graph");
+
+    m_edgeSources.push_back(index(from));
+    m_edgeTargets.push_back(index(to));
+    m_adjacencyDirty = true;
+    m_acyclic = -1;
+}
+
+METHAN_API void Methan::Graph::setAttribute(NodeHandle node, AttributeKey key, Varient value)
+{
+    METHAN_ASSERT_INDEX(index(node), m_ops.size());
+
+    for(uint32_t it = m_attributeHeads[index(node)]; it != InvalidIndex; it = m_attributeNexts[it])
+    {
+        if(m_attributeKeys[it] == key)
+        {
+            m_attributeValues[it] = std::move(value);
+            return;
+        }
+    }
+
+    const uint32_t attribute = static_cast<uint32_t>(m_attributeKeys.size());
+    m_attributeKeys.push_back(key);
+    m_attributeNexts.push_back(m_attributeHeads[index(node)]);
+    m_attributeValues.push_back(std::move(value));
+    m_attributeHeads[index(node)] = attribute;
+}
+
+METHAN_API const Methan::Varient* Methan::Graph::attribute(NodeHandle node, AttributeKey key) const
+{
+    METHAN_ASSERT_INDEX(index(node), m_ops.size());
+
+    for(uint32_t it = m_attributeHeads[index(node)]; it != InvalidIndex; it = m_attributeNexts[it])
+    {
+        if(m_attributeKeys[it] == key) return &m_attributeValues[it];
+    }
+
+    return nullptr;
+}
+
+METHAN_API void Methan::Graph::buildAdjacency() const
+{
+    if(!m_adjacencyDirty) return;
+
+    const size_t nodeCount = m_ops.size();
+    const size_t edgeCount = m_edgeSources.size();
+
+    // Counting sort of the edge list by target (resp. source). The sort is stable so the inputs of a
+    // node keep their insertion order.
+    m_inputOffsets.assign(nodeCount + 1, 0);
+    m_outputOffsets.assign(nodeCount + 1, 0);
+    for(size_t e = 0; e < edgeCount; ++e)
+    {
+        ++m_inputOffsets[m_edgeTargets[e] + 1];
+        ++m_outputOffsets[m_edgeSources[e] + 1];
+    }
+
+    for(size_t i = 0; i < nodeCount; ++i)
+    {
+        m_inputOffsets[i + 1] += m_inputOffsets[i];
+        m_outputOffsets[i + 1] += m_outputOffsets[i];
+    }
+
+    m_inputs.resize(edgeCount);
+    m_outputs.resize(edgeCount);
+    std::vector<size_t> inputCursor(m_inputOffsets.begin(), m_inputOffsets.end() - 1);
+    std::vector<size_t> outputCursor(m_outputOffsets.begin(), m_outputOffsets.end() - 1);
+    for(size_t e = 0; e < edgeCount; ++e)
+    {
+        m_inputs[inputCursor[m_edgeTargets[e]]++] = m_edgeSources[e];
+        m_outputs[outputCursor[m_edgeSources[e]]++] = m_edgeTargets[e];
+    }
+
+    m_adjacencyDirty = false;
+}
+
+METHAN_API std::vector<Methan::NodeIndex> Methan::Graph::topologicalOrder() const
+{
+    std::vector<NodeIndex> order;
+    METHAN_FORCE_ASSERT(__kahn(order) == m_ops.size(), Methan::ExceptionType::IllegalState, "The graph contains a cycle");
+    return order;
+}
+
+METHAN_API bool Methan::Graph::isAcyclic() const
+{
+    if(m_acyclic < 0)
+    {
+        std::vector<NodeIndex> order;
+        __kahn(order);
+    }
+
+    return m_acyclic == 1;
+}
+
+size_t Methan::Graph::__kahn(std::vector<NodeIndex>& order) const
+{
+    buildAdjacency();
+
+    const size_t nodeCount = m_ops.size();
+    std::vector<uint32_t> pending(nodeCount);
+    order.clear();
+    order.reserve(nodeCount);
+
+    for(size_t i = 0; i < nodeCount; ++i)
+    {
+        pending[i] = static_cast<uint32_t>(m_inputOffsets[i + 1] - m_inputOffsets[i]);
+        if(pending[i] == 0) order.push_back(static_cast<NodeIndex>(i));
+    }
+
+    // Kahn's algorithm, `order` doubles as the work queue
+    for(size_t head = 0; head < order.size(); ++head)
+    {
+        const NodeIndex node = order[head];
+        for(size_t e = m_outputOffsets[node]; e < m_outputOffsets[node + 1]; ++e)
+        {
+            if(--pending[m_outputs[e]] == 0) order.push_back(m_outputs[e]);
+        }
+    }
+
+    m_acyclic = order.size() == nodeCount ? 1 : 0;
+    return order.size();
+}
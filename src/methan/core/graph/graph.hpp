@@ -0,0 +1,263 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/utility/assertion.hpp>
+#include <methan/utility/span.hpp>
+#include <methan/utility/varient.hpp>
+
+namespace Methan {
+
+    METHAN_OPAQUE_HANDLE(NodeHandle);
+
+    /**
+     * @brief Index of a node within its graph. Node indices are dense (0 to nodeCount - 1) and are the
+     * representation used by the adjacency arrays.
+     */
+    typedef uint32_t NodeIndex;
+
+    /**
+     * @brief The operation computed by a node. The semantic of the operations on tensors, and the payload
+     * they expect, is given by the Evaluator.
+     *
+     * - `Input`: tensor bound when the graph is evaluated
+     * - `Constant`: tensor held by the payload
+     * - `Custom`: user defined operation
+     * - `Elementwise`: elementwise operation of its inputs (see Methan::elementwise)
+     * - `MatMul`: product of its two input matrices (see Methan::matmul)
+     * - `FusedElementwise`: program of elementwise operations of its inputs, see Methan::fuseElementwise
+     */
+    enum class OpCode : uint32_t
+    {
+        Input,
+        Constant,
+        Custom,
+        Elementwise,
+        MatMul,
+        FusedElementwise
+    };
+
+    /**
+     * @brief Keys of the optional attributes that can be attached to a node. Values greater or equal to
+     * `User` are free to be used by the user of the library.
+     *
+     * - `Name`: human readable name of the node
+     * - `Cost`: estimated cost of the node (any arithmetic type, in arbitrary but consistent units), used
+     *   by the scheduler to prioritize the critical path
+     */
+    enum class AttributeKey : uint32_t
+    {
+        Name,
+        Cost,
+        User = 0x10000
+    };
+
+    /**
+     * @brief Directed acyclic graph of operations. Nodes are stored as a structure of arrays and edges are
+     * kept both as an append-only edge list and as two CSR (compressed sparse row) adjacency tables (inputs
+     * and outputs of each node). The CSR tables are rebuilt lazily, in linear time, the first time they are
+     * accessed after a modification. Notice that this rebuild is not thread-safe; call `buildAdjacency`
+     * and `isAcyclic` before sharing a modified graph with several threads.
+     *
+     * Every table of the graph is allocated from the memory resource given at construction; building a
+     * short-lived graph from a MonotonicArena releases it all at once when the arena is reset. Payloads
+     * and attributes allocate their own storage, see the `std::allocator_arg` constructors of Varient.
+     */
+    class Graph
+    {
+    public:
+        static constexpr NodeIndex InvalidIndex = ~NodeIndex(0);
+
+        METHAN_API explicit Graph(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        /**
+         * @brief Preallocate the storage for the given number of nodes and edges
+         */
+        METHAN_API void reserve(size_t nodeCount, size_t edgeCount);
+
+        /**
+         * @brief Remove every nodes and edges of the graph
+         */
+        METHAN_API void clear();
+
+        /**
+         * @brief Append a new node to the graph
+         *
+         * @param op the operation computed by the node
+         * @param inputs the nodes whose results are consumed by the new node (in order)
+         * @param payload the parameters of the operation
+         * @return NodeHandle the handle of the new node
+         */
+        METHAN_API NodeHandle addNode(OpCode op, Span<const NodeHandle> inputs, Varient payload = nullptr);
+
+        inline NodeHandle addNode(OpCode op, std::initializer_list<NodeHandle> inputs = {}, Varient payload = nullptr)
+        {
+            return addNode(op, Span<const NodeHandle>(inputs.begin(), inputs.size()), std::move(payload));
+        }
+
+        /**
+         * @brief Append `from` as the next input of `to`
+         */
+        METHAN_API void addEdge(NodeHandle from, NodeHandle to);
+
+        /**
+         * @brief Attach (or replace) an attribute to a node
+         */
+        METHAN_API void setAttribute(NodeHandle node, AttributeKey key, Varient value);
+
+        /**
+         * @brief Return the attribute attached to the node, or nullptr if the node has no such attribute
+         */
+        METHAN_API const Varient* attribute(NodeHandle node, AttributeKey key) const;
+
+        /**
+         * @brief Return the attribute attached to the node as a T, or an error if the node has no such
+         * attribute or if it holds another type
+         */
+        template<typename T>
+        inline Result<const T&> attributeAs(NodeHandle node, AttributeKey key) const
+        {
+            const Varient* value = attribute(node, key);
+            if(value == nullptr) return ResultError{ Methan::ExceptionType::IllegalArgument, "The node has no such attribute" };
+            return value->tryGet<T>();
+        }
+
+        inline bool hasAttribute(NodeHandle node, AttributeKey key) const
+        {
+            return attribute(node, key) != nullptr;
+        }
+
+        /**
+         * @brief Call `function(AttributeKey, const Varient&)` for every attribute attached to the node
+         */
+        template<typename Function>
+        inline void forEachAttribute(NodeHandle node, Function&& function) const
+        {
+            METHAN_ASSERT_INDEX(index(node), m_ops.size());
+            for(uint32_t it = m_attributeHeads[index(node)]; it != InvalidIndex; it = m_attributeNexts[it]) function(m_attributeKeys[it], m_attributeValues[it]);
+        }
+
+        /**
+         * @brief Rebuild the CSR adjacency tables if the graph was modified since the last rebuild
+         */
+        METHAN_API void buildAdjacency() const;
+
+        /**
+         * @brief Return the nodes in an order such that every node appears after all of its inputs
+         * An `IllegalState` exception is raised if the graph contains a cycle.
+         */
+        METHAN_API std::vector<NodeIndex> topologicalOrder() const;
+
+        /**
+         * @brief Whether or not the graph is free of cycles. The answer is cached until the next modification.
+         */
+        METHAN_API bool isAcyclic() const;
+
+        static inline NodeHandle handle(NodeIndex index) noexcept
+        {
+            return reinterpret_cast<NodeHandle>(static_cast<uintptr_t>(index) + 1);
+        }
+
+        static inline NodeIndex index(NodeHandle handle) noexcept
+        {
+            return static_cast<NodeIndex>(reinterpret_cast<uintptr_t>(handle) - 1);
+        }
+
+        inline bool contains(NodeHandle node) const noexcept
+        {
+            return node != nullptr && index(node) < m_ops.size();
+        }
+
+        inline size_t nodeCount() const noexcept
+        {
+            return m_ops.size();
+        }
+
+        inline size_t edgeCount() const noexcept
+        {
+            return m_edgeSources.size();
+        }
+
+        inline OpCode op(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(index(node), m_ops.size());
+            return m_ops[index(node)];
+        }
+
+        inline const Varient& payload(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(index(node), m_ops.size());
+            return m_payloads[index(node)];
+        }
+
+        inline Varient& payload(NodeHandle node)
+        {
+            METHAN_ASSERT_INDEX(index(node), m_ops.size());
+            return m_payloads[index(node)];
+        }
+
+        /**
+         * @brief The memory resource the tables of the graph are allocated from
+         */
+        inline std::pmr::memory_resource* resource() const noexcept
+        {
+            return m_ops.get_allocator().resource();
+        }
+
+        inline Span<const NodeIndex> inputs(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(index(node), m_ops.size());
+            buildAdjacency();
+            const NodeIndex i = index(node);
+            return Span<const NodeIndex>(m_inputs.data() + m_inputOffsets[i], m_inputOffsets[i + 1] - m_inputOffsets[i]);
+        }
+
+        inline Span<const NodeIndex> outputs(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(index(node), m_ops.size());
+            buildAdjacency();
+            const NodeIndex i = index(node);
+            return Span<const NodeIndex>(m_outputs.data() + m_outputOffsets[i], m_outputOffsets[i + 1] - m_outputOffsets[i]);
+        }
+
+        inline size_t inDegree(NodeHandle node) const
+        {
+            return inputs(node).size();
+        }
+
+        inline size_t outDegree(NodeHandle node) const
+        {
+            return outputs(node).size();
+        }
+
+    private:
+        size_t __kahn(std::vector<NodeIndex>& order) const;
+
+        // Node table (structure of arrays, indexed by NodeIndex)
+        std::pmr::vector<OpCode> m_ops;
+        std::pmr::vector<Varient> m_payloads;
+        std::pmr::vector<uint32_t> m_attributeHeads;
+
+        // Attribute pool, each node owns a singly-linked list of indices in this pool
+        std::pmr::vector<AttributeKey> m_attributeKeys;
+        std::pmr::vector<uint32_t> m_attributeNexts;
+        std::pmr::vector<Varient> m_attributeValues;
+
+        // Edge list in insertion order (source of truth)
+        std::pmr::vector<NodeIndex> m_edgeSources;
+        std::pmr::vector<NodeIndex> m_edgeTargets;
+
+        // CSR adjacency tables, derived from the edge list
+        mutable bool m_adjacencyDirty;
+        mutable int8_t m_acyclic;
+        mutable std::pmr::vector<size_t> m_inputOffsets;
+        mutable std::pmr::vector<NodeIndex> m_inputs;
+        mutable std::pmr::vector<size_t> m_outputOffsets;
+        mutable std::pmr::vector<NodeIndex> m_outputs;
+    };
+
+}
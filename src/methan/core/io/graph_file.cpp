@@ -0,0 +1,600 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/io/graph_file.hpp>
+
+#if defined(METHAN_OS_UNIX_LIKE)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr char __magic[8] = { 'M', 'E', 'T', 'H', 'A', 'N', 'G', 'F' };
+    constexpr uint32_t __byte_order = 0x01020304;
+
+    // Payload records of the blob
+    struct ElementwiseRecord
+    {
+        Methan::ElementwiseOp op;
+        uint32_t reserved;
+        double lower;
+        double upper;
+    };
+
+    struct InstructionRecord
+    {
+        Methan::ElementwiseOp op;
+        uint32_t operands[3];
+        double lower;
+        double upper;
+    };
+
+    struct MatMulRecord
+    {
+        double alpha;
+        uint8_t transposeA;
+        uint8_t transposeB;
+        uint8_t reserved[6];
+    };
+
+    // The layout of the records is the format, it must not depend on the compiler
+    static_assert(sizeof(Methan::details::GraphFileValue) == 24, "Unexpected layout of GraphFileValue");
+    static_assert(sizeof(Methan::details::GraphFileNode) == 40, "Unexpected layout of GraphFileNode");
+    static_assert(sizeof(Methan::details::GraphFileAttribute) == 32, "Unexpected layout of GraphFileAttribute");
+    static_assert(sizeof(Methan::details::GraphFileTensor) == 88, "Unexpected layout of GraphFileTensor");
+    static_assert(sizeof(Methan::details::GraphFileHeader) == 192, "Unexpected layout of GraphFileHeader");
+    static_assert(sizeof(ElementwiseRecord) == 24 && sizeof(InstructionRecord) == 32 && sizeof(MatMulRecord) == 16, "Unexpected layout of the payload records");
+    static_assert(sizeof(Methan::ElementwiseOp) == 4, "The elementwise operations are stored on 4 bytes");
+    static_assert(Methan::GraphFileAlignment % Methan::Buffer::Alignment == 0, "The tensors of a graph file must be aligned for the kernels");
+
+    inline uint64_t __align(uint64_t value, uint64_t alignment) noexcept
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    inline size_t __section_index(Methan::details::GraphFileSection section) noexcept
+    {
+        return static_cast<size_t>(section);
+    }
+
+    template<typename T>
+    inline bool __encode_integer(const Methan::Varient& value, Methan::details::GraphFileValue::Kind kind, Methan::details::GraphFileValue& encoded)
+    {
+        if(!value.is<T>()) return false;
+
+        // Two's complement for the signed types, read back by __decode_integer
+        encoded.kind = kind;
+        encoded.data = static_cast<uint64_t>(value.get<T>());
+        return true;
+    }
+
+    /**
+     * @brief Integer of a file as its own type, which may be narrower than on the host writing the file
+     * (e.g. `long` of a LP64 host read on a LLP64 one)
+     */
+    template<typename T>
+    inline Methan::Varient __decode_integer(uint64_t data)
+    {
+        if constexpr(std::is_signed<T>::value)
+        {
+            const int64_t integer = static_cast<int64_t>(data);
+            METHAN_FORCE_ASSERT(integer >= std::numeric_limits<T>::min() && integer <= std::numeric_limits<T>::max(), Methan::ExceptionType::IllegalArgument, "Invalid graph file: an integer does not fit its type");
+            return static_cast<T>(integer);
+        }
+        else
+        {
+            METHAN_FORCE_ASSERT(data <= std::numeric_limits<T>::max(), Methan::ExceptionType::IllegalArgument, "Invalid graph file: an integer does not fit its type");
+            return static_cast<T>(data);
+        }
+    }
+
+    /**
+     * @brief Encode the values of a graph into the records of a file, collecting the blob and the tensors
+     */
+    class Encoder
+    {
+    public:
+        Methan::details::GraphFileValue encode(const Methan::Varient& value, Methan::NodeIndex node, const char* what)
+        {
+            typedef Methan::details::GraphFileValue::Kind Kind;
+
+            Methan::details::GraphFileValue encoded{};
+            if(value.isEmpty())
+            {
+                encoded.kind = Kind::Empty;
+            }
+            else if(value.is<bool>())
+            {
+                encoded.kind = Kind::Bool;
+                encoded.data = value.get<bool>() ? 1 : 0;
+            }
+            else if(__encode_integer<int>(value, Kind::Int, encoded) ||
+                    __encode_integer<unsigned int>(value, Kind::UnsignedInt, encoded) ||
+                    __encode_integer<long>(value, Kind::Long, encoded) ||
+                    __encode_integer<unsigned long>(value, Kind::UnsignedLong, encoded) ||
+                    __encode_integer<long long>(value, Kind::LongLong, encoded) ||
+                    __encode_integer<unsigned long long>(value, Kind::UnsignedLongLong, encoded))
+            {
+            }
+            else if(value.is<float>())
+            {
+                uint32_t bits;
+                std::memcpy(&bits, &value.get<float>(), sizeof(bits));
+                encoded.kind = Kind::Float32;
+                encoded.data = bits;
+            }
+            else if(value.is<double>())
+            {
+                std::memcpy(&encoded.data, &value.get<double>(), sizeof(encoded.data));
+                encoded.kind = Kind::Float64;
+            }
+            else if(value.is<std::string>())
+            {
+                const std::string& text = value.get<std::string>();
+                encoded.kind = Kind::String;
+                encoded.data = __append(text.data(), text.size());
+                encoded.size = text.size();
+            }
+            else if(value.is<Methan::Tensor>())
+            {
+                const Methan::Tensor& tensor = value.get<Methan::Tensor>();
+                METHAN_FORCE_ASSERT_FORMAT(!tensor.isEmpty(), Methan::ExceptionType::IllegalArgument, "The {} of node {} is a tensor without storage", what, node);
+                encoded.kind = Kind::Tensor;
+                encoded.data = __add_tensor(tensor);
+            }
+            else if(value.is<Methan::ElementwisePayload>())
+            {
+                const Methan::ElementwisePayload& payload = value.get<Methan::ElementwisePayload>();
+                const ElementwiseRecord record{ payload.op, 0, payload.params.lower, payload.params.upper };
+                encoded.kind = Kind::Elementwise;
+                encoded.data = __append(&record, sizeof(record));
+                encoded.size = sizeof(record);
+            }
+            else if(value.is<Methan::FusedElementwisePayload>())
+            {
+                const std::vector<Methan::ElementwiseInstruction>& program = value.get<Methan::FusedElementwisePayload>().program;
+                std::vector<InstructionRecord> records(program.size());
+                for(size_t i = 0; i < program.size(); ++i)
+                {
+                    const Methan::ElementwiseInstruction& instruction = program[i];
+                    records[i] = InstructionRecord{ instruction.op, { instruction.operands[0], instruction.operands[1], instruction.operands[2] }, instruction.params.lower, instruction.params.upper };
+                }
+                encoded.kind = Kind::FusedElementwise;
+                encoded.data = __append(records.data(), records.size() * sizeof(InstructionRecord));
+                encoded.size = records.size();
+            }
+            else if(value.is<Methan::MatMulPayload>())
+            {
+                const Methan::MatMulPayload& payload = value.get<Methan::MatMulPayload>();
+                const MatMulRecord record{ payload.alpha, payload.transposeA, payload.transposeB, {} };
+                encoded.kind = Kind::MatMul;
+                encoded.data = __append(&record, sizeof(record));
+                encoded.size = sizeof(record);
+            }
+            else
+            {
+                METHAN_THROW_EXCEPTION_FORMAT("The {} of node {} cannot be written in a graph file (unsupported type)", Methan::ExceptionType::IllegalArgument, what, node);
+            }
+            return encoded;
+        }
+
+        std::vector<unsigned char> blob;
+        std::vector<Methan::details::GraphFileTensor> tensors;
+        std::vector<Methan::Tensor> tensorValues;
+        uint64_t dataSize = 0;
+
+    private:
+        uint64_t __append(const void* data, size_t size)
+        {
+            const uint64_t offset = __align(blob.size(), 8);
+            blob.resize(offset + size);
+            if(size > 0) std::memcpy(blob.data() + offset, data, size);
+            return offset;
+        }
+
+        uint64_t __add_tensor(const Methan::Tensor& tensor)
+        {
+            Methan::details::GraphFileTensor record{};
+            record.dtype = tensor.dtype();
+            record.rank = static_cast<uint8_t>(tensor.rank());
+            for(size_t axis = 0; axis < tensor.rank(); ++axis) record.shape[axis] = tensor.dim(axis);
+            record.offset = dataSize;
+            record.size = static_cast<uint64_t>(tensor.elementCount()) * tensor.elementSize();
+            dataSize = __align(record.offset + record.size, Methan::GraphFileAlignment);
+
+            tensors.push_back(record);
+            tensorValues.push_back(tensor.isContiguous() ? tensor : tensor.contiguous());
+            return tensors.size() - 1;
+        }
+    };
+
+    /**
+     * @brief Write the sections of a file in order, padding with zeros up to their offset
+     */
+    class SectionWriter
+    {
+    public:
+        explicit SectionWriter(std::ostream& stream)
+        : m_stream(stream),
+        m_position(0)
+        {}
+
+        void write(uint64_t offset, const void* data, size_t size)
+        {
+            pad(offset);
+            m_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            m_position += size;
+        }
+
+        void pad(uint64_t offset)
+        {
+            static const char zeros[Methan::GraphFileAlignment] = {};
+            while(m_position < offset)
+            {
+                const uint64_t size = std::min<uint64_t>(offset - m_position, sizeof(zeros));
+                m_stream.write(zeros, static_cast<std::streamsize>(size));
+                m_position += size;
+            }
+        }
+
+    private:
+        std::ostream& m_stream;
+        uint64_t m_position;
+    };
+
+#if defined(METHAN_OS_UNIX_LIKE)
+    struct MappedFile
+    {
+        MappedFile(void* data, size_t size)
+        : data(data),
+        size(size)
+        {}
+
+        ~MappedFile()
+        {
+            munmap(data, size);
+        }
+
+        void* data;
+        size_t size;
+    };
+#endif
+
+}
+
+METHAN_API void Methan::saveGraph(const Graph& graph, std::ostream& stream)
+{
+    typedef details::GraphFileSection Section;
+
+    const size_t nodeCount = graph.nodeCount();
+    const size_t edgeCount = graph.edgeCount();
+    graph.buildAdjacency();
+
+    // Encode the tables, the tensors are only collected and written last
+    Encoder encoder;
+    std::vector<details::GraphFileNode> nodes(nodeCount);
+    std::vector<uint64_t> inputOffsets(nodeCount + 1, 0);
+    std::vector<uint64_t> outputOffsets(nodeCount + 1, 0);
+    std::vector<NodeIndex> inputs;
+    std::vector<NodeIndex> outputs;
+    std::vector<details::GraphFileAttribute> attributes;
+    inputs.reserve(edgeCount);
+    outputs.reserve(edgeCount);
+
+    for(NodeIndex i = 0; i < nodeCount; ++i)
+    {
+        const NodeHandle node = Graph::handle(i);
+        const Span<const NodeIndex> nodeInputs = graph.inputs(node);
+        const Span<const NodeIndex> nodeOutputs = graph.outputs(node);
+        inputs.insert(inputs.end(), nodeInputs.begin(), nodeInputs.end());
+        outputs.insert(outputs.end(), nodeOutputs.begin(), nodeOutputs.end());
+        inputOffsets[i + 1] = inputs.size();
+        outputOffsets[i + 1] = outputs.size();
+
+        details::GraphFileNode& record = nodes[i];
+        record.op = graph.op(node);
+        record.attributeBegin = static_cast<uint32_t>(attributes.size());
+        graph.forEachAttribute(node, [&](AttributeKey key, const Varient& value) {
+            attributes.push_back(details::GraphFileAttribute{ key, 0, encoder.encode(value, i, "attribute") });
+        });
+        record.attributeCount = static_cast<uint32_t>(attributes.size() - record.attributeBegin);
+        record.payload = encoder.encode(graph.payload(node), i, "payload");
+    }
+
+    details::GraphFileHeader header{};
+    std::memcpy(header.magic, __magic, sizeof(__magic));
+    header.version = GraphFileVersion;
+    header.byteOrder = __byte_order;
+    header.edgeCount = edgeCount;
+    header.nodeCount = static_cast<uint32_t>(nodeCount);
+    header.attributeCount = static_cast<uint32_t>(attributes.size());
+    header.tensorCount = static_cast<uint32_t>(encoder.tensors.size());
+
+    uint64_t offset = sizeof(header);
+    const auto place = [&](Section section, uint64_t size, uint64_t alignment) {
+        offset = __align(offset, alignment);
+        header.sections[__section_index(section)] = details::GraphFileHeader::Section{ offset, size };
+        offset += size;
+    };
+    place(Section::Nodes, nodes.size() * sizeof(details::GraphFileNode), 8);
+    place(Section::InputOffsets, inputOffsets.size() * sizeof(uint64_t), 8);
+    place(Section::Inputs, inputs.size() * sizeof(NodeIndex), 8);
+    place(Section::OutputOffsets, outputOffsets.size() * sizeof(uint64_t), 8);
+    place(Section::Outputs, outputs.size() * sizeof(NodeIndex), 8);
+    place(Section::Attributes, attributes.size() * sizeof(details::GraphFileAttribute), 8);
+    place(Section::Tensors, encoder.tensors.size() * sizeof(details::GraphFileTensor), 8);
+    place(Section::Blob, encoder.blob.size(), 8);
+    place(Section::Data, encoder.dataSize, GraphFileAlignment);
+    header.fileSize = __align(offset, GraphFileAlignment);
+
+    SectionWriter writer(stream);
+    const auto section = [&](Section section) { return header.sections[__section_index(section)].offset; };
+    writer.write(0, &header, sizeof(header));
+    writer.write(section(Section::Nodes), nodes.data(), nodes.size() * sizeof(details::GraphFileNode));
+    writer.write(section(Section::InputOffsets), inputOffsets.data(), inputOffsets.size() * sizeof(uint64_t));
+    writer.write(section(Section::Inputs), inputs.data(), inputs.size() * sizeof(NodeIndex));
+    writer.write(section(Section::OutputOffsets), outputOffsets.data(), outputOffsets.size() * sizeof(uint64_t));
+    writer.write(section(Section::Outputs), outputs.data(), outputs.size() * sizeof(NodeIndex));
+    writer.write(section(Section::Attributes), attributes.data(), attributes.size() * sizeof(details::GraphFileAttribute));
+    writer.write(section(Section::Tensors), encoder.tensors.data(), encoder.tensors.size() * sizeof(details::GraphFileTensor));
+    writer.write(section(Section::Blob), encoder.blob.data(), encoder.blob.size());
+    for(size_t i = 0; i < encoder.tensors.size(); ++i)
+    {
+        writer.write(section(Section::Data) + encoder.tensors[i].offset, encoder.tensorValues[i].rawData(), encoder.tensors[i].size);
+    }
+    writer.pad(header.fileSize);
+
+    METHAN_FORCE_ASSERT(stream.good(), Methan::ExceptionType::IllegalState, "The graph file could not be written");
+}
+
+METHAN_API void Methan::saveGraph(const Graph& graph, const std::string& path)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if(!stream.is_open()) METHAN_THROW_EXCEPTION("Cannot open the graph file " + path + " for writing", Methan::ExceptionType::IllegalArgument);
+    saveGraph(graph, stream);
+}
+
+METHAN_API Methan::GraphFile Methan::GraphFile::open(const std::string& path)
+{
+#if defined(METHAN_OS_UNIX_LIKE)
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(file < 0) METHAN_THROW_EXCEPTION("Cannot open the graph file " + path, Methan::ExceptionType::IllegalArgument);
+
+    struct stat status;
+    const bool sized = fstat(file, &status) == 0 && static_cast<uint64_t>(status.st_size) >= sizeof(details::GraphFileHeader) && status.st_size % GraphFileAlignment == 0;
+    void* data = sized ? mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0) : MAP_FAILED;
+    ::close(file);
+    if(!sized) METHAN_THROW_EXCEPTION("The file " + path + " is not a graph file (invalid size)", Methan::ExceptionType::IllegalArgument);
+    if(data == MAP_FAILED) METHAN_THROW_EXCEPTION("Cannot map the graph file " + path, Methan::ExceptionType::IllegalArgument);
+
+    const std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>(data, static_cast<size_t>(status.st_size));
+    return GraphFile(std::make_shared<Buffer>(data, mapping->size, mapping));
+#else
+    // Without memory mapping, the file is read in a buffer
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if(!stream.is_open()) METHAN_THROW_EXCEPTION("Cannot open the graph file " + path, Methan::ExceptionType::IllegalArgument);
+
+    const uint64_t size = static_cast<uint64_t>(stream.tellg());
+    if(size < sizeof(details::GraphFileHeader) || size % GraphFileAlignment != 0) METHAN_THROW_EXCEPTION("The file " + path + " is not a graph file (invalid size)", Methan::ExceptionType::IllegalArgument);
+
+    std::shared_ptr<Buffer> image = std::make_shared<Buffer>(static_cast<size_t>(size));
+    stream.seekg(0);
+    stream.read(static_cast<char*>(image->data()), static_cast<std::streamsize>(size));
+    if(!stream) METHAN_THROW_EXCEPTION("Cannot read the graph file " + path, Methan::ExceptionType::IllegalArgument);
+    return GraphFile(std::move(image));
+#endif
+}
+
+METHAN_API Methan::GraphFile::GraphFile(std::shared_ptr<Buffer> image)
+: m_image(std::move(image))
+{
+    typedef details::GraphFileSection Section;
+
+    METHAN_FORCE_ASSERT(m_image != nullptr, Methan::ExceptionType::NullPointer, "A graph file cannot be read from a null image");
+    const uint64_t size = m_image->size();
+    METHAN_FORCE_ASSERT(size >= sizeof(details::GraphFileHeader), Methan::ExceptionType::IllegalArgument, "Invalid graph file: too small for its header");
+
+    m_header = static_cast<const details::GraphFileHeader*>(m_image->data());
+    METHAN_FORCE_ASSERT(std::memcmp(m_header->magic, __magic, sizeof(__magic)) == 0, Methan::ExceptionType::IllegalArgument, "Invalid graph file: bad magic number");
+    METHAN_FORCE_ASSERT_FORMAT(m_header->version <= GraphFileVersion, Methan::ExceptionType::IllegalArgument, "Unsupported graph file: version {} is newer than {}", m_header->version, GraphFileVersion);
+    METHAN_FORCE_ASSERT(m_header->byteOrder == __byte_order, Methan::ExceptionType::IllegalArgument, "Unsupported graph file: written with another byte order");
+    METHAN_FORCE_ASSERT_FORMAT(m_header->fileSize <= size, Methan::ExceptionType::IllegalArgument, "Invalid graph file: truncated to {} bytes out of {}", size, m_header->fileSize);
+
+    // Every section lies in the file and has the size of its records
+    const uint64_t nodeCount = m_header->nodeCount;
+    const uint64_t expected[] = {
+        nodeCount * sizeof(details::GraphFileNode),
+        (nodeCount + 1) * sizeof(uint64_t),
+        m_header->edgeCount * sizeof(NodeIndex),
+        (nodeCount + 1) * sizeof(uint64_t),
+        m_header->edgeCount * sizeof(NodeIndex),
+        m_header->attributeCount * sizeof(details::GraphFileAttribute),
+        m_header->tensorCount * sizeof(details::GraphFileTensor)
+    };
+    for(size_t i = 0; i < static_cast<size_t>(Section::Count); ++i)
+    {
+        const details::GraphFileHeader::Section& section = m_header->sections[i];
+        const uint64_t alignment = i == __section_index(Section::Data) ? GraphFileAlignment : 8;
+        METHAN_FORCE_ASSERT_FORMAT(section.offset % alignment == 0 && section.offset <= m_header->fileSize && section.size <= m_header->fileSize - section.offset, Methan::ExceptionType::IllegalArgument, "Invalid graph file: section {} is out of the file", i);
+        METHAN_FORCE_ASSERT_FORMAT(i >= sizeof(expected) / sizeof(expected[0]) || section.size == expected[i], Methan::ExceptionType::IllegalArgument, "Invalid graph file: section {} does not match the counts", i);
+    }
+
+    m_nodes = reinterpret_cast<const details::GraphFileNode*>(__section(Section::Nodes));
+    m_inputOffsets = reinterpret_cast<const uint64_t*>(__section(Section::InputOffsets));
+    m_inputs = reinterpret_cast<const NodeIndex*>(__section(Section::Inputs));
+    m_outputOffsets = reinterpret_cast<const uint64_t*>(__section(Section::OutputOffsets));
+    m_outputs = reinterpret_cast<const NodeIndex*>(__section(Section::Outputs));
+    m_attributes = reinterpret_cast<const details::GraphFileAttribute*>(__section(Section::Attributes));
+    m_tensors = reinterpret_cast<const details::GraphFileTensor*>(__section(Section::Tensors));
+
+    METHAN_FORCE_ASSERT(m_inputOffsets[0] == 0 && m_inputOffsets[nodeCount] == m_header->edgeCount && m_outputOffsets[0] == 0 && m_outputOffsets[nodeCount] == m_header->edgeCount, Methan::ExceptionType::IllegalArgument, "Invalid graph file: the adjacency tables do not match the edge count");
+}
+
+METHAN_API Methan::Varient Methan::GraphFile::payload(NodeIndex node) const
+{
+    METHAN_FORCE_ASSERT_INDEX(node, nodeCount());
+    return __decode(m_nodes[node].payload);
+}
+
+METHAN_API Methan::Varient Methan::GraphFile::attribute(NodeIndex node, AttributeKey key) const
+{
+    METHAN_FORCE_ASSERT_INDEX(node, nodeCount());
+    const details::GraphFileNode& record = m_nodes[node];
+    METHAN_FORCE_ASSERT(static_cast<uint64_t>(record.attributeBegin) + record.attributeCount <= m_header->attributeCount, Methan::ExceptionType::IllegalArgument, "Invalid graph file: the attributes of a node are out of the table");
+
+    for(uint32_t i = 0; i < record.attributeCount; ++i)
+    {
+        const details::GraphFileAttribute& attribute = m_attributes[record.attributeBegin + i];
+        if(attribute.key == key) return __decode(attribute.value);
+    }
+    return nullptr;
+}
+
+METHAN_API Methan::Tensor Methan::GraphFile::tensor(size_t index) const
+{
+    METHAN_FORCE_ASSERT_INDEX(index, tensorCount());
+    const details::GraphFileTensor& record = m_tensors[index];
+    METHAN_FORCE_ASSERT(record.rank <= Shape::MaxRank, Methan::ExceptionType::IllegalArgument, "Invalid graph file: a tensor has too many dimensions");
+
+    const Shape shape(Span<const int64_t>(record.shape, record.rank));
+    const details::GraphFileHeader::Section& data = m_header->sections[__section_index(details::GraphFileSection::Data)];
+    METHAN_FORCE_ASSERT(record.offset % GraphFileAlignment == 0 && record.offset <= data.size && record.size <= data.size - record.offset, Methan::ExceptionType::IllegalArgument, "Invalid graph file: a tensor is out of the data section");
+    METHAN_FORCE_ASSERT(static_cast<uint64_t>(shape.elementCount()) * sizeOf(record.dtype) == record.size, Methan::ExceptionType::IllegalArgument, "Invalid graph file: the size of a tensor does not match its shape");
+
+    return Tensor(m_image, static_cast<size_t>(data.offset + record.offset), record.dtype, shape);
+}
+
+METHAN_API Methan::Graph Methan::GraphFile::toGraph(std::pmr::memory_resource* resource) const
+{
+    const NodeIndex count = static_cast<NodeIndex>(nodeCount());
+    Graph graph(resource);
+    graph.reserve(count, edgeCount());
+
+    for(NodeIndex node = 0; node < count; ++node)
+    {
+        graph.addNode(op(node), {}, payload(node));
+
+        // The attributes are listed from the last set, set them back in their original order
+        const details::GraphFileNode& record = m_nodes[node];
+        METHAN_FORCE_ASSERT(static_cast<uint64_t>(record.attributeBegin) + record.attributeCount <= m_header->attributeCount, Methan::ExceptionType::IllegalArgument, "Invalid graph file: the attributes of a node are out of the table");
+        for(uint32_t i = record.attributeCount; i > 0; --i)
+        {
+            const details::GraphFileAttribute& attribute = m_attributes[record.attributeBegin + i - 1];
+            graph.setAttribute(Graph::handle(node), attribute.key, __decode(attribute.value));
+        }
+    }
+
+    // Edges grouped by target, which keeps the inputs of every node in order
+    for(NodeIndex node = 0; node < count; ++node)
+    {
+        METHAN_FORCE_ASSERT(m_inputOffsets[node] <= m_inputOffsets[node + 1] && m_inputOffsets[node + 1] <= m_header->edgeCount, Methan::ExceptionType::IllegalArgument, "Invalid graph file: the input offsets are not sorted");
+        for(NodeIndex input : inputs(node))
+        {
+            METHAN_FORCE_ASSERT_INDEX(input, count);
+            graph.addEdge(Graph::handle(input), Graph::handle(node));
+        }
+    }
+
+    return graph;
+}
+
+Methan::Varient Methan::GraphFile::__decode(const details::GraphFileValue& value) const
+{
+    typedef details::GraphFileValue::Kind Kind;
+
+    // Records of the blob, checked to lie in it
+    const details::GraphFileHeader::Section& blob = m_header->sections[__section_index(details::GraphFileSection::Blob)];
+    const auto record = [&](uint64_t size) {
+        METHAN_FORCE_ASSERT(value.data % 8 == 0 && value.data <= blob.size && size <= blob.size - value.data, Methan::ExceptionType::IllegalArgument, "Invalid graph file: a value is out of the blob");
+        return __section(details::GraphFileSection::Blob) + value.data;
+    };
+
+    switch(value.kind)
+    {
+    case Kind::Empty:
+        return nullptr;
+    case Kind::Bool:
+        return value.data != 0;
+    case Kind::Int:
+        return __decode_integer<int>(value.data);
+    case Kind::UnsignedInt:
+        return __decode_integer<unsigned int>(value.data);
+    case Kind::Long:
+        return __decode_integer<long>(value.data);
+    case Kind::UnsignedLong:
+        return __decode_integer<unsigned long>(value.data);
+    case Kind::LongLong:
+        return __decode_integer<long long>(value.data);
+    case Kind::UnsignedLongLong:
+        return __decode_integer<unsigned long long>(value.data);
+    case Kind::Float32:
+    {
+        const uint32_t bits = static_cast<uint32_t>(value.data);
+        float real;
+        std::memcpy(&real, &bits, sizeof(real));
+        return real;
+    }
+    case Kind::Float64:
+    {
+        double real;
+        std::memcpy(&real, &value.data, sizeof(real));
+        return real;
+    }
+    case Kind::String:
+    {
+        const unsigned char* text = record(value.size);
+        return std::string(reinterpret_cast<const char*>(text), static_cast<size_t>(value.size));
+    }
+    case Kind::Tensor:
+        return tensor(static_cast<size_t>(value.data));
+    case Kind::Elementwise:
+    {
+        ElementwiseRecord decoded;
+        std::memcpy(&decoded, record(sizeof(decoded)), sizeof(decoded));
+        return ElementwisePayload{ decoded.op, ElementwiseParams{ decoded.lower, decoded.upper } };
+    }
+    case Kind::FusedElementwise:
+    {
+        METHAN_FORCE_ASSERT(value.size <= blob.size / sizeof(InstructionRecord), Methan::ExceptionType::IllegalArgument, "Invalid graph file: a value is out of the blob");
+        const unsigned char* records = record(value.size * sizeof(InstructionRecord));
+        FusedElementwisePayload payload;
+        payload.program.resize(static_cast<size_t>(value.size));
+        for(size_t i = 0; i < payload.program.size(); ++i)
+        {
+            InstructionRecord decoded;
+            std::memcpy(&decoded, records + i * sizeof(decoded), sizeof(decoded));
+            payload.program[i] = ElementwiseInstruction{ decoded.op, ElementwiseParams{ decoded.lower, decoded.upper }, { decoded.operands[0], decoded.operands[1], decoded.operands[2] } };
+        }
+        return payload;
+    }
+    case Kind::MatMul:
+    {
+        MatMulRecord decoded;
+        std::memcpy(&decoded, record(sizeof(decoded)), sizeof(decoded));
+        MatMulPayload payload;
+        payload.alpha = decoded.alpha;
+        payload.transposeA = decoded.transposeA != 0;
+        payload.transposeB = decoded.transposeB != 0;
+        return payload;
+    }
+    }
+    METHAN_THROW_EXCEPTION_FORMAT("Invalid graph file: unknown kind of value {}", Methan::ExceptionType::IllegalArgument, static_cast<uint32_t>(value.kind));
+}
+
+const unsigned char* Methan::GraphFile::__section(details::GraphFileSection section) const noexcept
+{
+    return static_cast<const unsigned char*>(m_image->data()) + m_header->sections[__section_index(section)].offset;
+}
+
+METHAN_API Methan::Graph Methan::loadGraph(const std::string& path, std::pmr::memory_resource* resource)
+{
+    return GraphFile::open(path).toGraph(resource);
+}
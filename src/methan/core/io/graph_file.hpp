@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
+#include <string>
+
+#include <methan/core/except.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/tensor/tensor.hpp>
+#include <methan/utility/assertion.hpp>
+#include <methan/utility/span.hpp>
+#include <methan/utility/varient.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Version of the graph files written by saveGraph. Files of a later version are rejected.
+     */
+    constexpr uint32_t GraphFileVersion = 1;
+
+    /**
+     * @brief Alignment (in bytes) of the tensors within a graph file, and of the size of the file
+     */
+    constexpr size_t GraphFileAlignment = 64;
+
+    namespace details {
+
+        /**
+         * @brief Layout of a graph file. Every record is in the byte order of the host (files of the
+         * other byte order are rejected) and every section starts on 8 bytes, the `Data` section on
+         * GraphFileAlignment bytes:
+         *
+         * - `Nodes`: a GraphFileNode per node
+         * - `InputOffsets`, `Inputs`: CSR table of the inputs of the nodes (uint64_t offsets, NodeIndex)
+         * - `OutputOffsets`, `Outputs`: CSR table of the outputs of the nodes
+         * - `Attributes`: the GraphFileAttribute of the nodes, those of a node are contiguous
+         * - `Tensors`: a GraphFileTensor per tensor
+         * - `Blob`: strings and payload records, each on 8 bytes
+         * - `Data`: the elements of the tensors (contiguous, row-major), each on GraphFileAlignment bytes
+         */
+        enum class GraphFileSection : uint32_t
+        {
+            Nodes,
+            InputOffsets,
+            Inputs,
+            OutputOffsets,
+            Outputs,
+            Attributes,
+            Tensors,
+            Blob,
+            Data,
+            Count
+        };
+
+        /**
+         * @brief Encoded Varient. Scalars are stored in `data`; strings and payload records are `size`
+         * bytes (instructions for a program) at offset `data` of the blob; tensors are the tensor `data`.
+         * Each integer type has its own kind so that a value is read back with the type it was written with.
+         */
+        struct GraphFileValue
+        {
+            enum class Kind : uint32_t
+            {
+                Empty,
+                Bool,
+                Int,
+                UnsignedInt,
+                Long,
+                UnsignedLong,
+                LongLong,
+                UnsignedLongLong,
+                Float32,
+                Float64,
+                String,
+                Tensor,
+                Elementwise,
+                FusedElementwise,
+                MatMul
+            };
+
+            Kind kind;
+            uint32_t reserved;
+            uint64_t data;
+            uint64_t size;
+        };
+
+        struct GraphFileNode
+        {
+            OpCode op;
+            uint32_t attributeBegin;
+            uint32_t attributeCount;
+            uint32_t reserved;
+            GraphFileValue payload;
+        };
+
+        struct GraphFileAttribute
+        {
+            AttributeKey key;
+            uint32_t reserved;
+            GraphFileValue value;
+        };
+
+        struct GraphFileTensor
+        {
+            DataType dtype;
+            uint8_t rank;
+            uint8_t reserved[6];
+            int64_t shape[Shape::MaxRank];
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct GraphFileHeader
+        {
+            struct Section
+            {
+                uint64_t offset;
+                uint64_t size;
+            };
+
+            char magic[8];
+            uint32_t version;
+            uint32_t byteOrder;
+            uint64_t fileSize;
+            uint64_t edgeCount;
+            uint32_t nodeCount;
+            uint32_t attributeCount;
+            uint32_t tensorCount;
+            uint32_t reserved;
+            Section sections[static_cast<size_t>(GraphFileSection::Count)];
+        };
+
+    }
+
+    /**
+     * @brief Write the graph in the binary format read by GraphFile. The payloads and attributes must be
+     * empty, booleans, `int`, `long` or `long long` (signed or not), floating point numbers, strings, Tensors
+     * or the payloads of the Evaluator (ElementwisePayload, FusedElementwisePayload, MatMulPayload); an
+     * `IllegalArgument` exception is raised otherwise (e.g. for a CustomOperation or a `short`). The tensors
+     * are written contiguous.
+     */
+    METHAN_API void saveGraph(const Graph& graph, std::ostream& stream);
+    METHAN_API void saveGraph(const Graph& graph, const std::string& path);
+
+    /**
+     * @brief Graph written by saveGraph, used in place: the file is mapped in memory (copy-on-write, so the
+     * processes mapping the same file share its pages) and the tables and tensors are read from the
+     * mapping, without parsing nor copying. Opening a file only checks its header.
+     *
+     * The tensors of the file (`tensor`, and the Tensor payloads and attributes) are views of the mapping,
+     * which stays alive as long as any of them does.
+     */
+    class GraphFile
+    {
+    public:
+        /**
+         * @brief Map the file at `path`. An `IllegalArgument` exception is raised if the file cannot be
+         * read or is not a valid graph file.
+         */
+        METHAN_API static GraphFile open(const std::string& path);
+
+        /**
+         * @brief Use an image of a graph file already in memory, shared not copied
+         */
+        METHAN_API explicit GraphFile(std::shared_ptr<Buffer> image);
+
+        inline size_t nodeCount() const noexcept
+        {
+            return m_header->nodeCount;
+        }
+
+        inline size_t edgeCount() const noexcept
+        {
+            return m_header->edgeCount;
+        }
+
+        inline size_t tensorCount() const noexcept
+        {
+            return m_header->tensorCount;
+        }
+
+        inline OpCode op(NodeIndex node) const
+        {
+            METHAN_ASSERT_INDEX(node, nodeCount());
+            return m_nodes[node].op;
+        }
+
+        inline Span<const NodeIndex> inputs(NodeIndex node) const
+        {
+            METHAN_ASSERT_INDEX(node, nodeCount());
+            return Span<const NodeIndex>(m_inputs + m_inputOffsets[node], m_inputOffsets[node + 1] - m_inputOffsets[node]);
+        }
+
+        inline Span<const NodeIndex> outputs(NodeIndex node) const
+        {
+            METHAN_ASSERT_INDEX(node, nodeCount());
+            return Span<const NodeIndex>(m_outputs + m_outputOffsets[node], m_outputOffsets[node + 1] - m_outputOffsets[node]);
+        }
+
+        /**
+         * @brief Decode the payload of a node, a Tensor payload is a view of the file
+         */
+        METHAN_API Varient payload(NodeIndex node) const;
+
+        /**
+         * @brief Decode an attribute of a node, empty if the node has no such attribute
+         */
+        METHAN_API Varient attribute(NodeIndex node, AttributeKey key) const;
+
+        /**
+         * @brief View of a tensor of the file
+         */
+        METHAN_API Tensor tensor(size_t index) const;
+
+        /**
+         * @brief Build a Graph with the nodes, edges, payloads and attributes of the file. The tables of the
+         * graph are copied, its tensors are views of the file.
+         */
+        METHAN_API Graph toGraph(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+        /**
+         * @brief The image of the file
+         */
+        inline const std::shared_ptr<Buffer>& image() const noexcept
+        {
+            return m_image;
+        }
+
+    private:
+        Varient __decode(const details::GraphFileValue& value) const;
+        const unsigned char* __section(details::GraphFileSection section) const noexcept;
+
+        std::shared_ptr<Buffer> m_image;
+        const details::GraphFileHeader* m_header;
+        const details::GraphFileNode* m_nodes;
+        const uint64_t* m_inputOffsets;
+        const NodeIndex* m_inputs;
+        const uint64_t* m_outputOffsets;
+        const NodeIndex* m_outputs;
+        const details::GraphFileAttribute* m_attributes;
+        const details::GraphFileTensor* m_tensors;
+    };
+
+    /**
+     * @brief Map a graph file and build its Graph, see GraphFile::toGraph
+     */
+    METHAN_API Graph loadGraph(const std::string& path, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+}
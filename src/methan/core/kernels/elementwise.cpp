@@ -0,0 +1,462 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <methan/core/cpu.hpp>
+#include <methan/core/kernels/elementwise.hpp>
+#include <methan/private/kernels/elementwise_isa.hpp>
+#include <methan/utility/arena.hpp>
+
+namespace {
+
+    Methan::details::ElementwiseType __kernel_type(Methan::DataType type)
+    {
+        switch(type)
+        {
+        case Methan::DataType::Float16: return Methan::details::ElementwiseType::Float16;
+        case Methan::DataType::Float32: return Methan::details::ElementwiseType::Float32;
+        case Methan::DataType::Float64: return Methan::details::ElementwiseType::Float64;
+        default: break;
+        }
+        METHAN_THROW_EXCEPTION("Elementwise kernels are not implemented for " + Methan::to_string(type), Methan::ExceptionType::IllegalArgument);
+    }
+
+    inline float __load(const Methan::Half* pointer) { return Methan::toFloat(*pointer); }
+    inline float __load(const float* pointer) { return *pointer; }
+    inline double __load(const double* pointer) { return *pointer; }
+
+    inline void __store(Methan::Half* pointer, float value) { *pointer = Methan::toHalf(value); }
+    inline void __store(float* pointer, float value) { *pointer = value; }
+    inline void __store(double* pointer, double value) { *pointer = value; }
+
+    template<typename Storage, size_t Arity, typename Function>
+    inline void __scalar_map(const Methan::details::ElementwiseKernelArgs& args, size_t begin, Function&& function)
+    {
+        const Storage* a = static_cast<const Storage*>(args.inputs[0]);
+        const Storage* b = static_cast<const Storage*>(args.inputs[1]);
+        const Storage* c = static_cast<const Storage*>(args.inputs[2]);
+        Storage* out = static_cast<Storage*>(args.output);
+
+        for(size_t i = begin; i < args.count; ++i)
+        {
+            if constexpr(Arity == 1) __store(out + i, function(__load(a + i)));
+            else if constexpr(Arity == 2) __store(out + i, function(__load(a + i), __load(b + i)));
+            else __store(out + i, function(__load(a + i), __load(b + i), __load(c + i)));
+        }
+    }
+
+    /**
+     * @brief Reference implementation, process the elements [begin, count)
+     */
+    template<typename Storage>
+    void __scalar_elementwise(Methan::ElementwiseOp op, const Methan::details::ElementwiseKernelArgs& args, size_t begin)
+    {
+        typedef decltype(__load(static_cast<const Storage*>(nullptr))) T;
+
+        switch(op)
+        {
+        case Methan::ElementwiseOp::Add:
+            __scalar_map<Storage, 2>(args, begin, [](T a, T b) { return a + b; });
+            break;
+        case Methan::ElementwiseOp::Sub:
+            __scalar_map<Storage, 2>(args, begin, [](T a, T b) { return a - b; });
+            break;
+        case Methan::ElementwiseOp::Mul:
+            __scalar_map<Storage, 2>(args, begin, [](T a, T b) { return a * b; });
+            break;
+        case Methan::ElementwiseOp::Div:
+            __scalar_map<Storage, 2>(args, begin, [](T a, T b) { return a / b; });
+            break;
+        case Methan::ElementwiseOp::Fma:
+            __scalar_map<Storage, 3>(args, begin, [](T a, T b, T c) { return a * b + c; });
+            break;
+        case Methan::ElementwiseOp::Exp:
+            __scalar_map<Storage, 1>(args, begin, [](T a) { return std::exp(a); });
+            break;
+        case Methan::ElementwiseOp::Tanh:
+            __scalar_map<Storage, 1>(args, begin, [](T a) { return std::tanh(a); });
+            break;
+        case Methan::ElementwiseOp::Relu:
+            // Written so that NaN is propagated, as the vector kernels do
+            __scalar_map<Storage, 1>(args, begin, [](T a) { return a < T(0) ? T(0) : a; });
+            break;
+        case Methan::ElementwiseOp::Sigmoid:
+            __scalar_map<Storage, 1>(args, begin, [](T a) { return T(1) / (T(1) + std::exp(-a)); });
+            break;
+        case Methan::ElementwiseOp::Clamp:
+        {
+            const T lower = static_cast<T>(args.lower);
+            const T upper = static_cast<T>(args.upper);
+            __scalar_map<Storage, 1>(args, begin, [lower, upper](T a) { return a < lower ? lower : (a > upper ? upper : a); });
+            break;
+        }
+        }
+    }
+
+    void __scalar_elementwise(Methan::ElementwiseOp op, Methan::details::ElementwiseType type, const Methan::details::ElementwiseKernelArgs& args, size_t begin)
+    {
+        switch(type)
+        {
+        case Methan::details::ElementwiseType::Float16: __scalar_elementwise<Methan::Half>(op, args, begin); break;
+        case Methan::details::ElementwiseType::Float32: __scalar_elementwise<float>(op, args, begin); break;
+        case Methan::details::ElementwiseType::Float64: __scalar_elementwise<double>(op, args, begin); break;
+        }
+    }
+
+    size_t __elementwise_scalar(Methan::ElementwiseOp op, Methan::details::ElementwiseType type, const Methan::details::ElementwiseKernelArgs& args)
+    {
+        __scalar_elementwise(op, type, args, 0);
+        return args.count;
+    }
+
+    constexpr Methan::Dispatch<Methan::details::ElementwiseKernel> __elementwise_kernels = {
+        &__elementwise_scalar,
+#if defined(METHAN_SUPPORT_SSE2)
+        &Methan::details::elementwiseSSE2,
+#else
+        nullptr,
+#endif
+#if defined(METHAN_DISPATCH_AVX2)
+        &Methan::details::elementwiseAVX2,
+#else
+        nullptr,
+#endif
+#if defined(METHAN_DISPATCH_AVX512)
+        &Methan::details::elementwiseAVX512
+#else
+        nullptr
+#endif
+    };
+
+    /**
+     * @brief Apply the operation with the kernels of the current instruction set, the arguments are valid
+     */
+    inline void __run_kernel(Methan::ElementwiseOp op, Methan::details::ElementwiseType type, const Methan::details::ElementwiseKernelArgs& args)
+    {
+        const size_t processed = __elementwise_kernels()(op, type, args);
+        if(processed < args.count) __scalar_elementwise(op, type, args, processed);
+    }
+
+    /**
+     * @brief Broadcast shape of the given shapes (dimensions aligned on the right)
+     */
+    Methan::Shape __broadcast_shape(const Methan::Shape* const* shapes, size_t count)
+    {
+        size_t rank = 0;
+        for(size_t i = 0; i < count; ++i) rank = shapes[i]->rank() > rank ? shapes[i]->rank() : rank;
+
+        std::array<int64_t, Methan::Shape::MaxRank> dims{};
+        for(size_t axis = 0; axis < rank; ++axis)
+        {
+            int64_t dim = 1;
+            for(size_t i = 0; i < count; ++i)
+            {
+                const Methan::Shape& shape = *shapes[i];
+                const size_t shift = rank - shape.rank();
+                if(axis < shift || shape[axis - shift] == 1) continue;
+                METHAN_FORCE_ASSERT(dim == 1 || dim == shape[axis - shift], Methan::ExceptionType::IllegalArgument, "Cannot broadcast a dimension of size " + std::to_string(shape[axis - shift]) + " with " + std::to_string(dim));
+                dim = shape[axis - shift];
+            }
+            dims[axis] = dim;
+        }
+        return Methan::Shape(Methan::Span<const int64_t>(dims.data(), rank));
+    }
+
+    Methan::Shape __broadcast_shape(Methan::Span<const Methan::Tensor> inputs)
+    {
+        const Methan::Shape* shapes[3] = { nullptr, nullptr, nullptr };
+        for(size_t i = 0; i < inputs.size(); ++i) shapes[i] = &inputs[i].shape();
+        return __broadcast_shape(shapes, inputs.size());
+    }
+
+    // Size (in bytes) of the blocks of a fused program, a few of them fit in the L1 cache
+    constexpr size_t __fused_block_size = 4096;
+
+    /**
+     * @brief Input of a fused program: contiguous elements, either of the shape of the result or repeated
+     * every `period` elements (an input broadcast along the leading dimensions of the result)
+     */
+    struct FusedInput
+    {
+        Methan::Tensor tensor;
+        const uint8_t* data;
+        size_t period;
+        uint8_t* block;
+    };
+
+    /**
+     * @brief Whether the input broadcast to `shape` is its contiguous elements repeated
+     */
+    bool __is_periodic(const Methan::Tensor& input, const Methan::Shape& shape)
+    {
+        if(!input.isContiguous() || input.rank() > shape.rank()) return false;
+
+        size_t axis = 0;
+        while(axis < input.rank() && input.dim(axis) == 1) ++axis;
+
+        const size_t shift = shape.rank() - input.rank();
+        for(; axis < input.rank(); ++axis)
+        {
+            if(input.dim(axis) != shape[axis + shift]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Elements [begin, begin + count) of a periodic input, copied to its block unless they are contiguous
+     */
+    const void* __periodic_elements(const FusedInput& input, size_t elementSize, size_t begin, size_t count)
+    {
+        const size_t offset = begin % input.period;
+        if(offset + count <= input.period) return input.data + offset * elementSize;
+
+        // First period, then the block is doubled (the elements filled so far are a whole number of periods)
+        size_t filled = std::min(count, input.period);
+        const size_t head = std::min(filled, input.period - offset);
+        std::memcpy(input.block, input.data + offset * elementSize, head * elementSize);
+        std::memcpy(input.block + head * elementSize, input.data, (filled - head) * elementSize);
+        while(filled < count)
+        {
+            const size_t chunk = std::min(filled, count - filled);
+            std::memcpy(input.block + filled * elementSize, input.block, chunk * elementSize);
+            filled += chunk;
+        }
+        return input.block;
+    }
+
+    /**
+     * @brief Validate the program and return the shape of every value, the inputs followed by the results
+     * of the instructions
+     */
+    std::vector<Methan::Shape> __program_shapes(Methan::Span<const Methan::ElementwiseInstruction> program, Methan::Span<const Methan::Tensor> inputs)
+    {
+        METHAN_FORCE_ASSERT(!program.empty() && !inputs.empty(), Methan::ExceptionType::IllegalArgument, "An elementwise program needs at least one instruction and one input");
+        const Methan::DataType type = inputs[0].dtype();
+        __kernel_type(type);
+        for(size_t i = 1; i < inputs.size(); ++i) METHAN_FORCE_ASSERT(inputs[i].dtype() == type, Methan::ExceptionType::IllegalArgument, "Cannot compute an elementwise program of " + Methan::to_string(type) + " and " + Methan::to_string(inputs[i].dtype()));
+
+        const size_t inputCount = inputs.size();
+        std::vector<Methan::Shape> shapes(inputCount + program.size());
+        for(size_t i = 0; i < inputCount; ++i) shapes[i] = inputs[i].shape();
+        for(size_t j = 0; j < program.size(); ++j)
+        {
+            const Methan::ElementwiseInstruction& instruction = program[j];
+            METHAN_FORCE_ASSERT(instruction.op != Methan::ElementwiseOp::Clamp || instruction.params.lower <= instruction.params.upper, Methan::ExceptionType::IllegalArgument, "The lower bound of Clamp must not exceed the upper bound");
+
+            const Methan::Shape* operands[3] = { nullptr, nullptr, nullptr };
+            for(size_t o = 0; o < Methan::arity(instruction.op); ++o)
+            {
+                METHAN_FORCE_ASSERT(instruction.operands[o] < inputCount + j, Methan::ExceptionType::IllegalArgument, "The operand " + std::to_string(instruction.operands[o]) + " of the instruction " + std::to_string(j) + " is not defined");
+                operands[o] = &shapes[instruction.operands[o]];
+            }
+            shapes[inputCount + j] = __broadcast_shape(operands, Methan::arity(instruction.op));
+        }
+        return shapes;
+    }
+
+}
+
+METHAN_API std::string Methan::to_string(ElementwiseOp op)
+{
+    switch(op)
+    {
+    case ElementwiseOp::Add: return "Add";
+    case ElementwiseOp::Sub: return "Sub";
+    case ElementwiseOp::Mul: return "Mul";
+    case ElementwiseOp::Div: return "Div";
+    case ElementwiseOp::Fma: return "Fma";
+    case ElementwiseOp::Exp: return "Exp";
+    case ElementwiseOp::Tanh: return "Tanh";
+    case ElementwiseOp::Relu: return "Relu";
+    case ElementwiseOp::Sigmoid: return "Sigmoid";
+    case ElementwiseOp::Clamp: return "Clamp";
+    }
+    return "Unknown";
+}
+
+METHAN_API void Methan::elementwise(ElementwiseOp op, DataType type, size_t count, Span<const void* const> inputs, void* output, const ElementwiseParams& params)
+{
+    const details::ElementwiseType kernelType = __kernel_type(type);
+    METHAN_FORCE_ASSERT(inputs.size() == arity(op), Methan::ExceptionType::IllegalArgument, to_string(op) + " expects " + std::to_string(arity(op)) + " inputs, got " + std::to_string(inputs.size()));
+    METHAN_FORCE_ASSERT(op != ElementwiseOp::Clamp || params.lower <= params.upper, Methan::ExceptionType::IllegalArgument, "The lower bound of Clamp must not exceed the upper bound");
+    if(count == 0) return;
+
+    details::ElementwiseKernelArgs args = { { nullptr, nullptr, nullptr }, output, count, params.lower, params.upper };
+    METHAN_ASSERT_NON_NULL(output);
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        METHAN_ASSERT_NON_NULL(inputs[i]);
+        args.inputs[i] = inputs[i];
+    }
+
+    __run_kernel(op, kernelType, args);
+}
+
+METHAN_API void Methan::elementwise(ElementwiseOp op, Span<const Tensor> inputs, Tensor& output, const ElementwiseParams& params)
+{
+    METHAN_FORCE_ASSERT(inputs.size() == arity(op), Methan::ExceptionType::IllegalArgument, to_string(op) + " expects " + std::to_string(arity(op)) + " inputs, got " + std::to_string(inputs.size()));
+    METHAN_FORCE_ASSERT(!output.isEmpty(), Methan::ExceptionType::IllegalArgument, "The output of an elementwise operation must be allocated");
+    METHAN_FORCE_ASSERT(output.isContiguous(), Methan::ExceptionType::IllegalArgument, "The output of an elementwise operation must be contiguous");
+
+    // Inputs that are views (broadcast, strided) are materialized first
+    Tensor operands[3];
+    const void* pointers[3] = { nullptr, nullptr, nullptr };
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(inputs[i].dtype() == output.dtype(), Methan::ExceptionType::IllegalArgument, "Cannot compute " + to_string(op) + " of " + to_string(inputs[i].dtype()) + " into " + to_string(output.dtype()));
+        operands[i] = inputs[i].shape() == output.shape() ? inputs[i] : inputs[i].broadcastTo(output.shape());
+        if(!operands[i].isContiguous()) operands[i] = operands[i].clone();
+        pointers[i] = operands[i].rawData();
+    }
+
+    elementwise(op, output.dtype(), static_cast<size_t>(output.elementCount()), Span<const void* const>(pointers, inputs.size()), output.rawData(), params);
+}
+
+METHAN_API Methan::Tensor Methan::elementwise(ElementwiseOp op, Span<const Tensor> inputs, const ElementwiseParams& params, std::pmr::memory_resource* resource)
+{
+    METHAN_FORCE_ASSERT(inputs.size() == arity(op), Methan::ExceptionType::IllegalArgument, to_string(op) + " expects " + std::to_string(arity(op)) + " inputs, got " + std::to_string(inputs.size()));
+
+    Tensor output(inputs[0].dtype(), __broadcast_shape(inputs), resource);
+    elementwise(op, inputs, output, params);
+    return output;
+}
+
+METHAN_API Methan::Shape Methan::broadcastShape(Span<const Shape> shapes)
+{
+    std::vector<const Shape*> pointers(shapes.size());
+    for(size_t i = 0; i < shapes.size(); ++i) pointers[i] = &shapes[i];
+    return __broadcast_shape(pointers.data(), pointers.size());
+}
+
+METHAN_API Methan::Tensor Methan::elementwise(Span<const ElementwiseInstruction> program, Span<const Tensor> inputs, std::pmr::memory_resource* resource)
+{
+    const std::vector<Shape> shapes = __program_shapes(program, inputs);
+    Tensor output(inputs[0].dtype(), shapes.back(), resource);
+    elementwise(program, inputs, output);
+    return output;
+}
+
+METHAN_API void Methan::elementwise(Span<const ElementwiseInstruction> program, Span<const Tensor> inputs, Tensor& output)
+{
+    const std::vector<Shape> shapes = __program_shapes(program, inputs);
+    const Shape& shape = shapes.back();
+    const DataType type = inputs[0].dtype();
+    const details::ElementwiseType kernelType = __kernel_type(type);
+    METHAN_FORCE_ASSERT(!output.isEmpty() && output.isContiguous(), Methan::ExceptionType::IllegalArgument, "The output of an elementwise program must be allocated and contiguous");
+    METHAN_FORCE_ASSERT(output.dtype() == type && output.shape() == shape, Methan::ExceptionType::IllegalArgument, "The output of an elementwise program does not match its result");
+
+    const size_t inputCount = inputs.size();
+    const bool blocked = std::all_of(shapes.begin() + inputCount, shapes.end(), [&shape](const Shape& value) { return value == shape; });
+    if(!blocked)
+    {
+        // Instructions of different shapes are computed one by one
+        std::vector<Tensor> values(inputs.begin(), inputs.end());
+        values.reserve(inputCount + program.size());
+        for(size_t j = 0; j < program.size(); ++j)
+        {
+            const ElementwiseInstruction& instruction = program[j];
+            Tensor operands[3];
+            for(size_t o = 0; o < arity(instruction.op); ++o) operands[o] = values[instruction.operands[o]];
+
+            const Span<const Tensor> arguments(operands, arity(instruction.op));
+            if(j + 1 == program.size()) elementwise(instruction.op, arguments, output, instruction.params);
+            else values.push_back(elementwise(instruction.op, arguments, instruction.params));
+        }
+        return;
+    }
+
+    const size_t count = static_cast<size_t>(shape.elementCount());
+    if(count == 0) return;
+
+    // The intermediate results live in blocks, a block is reused once its last reader is done. The
+    // output of an instruction may be the block of one of its operands.
+    std::vector<size_t> lastUse(program.size());
+    for(size_t j = 0; j < program.size(); ++j)
+    {
+        lastUse[j] = j;
+        for(size_t o = 0; o < arity(program[j].op); ++o)
+        {
+            if(program[j].operands[o] >= inputCount) lastUse[program[j].operands[o] - inputCount] = j;
+        }
+    }
+
+    std::vector<size_t> slots(program.size());
+    std::vector<size_t> available;
+    size_t slotCount = 0;
+    for(size_t j = 0; j + 1 < program.size(); ++j)
+    {
+        for(size_t o = 0; o < arity(program[j].op); ++o)
+        {
+            const uint32_t operand = program[j].operands[o];
+            if(operand >= inputCount && lastUse[operand - inputCount] == j)
+            {
+                // Released once, even if the instruction reads it several times
+                if(std::find(available.begin(), available.end(), slots[operand - inputCount]) == available.end()) available.push_back(slots[operand - inputCount]);
+            }
+        }
+
+        if(available.empty()) slots[j] = slotCount++;
+        else
+        {
+            slots[j] = available.back();
+            available.pop_back();
+        }
+        if(lastUse[j] == j) available.push_back(slots[j]);
+    }
+
+    // Inputs that are neither of the shape of the result nor periodic are materialized
+    const size_t elementSize = sizeOf(type);
+    const size_t blockLength = __fused_block_size / elementSize;
+    std::vector<FusedInput> sources(inputCount);
+    size_t periodicCount = 0;
+    for(size_t i = 0; i < inputCount; ++i)
+    {
+        FusedInput& source = sources[i];
+        source.tensor = inputs[i];
+        if(source.tensor.shape() == shape && source.tensor.isContiguous()) source.period = count;
+        else if(__is_periodic(source.tensor, shape)) source.period = static_cast<size_t>(source.tensor.elementCount());
+        else
+        {
+            source.tensor = source.tensor.broadcastTo(shape).clone();
+            source.period = count;
+        }
+        source.data = static_cast<const uint8_t*>(source.tensor.rawData());
+        source.block = nullptr;
+        if(source.period < count) ++periodicCount;
+    }
+
+    ArenaScope scope(scratchArena());
+    uint8_t* blocks = static_cast<uint8_t*>(scope.arena().allocate((slotCount + periodicCount) * __fused_block_size, METHAN_CACHE_LINE_SIZE));
+    uint8_t* nextBlock = blocks + slotCount * __fused_block_size;
+    for(FusedInput& source : sources)
+    {
+        if(source.period == count) continue;
+        source.block = nextBlock;
+        nextBlock += __fused_block_size;
+    }
+
+    std::vector<const void*> values(inputCount + program.size());
+    uint8_t* target = static_cast<uint8_t*>(output.rawData());
+    for(size_t begin = 0; begin < count; begin += blockLength)
+    {
+        const size_t length = std::min(blockLength, count - begin);
+        for(size_t i = 0; i < inputCount; ++i)
+        {
+            const FusedInput& source = sources[i];
+            values[i] = source.period == count ? source.data + begin * elementSize : __periodic_elements(source, elementSize, begin, length);
+        }
+
+        for(size_t j = 0; j < program.size(); ++j)
+        {
+            const ElementwiseInstruction& instruction = program[j];
+            void* result = j + 1 == program.size() ? target + begin * elementSize : blocks + slots[j] * __fused_block_size;
+
+            details::ElementwiseKernelArgs args = { { nullptr, nullptr, nullptr }, result, length, instruction.params.lower, instruction.params.upper };
+            for(size_t o = 0; o < arity(instruction.op); ++o) args.inputs[o] = values[instruction.operands[o]];
+            __run_kernel(instruction.op, kernelType, args);
+            values[inputCount + j] = result;
+        }
+    }
+}
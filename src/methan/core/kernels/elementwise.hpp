@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory_resource>
+#include <string>
+
+#include <methan/core/except.hpp>
+#include <methan/core/kernels/elementwise_op.hpp>
+#include <methan/core/tensor/dtype.hpp>
+#include <methan/core/tensor/tensor.hpp>
+#include <methan/utility/hash.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Number of inputs of the operation
+     */
+    constexpr size_t arity(ElementwiseOp op) noexcept
+    {
+        switch(op)
+        {
+        case ElementwiseOp::Add:
+        case ElementwiseOp::Sub:
+        case ElementwiseOp::Mul:
+        case ElementwiseOp::Div:
+            return 2;
+        case ElementwiseOp::Fma:
+            return 3;
+        default:
+            return 1;
+        }
+    }
+
+    METHAN_API std::string to_string(ElementwiseOp op);
+
+    /**
+     * @brief Shape of the result of an elementwise operation on tensors of the given shapes (dimensions are
+     * aligned on the right, those of size 1 are repeated). An `IllegalArgument` exception is raised if the
+     * shapes are not compatible.
+     */
+    METHAN_API Shape broadcastShape(Span<const Shape> shapes);
+
+    /**
+     * @brief Scalar parameters of the elementwise operations (bounds of `Clamp`)
+     */
+    struct ElementwiseParams
+    {
+        double lower = 0.0;
+        double upper = 0.0;
+    };
+
+    inline bool operator==(const ElementwiseParams& first, const ElementwiseParams& second) noexcept
+    {
+        return first.lower == second.lower && first.upper == second.upper;
+    }
+
+    /**
+     * @brief Instruction of a fused elementwise program. The operands index the inputs of the program
+     * (from 0 to the number of inputs - 1) followed by the results of the previous instructions, only the
+     * first `arity(op)` operands are used.
+     */
+    struct ElementwiseInstruction
+    {
+        ElementwiseOp op;
+        ElementwiseParams params;
+        uint32_t operands[3];
+    };
+
+    /**
+     * @brief Instructions are equal when they apply the same operation to the same operands, the unused
+     * operands are ignored
+     */
+    inline bool operator==(const ElementwiseInstruction& first, const ElementwiseInstruction& second) noexcept
+    {
+        if(first.op != second.op || !(first.params == second.params)) return false;
+        for(size_t i = 0; i < arity(first.op); ++i) if(first.operands[i] != second.operands[i]) return false;
+        return true;
+    }
+
+    /**
+     * @brief Apply the operation on `count` elements of contiguous buffers of the given type (Float16, Float32
+     * or Float64). The kernels of the best instruction set selected by `isaLevel()` are used, Float16 is
+     * computed in single precision. The output may be one of the inputs but must not partially overlap them.
+     *
+     * The transcendental functions are accurate to a few ulps, `Exp` saturates instead of overflowing to
+     * infinity and `Fma` is only fused when the instruction set has a fused multiply-add.
+     */
+    METHAN_API void elementwise(ElementwiseOp op, DataType type, size_t count, Span<const void* const> inputs, void* output, const ElementwiseParams& params = ElementwiseParams());
+
+    inline void elementwise(ElementwiseOp op, DataType type, size_t count, std::initializer_list<const void*> inputs, void* output, const ElementwiseParams& params = ElementwiseParams())
+    {
+        elementwise(op, type, count, Span<const void* const>(inputs.begin(), inputs.size()), output, params);
+    }
+
+    /**
+     * @brief Apply the operation on tensors. The inputs are broadcast to the shape of the output, which must
+     * be contiguous and of the same type as the inputs.
+     */
+    METHAN_API void elementwise(ElementwiseOp op, Span<const Tensor> inputs, Tensor& output, const ElementwiseParams& params = ElementwiseParams());
+
+    inline void elementwise(ElementwiseOp op, std::initializer_list<Tensor> inputs, Tensor& output, const ElementwiseParams& params = ElementwiseParams())
+    {
+        elementwise(op, Span<const Tensor>(inputs.begin(), inputs.size()), output, params);
+    }
+
+    /**
+     * @brief Apply the operation on tensors, the result has the broadcast shape of the inputs
+     */
+    METHAN_API Tensor elementwise(ElementwiseOp op, Span<const Tensor> inputs, const ElementwiseParams& params = ElementwiseParams(), std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    inline Tensor elementwise(ElementwiseOp op, std::initializer_list<Tensor> inputs, const ElementwiseParams& params = ElementwiseParams(), std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        return elementwise(op, Span<const Tensor>(inputs.begin(), inputs.size()), params, resource);
+    }
+
+    /**
+     * @brief Evaluate a program of elementwise operations on tensors of the same type, the result is the
+     * one of the last instruction. The result is identical to the one of the instructions applied one by
+     * one, but when every instruction has the shape of the result (the inputs may be broadcast) the program
+     * is computed block by block in a single pass over the data: the intermediate results of a block stay
+     * in the L1 cache and are never written to memory.
+     */
+    METHAN_API Tensor elementwise(Span<const ElementwiseInstruction> program, Span<const Tensor> inputs, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Same as above, into an allocated contiguous tensor of the type and shape of the result. The
+     * output may share its storage with an input of the same shape, but must not partially overlap any.
+     */
+    METHAN_API void elementwise(Span<const ElementwiseInstruction> program, Span<const Tensor> inputs, Tensor& output);
+
+}
+
+namespace std {
+
+    template<>
+    struct hash<Methan::ElementwiseParams>
+    {
+        inline size_t operator()(const Methan::ElementwiseParams& params) const noexcept
+        {
+            return Methan::hash_values(0, params.lower, params.upper);
+        }
+    };
+
+    template<>
+    struct hash<Methan::ElementwiseInstruction>
+    {
+        inline size_t operator()(const Methan::ElementwiseInstruction& instruction) const noexcept
+        {
+            size_t seed = Methan::hash_values(0, instruction.op, instruction.params);
+            for(size_t i = 0; i < Methan::arity(instruction.op); ++i) seed = Methan::hash_combine(seed, instruction.operands[i]);
+            return seed;
+        }
+    };
+
+}
@@ -0,0 +1,94 @@
+#include <methan/core/details/platform.hpp>
+#include <methan/private/kernels/elementwise_isa.hpp>
+
+// Compiled with -mavx2 -mfma -mf16c when METHAN_DISPATCH_AVX2 is set, see src/CMakeLists.txt
+#if defined(METHAN_SUPPORT_AVX2) && defined(METHAN_SUPPORT_AVX_FMA) && defined(METHAN_SUPPORT_AVX_F16C)
+#include <immintrin.h>
+
+namespace {
+
+    struct Avx2Float
+    {
+        typedef float Storage;
+        typedef __m256 V;
+        static constexpr size_t Width = 8;
+        static constexpr bool Double = false;
+
+        static inline V load(const float* pointer) { return _mm256_loadu_ps(pointer); }
+        static inline void store(float* pointer, V value) { _mm256_storeu_ps(pointer, value); }
+        static inline V set(double value) { return _mm256_set1_ps(static_cast<float>(value)); }
+
+        static inline V add(V a, V b) { return _mm256_add_ps(a, b); }
+        static inline V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+        static inline V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+        static inline V div(V a, V b) { return _mm256_div_ps(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+        static inline V abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+        static inline V min(V a, V b) { return _mm256_min_ps(a, b); }
+        static inline V max(V a, V b) { return _mm256_max_ps(a, b); }
+        static inline V select(V a, V b, V x, V y) { return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+        static inline V round(V a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        static inline V pow2(V n)
+        {
+            return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23));
+        }
+    };
+
+    /**
+     * @brief Half precision in memory, single precision in registers (F16C conversions)
+     */
+    struct Avx2Half : Avx2Float
+    {
+        typedef uint16_t Storage;
+
+        static inline V load(const uint16_t* pointer) { return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pointer))); }
+        static inline void store(uint16_t* pointer, V value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(pointer), _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT)); }
+    };
+
+    struct Avx2Double
+    {
+        typedef double Storage;
+        typedef __m256d V;
+        static constexpr size_t Width = 4;
+        static constexpr bool Double = true;
+
+        static inline V load(const double* pointer) { return _mm256_loadu_pd(pointer); }
+        static inline void store(double* pointer, V value) { _mm256_storeu_pd(pointer, value); }
+        static inline V set(double value) { return _mm256_set1_pd(value); }
+
+        static inline V add(V a, V b) { return _mm256_add_pd(a, b); }
+        static inline V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+        static inline V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+        static inline V div(V a, V b) { return _mm256_div_pd(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+        static inline V abs(V a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+        static inline V min(V a, V b) { return _mm256_min_pd(a, b); }
+        static inline V max(V a, V b) { return _mm256_max_pd(a, b); }
+        static inline V select(V a, V b, V x, V y) { return _mm256_blendv_pd(y, x, _mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+        static inline V round(V a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        // The biased exponent is read from the low bits of the mantissa of 2^52 + 1023 + n
+        static inline V pow2(V n)
+        {
+            const __m256i biased = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(4503599627370496.0 + 1023.0)));
+            return _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+        }
+    };
+
+#include <methan/private/kernels/elementwise_impl.inl>
+
+}
+
+size_t Methan::details::elementwiseAVX2(ElementwiseOp op, ElementwiseType type, const ElementwiseKernelArgs& args)
+{
+    switch(type)
+    {
+    case ElementwiseType::Float16: return __vector_elementwise<Avx2Half>(op, args);
+    case ElementwiseType::Float32: return __vector_elementwise<Avx2Float>(op, args);
+    case ElementwiseType::Float64: return __vector_elementwise<Avx2Double>(op, args);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include <methan/core/details/platform.hpp>
+#include <methan/private/kernels/elementwise_isa.hpp>
+
+// Compiled with -mavx512f (and the AVX2 flags) when METHAN_DISPATCH_AVX512 is set, see src/CMakeLists.txt
+#if defined(METHAN_SUPPORT_AVX512F)
+#if defined(METHAN_COMPILER_GCC)
+// GCC reports the undefined vectors used by the intrinsics themselves (_mm512_undefined_ps)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+
+namespace {
+
+    struct Avx512Float
+    {
+        typedef float Storage;
+        typedef __m512 V;
+        static constexpr size_t Width = 16;
+        static constexpr bool Double = false;
+
+        static inline V load(const float* pointer) { return _mm512_loadu_ps(pointer); }
+        static inline void store(float* pointer, V value) { _mm512_storeu_ps(pointer, value); }
+        static inline V set(double value) { return _mm512_set1_ps(static_cast<float>(value)); }
+
+        static inline V add(V a, V b) { return _mm512_add_ps(a, b); }
+        static inline V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+        static inline V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+        static inline V div(V a, V b) { return _mm512_div_ps(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+        static inline V abs(V a) { return _mm512_abs_ps(a); }
+        static inline V min(V a, V b) { return _mm512_min_ps(a, b); }
+        static inline V max(V a, V b) { return _mm512_max_ps(a, b); }
+        static inline V select(V a, V b, V x, V y) { return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), y, x); }
+        static inline V round(V a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        static inline V pow2(V n)
+        {
+            return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23));
+        }
+    };
+
+    /**
+     * @brief Half precision in memory, single precision in registers
+     */
+    struct Avx512Half : Avx512Float
+    {
+        typedef uint16_t Storage;
+
+        static inline V load(const uint16_t* pointer) { return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pointer))); }
+        static inline void store(uint16_t* pointer, V value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(pointer), _mm512_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT)); }
+    };
+
+    struct Avx512Double
+    {
+        typedef double Storage;
+        typedef __m512d V;
+        static constexpr size_t Width = 8;
+        static constexpr bool Double = true;
+
+        static inline V load(const double* pointer) { return _mm512_loadu_pd(pointer); }
+        static inline void store(double* pointer, V value) { _mm512_storeu_pd(pointer, value); }
+        static inline V set(double value) { return _mm512_set1_pd(value); }
+
+        static inline V add(V a, V b) { return _mm512_add_pd(a, b); }
+        static inline V sub(V a, V b) { return _mm512_sub_pd(a, b); }
+        static inline V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+        static inline V div(V a, V b) { return _mm512_div_pd(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+        static inline V abs(V a) { return _mm512_abs_pd(a); }
+        static inline V min(V a, V b) { return _mm512_min_pd(a, b); }
+        static inline V max(V a, V b) { return _mm512_max_pd(a, b); }
+        static inline V select(V a, V b, V x, V y) { return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, b, _CMP_LT_OQ), y, x); }
+        static inline V round(V a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        // The biased exponent is read from the low bits of the mantissa of 2^52 + 1023 + n
+        static inline V pow2(V n)
+        {
+            const __m512i biased = _mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(4503599627370496.0 + 1023.0)));
+            return _mm512_castsi512_pd(_mm512_slli_epi64(biased, 52));
+        }
+    };
+
+#include <methan/private/kernels/elementwise_impl.inl>
+
+}
+
+size_t Methan::details::elementwiseAVX512(ElementwiseOp op, ElementwiseType type, const ElementwiseKernelArgs& args)
+{
+    switch(type)
+    {
+    case ElementwiseType::Float16: return __vector_elementwise<Avx512Half>(op, args);
+    case ElementwiseType::Float32: return __vector_elementwise<Avx512Float>(op, args);
+    case ElementwiseType::Float64: return __vector_elementwise<Avx512Double>(op, args);
+    }
+    return 0;
+}
+
+#endif
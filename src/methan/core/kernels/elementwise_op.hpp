@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Methan {
+
+    /**
+     * @brief Operation of an elementwise kernel, see Methan::elementwise
+     */
+    enum class ElementwiseOp : uint32_t
+    {
+        Add,        // a + b
+        Sub,        // a - b
+        Mul,        // a * b
+        Div,        // a / b
+        Fma,        // a * b + c
+        Exp,        // exp(a)
+        Tanh,       // tanh(a)
+        Relu,       // max(a, 0)
+        Sigmoid,    // 1 / (1 + exp(-a))
+        Clamp       // min(max(a, lower), upper)
+    };
+
+}
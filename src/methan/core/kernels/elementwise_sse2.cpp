@@ -0,0 +1,101 @@
+#include <methan/core/details/platform.hpp>
+#include <methan/private/kernels/elementwise_isa.hpp>
+
+#if defined(METHAN_SUPPORT_SSE2)
+#include <emmintrin.h>
+
+namespace {
+
+    struct Sse2Float
+    {
+        typedef float Storage;
+        typedef __m128 V;
+        static constexpr size_t Width = 4;
+        static constexpr bool Double = false;
+
+        static inline V load(const float* pointer) { return _mm_loadu_ps(pointer); }
+        static inline void store(float* pointer, V value) { _mm_storeu_ps(pointer, value); }
+        static inline V set(double value) { return _mm_set1_ps(static_cast<float>(value)); }
+
+        static inline V add(V a, V b) { return _mm_add_ps(a, b); }
+        static inline V sub(V a, V b) { return _mm_sub_ps(a, b); }
+        static inline V mul(V a, V b) { return _mm_mul_ps(a, b); }
+        static inline V div(V a, V b) { return _mm_div_ps(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        static inline V abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+        static inline V min(V a, V b) { return _mm_min_ps(a, b); }
+        static inline V max(V a, V b) { return _mm_max_ps(a, b); }
+
+        static inline V select(V a, V b, V x, V y)
+        {
+            const V mask = _mm_cmplt_ps(a, b);
+            return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+        }
+
+        static inline V round(V a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+
+        static inline V pow2(V n)
+        {
+            return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23));
+        }
+    };
+
+    struct Sse2Double
+    {
+        typedef double Storage;
+        typedef __m128d V;
+        static constexpr size_t Width = 2;
+        static constexpr bool Double = true;
+
+        static inline V load(const double* pointer) { return _mm_loadu_pd(pointer); }
+        static inline void store(double* pointer, V value) { _mm_storeu_pd(pointer, value); }
+        static inline V set(double value) { return _mm_set1_pd(value); }
+
+        static inline V add(V a, V b) { return _mm_add_pd(a, b); }
+        static inline V sub(V a, V b) { return _mm_sub_pd(a, b); }
+        static inline V mul(V a, V b) { return _mm_mul_pd(a, b); }
+        static inline V div(V a, V b) { return _mm_div_pd(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+        static inline V abs(V a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+        static inline V min(V a, V b) { return _mm_min_pd(a, b); }
+        static inline V max(V a, V b) { return _mm_max_pd(a, b); }
+
+        static inline V select(V a, V b, V x, V y)
+        {
+            const V mask = _mm_cmplt_pd(a, b);
+            return _mm_or_pd(_mm_and_pd(mask, x), _mm_andnot_pd(mask, y));
+        }
+
+        // SSE2 has no rounding instruction: adding 1.5 * 2^52 rounds to the nearest integer
+        static inline V round(V a)
+        {
+            const V magic = _mm_set1_pd(6755399441055744.0);
+            return _mm_sub_pd(_mm_add_pd(a, magic), magic);
+        }
+
+        // The biased exponent is read from the low bits of the mantissa of 2^52 + 1023 + n
+        static inline V pow2(V n)
+        {
+            const __m128i biased = _mm_castpd_si128(_mm_add_pd(n, _mm_set1_pd(4503599627370496.0 + 1023.0)));
+            return _mm_castsi128_pd(_mm_slli_epi64(biased, 52));
+        }
+    };
+
+#include <methan/private/kernels/elementwise_impl.inl>
+
+}
+
+/**
+ * SSE2 has no conversion from half precision, Float16 is left to the scalar kernel
+ */
+size_t Methan::details::elementwiseSSE2(ElementwiseOp op, ElementwiseType type, const ElementwiseKernelArgs& args)
+{
+    switch(type)
+    {
+    case ElementwiseType::Float32: return __vector_elementwise<Sse2Float>(op, args);
+    case ElementwiseType::Float64: return __vector_elementwise<Sse2Double>(op, args);
+    default: return 0;
+    }
+}
+
+#endif
@@ -0,0 +1,428 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <vector>
+
+#include <methan/core/cpu.hpp>
+#include <methan/core/kernels/gemm.hpp>
+#include <methan/private/kernels/gemm_isa.hpp>
+#include <methan/utility/arena.hpp>
+
+namespace {
+
+    struct ScalarFloat
+    {
+        typedef float T;
+        typedef float V;
+        static constexpr size_t Width = 1;
+
+        static inline V zero() { return 0.0f; }
+        static inline V set(float value) { return value; }
+        static inline V broadcast(const float* pointer) { return *pointer; }
+        static inline V load(const float* pointer) { return *pointer; }
+        static inline void store(float* pointer, V value) { *pointer = value; }
+        static inline V mul(V a, V b) { return a * b; }
+        static inline V fma(V a, V b, V c) { return a * b + c; }
+    };
+
+    struct ScalarDouble
+    {
+        typedef double T;
+        typedef double V;
+        static constexpr size_t Width = 1;
+
+        static inline V zero() { return 0.0; }
+        static inline V set(double value) { return value; }
+        static inline V broadcast(const double* pointer) { return *pointer; }
+        static inline V load(const double* pointer) { return *pointer; }
+        static inline void store(double* pointer, V value) { *pointer = value; }
+        static inline V mul(V a, V b) { return a * b; }
+        static inline V fma(V a, V b, V c) { return a * b + c; }
+    };
+
+#include <methan/private/kernels/gemm_impl.inl>
+
+    Methan::details::GemmKernelInfo __gemm_kernel_scalar(Methan::details::GemmType type)
+    {
+        switch(type)
+        {
+        case Methan::details::GemmType::Float32: return { &__gemm_micro_kernel<ScalarFloat, 4, 4>, 4, 4 };
+        case Methan::details::GemmType::Float64: return { &__gemm_micro_kernel<ScalarDouble, 4, 4>, 4, 4 };
+        }
+        return { nullptr, 0, 0 };
+    }
+
+    constexpr Methan::Dispatch<Methan::details::GemmKernelQuery> __gemm_kernels = {
+        &__gemm_kernel_scalar,
+#if defined(METHAN_SUPPORT_SSE2)
+        &Methan::details::gemmKernelSSE2,
+#else
+        nullptr,
+#endif
+#if defined(METHAN_DISPATCH_AVX2)
+        &Methan::details::gemmKernelAVX2,
+#else
+        nullptr,
+#endif
+#if defined(METHAN_DISPATCH_AVX512)
+        &Methan::details::gemmKernelAVX512
+#else
+        nullptr
+#endif
+    };
+
+    // Largest tile of the micro-kernels (in elements), used for the partial tiles at the edges of C
+    constexpr size_t __max_tile = 512;
+
+    inline size_t __round_up(size_t value, size_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    inline size_t __ceil_div(size_t value, size_t divisor)
+    {
+        return (value + divisor - 1) / divisor;
+    }
+
+    template<typename T>
+    struct GemmProblem
+    {
+        size_t m, n, k;
+        T alpha, beta;
+        const T* a;
+        int64_t rowStrideA, columnStrideA;
+        const T* b;
+        int64_t rowStrideB, columnStrideB;
+        T* c;
+        int64_t rowStrideC;
+
+        Methan::details::GemmKernelInfo kernel;
+
+        // Block sizes: a KC x NR panel of B stays in L1, a MC x KC block of A in L2 and a KC x NC block of B
+        // in the last level cache
+        size_t mc, kc, nc;
+        size_t tilesM;
+
+        // The columns of a block of B are split in chunks of panels to get enough tasks for the workers
+        size_t chunkColumns;
+    };
+
+    /**
+     * @brief Block of B (KC x NC elements) shared by the tasks of an iteration of the outer loops
+     */
+    template<typename T>
+    struct GemmBlock
+    {
+        size_t jc, columns;
+        size_t pc, depth;
+        T beta;
+        T* packedB;
+        size_t chunks;
+    };
+
+    /**
+     * @brief Pack the `rows` x `depth` block of A starting at `a` in panels of MR rows, stored column by
+     * column (the micro-kernel reads MR consecutive elements per step). The last panel is padded with zeros.
+     */
+    template<typename T>
+    void __pack_a(const GemmProblem<T>& problem, const T* a, size_t rows, size_t depth, T* packed)
+    {
+        const size_t mr = problem.kernel.rows;
+        for(size_t i0 = 0; i0 < rows; i0 += mr)
+        {
+            const size_t panelRows = std::min(mr, rows - i0);
+            for(size_t p = 0; p < depth; ++p)
+            {
+                const T* column = a + static_cast<int64_t>(i0) * problem.rowStrideA + static_cast<int64_t>(p) * problem.columnStrideA;
+                for(size_t i = 0; i < panelRows; ++i) packed[i] = column[static_cast<int64_t>(i) * problem.rowStrideA];
+                for(size_t i = panelRows; i < mr; ++i) packed[i] = T(0);
+                packed += mr;
+            }
+        }
+    }
+
+    /**
+     * @brief Pack the panel `panel` (NR columns, stored row by row) of the block of B, the last panel is
+     * padded with zeros
+     */
+    template<typename T>
+    void __pack_b(const GemmProblem<T>& problem, const GemmBlock<T>& block, size_t panel)
+    {
+        const size_t nr = problem.kernel.columns;
+        const size_t j0 = panel * nr;
+        const size_t panelColumns = std::min(nr, block.columns - j0);
+        T* packed = block.packedB + j0 * block.depth;
+
+        for(size_t p = 0; p < block.depth; ++p)
+        {
+            const T* row = problem.b + static_cast<int64_t>(block.pc + p) * problem.rowStrideB + static_cast<int64_t>(block.jc + j0) * problem.columnStrideB;
+            if(problem.columnStrideB == 1) std::copy(row, row + panelColumns, packed);
+            else for(size_t j = 0; j < panelColumns; ++j) packed[j] = row[static_cast<int64_t>(j) * problem.columnStrideB];
+            for(size_t j = panelColumns; j < nr; ++j) packed[j] = T(0);
+            packed += nr;
+        }
+    }
+
+    /**
+     * @brief Pack a block of MC rows of A and multiply it by a chunk of the packed block of B
+     */
+    template<typename T>
+    void __gemm_task(const GemmProblem<T>& problem, const GemmBlock<T>& block, size_t task)
+    {
+        const size_t mr = problem.kernel.rows;
+        const size_t nr = problem.kernel.columns;
+        const size_t ic = (task / block.chunks) * problem.mc;
+        const size_t rows = std::min(problem.mc, problem.m - ic);
+        const size_t first = (task % block.chunks) * problem.chunkColumns;
+        const size_t last = std::min(first + problem.chunkColumns, block.columns);
+
+        Methan::ArenaScope scope(Methan::scratchArena());
+        T* packedA = static_cast<T*>(scope.arena().allocate(__round_up(rows, mr) * block.depth * sizeof(T), METHAN_CACHE_LINE_SIZE));
+        __pack_a(problem, problem.a + static_cast<int64_t>(ic) * problem.rowStrideA + static_cast<int64_t>(block.pc) * problem.columnStrideA, rows, block.depth, packedA);
+
+        alignas(METHAN_CACHE_LINE_SIZE) T partial[__max_tile];
+        const T zero = T(0);
+        const T beta = block.beta;
+
+        for(size_t jr = first; jr < last; jr += nr)
+        {
+            const T* panelB = block.packedB + jr * block.depth;
+            for(size_t ir = 0; ir < rows; ir += mr)
+            {
+                const T* panelA = packedA + ir * block.depth;
+                T* target = problem.c + static_cast<int64_t>(ic + ir) * problem.rowStrideC + static_cast<int64_t>(block.jc + jr);
+                const size_t tileRows = std::min(mr, rows - ir);
+                const size_t tileColumns = std::min(nr, last - jr);
+
+                if(tileRows == mr && tileColumns == nr)
+                {
+                    problem.kernel.kernel(block.depth, panelA, panelB, target, static_cast<size_t>(problem.rowStrideC), &problem.alpha, &beta);
+                    continue;
+                }
+
+                // Partial tile: computed in a local buffer and merged
+                problem.kernel.kernel(block.depth, panelA, panelB, partial, nr, &problem.alpha, &zero);
+                for(size_t i = 0; i < tileRows; ++i)
+                {
+                    T* row = target + static_cast<int64_t>(i) * problem.rowStrideC;
+                    for(size_t j = 0; j < tileColumns; ++j) row[j] = partial[i * nr + j] + (beta == T(0) ? T(0) : beta * row[j]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Tasks of one parallel step (packing B or computing C) of a block, shared by the jobs
+     */
+    template<typename T>
+    struct GemmContext
+    {
+        const GemmProblem<T>* problem;
+        const GemmBlock<T>* block;
+        void (*task)(const GemmProblem<T>&, const GemmBlock<T>&, size_t);
+        size_t taskCount;
+        std::atomic<size_t> next;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+        Methan::WaitGroup group;
+    };
+
+    template<typename T>
+    void __gemm_tasks(GemmContext<T>& context)
+    {
+        try
+        {
+            size_t task;
+            while((task = context.next.fetch_add(1, std::memory_order_relaxed)) < context.taskCount) context.task(*context.problem, *context.block, task);
+        }
+        catch(...)
+        {
+            if(!context.failed.exchange(true)) context.error = std::current_exception();
+            context.next.store(context.taskCount, std::memory_order_relaxed);
+        }
+    }
+
+    template<typename T>
+    struct GemmJob : Methan::Job
+    {
+        GemmContext<T>* context;
+    };
+
+    template<typename T>
+    void __gemm_job(Methan::Job* job)
+    {
+        GemmContext<T>& context = *static_cast<GemmJob<T>*>(job)->context;
+        __gemm_tasks(context);
+        context.group.done();
+    }
+
+    /**
+     * @brief Run the tasks [0, count) on the jobs and the calling thread, return when they are all done
+     */
+    template<typename T>
+    void __gemm_parallel(GemmContext<T>& context, std::vector<GemmJob<T>>& jobs, Methan::ThreadPool& pool,
+                         void (*task)(const GemmProblem<T>&, const GemmBlock<T>&, size_t), size_t count)
+    {
+        context.task = task;
+        context.taskCount = count;
+        context.next.store(0, std::memory_order_relaxed);
+
+        const size_t submitted = std::min(jobs.size(), count - 1);
+        context.group.add(submitted);
+        for(size_t i = 0; i < submitted; ++i) pool.submit(&jobs[i]);
+
+        __gemm_tasks(context);
+        pool.wait(context.group);
+        if(context.error) std::rethrow_exception(context.error);
+    }
+
+    template<typename T>
+    void __gemm(GemmProblem<T>& problem, Methan::ThreadPool& pool)
+    {
+        if(problem.m == 0 || problem.n == 0) return;
+        if(problem.k == 0)
+        {
+            for(size_t i = 0; i < problem.m; ++i)
+            {
+                T* row = problem.c + static_cast<int64_t>(i) * problem.rowStrideC;
+                for(size_t j = 0; j < problem.n; ++j) row[j] = problem.beta == T(0) ? T(0) : problem.beta * row[j];
+            }
+            return;
+        }
+
+        const size_t mr = problem.kernel.rows;
+        const size_t nr = problem.kernel.columns;
+        METHAN_ASSERT(mr * nr <= __max_tile, Methan::ExceptionType::IllegalState, "The tile of the GEMM micro-kernel is too large");
+
+        problem.kc = std::clamp<size_t>((32 * 1024) / (nr * sizeof(T)) / 8 * 8, 64, 256);
+        problem.mc = std::max(mr, (192 * 1024) / (problem.kc * sizeof(T)) / mr * mr);
+        problem.nc = std::max(nr, (1024 * 1024) / (problem.kc * sizeof(T)) / nr * nr);
+        problem.kc = std::min(problem.kc, problem.k);
+        problem.nc = std::min(problem.nc, __round_up(problem.n, nr));
+        problem.tilesM = __ceil_div(problem.m, problem.mc);
+        problem.chunkColumns = problem.nc;
+
+        // Small products are not worth a job. Larger ones are split (by columns, then by rows) so that every
+        // worker gets some tasks at each step.
+        const size_t workers = pool.workerCount();
+        const bool parallel = workers > 1 && static_cast<double>(problem.m) * static_cast<double>(problem.n) * static_cast<double>(problem.k) >= 64.0 * 64.0 * 64.0;
+        if(parallel && problem.tilesM < 2 * workers)
+        {
+            problem.chunkColumns = std::max(nr, __round_up(__ceil_div(problem.nc, __ceil_div(2 * workers, problem.tilesM)), nr));
+            const size_t chunks = __ceil_div(problem.nc, problem.chunkColumns);
+            if(problem.tilesM * chunks < 2 * workers)
+            {
+                problem.mc = std::max(mr, __round_up(__ceil_div(problem.m, __ceil_div(2 * workers, chunks)), mr));
+                problem.tilesM = __ceil_div(problem.m, problem.mc);
+            }
+        }
+
+        // The packed block of B is shared by the tasks of an iteration
+        Methan::ArenaScope scope(Methan::scratchArena());
+        GemmBlock<T> block;
+        block.packedB = static_cast<T*>(scope.arena().allocate(problem.nc * problem.kc * sizeof(T), METHAN_CACHE_LINE_SIZE));
+
+        // The calling thread executes tasks as well
+        GemmContext<T> context;
+        context.problem = &problem;
+        context.block = &block;
+        context.failed.store(false, std::memory_order_relaxed);
+        std::vector<GemmJob<T>> jobs(parallel ? workers - 1 : 0);
+        for(GemmJob<T>& job : jobs)
+        {
+            job.execute = &__gemm_job<T>;
+            job.context = &context;
+        }
+
+        for(block.jc = 0; block.jc < problem.n; block.jc += problem.nc)
+        {
+            block.columns = std::min(problem.nc, problem.n - block.jc);
+            block.chunks = __ceil_div(block.columns, problem.chunkColumns);
+            const size_t panels = __ceil_div(block.columns, nr);
+            const size_t tasks = problem.tilesM * block.chunks;
+
+            for(block.pc = 0; block.pc < problem.k; block.pc += problem.kc)
+            {
+                block.depth = std::min(problem.kc, problem.k - block.pc);
+                block.beta = block.pc == 0 ? problem.beta : T(1);
+
+                if(jobs.empty())
+                {
+                    for(size_t panel = 0; panel < panels; ++panel) __pack_b(problem, block, panel);
+                    for(size_t task = 0; task < tasks; ++task) __gemm_task(problem, block, task);
+                    continue;
+                }
+
+                __gemm_parallel<T>(context, jobs, pool, &__pack_b<T>, panels);
+                __gemm_parallel<T>(context, jobs, pool, &__gemm_task<T>, tasks);
+            }
+        }
+    }
+
+    template<typename T>
+    void __gemm(Methan::details::GemmType type, size_t m, size_t n, size_t k, double alpha, const void* a, int64_t rowStrideA, int64_t columnStrideA,
+                const void* b, int64_t rowStrideB, int64_t columnStrideB, double beta, void* c, int64_t rowStrideC, Methan::ThreadPool& pool)
+    {
+        GemmProblem<T> problem;
+        problem.m = m;
+        problem.n = n;
+        problem.k = k;
+        problem.alpha = static_cast<T>(alpha);
+        problem.beta = static_cast<T>(beta);
+        problem.a = static_cast<const T*>(a);
+        problem.rowStrideA = rowStrideA;
+        problem.columnStrideA = columnStrideA;
+        problem.b = static_cast<const T*>(b);
+        problem.rowStrideB = rowStrideB;
+        problem.columnStrideB = columnStrideB;
+        problem.c = static_cast<T*>(c);
+        problem.rowStrideC = rowStrideC;
+        problem.kernel = __gemm_kernels()(type);
+        __gemm(problem, pool);
+    }
+
+}
+
+METHAN_API void Methan::gemm(DataType type, size_t m, size_t n, size_t k,
+                             double alpha, const void* a, int64_t rowStrideA, int64_t columnStrideA,
+                             const void* b, int64_t rowStrideB, int64_t columnStrideB,
+                             double beta, void* c, int64_t rowStrideC,
+                             ThreadPool& pool)
+{
+    METHAN_FORCE_ASSERT(type == DataType::Float32 || type == DataType::Float64, Methan::ExceptionType::IllegalArgument, "GEMM is not implemented for " + to_string(type));
+    METHAN_FORCE_ASSERT(rowStrideC >= static_cast<int64_t>(n), Methan::ExceptionType::IllegalArgument, "The rows of C overlap (row stride " + std::to_string(rowStrideC) + " for " + std::to_string(n) + " columns)");
+    if(m == 0 || n == 0) return;
+    METHAN_ASSERT_NON_NULL(c);
+    if(k > 0)
+    {
+        METHAN_ASSERT_NON_NULL(a);
+        METHAN_ASSERT_NON_NULL(b);
+    }
+
+    if(type == DataType::Float32) __gemm<float>(details::GemmType::Float32, m, n, k, alpha, a, rowStrideA, columnStrideA, b, rowStrideB, columnStrideB, beta, c, rowStrideC, pool);
+    else __gemm<double>(details::GemmType::Float64, m, n, k, alpha, a, rowStrideA, columnStrideA, b, rowStrideB, columnStrideB, beta, c, rowStrideC, pool);
+}
+
+METHAN_API void Methan::matmul(const Tensor& a, const Tensor& b, Tensor& c, double alpha, double beta, ThreadPool& pool)
+{
+    METHAN_FORCE_ASSERT(a.rank() == 2 && b.rank() == 2 && c.rank() == 2, Methan::ExceptionType::IllegalArgument, "Matrix multiplication expects tensors of rank 2");
+    METHAN_FORCE_ASSERT(a.dtype() == b.dtype() && a.dtype() == c.dtype(), Methan::ExceptionType::IllegalArgument, "Cannot multiply " + to_string(a.dtype()) + " by " + to_string(b.dtype()) + " into " + to_string(c.dtype()));
+    METHAN_FORCE_ASSERT(a.dim(1) == b.dim(0), Methan::ExceptionType::IllegalArgument, "Cannot multiply a matrix of " + std::to_string(a.dim(1)) + " columns by a matrix of " + std::to_string(b.dim(0)) + " rows");
+    METHAN_FORCE_ASSERT(c.dim(0) == a.dim(0) && c.dim(1) == b.dim(1), Methan::ExceptionType::IllegalArgument, "The shape of the result does not match the product");
+    METHAN_FORCE_ASSERT(c.stride(1) == 1 || c.dim(1) <= 1, Methan::ExceptionType::IllegalArgument, "The result of a matrix multiplication must have a unit column stride");
+
+    const int64_t rowStrideC = c.dim(0) <= 1 ? c.dim(1) : c.stride(0);
+    gemm(a.dtype(), static_cast<size_t>(a.dim(0)), static_cast<size_t>(b.dim(1)), static_cast<size_t>(a.dim(1)),
+         alpha, a.rawData(), a.stride(0), a.stride(1),
+         b.rawData(), b.stride(0), b.stride(1),
+         beta, c.rawData(), rowStrideC, pool);
+}
+
+METHAN_API Methan::Tensor Methan::matmul(const Tensor& a, const Tensor& b, ThreadPool& pool, std::pmr::memory_resource* resource)
+{
+    METHAN_FORCE_ASSERT(a.rank() == 2 && b.rank() == 2, Methan::ExceptionType::IllegalArgument, "Matrix multiplication expects tensors of rank 2");
+
+    Tensor c(a.dtype(), { a.dim(0), b.dim(1) }, resource);
+    matmul(a, b, c, 1.0, 0.0, pool);
+    return c;
+}
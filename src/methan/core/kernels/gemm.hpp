@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/thread_pool.hpp>
+#include <methan/core/tensor/dtype.hpp>
+#include <methan/core/tensor/tensor.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief General matrix multiply, C = alpha * A * B + beta * C with A of m x k, B of k x n and C of m x n
+     * elements of the given type (Float32 or Float64). The element (i, j) of A is at
+     * `a[i * rowStrideA + j * columnStrideA]` (and likewise for B), so transposed operands are described by
+     * their strides. C is row-major with unit column stride and must not overlap A or B. C is not read when
+     * beta is 0.
+     *
+     * The operands are packed in cache-sized blocks and multiplied by register-tiled micro-kernels of the
+     * instruction set selected by `isaLevel()`. The blocks of C are distributed over the workers of the pool;
+     * when called from a worker of the pool, the calling worker keeps executing jobs while waiting.
+     */
+    METHAN_API void gemm(DataType type, size_t m, size_t n, size_t k,
+                         double alpha, const void* a, int64_t rowStrideA, int64_t columnStrideA,
+                         const void* b, int64_t rowStrideB, int64_t columnStrideB,
+                         double beta, void* c, int64_t rowStrideC,
+                         ThreadPool& pool = ThreadPool::global());
+
+    /**
+     * @brief C = alpha * A * B + beta * C for matrices (tensors of rank 2). A and B may be strided views
+     * (e.g. transposed), C must have a unit stride along its last axis.
+     */
+    METHAN_API void matmul(const Tensor& a, const Tensor& b, Tensor& c, double alpha = 1.0, double beta = 0.0, ThreadPool& pool = ThreadPool::global());
+
+    /**
+     * @brief Return the product of two matrices
+     */
+    METHAN_API Tensor matmul(const Tensor& a, const Tensor& b, ThreadPool& pool = ThreadPool::global(), std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+}
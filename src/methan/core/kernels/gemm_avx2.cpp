@@ -0,0 +1,57 @@
+#include <methan/core/details/platform.hpp>
+#include <methan/private/kernels/gemm_isa.hpp>
+
+// Compiled with -mavx2 -mfma -mf16c when METHAN_DISPATCH_AVX2 is set, see src/CMakeLists.txt
+#if defined(METHAN_SUPPORT_AVX2) && defined(METHAN_SUPPORT_AVX_FMA)
+#include <immintrin.h>
+
+namespace {
+
+    struct Avx2Float
+    {
+        typedef float T;
+        typedef __m256 V;
+        static constexpr size_t Width = 8;
+
+        static inline V zero() { return _mm256_setzero_ps(); }
+        static inline V set(float value) { return _mm256_set1_ps(value); }
+        static inline V broadcast(const float* pointer) { return _mm256_broadcast_ss(pointer); }
+        static inline V load(const float* pointer) { return _mm256_loadu_ps(pointer); }
+        static inline void store(float* pointer, V value) { _mm256_storeu_ps(pointer, value); }
+        static inline V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    };
+
+    struct Avx2Double
+    {
+        typedef double T;
+        typedef __m256d V;
+        static constexpr size_t Width = 4;
+
+        static inline V zero() { return _mm256_setzero_pd(); }
+        static inline V set(double value) { return _mm256_set1_pd(value); }
+        static inline V broadcast(const double* pointer) { return _mm256_broadcast_sd(pointer); }
+        static inline V load(const double* pointer) { return _mm256_loadu_pd(pointer); }
+        static inline void store(double* pointer, V value) { _mm256_storeu_pd(pointer, value); }
+        static inline V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+    };
+
+#include <methan/private/kernels/gemm_impl.inl>
+
+}
+
+/**
+ * 16 vector registers: 6 x 2 accumulators, 2 rows of B and 1 broadcast element of A
+ */
+Methan::details::GemmKernelInfo Methan::details::gemmKernelAVX2(GemmType type)
+{
+    switch(type)
+    {
+    case GemmType::Float32: return { &__gemm_micro_kernel<Avx2Float, 6, 2>, 6, 16 };
+    case GemmType::Float64: return { &__gemm_micro_kernel<Avx2Double, 6, 2>, 6, 8 };
+    }
+    return { nullptr, 0, 0 };
+}
+
+#endif
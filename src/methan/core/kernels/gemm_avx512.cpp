@@ -0,0 +1,61 @@
+#include <methan/core/details/platform.hpp>
+#include <methan/private/kernels/gemm_isa.hpp>
+
+// Compiled with -mavx512f (and the AVX2 flags) when METHAN_DISPATCH_AVX512 is set, see src/CMakeLists.txt
+#if defined(METHAN_SUPPORT_AVX512F)
+#if defined(METHAN_COMPILER_GCC)
+// GCC reports the undefined vectors used by the intrinsics themselves (_mm512_undefined_ps)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+
+namespace {
+
+    struct Avx512Float
+    {
+        typedef float T;
+        typedef __m512 V;
+        static constexpr size_t Width = 16;
+
+        static inline V zero() { return _mm512_setzero_ps(); }
+        static inline V set(float value) { return _mm512_set1_ps(value); }
+        static inline V broadcast(const float* pointer) { return _mm512_set1_ps(*pointer); }
+        static inline V load(const float* pointer) { return _mm512_loadu_ps(pointer); }
+        static inline void store(float* pointer, V value) { _mm512_storeu_ps(pointer, value); }
+        static inline V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+    };
+
+    struct Avx512Double
+    {
+        typedef double T;
+        typedef __m512d V;
+        static constexpr size_t Width = 8;
+
+        static inline V zero() { return _mm512_setzero_pd(); }
+        static inline V set(double value) { return _mm512_set1_pd(value); }
+        static inline V broadcast(const double* pointer) { return _mm512_set1_pd(*pointer); }
+        static inline V load(const double* pointer) { return _mm512_loadu_pd(pointer); }
+        static inline void store(double* pointer, V value) { _mm512_storeu_pd(pointer, value); }
+        static inline V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+    };
+
+#include <methan/private/kernels/gemm_impl.inl>
+
+}
+
+/**
+ * 32 vector registers: 12 x 2 accumulators, 2 rows of B and 1 broadcast element of A
+ */
+Methan::details::GemmKernelInfo Methan::details::gemmKernelAVX512(GemmType type)
+{
+    switch(type)
+    {
+    case GemmType::Float32: return { &__gemm_micro_kernel<Avx512Float, 12, 2>, 12, 32 };
+    case GemmType::Float64: return { &__gemm_micro_kernel<Avx512Double, 12, 2>, 12, 16 };
+    }
+    return { nullptr, 0, 0 };
+}
+
+#endif
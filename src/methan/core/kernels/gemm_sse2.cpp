@@ -0,0 +1,56 @@
+#include <methan/core/details/platform.hpp>
+#include <methan/private/kernels/gemm_isa.hpp>
+
+#if defined(METHAN_SUPPORT_SSE2)
+#include <emmintrin.h>
+
+namespace {
+
+    struct Sse2Float
+    {
+        typedef float T;
+        typedef __m128 V;
+        static constexpr size_t Width = 4;
+
+        static inline V zero() { return _mm_setzero_ps(); }
+        static inline V set(float value) { return _mm_set1_ps(value); }
+        static inline V broadcast(const float* pointer) { return _mm_set1_ps(*pointer); }
+        static inline V load(const float* pointer) { return _mm_loadu_ps(pointer); }
+        static inline void store(float* pointer, V value) { _mm_storeu_ps(pointer, value); }
+        static inline V mul(V a, V b) { return _mm_mul_ps(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    };
+
+    struct Sse2Double
+    {
+        typedef double T;
+        typedef __m128d V;
+        static constexpr size_t Width = 2;
+
+        static inline V zero() { return _mm_setzero_pd(); }
+        static inline V set(double value) { return _mm_set1_pd(value); }
+        static inline V broadcast(const double* pointer) { return _mm_set1_pd(*pointer); }
+        static inline V load(const double* pointer) { return _mm_loadu_pd(pointer); }
+        static inline void store(double* pointer, V value) { _mm_storeu_pd(pointer, value); }
+        static inline V mul(V a, V b) { return _mm_mul_pd(a, b); }
+        static inline V fma(V a, V b, V c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    };
+
+#include <methan/private/kernels/gemm_impl.inl>
+
+}
+
+/**
+ * 16 vector registers: 6 x 2 accumulators, 2 rows of B and 1 broadcast element of A
+ */
+Methan::details::GemmKernelInfo Methan::details::gemmKernelSSE2(GemmType type)
+{
+    switch(type)
+    {
+    case GemmType::Float32: return { &__gemm_micro_kernel<Sse2Float, 6, 2>, 6, 8 };
+    case GemmType::Float64: return { &__gemm_micro_kernel<Sse2Double, 6, 2>, 6, 4 };
+    }
+    return { nullptr, 0, 0 };
+}
+
+#endif
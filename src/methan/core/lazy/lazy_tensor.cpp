@@ -0,0 +1,369 @@
+#include <algorithm>
+
+#include <methan/core/lazy/lazy_tensor.hpp>
+#include <methan/core/passes/cse.hpp>
+#include <methan/core/passes/folding.hpp>
+#include <methan/core/passes/fusion.hpp>
+
+namespace {
+
+    /**
+     * @brief Size of the graph below which it is not compacted
+     */
+    constexpr size_t __minimum_compaction_size = 64;
+
+    void __check_operand(const Methan::LazyTensor& tensor)
+    {
+        METHAN_FORCE_ASSERT(!tensor.isEmpty(), Methan::ExceptionType::IllegalArgument, "Cannot record an operation on an empty LazyTensor");
+    }
+
+    Methan::LazyTensor __elementwise(Methan::ElementwiseOp op, std::initializer_list<Methan::LazyTensor> operands, const Methan::ElementwiseParams& params = Methan::ElementwiseParams())
+    {
+        __check_operand(*operands.begin());
+        return operands.begin()->graph()->record(Methan::OpCode::Elementwise, operands, Methan::ElementwisePayload{ op, params });
+    }
+
+    Methan::LazyTensor __scalar(const Methan::LazyTensor& tensor, double value)
+    {
+        __check_operand(tensor);
+        return tensor.graph()->scalar(value, tensor.dtype());
+    }
+
+}
+
+Methan::LazyGraph::LazyGraph(ThreadPool& pool)
+: m_compactionSize(__minimum_compaction_size),
+m_pool(&pool),
+m_evaluator(pool)
+{}
+
+METHAN_API std::shared_ptr<Methan::LazyGraph> Methan::LazyGraph::create(ThreadPool& pool)
+{
+    return std::shared_ptr<LazyGraph>(new LazyGraph(pool));
+}
+
+METHAN_API Methan::LazyTensor Methan::LazyGraph::input(Tensor tensor)
+{
+    METHAN_FORCE_ASSERT(!tensor.isEmpty(), Methan::ExceptionType::IllegalArgument, "Cannot record an empty tensor");
+    const NodeHandle node = m_graph.addNode(OpCode::Input);
+    const DataType dtype = tensor.dtype();
+    m_values.push_back(std::move(tensor));
+    return __handle(node, dtype);
+}
+
+METHAN_API Methan::LazyTensor Methan::LazyGraph::constant(Tensor tensor)
+{
+    METHAN_FORCE_ASSERT(!tensor.isEmpty(), Methan::ExceptionType::IllegalArgument, "Cannot record an empty tensor");
+    const DataType dtype = tensor.dtype();
+    const NodeHandle node = m_graph.addNode(OpCode::Constant, {}, std::move(tensor));
+    m_values.emplace_back();
+    return __handle(node, dtype);
+}
+
+METHAN_API Methan::LazyTensor Methan::LazyGraph::scalar(double value, DataType type)
+{
+    Tensor tensor(type, { 1 });
+    switch(type)
+    {
+    case DataType::Float16:
+        tensor.data<Half>()[0] = toHalf(static_cast<float>(value));
+        break;
+    case DataType::Float32:
+        tensor.data<float>()[0] = static_cast<float>(value);
+        break;
+    case DataType::Float64:
+        tensor.data<double>()[0] = value;
+        break;
+    default:
+        METHAN_THROW_EXCEPTION("The elementwise operations do not support tensors of " + to_string(type), Methan::ExceptionType::IllegalArgument);
+    }
+    return constant(std::move(tensor));
+}
+
+METHAN_API Methan::LazyTensor Methan::LazyGraph::record(OpCode op, Span<const LazyTensor> inputs, Varient payload)
+{
+    METHAN_FORCE_ASSERT(!inputs.empty(), Methan::ExceptionType::IllegalArgument, "A recorded operation expects at least one input");
+    std::vector<NodeHandle> nodes;
+    nodes.reserve(inputs.size());
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        __check_operand(inputs[i]);
+        METHAN_FORCE_ASSERT(inputs[i].graph().get() == this, Methan::ExceptionType::IllegalArgument, "Cannot combine lazy tensors of different graphs");
+        nodes.push_back(inputs[i].node());
+    }
+
+    const NodeHandle node = m_graph.addNode(op, Span<const NodeHandle>(nodes.data(), nodes.size()), std::move(payload));
+    m_values.emplace_back();
+    return __handle(node, inputs[0].dtype());
+}
+
+METHAN_API std::vector<Methan::Tensor> Methan::LazyGraph::eval(Span<const LazyTensor> tensors)
+{
+    const size_t nodeCount = m_graph.nodeCount();
+    for(size_t i = 0; i < tensors.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(!tensors[i].isEmpty() && tensors[i].graph().get() == this, Methan::ExceptionType::IllegalArgument, "Cannot evaluate a lazy tensor of another graph");
+    }
+
+    // Walk up from the requested nodes to the evaluated ones, which are the inputs of the computation
+    std::vector<bool> needed(nodeCount, false);
+    std::vector<NodeIndex> stack;
+    std::vector<NodeHandle> requested;
+    for(size_t i = 0; i < tensors.size(); ++i)
+    {
+        const NodeIndex index = Graph::index(tensors[i].node());
+        if(needed[index] || !m_values[index].isEmpty()) continue;
+        needed[index] = true;
+        stack.push_back(index);
+        requested.push_back(tensors[i].node());
+    }
+    while(!stack.empty())
+    {
+        const NodeIndex index = stack.back();
+        stack.pop_back();
+        if(!m_values[index].isEmpty()) continue;
+        for(NodeIndex input : m_graph.inputs(Graph::handle(index)))
+        {
+            if(needed[input]) continue;
+            needed[input] = true;
+            stack.push_back(input);
+        }
+    }
+
+    if(!requested.empty())
+    {
+        // The nodes are recorded after their inputs, the order of the indices is topological
+        Graph computation;
+        std::vector<NodeHandle> mapping(nodeCount, nullptr);
+        std::vector<InputBinding> bindings;
+        std::vector<NodeHandle> inputs;
+        for(NodeIndex index = 0; index < nodeCount; ++index)
+        {
+            if(!needed[index]) continue;
+            const NodeHandle node = Graph::handle(index);
+            if(!m_values[index].isEmpty())
+            {
+                mapping[index] = computation.addNode(OpCode::Input);
+                bindings.push_back({ mapping[index], m_values[index] });
+                continue;
+            }
+            inputs.clear();
+            for(NodeIndex input : m_graph.inputs(node)) inputs.push_back(mapping[input]);
+            mapping[index] = copyNode(m_graph, node, computation, Span<const NodeHandle>(inputs.data(), inputs.size()));
+        }
+
+        std::vector<NodeHandle> outputs;
+        for(NodeHandle node : requested) outputs.push_back(mapping[Graph::index(node)]);
+        const auto remap = [&](const RewrittenGraph& rewritten) {
+            for(NodeHandle& output : outputs) output = rewritten.map(output);
+            for(InputBinding& binding : bindings) binding.node = rewritten.map(binding.node);
+        };
+
+        const RewrittenGraph folded = foldConstants(computation, Span<const NodeHandle>(outputs.data(), outputs.size()), *m_pool);
+        remap(folded);
+        const RewrittenGraph unique = eliminateCommonSubexpressions(folded.graph);
+        remap(unique);
+        const RewrittenGraph fused = fuseElementwise(unique.graph, Span<const NodeHandle>(outputs.data(), outputs.size()));
+        remap(fused);
+
+        const std::vector<Tensor> results = m_evaluator.run(fused.graph, Span<const InputBinding>(bindings.data(), bindings.size()), Span<const NodeHandle>(outputs.data(), outputs.size()));
+        for(size_t i = 0; i < requested.size(); ++i) m_values[Graph::index(requested[i])] = results[i];
+    }
+
+    std::vector<Tensor> results;
+    results.reserve(tensors.size());
+    for(size_t i = 0; i < tensors.size(); ++i) results.push_back(m_values[Graph::index(tensors[i].node())]);
+    return results;
+}
+
+METHAN_API void Methan::LazyGraph::compact()
+{
+    // The referenced nodes and, up to the evaluated ones, the nodes they are computed from
+    const size_t nodeCount = m_graph.nodeCount();
+    std::vector<bool> needed(nodeCount, false);
+    std::vector<NodeIndex> stack;
+    for(const Slot& slot : m_slots)
+    {
+        if(slot.references == 0 || needed[slot.node]) continue;
+        needed[slot.node] = true;
+        stack.push_back(slot.node);
+    }
+    while(!stack.empty())
+    {
+        const NodeIndex index = stack.back();
+        stack.pop_back();
+        if(!m_values[index].isEmpty()) continue;
+        for(NodeIndex input : m_graph.inputs(Graph::handle(index)))
+        {
+            if(needed[input]) continue;
+            needed[input] = true;
+            stack.push_back(input);
+        }
+    }
+
+    // The order of the indices stays topological
+    Graph compacted;
+    std::vector<Tensor> values;
+    std::vector<NodeHandle> mapping(nodeCount, nullptr);
+    std::vector<NodeHandle> inputs;
+    for(NodeIndex index = 0; index < nodeCount; ++index)
+    {
+        if(!needed[index]) continue;
+        const NodeHandle node = Graph::handle(index);
+        if(!m_values[index].isEmpty())
+        {
+            mapping[index] = compacted.addNode(OpCode::Input);
+        }
+        else
+        {
+            inputs.clear();
+            for(NodeIndex input : m_graph.inputs(node)) inputs.push_back(mapping[input]);
+            mapping[index] = copyNode(m_graph, node, compacted, Span<const NodeHandle>(inputs.data(), inputs.size()));
+        }
+        values.push_back(std::move(m_values[index]));
+    }
+
+    m_freeSlots.clear();
+    for(uint32_t slot = 0; slot < m_slots.size(); ++slot)
+    {
+        if(m_slots[slot].references == 0) m_freeSlots.push_back(slot);
+        else m_slots[slot].node = Graph::index(mapping[m_slots[slot].node]);
+    }
+    m_graph = std::move(compacted);
+    m_values = std::move(values);
+    m_compactionSize = std::max(__minimum_compaction_size, 2 * m_graph.nodeCount());
+}
+
+Methan::LazyTensor Methan::LazyGraph::__handle(NodeHandle node, DataType dtype)
+{
+    uint32_t slot;
+    if(m_freeSlots.empty())
+    {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back({ Graph::index(node), 1 });
+    }
+    else
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_slots[slot] = { Graph::index(node), 1 };
+    }
+
+    LazyTensor tensor(shared_from_this(), slot, dtype);
+    if(m_graph.nodeCount() >= m_compactionSize) compact();
+    return tensor;
+}
+
+METHAN_API Methan::Tensor Methan::LazyTensor::eval() const
+{
+    METHAN_FORCE_ASSERT(!isEmpty(), Methan::ExceptionType::IllegalArgument, "Cannot evaluate an empty LazyTensor");
+    return m_graph->eval(Span<const LazyTensor>(this, 1))[0];
+}
+
+METHAN_API std::vector<Methan::Tensor> Methan::eval(std::initializer_list<LazyTensor> tensors)
+{
+    if(tensors.size() == 0) return {};
+    __check_operand(*tensors.begin());
+    return tensors.begin()->graph()->eval(tensors);
+}
+
+METHAN_API Methan::LazyTensor Methan::operator+(const LazyTensor& a, const LazyTensor& b)
+{
+    return __elementwise(ElementwiseOp::Add, { a, b });
+}
+
+METHAN_API Methan::LazyTensor Methan::operator-(const LazyTensor& a, const LazyTensor& b)
+{
+    return __elementwise(ElementwiseOp::Sub, { a, b });
+}
+
+METHAN_API Methan::LazyTensor Methan::operator*(const LazyTensor& a, const LazyTensor& b)
+{
+    return __elementwise(ElementwiseOp::Mul, { a, b });
+}
+
+METHAN_API Methan::LazyTensor Methan::operator/(const LazyTensor& a, const LazyTensor& b)
+{
+    return __elementwise(ElementwiseOp::Div, { a, b });
+}
+
+METHAN_API Methan::LazyTensor Methan::operator+(const LazyTensor& a, double b)
+{
+    return a + __scalar(a, b);
+}
+
+METHAN_API Methan::LazyTensor Methan::operator-(const LazyTensor& a, double b)
+{
+    return a - __scalar(a, b);
+}
+
+METHAN_API Methan::LazyTensor Methan::operator*(const LazyTensor& a, double b)
+{
+    return a * __scalar(a, b);
+}
+
+METHAN_API Methan::LazyTensor Methan::operator/(const LazyTensor& a, double b)
+{
+    return a / __scalar(a, b);
+}
+
+METHAN_API Methan::LazyTensor Methan::operator+(double a, const LazyTensor& b)
+{
+    return __scalar(b, a) + b;
+}
+
+METHAN_API Methan::LazyTensor Methan::operator-(double a, const LazyTensor& b)
+{
+    return __scalar(b, a) - b;
+}
+
+METHAN_API Methan::LazyTensor Methan::operator*(double a, const LazyTensor& b)
+{
+    return __scalar(b, a) * b;
+}
+
+METHAN_API Methan::LazyTensor Methan::operator/(double a, const LazyTensor& b)
+{
+    return __scalar(b, a) / b;
+}
+
+METHAN_API Methan::LazyTensor Methan::operator-(const LazyTensor& a)
+{
+    return 0.0 - a;
+}
+
+METHAN_API Methan::LazyTensor Methan::exp(const LazyTensor& a)
+{
+    return __elementwise(ElementwiseOp::Exp, { a });
+}
+
+METHAN_API Methan::LazyTensor Methan::tanh(const LazyTensor& a)
+{
+    return __elementwise(ElementwiseOp::Tanh, { a });
+}
+
+METHAN_API Methan::LazyTensor Methan::relu(const LazyTensor& a)
+{
+    return __elementwise(ElementwiseOp::Relu, { a });
+}
+
+METHAN_API Methan::LazyTensor Methan::sigmoid(const LazyTensor& a)
+{
+    return __elementwise(ElementwiseOp::Sigmoid, { a });
+}
+
+METHAN_API Methan::LazyTensor Methan::clamp(const LazyTensor& a, double lower, double upper)
+{
+    return __elementwise(ElementwiseOp::Clamp, { a }, ElementwiseParams{ lower, upper });
+}
+
+METHAN_API Methan::LazyTensor Methan::fma(const LazyTensor& a, const LazyTensor& b, const LazyTensor& c)
+{
+    return __elementwise(ElementwiseOp::Fma, { a, b, c });
+}
+
+METHAN_API Methan::LazyTensor Methan::matmul(const LazyTensor& a, const LazyTensor& b, bool transposeA, bool transposeB)
+{
+    __check_operand(a);
+    return a.graph()->record(OpCode::MatMul, { a, b }, MatMulPayload{ 1.0, transposeA, transposeB });
+}
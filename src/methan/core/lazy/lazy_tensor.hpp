@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/execution/thread_pool.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/kernels/elementwise.hpp>
+#include <methan/core/tensor/tensor.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    class LazyTensor;
+
+    /**
+     * @brief Graph recorded by the operations on LazyTensor. The operators do not compute anything, they append
+     * a node to the graph; an evaluation optimizes the part of the graph needed by the requested tensors
+     * (see foldConstants, eliminateCommonSubexpressions and fuseElementwise) and runs it with an Evaluator.
+     *
+     * The evaluated tensors are kept by the graph, the expressions built on top of them start from their
+     * values. The shapes and types are only checked by the evaluation, which reports the errors of the
+     * nodes. A LazyGraph is not thread-safe.
+     *
+     * The graph only keeps what the live LazyTensor need: the nodes and evaluated tensors no LazyTensor
+     * depends on anymore are dropped by `compact`, which runs whenever the graph has doubled since the last
+     * compaction. A loop such as `x = x * 0.5 + y; x.eval();` runs in constant memory.
+     *
+     * @code
+     * std::shared_ptr<LazyGraph> graph = LazyGraph::create();
+     * LazyTensor x = graph->input(a);
+     * Tensor y = (tanh(matmul(x, graph->constant(w))) + x * 0.5).eval();
+     * @endcode
+     */
+    class LazyGraph : public std::enable_shared_from_this<LazyGraph>
+    {
+    public:
+        METHAN_DISABLE_COPY_MOVE(LazyGraph);
+
+        METHAN_API static std::shared_ptr<LazyGraph> create(ThreadPool& pool = ThreadPool::global());
+
+        /**
+         * @brief Leaf of the expressions holding the given tensor, recorded as a bound `Input` node
+         */
+        METHAN_API LazyTensor input(Tensor tensor);
+
+        /**
+         * @brief Leaf of the expressions holding the given tensor, recorded as a `Constant` node so that the
+         * operations on constants only are folded
+         */
+        METHAN_API LazyTensor constant(Tensor tensor);
+
+        /**
+         * @brief Constant of shape [1] and of the given type, broadcast by the elementwise operations
+         */
+        METHAN_API LazyTensor scalar(double value, DataType type);
+
+        /**
+         * @brief Record a node of the given operation on tensors of this graph (at least one), for the
+         * operations that have no operator. The LazyTensor has the type of the first input.
+         */
+        METHAN_API LazyTensor record(OpCode op, Span<const LazyTensor> inputs, Varient payload = nullptr);
+
+        inline LazyTensor record(OpCode op, std::initializer_list<LazyTensor> inputs, Varient payload = nullptr);
+
+        /**
+         * @brief Compute the given tensors of this graph at once, sharing their common subexpressions
+         */
+        METHAN_API std::vector<Tensor> eval(Span<const LazyTensor> tensors);
+
+        inline std::vector<Tensor> eval(std::initializer_list<LazyTensor> tensors);
+
+        /**
+         * @brief Drop the nodes and the evaluated tensors that no LazyTensor depends on, the evaluated nodes
+         * still referenced become `Input` leaves holding their tensor. The nodes are renumbered: the handles
+         * of the nodes taken before (see LazyTensor::node) are invalidated.
+         */
+        METHAN_API void compact();
+
+        /**
+         * @brief Whether the tensor of the node has been computed (or given, for the inputs)
+         */
+        inline bool isEvaluated(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(Graph::index(node), m_values.size());
+            return !m_values[Graph::index(node)].isEmpty();
+        }
+
+        inline const Graph& graph() const noexcept
+        {
+            return m_graph;
+        }
+
+    private:
+        friend class LazyTensor;
+
+        /**
+         * @brief Node of the graph referenced by the LazyTensor sharing the slot, updated by compact
+         */
+        struct Slot
+        {
+            NodeIndex node;
+            uint32_t references;
+        };
+
+        explicit LazyGraph(ThreadPool& pool);
+
+        LazyTensor __handle(NodeHandle node, DataType dtype);
+
+        inline void __acquire(uint32_t slot) noexcept
+        {
+            ++m_slots[slot].references;
+        }
+
+        /**
+         * @brief The slots without references are reused after the next compaction
+         */
+        inline void __release(uint32_t slot) noexcept
+        {
+            --m_slots[slot].references;
+        }
+
+        inline NodeHandle __node(uint32_t slot) const noexcept
+        {
+            return Graph::handle(m_slots[slot].node);
+        }
+
+        Graph m_graph;
+        std::vector<Tensor> m_values;
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+        size_t m_compactionSize;
+        ThreadPool* m_pool;
+        Evaluator m_evaluator;
+    };
+
+    /**
+     * @brief Handle to a tensor of a LazyGraph, the result of an expression that is computed when the tensor
+     * is read (see eval). Copying a LazyTensor copies the handle, not the tensor; the graph keeps the node
+     * as long as a handle to it (or to an expression on it) is alive.
+     */
+    class LazyTensor
+    {
+    public:
+        LazyTensor() = default;
+
+        inline LazyTensor(const LazyTensor& other)
+        : m_graph(other.m_graph),
+        m_slot(other.m_slot),
+        m_dtype(other.m_dtype)
+        {
+            if(m_graph != nullptr) m_graph->__acquire(m_slot);
+        }
+
+        inline LazyTensor(LazyTensor&& other) noexcept
+        : m_graph(std::move(other.m_graph)),
+        m_slot(other.m_slot),
+        m_dtype(other.m_dtype)
+        {}
+
+        inline ~LazyTensor()
+        {
+            __release();
+        }
+
+        inline LazyTensor& operator=(const LazyTensor& other)
+        {
+            if(this != &other) *this = LazyTensor(other);
+            return *this;
+        }
+
+        inline LazyTensor& operator=(LazyTensor&& other) noexcept
+        {
+            if(this != &other)
+            {
+                __release();
+                m_graph = std::move(other.m_graph);
+                m_slot = other.m_slot;
+                m_dtype = other.m_dtype;
+            }
+            return *this;
+        }
+
+        inline bool isEmpty() const noexcept
+        {
+            return m_graph == nullptr;
+        }
+
+        inline const std::shared_ptr<LazyGraph>& graph() const noexcept
+        {
+            return m_graph;
+        }
+
+        /**
+         * @brief The node of the tensor in LazyGraph::graph, until the next compaction of the graph
+         */
+        inline NodeHandle node() const noexcept
+        {
+            return m_graph == nullptr ? nullptr : m_graph->__node(m_slot);
+        }
+
+        inline DataType dtype() const noexcept
+        {
+            return m_dtype;
+        }
+
+        /**
+         * @brief Compute the tensor, see LazyGraph::eval
+         */
+        METHAN_API Tensor eval() const;
+
+        inline operator Tensor() const
+        {
+            return eval();
+        }
+
+    private:
+        friend class LazyGraph;
+
+        /**
+         * @brief Handle taking over a reference to the slot
+         */
+        inline LazyTensor(std::shared_ptr<LazyGraph> graph, uint32_t slot, DataType dtype)
+        : m_graph(std::move(graph)),
+        m_slot(slot),
+        m_dtype(dtype)
+        {}
+
+        inline void __release() noexcept
+        {
+            if(m_graph != nullptr) m_graph->__release(m_slot);
+        }
+
+        std::shared_ptr<LazyGraph> m_graph;
+        uint32_t m_slot = 0;
+        DataType m_dtype = DataType::Float32;
+    };
+
+    inline LazyTensor LazyGraph::record(OpCode op, std::initializer_list<LazyTensor> inputs, Varient payload)
+    {
+        return record(op, Span<const LazyTensor>(inputs.begin(), inputs.size()), std::move(payload));
+    }
+
+    inline std::vector<Tensor> LazyGraph::eval(std::initializer_list<LazyTensor> tensors)
+    {
+        return eval(Span<const LazyTensor>(tensors.begin(), tensors.size()));
+    }
+
+    /**
+     * @brief Compute several tensors of the same graph at once, see LazyGraph::eval
+     */
+    METHAN_API std::vector<Tensor> eval(std::initializer_list<LazyTensor> tensors);
+
+    // Elementwise operations, the scalars are broadcast (see LazyGraph::scalar)
+    METHAN_API LazyTensor operator+(const LazyTensor& a, const LazyTensor& b);
+    METHAN_API LazyTensor operator-(const LazyTensor& a, const LazyTensor& b);
+    METHAN_API LazyTensor operator*(const LazyTensor& a, const LazyTensor& b);
+    METHAN_API LazyTensor operator/(const LazyTensor& a, const LazyTensor& b);
+    METHAN_API LazyTensor operator+(const LazyTensor& a, double b);
+    METHAN_API LazyTensor operator-(const LazyTensor& a, double b);
+    METHAN_API LazyTensor operator*(const LazyTensor& a, double b);
+    METHAN_API LazyTensor operator/(const LazyTensor& a, double b);
+    METHAN_API LazyTensor operator+(double a, const LazyTensor& b);
+    METHAN_API LazyTensor operator-(double a, const LazyTensor& b);
+    METHAN_API LazyTensor operator*(double a, const LazyTensor& b);
+    METHAN_API LazyTensor operator/(double a, const LazyTensor& b);
+    METHAN_API LazyTensor operator-(const LazyTensor& a);
+
+    METHAN_API LazyTensor exp(const LazyTensor& a);
+    METHAN_API LazyTensor tanh(const LazyTensor& a);
+    METHAN_API LazyTensor relu(const LazyTensor& a);
+    METHAN_API LazyTensor sigmoid(const LazyTensor& a);
+    METHAN_API LazyTensor clamp(const LazyTensor& a, double lower, double upper);
+
+    /**
+     * @brief a * b + c
+     */
+    METHAN_API LazyTensor fma(const LazyTensor& a, const LazyTensor& b, const LazyTensor& c);
+
+    /**
+     * @brief Matrix product of two tensors of rank 2, see MatMulPayload
+     */
+    METHAN_API LazyTensor matmul(const LazyTensor& a, const LazyTensor& b, bool transposeA = false, bool transposeB = false);
+
+    inline LazyTensor& operator+=(LazyTensor& a, const LazyTensor& b)
+    {
+        return a = a + b;
+    }
+
+    inline LazyTensor& operator-=(LazyTensor& a, const LazyTensor& b)
+    {
+        return a = a - b;
+    }
+
+    inline LazyTensor& operator*=(LazyTensor& a, const LazyTensor& b)
+    {
+        return a = a * b;
+    }
+
+    inline LazyTensor& operator/=(LazyTensor& a, const LazyTensor& b)
+    {
+        return a = a / b;
+    }
+
+}
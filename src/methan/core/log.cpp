@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#if defined(SPDLOG_FMT_EXTERNAL)
+#include <fmt/args.h>
+#else
+#include <spdlog/fmt/bundled/args.h>
+#endif
+
+#include <methan/core/log.hpp>
+#include <methan/utility/spsc_queue.hpp>
+
+namespace {
+
+    // Records a thread can have in flight before the following ones are dropped
+    constexpr size_t __thread_buffer_capacity = 512;
+
+    // Period at which the background thread looks for records when nobody waits for them
+    constexpr std::chrono::milliseconds __poll_interval(10);
+
+    std::atomic<uint8_t> g_logLevel{ static_cast<uint8_t>(std::min(METHAN_LOG_LEVEL, static_cast<int>(Methan::LogLevel::Off))) };
+    std::atomic<uint64_t> g_droppedLogCount{0};
+
+    /**
+     * @brief Records of a thread, written by the thread and read by the background thread. `closed` is set
+     * when the thread exits, the buffer is forgotten once empty.
+     */
+    struct ThreadLog
+    {
+        ThreadLog()
+        : records(__thread_buffer_capacity),
+        closed(false)
+        {}
+
+        Methan::SpscQueue<Methan::details::LogRecord> records;
+        std::atomic<bool> closed;
+    };
+
+    /**
+     * @brief Background thread writing the records. Never destroyed (threads may log while the statics are
+     * destroyed); the thread is stopped at exit, after writing the pending records, and the records logged
+     * later are written by their own thread.
+     */
+    class LogService
+    {
+    public:
+        LogService()
+        : m_started(false),
+        m_stopping(false),
+        m_stopped(false),
+        m_flushRequested(0),
+        m_flushCompleted(0),
+        m_reportedDrops(0)
+        {
+            // The registry of spdlog must outlive the handler registered below
+            spdlog::default_logger();
+            std::atexit([]() { LogService::instance().__stop(); });
+        }
+
+        static LogService& instance()
+        {
+            static LogService* service = new LogService();
+            return *service;
+        }
+
+        std::shared_ptr<ThreadLog> open()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(isStopped()) return nullptr;
+            if(!m_started)
+            {
+                m_thread = std::thread([this]() { __run(); });
+                m_started = true;
+            }
+            m_buffers.push_back(std::make_shared<ThreadLog>());
+            return m_buffers.back();
+        }
+
+        bool isStopped() const noexcept
+        {
+            return m_stopped.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Write a record from the calling thread, once the background thread is stopped
+         */
+        void write(const Methan::details::LogRecord& record)
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            __write(record);
+        }
+
+        void setHandler(Methan::LogHandler handler)
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            m_handler = std::move(handler);
+        }
+
+        void flush()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if(!m_started || isStopped()) return;
+
+            const uint64_t ticket = ++m_flushRequested;
+            m_condition.notify_all();
+            m_flushed.wait(lock, [&]() { return m_flushCompleted >= ticket; });
+        }
+
+    private:
+        void __run()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while(true)
+            {
+                const uint64_t requested = m_flushRequested;
+                const bool stopping = m_stopping;
+                lock.unlock();
+
+                while(__drain()) {}
+                if(requested > m_flushCompleted)
+                {
+                    std::lock_guard<std::mutex> write(m_writeMutex);
+                    if(!m_handler) __logger()->flush();
+                }
+
+                lock.lock();
+                if(requested > m_flushCompleted)
+                {
+                    m_flushCompleted = requested;
+                    m_flushed.notify_all();
+                }
+                if(stopping) return;
+                if(m_flushRequested == requested && !m_stopping) m_condition.wait_for(lock, __poll_interval);
+            }
+        }
+
+        void __stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(!m_started || m_stopping) return;
+                m_stopping = true;
+                ++m_flushRequested;
+            }
+            m_condition.notify_all();
+            m_thread.join();
+            m_stopped.store(true, std::memory_order_release);
+        }
+
+        /**
+         * @brief Write the records available in the buffers, ordered by time
+         *
+         * @return bool whether there was any
+         */
+        bool __drain()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), [](const std::shared_ptr<ThreadLog>& buffer) {
+                    return buffer->closed.load(std::memory_order_acquire) && buffer->records.empty();
+                }), m_buffers.end());
+                m_snapshot.assign(m_buffers.begin(), m_buffers.end());
+            }
+
+            m_batch.clear();
+            Methan::details::LogRecord record;
+            for(const std::shared_ptr<ThreadLog>& buffer : m_snapshot)
+            {
+                for(size_t i = 0; i < __thread_buffer_capacity && buffer->records.tryPop(record); ++i) m_batch.push_back(record);
+            }
+            m_snapshot.clear();
+
+            std::stable_sort(m_batch.begin(), m_batch.end(), [](const Methan::details::LogRecord& a, const Methan::details::LogRecord& b) {
+                return a.time < b.time;
+            });
+
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            for(const Methan::details::LogRecord& batched : m_batch) __write(batched);
+
+            const uint64_t dropped = g_droppedLogCount.load(std::memory_order_relaxed);
+            if(dropped > m_reportedDrops)
+            {
+                Methan::details::LogRecord warning;
+                warning.time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+                warning.format = "{} log records were dropped (full thread buffers)";
+                warning.level = Methan::LogLevel::Warning;
+                warning.argumentCount = 0;
+                warning.textSize = 0;
+                Methan::details::captureLogArgument(warning, dropped - m_reportedDrops);
+                __write(warning);
+                m_reportedDrops = dropped;
+            }
+            return !m_batch.empty();
+        }
+
+        /**
+         * @brief Format a record and hand it to the handler or spdlog, under `m_writeMutex`
+         */
+        void __write(const Methan::details::LogRecord& record)
+        {
+            fmt::dynamic_format_arg_store<fmt::format_context> arguments;
+            for(uint8_t i = 0; i < record.argumentCount; ++i)
+            {
+                const Methan::details::LogArgument& argument = record.arguments[i];
+                switch(argument.kind)
+                {
+                case Methan::details::LogArgument::Kind::Int: arguments.push_back(argument.integer); break;
+                case Methan::details::LogArgument::Kind::UInt: arguments.push_back(argument.unsignedInteger); break;
+                case Methan::details::LogArgument::Kind::Double: arguments.push_back(argument.real); break;
+                case Methan::details::LogArgument::Kind::Bool: arguments.push_back(argument.unsignedInteger != 0); break;
+                case Methan::details::LogArgument::Kind::Char: arguments.push_back(static_cast<char>(argument.integer)); break;
+                case Methan::details::LogArgument::Kind::String: arguments.push_back(fmt::string_view(record.text + argument.text.offset, argument.text.size)); break;
+                case Methan::details::LogArgument::Kind::Pointer: arguments.push_back(argument.pointer); break;
+                }
+            }
+
+            std::string message;
+            try
+            {
+                message = fmt::vformat(fmt::string_view(record.format), arguments);
+            }
+            catch(const std::exception& e)
+            {
+                message = std::string(record.format) + " [" + e.what() + "]";
+            }
+
+            const std::chrono::system_clock::time_point time(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(record.time)));
+            if(m_handler) m_handler(record.level, time, message);
+            else __logger()->log(time, spdlog::source_loc(), static_cast<spdlog::level::level_enum>(record.level), message);
+        }
+
+        /**
+         * @brief Logger registered under Methan::LoggerName, or one writing to the sinks of the default logger
+         */
+        std::shared_ptr<spdlog::logger> __logger()
+        {
+            std::shared_ptr<spdlog::logger> logger = spdlog::get(Methan::LoggerName);
+            if(logger != nullptr) return logger;
+
+            if(m_fallback == nullptr)
+            {
+                const std::vector<spdlog::sink_ptr>& sinks = spdlog::default_logger()->sinks();
+                m_fallback = std::make_shared<spdlog::logger>(Methan::LoggerName, sinks.begin(), sinks.end());
+                m_fallback->set_level(spdlog::level::trace);
+            }
+            return m_fallback;
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::condition_variable m_flushed;
+        std::vector<std::shared_ptr<ThreadLog>> m_buffers;
+        std::thread m_thread;
+        bool m_started;
+        bool m_stopping;
+        std::atomic<bool> m_stopped;
+        uint64_t m_flushRequested;
+        uint64_t m_flushCompleted;
+
+        // Used by the background thread only
+        std::vector<std::shared_ptr<ThreadLog>> m_snapshot;
+        std::vector<Methan::details::LogRecord> m_batch;
+        uint64_t m_reportedDrops;
+
+        std::mutex m_writeMutex;
+        Methan::LogHandler m_handler;
+        std::shared_ptr<spdlog::logger> m_fallback;
+    };
+
+    /**
+     * @brief Buffer of the calling thread, closed when the thread exits
+     */
+    struct ThreadLogHandle
+    {
+        ~ThreadLogHandle()
+        {
+            if(log != nullptr) log->closed.store(true, std::memory_order_release);
+        }
+
+        std::shared_ptr<ThreadLog> log;
+        bool opened = false;
+    };
+
+    thread_local ThreadLogHandle t_threadLog;
+
+}
+
+METHAN_API void Methan::details::pushLogRecord(LogRecord& record) noexcept
+{
+    record.time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+    try
+    {
+        if(!t_threadLog.opened)
+        {
+            t_threadLog.opened = true;
+            t_threadLog.log = LogService::instance().open();
+        }
+        if(t_threadLog.log != nullptr && !LogService::instance().isStopped())
+        {
+            if(!t_threadLog.log->records.tryPush(record)) g_droppedLogCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        LogService::instance().write(record);
+    }
+    catch(...)
+    {
+        g_droppedLogCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+METHAN_API bool Methan::isLogEnabled(LogLevel level) noexcept
+{
+    return level != LogLevel::Off && static_cast<uint8_t>(level) >= g_logLevel.load(std::memory_order_relaxed);
+}
+
+METHAN_API void Methan::setLogLevel(LogLevel level) noexcept
+{
+    g_logLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+METHAN_API Methan::LogLevel Methan::logLevel() noexcept
+{
+    return static_cast<LogLevel>(g_logLevel.load(std::memory_order_relaxed));
+}
+
+METHAN_API void Methan::setLogHandler(LogHandler handler)
+{
+    LogService::instance().setHandler(std::move(handler));
+}
+
+METHAN_API void Methan::flushLog()
+{
+    LogService::instance().flush();
+}
+
+METHAN_API uint64_t Methan::droppedLogCount() noexcept
+{
+    return g_droppedLogCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <methan/core/except.hpp>
+
+/**
+ * @brief Log a record of the given level. The records below METHAN_LOG_LEVEL (set by the configuration, 0
+ * for trace to 6 for none) are compiled out, arguments included; the others are filtered at run time by
+ * setLogLevel. See Methan::log for the format and the arguments.
+ */
+#define METHAN_LOG(level, ...)                                       do { if(Methan::isLogEnabled(level)) Methan::log(level, __VA_ARGS__); } while(0)
+
+#if METHAN_LOG_LEVEL <= 0
+#define METHAN_LOG_TRACE(...)                                        METHAN_LOG(Methan::LogLevel::Trace, __VA_ARGS__)
+#else
+#define METHAN_LOG_TRACE(...)                                        ((void) 0)
+#endif
+#if METHAN_LOG_LEVEL <= 1
+#define METHAN_LOG_DEBUG(...)                                        METHAN_LOG(Methan::LogLevel::Debug, __VA_ARGS__)
+#else
+#define METHAN_LOG_DEBUG(...)                                        ((void) 0)
+#endif
+#if METHAN_LOG_LEVEL <= 2
+#define METHAN_LOG_INFO(...)                                         METHAN_LOG(Methan::LogLevel::Info, __VA_ARGS__)
+#else
+#define METHAN_LOG_INFO(...)                                         ((void) 0)
+#endif
+#if METHAN_LOG_LEVEL <= 3
+#define METHAN_LOG_WARNING(...)                                      METHAN_LOG(Methan::LogLevel::Warning, __VA_ARGS__)
+#else
+#define METHAN_LOG_WARNING(...)                                      ((void) 0)
+#endif
+#if METHAN_LOG_LEVEL <= 4
+#define METHAN_LOG_ERROR(...)                                        METHAN_LOG(Methan::LogLevel::Error, __VA_ARGS__)
+#else
+#define METHAN_LOG_ERROR(...)                                        ((void) 0)
+#endif
+#if METHAN_LOG_LEVEL <= 5
+#define METHAN_LOG_CRITICAL(...)                                     METHAN_LOG(Methan::LogLevel::Critical, __VA_ARGS__)
+#else
+#define METHAN_LOG_CRITICAL(...)                                     ((void) 0)
+#endif
+
+namespace Methan {
+
+    enum class LogLevel : uint8_t
+    {
+        Trace,
+        Debug,
+        Info,
+        Warning,
+        Error,
+        Critical,
+        Off
+    };
+
+    /**
+     * @brief Receive the formatted records instead of spdlog, see setLogHandler
+     */
+    typedef std::function<void(LogLevel level, std::chrono::system_clock::time_point time, const std::string& message)> LogHandler;
+
+    /**
+     * @brief Name of the spdlog logger receiving the records. When no logger of this name is registered, the
+     * records go to the sinks of the default logger.
+     */
+    constexpr const char* LoggerName = "methan";
+
+    /**
+     * @brief Maximum number of arguments of a record, and number of bytes of their strings (longer strings
+     * are truncated)
+     */
+    constexpr size_t MaxLogArguments = 8;
+    constexpr size_t LogTextCapacity = 192;
+
+    namespace details {
+
+        struct LogArgument
+        {
+            enum class Kind : uint8_t
+            {
+                Int,
+                UInt,
+                Double,
+                Bool,
+                Char,
+                String,
+                Pointer
+            };
+
+            Kind kind;
+            union
+            {
+                int64_t integer;
+                uint64_t unsignedInteger;
+                double real;
+                const void* pointer;
+                struct
+                {
+                    uint16_t offset;
+                    uint16_t size;
+                } text;
+            };
+        };
+
+        /**
+         * @brief Record waiting to be formatted: the format and a copy of the arguments
+         */
+        struct LogRecord
+        {
+            uint64_t time;
+            const char* format;
+            LogLevel level;
+            uint8_t argumentCount;
+            uint16_t textSize;
+            LogArgument arguments[MaxLogArguments];
+            char text[LogTextCapacity];
+        };
+
+        inline void captureLogText(LogRecord& record, const char* text, size_t size) noexcept
+        {
+            LogArgument& argument = record.arguments[record.argumentCount++];
+            argument.kind = LogArgument::Kind::String;
+            size = std::min(size, LogTextCapacity - record.textSize);
+            argument.text.offset = record.textSize;
+            argument.text.size = static_cast<uint16_t>(size);
+            std::memcpy(record.text + record.textSize, text, size);
+            record.textSize = static_cast<uint16_t>(record.textSize + size);
+        }
+
+        template<typename T>
+        inline void captureLogArgument(LogRecord& record, const T& value) noexcept
+        {
+            if constexpr(std::is_same<T, bool>::value)
+            {
+                record.arguments[record.argumentCount].kind = LogArgument::Kind::Bool;
+                record.arguments[record.argumentCount++].unsignedInteger = value ? 1 : 0;
+            }
+            else if constexpr(std::is_same<T, char>::value)
+            {
+                record.arguments[record.argumentCount].kind = LogArgument::Kind::Char;
+                record.arguments[record.argumentCount++].integer = value;
+            }
+            else if constexpr(std::is_enum<T>::value)
+            {
+                captureLogArgument(record, static_cast<typename std::underlying_type<T>::type>(value));
+            }
+            else if constexpr(std::is_integral<T>::value && std::is_signed<T>::value)
+            {
+                record.arguments[record.argumentCount].kind = LogArgument::Kind::Int;
+                record.arguments[record.argumentCount++].integer = static_cast<int64_t>(value);
+            }
+            else if constexpr(std::is_integral<T>::value)
+            {
+                record.arguments[record.argumentCount].kind = LogArgument::Kind::UInt;
+                record.arguments[record.argumentCount++].unsignedInteger = static_cast<uint64_t>(value);
+            }
+            else if constexpr(std::is_floating_point<T>::value)
+            {
+                record.arguments[record.argumentCount].kind = LogArgument::Kind::Double;
+                record.arguments[record.argumentCount++].real = static_cast<double>(value);
+            }
+            else if constexpr(std::is_convertible<const T&, std::string_view>::value)
+            {
+                if constexpr(std::is_pointer<T>::value)
+                {
+                    if(value == nullptr) return captureLogText(record, "(null)", 6);
+                }
+                const std::string_view text(value);
+                captureLogText(record, text.data(), text.size());
+            }
+            else if constexpr(std::is_pointer<T>::value)
+            {
+                record.arguments[record.argumentCount].kind = LogArgument::Kind::Pointer;
+                record.arguments[record.argumentCount++].pointer = static_cast<const void*>(value);
+            }
+            else
+            {
+                static_assert(std::is_arithmetic<T>::value, "Log arguments must be arithmetic types, enumerations, strings or pointers");
+            }
+        }
+
+        /**
+         * @brief Hand a record to the background thread, through the buffer of the calling thread. The
+         * record is dropped (and counted) when the buffer is full.
+         */
+        METHAN_API void pushLogRecord(LogRecord& record) noexcept;
+
+    }
+
+    /**
+     * @brief Whether the records of a level are currently logged
+     */
+    METHAN_API bool isLogEnabled(LogLevel level) noexcept;
+
+    /**
+     * @brief Minimum level of the logged records, by default the one of the configuration (METHAN_LOG_LEVEL)
+     */
+    METHAN_API void setLogLevel(LogLevel level) noexcept;
+    METHAN_API LogLevel logLevel() noexcept;
+
+    /**
+     * @brief Send the records to `handler` (called by the background thread) instead of spdlog, or to spdlog
+     * again if the handler is empty
+     */
+    METHAN_API void setLogHandler(LogHandler handler);
+
+    /**
+     * @brief Wait until every record logged before the call is written, then flush the logger
+     */
+    METHAN_API void flushLog();
+
+    /**
+     * @brief Number of records dropped because the buffer of their thread was full
+     */
+    METHAN_API uint64_t droppedLogCount() noexcept;
+
+    /**
+     * @brief Log a record without waiting for it to be written. The calling thread only copies the arguments
+     * into its buffer; the formatting (fmt syntax) and the writing are done by a background thread.
+     *
+     * @param format a string with static storage duration (typically a literal)
+     * @param args at most MaxLogArguments arithmetic values, enumerations, strings (copied) or pointers
+     */
+    template<typename... Args>
+    inline void log(LogLevel level, const char* format, const Args&... args) noexcept
+    {
+        static_assert(sizeof...(Args) <= MaxLogArguments, "Too many log arguments");
+        details::LogRecord record;
+        record.format = format;
+        record.level = level;
+        record.argumentCount = 0;
+        record.textSize = 0;
+        (details::captureLogArgument(record, args), ...);
+        details::pushLogRecord(record);
+    }
+
+}
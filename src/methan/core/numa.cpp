@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <thread>
+
+#include <methan/core/numa.hpp>
+#include <methan/utility/assertion.hpp>
+
+#if defined(METHAN_OS_LINUX)
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    /**
+     * @brief CPUs the process is allowed to run on (all the CPUs reported by the standard library when the
+     * affinity cannot be read)
+     */
+    std::vector<int> __allowed_cpus()
+    {
+        std::vector<int> cpus;
+#if defined(METHAN_OS_LINUX)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if(sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu) if(CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+#endif
+        if(cpus.empty())
+        {
+            const int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            for(int cpu = 0; cpu < count; ++cpu) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    /**
+     * @brief Parse a list of CPUs in the format of sysfs (e.g. "0-3,8,10-11"), invalid parts are ignored
+     */
+    std::vector<int> __parse_cpu_list(const std::string& text)
+    {
+        std::vector<int> cpus;
+        size_t position = 0;
+        while(position < text.size())
+        {
+            size_t end = text.find(',', position);
+            if(end == std::string::npos) end = text.size();
+            const std::string range = text.substr(position, end - position);
+            position = end + 1;
+
+            char* next = nullptr;
+            const long first = std::strtol(range.c_str(), &next, 10);
+            if(next == range.c_str() || first < 0) continue;
+            long last = first;
+            if(*next == '-')
+            {
+                const char* bound = next + 1;
+                last = std::strtol(bound, &next, 10);
+                if(next == bound || last < first) continue;
+            }
+            for(long cpu = first; cpu <= last; ++cpu) cpus.push_back(static_cast<int>(cpu));
+        }
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+#if defined(METHAN_OS_LINUX)
+    constexpr int __mpol_preferred = 1;
+
+    size_t __page_size() noexcept
+    {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+#endif
+
+}
+
+METHAN_API int Methan::NumaTopology::nodeOfCpu(int cpu) const noexcept
+{
+    for(size_t i = 0; i < nodes.size(); ++i)
+    {
+        if(std::binary_search(nodes[i].cpus.begin(), nodes[i].cpus.end(), cpu)) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+METHAN_API Methan::NumaTopology Methan::NumaTopology::detect(const std::string& root)
+{
+    NumaTopology topology;
+#if defined(METHAN_OS_LINUX)
+    const std::vector<int> allowed = __allowed_cpus();
+    if(DIR* directory = opendir(root.c_str()))
+    {
+        while(const dirent* entry = readdir(directory))
+        {
+            const std::string name = entry->d_name;
+            if(name.size() < 5 || name.compare(0, 4, "node") != 0 || name.find_first_not_of("0123456789", 4) != std::string::npos) continue;
+
+            std::ifstream file(root + "/" + name + "/cpulist");
+            std::string text;
+            if(!file || !std::getline(file, text)) continue;
+
+            NumaNode node;
+            node.id = std::atoi(name.c_str() + 4);
+            for(int cpu : __parse_cpu_list(text))
+            {
+                if(std::binary_search(allowed.begin(), allowed.end(), cpu)) node.cpus.push_back(cpu);
+            }
+            if(!node.cpus.empty()) topology.nodes.push_back(std::move(node));
+        }
+        closedir(directory);
+    }
+    std::sort(topology.nodes.begin(), topology.nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+#else
+    (void) root;
+#endif
+    if(topology.nodes.empty()) return uniform();
+    return topology;
+}
+
+METHAN_API Methan::NumaTopology Methan::NumaTopology::uniform()
+{
+    NumaTopology topology;
+    topology.nodes.push_back(NumaNode{ 0, __allowed_cpus() });
+    return topology;
+}
+
+METHAN_API const Methan::NumaTopology& Methan::numaTopology()
+{
+    static const NumaTopology topology = NumaTopology::detect();
+    return topology;
+}
+
+METHAN_API int Methan::currentNumaNode() noexcept
+{
+#if defined(METHAN_OS_LINUX)
+    const int cpu = sched_getcpu();
+    if(cpu >= 0) return std::max(0, numaTopology().nodeOfCpu(cpu));
+#endif
+    return 0;
+}
+
+METHAN_API Methan::NumaMemoryResource::NumaMemoryResource(int node, size_t threshold, std::pmr::memory_resource* upstream)
+: m_node(node),
+m_threshold(threshold),
+m_upstream(upstream)
+{
+    METHAN_ASSERT_NON_NULL(upstream);
+    METHAN_FORCE_ASSERT(node == LocalNode || (node >= 0 && static_cast<size_t>(node) < numaTopology().nodeCount()), Methan::ExceptionType::IllegalArgument, "The NUMA node " + std::to_string(node) + " does not exist");
+}
+
+METHAN_API void* Methan::NumaMemoryResource::do_allocate(size_t bytes, size_t alignment)
+{
+#if defined(METHAN_OS_LINUX)
+    if(__isMapped(bytes, alignment))
+    {
+        const size_t length = (bytes + __page_size() - 1) / __page_size() * __page_size();
+        void* pointer = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(pointer == MAP_FAILED) throw std::bad_alloc();
+
+        // The binding is a preference: on failure (e.g. no permission), the pages are still placed on the
+        // node that touches them first
+        const NumaTopology& topology = numaTopology();
+        const int id = topology.nodes[static_cast<size_t>(m_node == LocalNode ? currentNumaNode() : m_node)].id;
+        std::vector<unsigned long> mask(static_cast<size_t>(id) / (8 * sizeof(unsigned long)) + 1, 0);
+        mask[static_cast<size_t>(id) / (8 * sizeof(unsigned long))] |= 1ul << (static_cast<size_t>(id) % (8 * sizeof(unsigned long)));
+        // The kernel reads `maxnode - 1` bits of the mask, hence the extra bit (as libnuma does)
+        syscall(SYS_mbind, pointer, length, __mpol_preferred, mask.data(), mask.size() * 8 * sizeof(unsigned long) + 1, 0);
+        return pointer;
+    }
+#endif
+    return m_upstream->allocate(bytes, alignment);
+}
+
+METHAN_API void Methan::NumaMemoryResource::do_deallocate(void* pointer, size_t bytes, size_t alignment)
+{
+#if defined(METHAN_OS_LINUX)
+    if(__isMapped(bytes, alignment))
+    {
+        munmap(pointer, (bytes + __page_size() - 1) / __page_size() * __page_size());
+        return;
+    }
+#endif
+    m_upstream->deallocate(pointer, bytes, alignment);
+}
+
+METHAN_API bool Methan::NumaMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+bool Methan::NumaMemoryResource::__isMapped(size_t bytes, size_t alignment) const noexcept
+{
+#if defined(METHAN_OS_LINUX)
+    return bytes >= m_threshold && bytes > 0 && alignment <= __page_size();
+#else
+    (void) bytes;
+    (void) alignment;
+    return false;
+#endif
+}
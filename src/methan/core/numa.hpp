@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include <methan/core/except.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief NUMA node: a set of CPUs sharing a local memory
+     */
+    struct NumaNode
+    {
+        /**
+         * @brief Identifier of the node for the operating system
+         */
+        int id;
+
+        /**
+         * @brief CPUs of the node the process is allowed to run on, in increasing order
+         */
+        std::vector<int> cpus;
+    };
+
+    /**
+     * @brief NUMA nodes of the machine, ordered by identifier. Nodes without CPUs (memory only) are omitted.
+     */
+    struct NumaTopology
+    {
+        std::vector<NumaNode> nodes;
+
+        inline size_t nodeCount() const noexcept
+        {
+            return nodes.size();
+        }
+
+        /**
+         * @brief Index (in `nodes`) of the node of a CPU, -1 if the CPU is not part of the topology
+         */
+        METHAN_API int nodeOfCpu(int cpu) const noexcept;
+
+        /**
+         * @brief Read the topology from sysfs (Linux), `root` being the directory of the nodes. Falls back to
+         * a single node holding every CPU when the directory cannot be read (other systems, containers
+         * hiding sysfs), see uniform.
+         */
+        METHAN_API static NumaTopology detect(const std::string& root = "/sys/devices/system/node");
+
+        /**
+         * @brief Single node 0 holding the CPUs the process is allowed to run on
+         */
+        METHAN_API static NumaTopology uniform();
+    };
+
+    /**
+     * @brief Return the topology of the machine (detected once, on the first call)
+     */
+    METHAN_API const NumaTopology& numaTopology();
+
+    /**
+     * @brief Index (in numaTopology) of the node of the CPU running the calling thread, 0 if unknown
+     */
+    METHAN_API int currentNumaNode() noexcept;
+
+    /**
+     * @brief Memory resource placing the large allocations on a NUMA node (Linux only). Those are mapped
+     * directly and bound to the node, the small ones and those of other systems come from `upstream`.
+     *
+     * Linux places a page on the node of the thread that touches it first, which the kernels already
+     * benefit from as they write their outputs from the worker that consumes them next (see
+     * ThreadPoolOptions::numaAware); this resource is meant for the buffers filled by another thread, such
+     * as the weights loaded before the execution. With `LocalNode`, the node is the one of the allocating
+     * thread.
+     */
+    class NumaMemoryResource : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr int LocalNode = -1;
+
+        METHAN_API explicit NumaMemoryResource(int node = LocalNode, size_t threshold = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        /**
+         * @brief Index of the node in numaTopology, or `LocalNode`
+         */
+        inline int node() const noexcept
+        {
+            return m_node;
+        }
+
+        /**
+         * @brief Size from which the allocations are bound to the node
+         */
+        inline size_t threshold() const noexcept
+        {
+            return m_threshold;
+        }
+
+        inline std::pmr::memory_resource* upstream() const noexcept
+        {
+            return m_upstream;
+        }
+
+    protected:
+        METHAN_API void* do_allocate(size_t bytes, size_t alignment) override;
+        METHAN_API void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        METHAN_API bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        bool __isMapped(size_t bytes, size_t alignment) const noexcept;
+
+        int m_node;
+        size_t m_threshold;
+        std::pmr::memory_resource* m_upstream;
+    };
+
+}
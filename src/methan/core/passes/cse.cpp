@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include <methan/core/passes/cse.hpp>
+#include <methan/utility/hash.hpp>
+
+namespace {
+
+    bool __is_tensor_constant(const Methan::Graph& graph, Methan::NodeHandle node)
+    {
+        return graph.op(node) == Methan::OpCode::Constant && graph.payload(node).is<Methan::Tensor>();
+    }
+
+    bool __is_commutative(const Methan::Graph& graph, Methan::NodeHandle node)
+    {
+        const Methan::Varient& payload = graph.payload(node);
+        if(graph.op(node) != Methan::OpCode::Elementwise || !payload.is<Methan::ElementwisePayload>()) return false;
+
+        const Methan::ElementwiseOp op = payload.get<Methan::ElementwisePayload>().op;
+        return op == Methan::ElementwiseOp::Add || op == Methan::ElementwiseOp::Mul;
+    }
+
+    /**
+     * @brief The nodes of the new graph consumed by the node, sorted if the order does not matter
+     */
+    void __mapped_inputs(const Methan::Graph& graph, Methan::NodeHandle node, const std::vector<Methan::NodeHandle>& mapping, std::vector<Methan::NodeHandle>& inputs)
+    {
+        const Methan::Span<const Methan::NodeIndex> predecessors = graph.inputs(node);
+        inputs.clear();
+        for(Methan::NodeIndex input : predecessors) inputs.push_back(mapping[input]);
+        if(__is_commutative(graph, node)) std::sort(inputs.begin(), inputs.end());
+    }
+
+    size_t __tensor_hash(const Methan::Tensor& tensor)
+    {
+        size_t seed = Methan::hash_values(0, tensor.dtype(), tensor.rank());
+        for(int64_t dim : tensor.shape()) seed = Methan::hash_combine(seed, std::hash<int64_t>{}(dim));
+        if(tensor.isEmpty() || tensor.elementCount() == 0) return seed;
+
+        const Methan::Tensor contiguous = tensor.contiguous();
+        const std::string_view bytes(static_cast<const char*>(contiguous.rawData()), static_cast<size_t>(contiguous.elementCount()) * contiguous.elementSize());
+        return Methan::hash_combine(seed, std::hash<std::string_view>{}(bytes));
+    }
+
+    /**
+     * @brief Constants are equal when they have the same type, shape and bits
+     */
+    bool __tensor_equal(const Methan::Tensor& first, const Methan::Tensor& second)
+    {
+        if(first.isEmpty() || second.isEmpty()) return first.isEmpty() == second.isEmpty();
+        if(first.dtype() != second.dtype() || first.shape() != second.shape()) return false;
+        if(first.rawData() == second.rawData() && first.strides() == second.strides()) return true;
+
+        const Methan::Tensor a = first.contiguous();
+        const Methan::Tensor b = second.contiguous();
+        return std::memcmp(a.rawData(), b.rawData(), static_cast<size_t>(a.elementCount()) * a.elementSize()) == 0;
+    }
+
+    /**
+     * @brief Hash of the value computed by the node, return false if the node must not be merged
+     */
+    bool __hash_node(const Methan::Graph& graph, Methan::NodeHandle node, const std::vector<Methan::NodeHandle>& inputs, size_t& hash)
+    {
+        const Methan::OpCode op = graph.op(node);
+        if(op == Methan::OpCode::Input || op == Methan::OpCode::Custom) return false;
+
+        const Methan::Varient& payload = graph.payload(node);
+        size_t seed = Methan::hash_values(0, op);
+        for(Methan::NodeHandle input : inputs) seed = Methan::hash_values(seed, input);
+
+        if(__is_tensor_constant(graph, node)) seed = Methan::hash_combine(seed, __tensor_hash(payload.get<Methan::Tensor>()));
+        else if(payload.isHashable()) seed = Methan::hash_combine(seed, payload.hash());
+        else return false;
+
+        // The attributes are not ordered, their hashes are summed
+        bool hashable = true;
+        size_t attributes = 0;
+        graph.forEachAttribute(node, [&](Methan::AttributeKey key, const Methan::Varient& value) {
+            if(key == Methan::AttributeKey::Name) return;
+            if(value.isHashable()) attributes += Methan::hash_combine(std::hash<Methan::AttributeKey>{}(key), value.hash());
+            else hashable = false;
+        });
+
+        hash = Methan::hash_combine(seed, attributes);
+        return hashable;
+    }
+
+    size_t __attribute_count(const Methan::Graph& graph, Methan::NodeHandle node)
+    {
+        size_t count = 0;
+        graph.forEachAttribute(node, [&](Methan::AttributeKey key, const Methan::Varient&) {
+            if(key != Methan::AttributeKey::Name) ++count;
+        });
+        return count;
+    }
+
+    /**
+     * @brief Whether the two nodes, of equal hash, compute the same value. The inputs of `node` are given,
+     * those of `other` (a node already copied) are mapped again.
+     */
+    bool __is_equivalent(const Methan::Graph& graph, Methan::NodeHandle node, const std::vector<Methan::NodeHandle>& inputs, Methan::NodeHandle other, const std::vector<Methan::NodeHandle>& mapping, std::vector<Methan::NodeHandle>& otherInputs)
+    {
+        if(graph.op(node) != graph.op(other)) return false;
+
+        __mapped_inputs(graph, other, mapping, otherInputs);
+        if(inputs != otherInputs) return false;
+
+        const Methan::Varient& payload = graph.payload(node);
+        const Methan::Varient& otherPayload = graph.payload(other);
+        if(__is_tensor_constant(graph, node) != __is_tensor_constant(graph, other)) return false;
+        if(__is_tensor_constant(graph, node))
+        {
+            if(!__tensor_equal(payload.get<Methan::Tensor>(), otherPayload.get<Methan::Tensor>())) return false;
+        }
+        else if(payload != otherPayload) return false;
+
+        if(__attribute_count(graph, node) != __attribute_count(graph, other)) return false;
+        bool equal = true;
+        graph.forEachAttribute(node, [&](Methan::AttributeKey key, const Methan::Varient& value) {
+            if(key == Methan::AttributeKey::Name) return;
+            const Methan::Varient* otherValue = graph.attribute(other, key);
+            equal = equal && otherValue != nullptr && *otherValue == value;
+        });
+        return equal;
+    }
+
+}
+
+METHAN_API Methan::RewrittenGraph Methan::eliminateCommonSubexpressions(const Graph& graph)
+{
+    const std::vector<NodeIndex> order = graph.topologicalOrder();
+
+    RewrittenGraph result;
+    result.graph.reserve(graph.nodeCount(), graph.edgeCount());
+    result.mapping.assign(graph.nodeCount(), nullptr);
+
+    // Hash of the value of a node to the nodes (of the original graph) whose copy computes it
+    std::unordered_multimap<size_t, NodeIndex> copies;
+    copies.reserve(graph.nodeCount());
+
+    std::vector<NodeHandle> key, candidateKey, inputs;
+    for(NodeIndex index : order)
+    {
+        const NodeHandle node = Graph::handle(index);
+        __mapped_inputs(graph, node, result.mapping, key);
+
+        size_t hash = 0;
+        const bool hashable = __hash_node(graph, node, key, hash);
+        if(hashable)
+        {
+            const auto range = copies.equal_range(hash);
+            const auto it = std::find_if(range.first, range.second, [&](const std::pair<const size_t, NodeIndex>& copy) {
+                return __is_equivalent(graph, node, key, Graph::handle(copy.second), result.mapping, candidateKey);
+            });
+            if(it != range.second)
+            {
+                result.mapping[index] = result.mapping[it->second];
+                continue;
+            }
+        }
+
+        // The copy keeps the order of the inputs of the original node
+        const Span<const NodeIndex> predecessors = graph.inputs(node);
+        inputs.clear();
+        for(NodeIndex input : predecessors) inputs.push_back(result.mapping[input]);
+        result.mapping[index] = copyNode(graph, node, result.graph, Span<const NodeHandle>(inputs.data(), inputs.size()));
+        if(hashable) copies.emplace(hash, index);
+    }
+
+    return result;
+}
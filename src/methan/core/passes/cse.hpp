@@ -0,0 +1,22 @@
+#pragma once
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/passes/rewrite.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Merge the nodes computing the same value: nodes with the same operation, inputs (in any order
+     * for the commutative `Add` and `Mul`), payload and attributes (other than `Name`) are replaced by the
+     * first of them, the nodes consuming them are merged in turn. Payloads are compared with the equality of
+     * Varient, except for the Tensor of the `Constant` nodes which are compared by content.
+     *
+     * `Input` and `Custom` nodes are never merged, nor are the nodes whose payload or attributes are not
+     * hashable (see Varient::isHashable). The other nodes are copied (see copyNode) and every node of the
+     * original graph is mapped.
+     */
+    METHAN_API RewrittenGraph eliminateCommonSubexpressions(const Graph& graph);
+
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+
+#include <methan/core/passes/folding.hpp>
+
+namespace {
+
+    bool __is_foldable(const Methan::Graph& graph, Methan::NodeHandle node)
+    {
+        switch(graph.op(node))
+        {
+        case Methan::OpCode::Elementwise:
+        case Methan::OpCode::FusedElementwise:
+        case Methan::OpCode::MatMul:
+            return graph.inDegree(node) > 0;
+        default:
+            return false;
+        }
+    }
+
+}
+
+METHAN_API Methan::RewrittenGraph Methan::foldConstants(const Graph& graph, Span<const NodeHandle> outputs, ThreadPool& pool)
+{
+    const std::vector<NodeIndex> order = graph.topologicalOrder();
+    const size_t nodeCount = graph.nodeCount();
+
+    std::vector<bool> kept(nodeCount, false);
+    for(size_t i = 0; i < outputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(graph.contains(outputs[i]), Methan::ExceptionType::IllegalArgument, "The requested output is not a node of the graph");
+        kept[Graph::index(outputs[i])] = true;
+    }
+
+    // Tensors of the constant nodes, original or folded
+    std::vector<Tensor> values(nodeCount);
+    std::vector<bool> constant(nodeCount, false);
+    std::vector<Tensor> operands;
+    for(NodeIndex index : order)
+    {
+        const NodeHandle node = Graph::handle(index);
+        if(graph.op(node) == OpCode::Constant)
+        {
+            constant[index] = graph.payload(node).is<Tensor>();
+            if(constant[index]) values[index] = graph.payload(node).get<Tensor>();
+            continue;
+        }
+
+        const Span<const NodeIndex> predecessors = graph.inputs(node);
+        if(!__is_foldable(graph, node) || !std::all_of(predecessors.begin(), predecessors.end(), [&](NodeIndex input) { return constant[input]; })) continue;
+
+        operands.clear();
+        for(NodeIndex input : predecessors) operands.push_back(values[input]);
+        try
+        {
+            values[index] = Evaluator::evaluateNode(graph, node, Span<const Tensor>(operands.data(), operands.size()), pool);
+            constant[index] = true;
+        }
+        catch(const Methan::Exception&)
+        {
+            // Invalid nodes are left to the evaluation of the graph, which reports them
+        }
+    }
+
+    RewrittenGraph result;
+    result.graph.reserve(nodeCount, graph.edgeCount());
+    result.mapping.assign(nodeCount, nullptr);
+
+    std::vector<NodeHandle> inputs;
+    for(NodeIndex index : order)
+    {
+        const NodeHandle node = Graph::handle(index);
+        if(constant[index])
+        {
+            // The constants only consumed by folded nodes are not needed anymore
+            const Span<const NodeIndex> consumers = graph.outputs(node);
+            const bool folded = !consumers.empty() && std::all_of(consumers.begin(), consumers.end(), [&](NodeIndex consumer) { return constant[consumer]; });
+            if(folded && !kept[index]) continue;
+        }
+
+        if(constant[index] && graph.op(node) != OpCode::Constant)
+        {
+            const NodeHandle folded = result.graph.addNode(OpCode::Constant, {}, values[index]);
+            graph.forEachAttribute(node, [&](AttributeKey key, const Varient& value) {
+                if(key != AttributeKey::Cost) result.graph.setAttribute(folded, key, value);
+            });
+            result.mapping[index] = folded;
+            continue;
+        }
+
+        const Span<const NodeIndex> predecessors = graph.inputs(node);
+        inputs.clear();
+        for(NodeIndex input : predecessors) inputs.push_back(result.mapping[input]);
+        result.mapping[index] = copyNode(graph, node, result.graph, Span<const NodeHandle>(inputs.data(), inputs.size()));
+    }
+
+    return result;
+}
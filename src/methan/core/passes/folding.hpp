@@ -0,0 +1,29 @@
+#pragma once
+
+#include <initializer_list>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/passes/rewrite.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Evaluate, once and for all, the `Elementwise`, `FusedElementwise` and `MatMul` nodes whose
+     * inputs are all constant (the `Constant` nodes holding a Tensor and the nodes folded before them) and
+     * replace them with `Constant` nodes holding their result, with the attributes of the node except `Cost`.
+     *
+     * A constant whose consumers are all folded is dropped (mapped to nullptr) unless it is one of the
+     * `outputs`, whose values are always kept. A node whose evaluation fails is left untouched, so that
+     * the evaluation of the graph reports it. `Custom` nodes are never folded as they may have side effects.
+     */
+    METHAN_API RewrittenGraph foldConstants(const Graph& graph, Span<const NodeHandle> outputs, ThreadPool& pool = ThreadPool::global());
+
+    inline RewrittenGraph foldConstants(const Graph& graph, std::initializer_list<NodeHandle> outputs, ThreadPool& pool = ThreadPool::global())
+    {
+        return foldConstants(graph, Span<const NodeHandle>(outputs.begin(), outputs.size()), pool);
+    }
+
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+
+#include <methan/core/passes/fusion.hpp>
+
+namespace {
+
+    // Operands of a program under construction referring to the inputs of the fused node (the other
+    // operands are instructions), renumbered once the program is complete
+    constexpr uint32_t __external = 0x80000000u;
+
+    struct FusedProgram
+    {
+        std::vector<Methan::NodeIndex> externals;
+        std::vector<Methan::ElementwiseInstruction> program;
+    };
+
+    /**
+     * @brief Whether the node is a well formed elementwise operation
+     */
+    bool __is_fusable(const Methan::Graph& graph, Methan::NodeHandle node)
+    {
+        const Methan::Varient& payload = graph.payload(node);
+        switch(graph.op(node))
+        {
+        case Methan::OpCode::Elementwise:
+            return payload.is<Methan::ElementwisePayload>() && graph.inDegree(node) == Methan::arity(payload.get<Methan::ElementwisePayload>().op);
+        case Methan::OpCode::FusedElementwise:
+            return payload.is<Methan::FusedElementwisePayload>() && !payload.get<Methan::FusedElementwisePayload>().program.empty();
+        default:
+            return false;
+        }
+    }
+
+    uint32_t __external_operand(FusedProgram& fused, Methan::NodeIndex node)
+    {
+        const auto it = std::find(fused.externals.begin(), fused.externals.end(), node);
+        if(it != fused.externals.end()) return __external | static_cast<uint32_t>(it - fused.externals.begin());
+
+        fused.externals.push_back(node);
+        return __external | static_cast<uint32_t>(fused.externals.size() - 1);
+    }
+
+}
+
+METHAN_API Methan::RewrittenGraph Methan::fuseElementwise(const Graph& graph, Span<const NodeHandle> outputs)
+{
+    const std::vector<NodeIndex> order = graph.topologicalOrder();
+    const size_t nodeCount = graph.nodeCount();
+
+    std::vector<bool> kept(nodeCount, false);
+    for(size_t i = 0; i < outputs.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(graph.contains(outputs[i]), Methan::ExceptionType::IllegalArgument, "The requested output is not a node of the graph");
+        kept[Graph::index(outputs[i])] = true;
+    }
+
+    std::vector<bool> fusable(nodeCount);
+    for(NodeIndex i = 0; i < nodeCount; ++i) fusable[i] = __is_fusable(graph, Graph::handle(i));
+
+    // A node is absorbed by its consumer when it is the only one (possibly through several edges), every
+    // node of a group is absorbed except its root, the last operation
+    std::vector<bool> absorbed(nodeCount, false);
+    for(NodeIndex i = 0; i < nodeCount; ++i)
+    {
+        const Span<const NodeIndex> consumers = graph.outputs(Graph::handle(i));
+        if(!fusable[i] || kept[i] || consumers.empty() || !fusable[consumers[0]]) continue;
+        absorbed[i] = std::all_of(consumers.begin(), consumers.end(), [&](NodeIndex consumer) { return consumer == consumers[0]; });
+    }
+
+    std::vector<NodeIndex> roots(nodeCount);
+    std::vector<bool> grouped(nodeCount, false);
+    for(auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        roots[*it] = absorbed[*it] ? roots[graph.outputs(Graph::handle(*it))[0]] : *it;
+        if(absorbed[*it]) grouped[roots[*it]] = true;
+    }
+
+    RewrittenGraph result;
+    result.graph.reserve(nodeCount, graph.edgeCount());
+    result.mapping.assign(nodeCount, nullptr);
+
+    // Programs of the groups, indexed by root, and instruction computing the value of every member
+    std::vector<FusedProgram> programs(nodeCount);
+    std::vector<uint32_t> values(nodeCount, 0);
+    std::vector<NodeHandle> inputs;
+
+    for(NodeIndex i : order)
+    {
+        const NodeHandle node = Graph::handle(i);
+        const Span<const NodeIndex> predecessors = graph.inputs(node);
+
+        if(!absorbed[i] && !grouped[i])
+        {
+            inputs.clear();
+            for(NodeIndex predecessor : predecessors) inputs.push_back(result.mapping[predecessor]);
+            result.mapping[i] = copyNode(graph, node, result.graph, Span<const NodeHandle>(inputs.data(), inputs.size()));
+            continue;
+        }
+
+        FusedProgram& fused = programs[roots[i]];
+        uint32_t operands[3] = { 0, 0, 0 };
+        std::vector<uint32_t> nested;
+        for(size_t k = 0; k < predecessors.size(); ++k)
+        {
+            const uint32_t operand = absorbed[predecessors[k]] ? values[predecessors[k]] : __external_operand(fused, predecessors[k]);
+            if(graph.op(node) == OpCode::Elementwise) operands[k] = operand;
+            else nested.push_back(operand);
+        }
+
+        if(graph.op(node) == OpCode::Elementwise)
+        {
+            const ElementwisePayload& payload = graph.payload(node).get<ElementwisePayload>();
+            fused.program.push_back({ payload.op, payload.params, { operands[0], operands[1], operands[2] } });
+        }
+        else
+        {
+            // The program of a fused node is inlined, its operands are translated
+            const std::vector<ElementwiseInstruction>& program = graph.payload(node).get<FusedElementwisePayload>().program;
+            const uint32_t base = static_cast<uint32_t>(fused.program.size());
+            for(ElementwiseInstruction instruction : program)
+            {
+                for(size_t o = 0; o < arity(instruction.op); ++o)
+                {
+                    const uint32_t operand = instruction.operands[o];
+                    METHAN_FORCE_ASSERT(operand < nested.size() + (fused.program.size() - base), Methan::ExceptionType::IllegalArgument, "The operand " + std::to_string(operand) + " of the program of the node " + std::to_string(i) + " is not defined");
+                    instruction.operands[o] = operand < nested.size() ? nested[operand] : base + (operand - static_cast<uint32_t>(nested.size()));
+                }
+                fused.program.push_back(instruction);
+            }
+        }
+        values[i] = static_cast<uint32_t>(fused.program.size() - 1);
+        if(absorbed[i]) continue;
+
+        // Root of the group: the operands are renumbered, the inputs of the program come first
+        const uint32_t externalCount = static_cast<uint32_t>(fused.externals.size());
+        FusedElementwisePayload payload;
+        payload.program = std::move(fused.program);
+        for(ElementwiseInstruction& instruction : payload.program)
+        {
+            for(size_t o = 0; o < arity(instruction.op); ++o)
+            {
+                const uint32_t operand = instruction.operands[o];
+                instruction.operands[o] = (operand & __external) ? (operand & ~__external) : externalCount + operand;
+            }
+        }
+
+        inputs.clear();
+        for(NodeIndex external : fused.externals) inputs.push_back(result.mapping[external]);
+        const NodeHandle fusedNode = result.graph.addNode(OpCode::FusedElementwise, Span<const NodeHandle>(inputs.data(), inputs.size()), std::move(payload));
+        graph.forEachAttribute(node, [&](AttributeKey key, const Varient& value) {
+            result.graph.setAttribute(fusedNode, key, value);
+        });
+        result.mapping[i] = fusedNode;
+        fused.externals.clear();
+    }
+
+    return result;
+}
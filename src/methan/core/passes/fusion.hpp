@@ -0,0 +1,29 @@
+#pragma once
+
+#include <initializer_list>
+
+#include <methan/core/except.hpp>
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/passes/rewrite.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Fuse the chains and trees of elementwise operations into `FusedElementwise` nodes, computed in a
+     * single pass over the data (see Methan::elementwise). An `Elementwise` (or `FusedElementwise`) node is
+     * merged into the node consuming it when that node is elementwise as well, is the only one reading its
+     * result and the node is not one of the `outputs`, whose values are always kept.
+     *
+     * The other nodes are copied (see copyNode). A fused node keeps the attributes of the last operation of
+     * its program, nodes with an invalid payload are never fused so that their evaluation reports them.
+     */
+    METHAN_API RewrittenGraph fuseElementwise(const Graph& graph, Span<const NodeHandle> outputs);
+
+    inline RewrittenGraph fuseElementwise(const Graph& graph, std::initializer_list<NodeHandle> outputs)
+    {
+        return fuseElementwise(graph, Span<const NodeHandle>(outputs.begin(), outputs.size()));
+    }
+
+}
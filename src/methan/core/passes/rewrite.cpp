@@ -0,0 +1,10 @@
+#include <methan/core/passes/rewrite.hpp>
+
+METHAN_API Methan::NodeHandle Methan::copyNode(const Graph& source, NodeHandle node, Graph& target, Span<const NodeHandle> inputs)
+{
+    const NodeHandle copy = target.addNode(source.op(node), inputs, source.payload(node));
+    source.forEachAttribute(node, [&](AttributeKey key, const Varient& value) {
+        target.setAttribute(copy, key, value);
+    });
+    return copy;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include <methan/core/except.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Result of a pass transforming a graph: the new graph and, for every node of the original
+     * graph, the node of the new graph that computes the same value (nullptr if the value is not computed
+     * anymore, such as the intermediate results of fused operations).
+     */
+    struct RewrittenGraph
+    {
+        Graph graph;
+        std::vector<NodeHandle> mapping;
+
+        /**
+         * @brief The node of the new graph computing the value of `node` (a node of the original graph)
+         */
+        inline NodeHandle map(NodeHandle node) const
+        {
+            METHAN_ASSERT_INDEX(Graph::index(node), mapping.size());
+            return mapping[Graph::index(node)];
+        }
+    };
+
+    /**
+     * @brief Append to `target` a copy of the node of `source` (operation, payload and attributes) whose inputs
+     * are the given nodes of `target`. An `IllegalState` exception is raised if the payload cannot be copied.
+     */
+    METHAN_API NodeHandle copyNode(const Graph& source, NodeHandle node, Graph& target, Span<const NodeHandle> inputs);
+
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+#include <methan/core/profiler.hpp>
+#include <methan/utility/assertion.hpp>
+
+namespace {
+
+    /**
+     * @brief Ring of the events of a thread. Only the thread writes the events and `count`; `start` is
+     * moved by clearProfile.
+     */
+    struct ProfileBuffer
+    {
+        explicit ProfileBuffer(uint32_t thread)
+        : thread(thread),
+        events(new Methan::ProfileEvent[Methan::ProfileBufferCapacity]),
+        count(0),
+        start(0)
+        {}
+
+        const uint32_t thread;
+        const std::unique_ptr<Methan::ProfileEvent[]> events;
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> start;
+    };
+
+    struct ProfileRegistry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ProfileBuffer>> buffers;
+    };
+
+    /**
+     * @brief Buffers of every thread that recorded an event. Never destroyed, the threads of the static
+     * pools may still record while the other statics are destroyed.
+     */
+    ProfileRegistry& __registry()
+    {
+        static ProfileRegistry* registry = new ProfileRegistry();
+        return *registry;
+    }
+
+    /**
+     * @brief Buffer of the calling thread, null if it could not be allocated (the events are then dropped)
+     */
+    ProfileBuffer* __local_buffer() noexcept
+    {
+        thread_local ProfileBuffer* buffer = []() noexcept -> ProfileBuffer* {
+            try
+            {
+                ProfileRegistry& registry = __registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.buffers.push_back(std::make_shared<ProfileBuffer>(static_cast<uint32_t>(registry.buffers.size())));
+                return registry.buffers.back().get();
+            }
+            catch(...)
+            {
+                return nullptr;
+            }
+        }();
+        return buffer;
+    }
+
+    void __write_json_string(std::ostream& stream, const char* text)
+    {
+        stream << '"';
+        for(const char* c = text; *c != '\0'; ++c)
+        {
+            if(*c == '"' || *c == '\\') stream << '\\' << *c;
+            else if(static_cast<unsigned char>(*c) >= 0x20) stream << *c;
+        }
+        stream << '"';
+    }
+
+}
+
+METHAN_API uint64_t Methan::profileClock() noexcept
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+METHAN_API void Methan::recordProfileEvent(const char* name, int64_t argument, uint64_t begin, uint64_t end) noexcept
+{
+    ProfileBuffer* buffer = __local_buffer();
+    if(buffer == nullptr) return;
+
+    const uint64_t count = buffer->count.load(std::memory_order_relaxed);
+    buffer->events[count & (ProfileBufferCapacity - 1)] = ProfileEvent{ name, argument, begin, end, buffer->thread };
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+METHAN_API std::vector<Methan::ProfileEvent> Methan::collectProfile()
+{
+    std::vector<ProfileEvent> events;
+    {
+        ProfileRegistry& registry = __registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for(const std::shared_ptr<ProfileBuffer>& buffer : registry.buffers)
+        {
+            const uint64_t count = buffer->count.load(std::memory_order_acquire);
+            uint64_t first = buffer->start.load(std::memory_order_relaxed);
+            if(count - std::min(first, count) > ProfileBufferCapacity) first = count - ProfileBufferCapacity;
+            for(uint64_t i = first; i < count; ++i) events.push_back(buffer->events[i & (ProfileBufferCapacity - 1)]);
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+        return a.begin != b.begin ? a.begin < b.begin : a.thread < b.thread;
+    });
+    return events;
+}
+
+METHAN_API void Methan::clearProfile() noexcept
+{
+    ProfileRegistry& registry = __registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(const std::shared_ptr<ProfileBuffer>& buffer : registry.buffers)
+    {
+        buffer->start.store(buffer->count.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+METHAN_API void Methan::writeChromeTrace(std::ostream& stream, const std::vector<ProfileEvent>& events)
+{
+    uint64_t origin = ~uint64_t(0);
+    for(const ProfileEvent& event : events) origin = std::min(origin, event.begin);
+
+    const std::ios_base::fmtflags flags = stream.flags();
+    stream.setf(std::ios_base::fixed, std::ios_base::floatfield);
+    const std::streamsize precision = stream.precision(3);
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for(size_t i = 0; i < events.size(); ++i)
+    {
+        const ProfileEvent& event = events[i];
+        stream << (i > 0 ? ",\n" : "\n") << "{\"name\":";
+        __write_json_string(stream, event.name);
+        stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+               << ",\"ts\":" << static_cast<double>(event.begin - origin) * 1e-3
+               << ",\"dur\":" << static_cast<double>(event.end - event.begin) * 1e-3;
+        if(event.argument >= 0) stream << ",\"args\":{\"node\":" << event.argument << "}";
+        stream << "}";
+    }
+    stream << "\n]}\n";
+
+    stream.precision(precision);
+    stream.flags(flags);
+}
+
+METHAN_API void Methan::saveChromeTrace(const std::string& path)
+{
+    std::ofstream file(path);
+    METHAN_FORCE_ASSERT(file.is_open(), Methan::ExceptionType::IllegalArgument, "Cannot open the file " + path);
+    writeChromeTrace(file, collectProfile());
+    file.flush();
+    METHAN_FORCE_ASSERT(file.good(), Methan::ExceptionType::ExecutionError, "Cannot write the trace to " + path);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <methan/core/except.hpp>
+
+/**
+ * @brief Profiling zones, recorded only when the library is configured with METHAN_ENABLE_PROFILING and
+ * compiled to nothing otherwise. `name` must be a string with static storage duration (typically a
+ * literal), `node` the index of the node the zone works on.
+ */
+#if defined(METHAN_ENABLE_PROFILING)
+#define METHAN_PROFILE_SCOPE(name)                                   Methan::ProfileScope METHAN_CONCATENATE(__methanProfileScope, __LINE__)(name)
+#define METHAN_PROFILE_NODE(name, node)                              Methan::ProfileScope METHAN_CONCATENATE(__methanProfileScope, __LINE__)(name, static_cast<int64_t>(node))
+#else
+#define METHAN_PROFILE_SCOPE(name)                                   ((void) 0)
+#define METHAN_PROFILE_NODE(name, node)                              ((void) 0)
+#endif
+
+namespace Methan {
+
+    /**
+     * @brief Span of time spent by a thread in a profiling zone
+     */
+    struct ProfileEvent
+    {
+        const char* name;
+
+        /**
+         * @brief Index of the node the zone worked on, -1 if none
+         */
+        int64_t argument;
+
+        /**
+         * @brief Timestamps of the zone, in nanoseconds of profileClock
+         */
+        uint64_t begin;
+        uint64_t end;
+
+        /**
+         * @brief Index of the recording thread, in the order in which the threads recorded their first zone
+         */
+        uint32_t thread;
+    };
+
+    /**
+     * @brief Number of events kept per thread, the oldest ones are overwritten
+     */
+    constexpr size_t ProfileBufferCapacity = size_t(1) << 15;
+
+    /**
+     * @brief Monotonic time, in nanoseconds
+     */
+    METHAN_API uint64_t profileClock() noexcept;
+
+    /**
+     * @brief Append an event to the buffer of the calling thread. The buffer is only written by its thread,
+     * recording takes neither lock nor allocation (except for the first event of the thread).
+     */
+    METHAN_API void recordProfileEvent(const char* name, int64_t argument, uint64_t begin, uint64_t end) noexcept;
+
+    /**
+     * @brief Return the events of every thread recorded since the last clearProfile, ordered by beginning.
+     * The threads should not be recording meanwhile: an event overwritten while it is copied is torn.
+     */
+    METHAN_API std::vector<ProfileEvent> collectProfile();
+
+    /**
+     * @brief Forget the events recorded so far
+     */
+    METHAN_API void clearProfile() noexcept;
+
+    /**
+     * @brief Write events in the Chrome trace event format (complete events, one track per thread), to be
+     * opened with chrome://tracing or Perfetto. The timestamps are relative to the first event.
+     */
+    METHAN_API void writeChromeTrace(std::ostream& stream, const std::vector<ProfileEvent>& events);
+
+    /**
+     * @brief Write the collected events to the file `path` in the Chrome trace event format
+     */
+    METHAN_API void saveChromeTrace(const std::string& path);
+
+    /**
+     * @brief Record the span of its lifetime, see METHAN_PROFILE_SCOPE
+     */
+    class ProfileScope
+    {
+    public:
+        inline explicit ProfileScope(const char* name, int64_t argument = -1) noexcept
+        : m_name(name),
+        m_argument(argument),
+        m_begin(profileClock())
+        {}
+
+        inline ~ProfileScope()
+        {
+            recordProfileEvent(m_name, m_argument, m_begin, profileClock());
+        }
+
+        METHAN_DISABLE_COPY_MOVE(ProfileScope);
+
+    private:
+        const char* m_name;
+        int64_t m_argument;
+        uint64_t m_begin;
+    };
+
+}
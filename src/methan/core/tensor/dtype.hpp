@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <methan/core/except.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Type of the elements of a Tensor
+     */
+    enum class DataType : uint8_t
+    {
+        Float16,
+        Float32,
+        Float64,
+        Int32,
+        Int64,
+        UInt8
+    };
+
+    /**
+     * @brief Size (in bytes) of a single element of the given type
+     */
+    constexpr size_t sizeOf(DataType type) noexcept
+    {
+        switch(type)
+        {
+        case DataType::Float16: return 2;
+        case DataType::Float32: return 4;
+        case DataType::Float64: return 8;
+        case DataType::Int32: return 4;
+        case DataType::Int64: return 8;
+        case DataType::UInt8: return 1;
+        }
+        return 0;
+    }
+
+    METHAN_API std::string to_string(DataType type);
+
+    /**
+     * @brief IEEE 754 half precision number (DataType::Float16). It is only a storage type, computations
+     * are done in single precision.
+     */
+    struct Half
+    {
+        uint16_t bits;
+    };
+
+    /**
+     * @brief Convert a half to single precision (exact)
+     */
+    METHAN_API float toFloat(Half value) noexcept;
+
+    /**
+     * @brief Convert a single precision number to half precision, rounding to the nearest even
+     */
+    METHAN_API Half toHalf(float value) noexcept;
+
+    /**
+     * @brief Map a C++ type to its DataType
+     */
+    template<typename T>
+    struct DataTypeOf;
+
+    template<> struct DataTypeOf<Half> { static constexpr DataType value = DataType::Float16; };
+    template<> struct DataTypeOf<float> { static constexpr DataType value = DataType::Float32; };
+    template<> struct DataTypeOf<double> { static constexpr DataType value = DataType::Float64; };
+    template<> struct DataTypeOf<int32_t> { static constexpr DataType value = DataType::Int32; };
+    template<> struct DataTypeOf<int64_t> { static constexpr DataType value = DataType::Int64; };
+    template<> struct DataTypeOf<uint8_t> { static constexpr DataType value = DataType::UInt8; };
+
+}
@@ -0,0 +1,332 @@
+#include <cstring>
+#include <utility>
+
+#include <methan/core/tensor/tensor.hpp>
+
+namespace {
+
+    /**
+     * @brief Call `function(destinationOffset, sourceOffset)` (in elements) for every element of the shape,
+     * in row-major order. The innermost axis is handled as a run of `shape[rank - 1]` elements.
+     */
+    template<typename Function>
+    void __for_each_row(const Methan::Shape& shape, const Methan::Shape& destinationStrides, const Methan::Shape& sourceStrides, Function&& function)
+    {
+        const size_t rank = shape.rank();
+        if(shape.elementCount() == 0) return;
+        if(rank == 0)
+        {
+            function(int64_t(0), int64_t(0));
+            return;
+        }
+
+        std::array<int64_t, Methan::Shape::MaxRank> index{};
+        int64_t destination = 0;
+        int64_t source = 0;
+
+        while(true)
+        {
+            function(destination, source);
+
+            // Increment the index of the outer axes (the innermost one is handled by the function)
+            size_t axis = rank - 1;
+            while(axis > 0)
+            {
+                --axis;
+                ++index[axis];
+                destination += destinationStrides[axis];
+                source += sourceStrides[axis];
+                if(index[axis] < shape[axis]) break;
+
+                destination -= destinationStrides[axis] * shape[axis];
+                source -= sourceStrides[axis] * shape[axis];
+                index[axis] = 0;
+                if(axis == 0) return;
+            }
+
+            if(rank == 1) return;
+        }
+    }
+
+}
+
+METHAN_API std::string Methan::to_string(DataType type)
+{
+    switch(type)
+    {
+    case DataType::Float16: return "Float16";
+    case DataType::Float32: return "Float32";
+    case DataType::Float64: return "Float64";
+    case DataType::Int32: return "Int32";
+    case DataType::Int64: return "Int64";
+    case DataType::UInt8: return "UInt8";
+    }
+    return "Unknown";
+}
+
+METHAN_API float Methan::toFloat(Half value) noexcept
+{
+    const uint32_t sign = static_cast<uint32_t>(value.bits & 0x8000) << 16;
+    uint32_t bits = static_cast<uint32_t>(value.bits & 0x7FFF) << 13;
+    const uint32_t exponent = bits & 0x0F800000;
+
+    // Rebias the exponent (15 -> 127)
+    bits += (127 - 15) << 23;
+    if(exponent == 0x0F800000) bits += (128 - 16) << 23;
+    else if(exponent == 0)
+    {
+        // Subnormal, renormalized by the FPU
+        bits += 1 << 23;
+        float result;
+        const uint32_t magic = 113 << 23;
+        float offset;
+        std::memcpy(&result, &bits, sizeof(float));
+        std::memcpy(&offset, &magic, sizeof(float));
+        result -= offset;
+        std::memcpy(&bits, &result, sizeof(float));
+    }
+
+    bits |= sign;
+    float result;
+    std::memcpy(&result, &bits, sizeof(float));
+    return result;
+}
+
+METHAN_API Methan::Half Methan::toHalf(float value) noexcept
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    bits &= 0x7FFFFFFF;
+
+    // Infinity and NaN (kept quiet)
+    if(bits >= 0x7F800000) return Half{ static_cast<uint16_t>(sign | (bits > 0x7F800000 ? 0x7E00 : 0x7C00)) };
+    // Too large, rounds to infinity
+    if(bits >= 0x477FF000) return Half{ static_cast<uint16_t>(sign | 0x7C00) };
+
+    if(bits < 0x38800000)
+    {
+        // Subnormal (or zero): let the FPU round by aligning the mantissa on 0.5
+        const uint32_t magic = 126 << 23;
+        float shifted, offset;
+        std::memcpy(&shifted, &bits, sizeof(float));
+        std::memcpy(&offset, &magic, sizeof(float));
+        shifted += offset;
+        std::memcpy(&bits, &shifted, sizeof(float));
+        return Half{ static_cast<uint16_t>(sign | (bits - magic)) };
+    }
+
+    // Normal: rebias the exponent (127 -> 15) and round to the nearest even
+    const uint32_t odd = (bits >> 13) & 1;
+    bits += ((15u - 127u) << 23) + 0xFFF + odd;
+    return Half{ static_cast<uint16_t>(sign | (bits >> 13)) };
+}
+
+METHAN_API Methan::Buffer::Buffer(size_t size, std::pmr::memory_resource* resource)
+: m_resource(resource),
+m_data(nullptr),
+m_size(size),
+m_capacity((size + Alignment - 1) / Alignment * Alignment)
+{
+    METHAN_ASSERT_NON_NULL(resource);
+    if(m_capacity == 0) m_capacity = Alignment;
+    m_data = m_resource->allocate(m_capacity, Alignment);
+}
+
+METHAN_API Methan::Buffer::Buffer(void* data, size_t size, std::shared_ptr<const void> owner)
+: m_resource(nullptr),
+m_owner(std::move(owner)),
+m_data(data),
+m_size(size),
+m_capacity(size)
+{
+    METHAN_ASSERT_NON_NULL(data);
+    METHAN_FORCE_ASSERT(reinterpret_cast<uintptr_t>(data) % Alignment == 0 && size % Alignment == 0, Methan::ExceptionType::IllegalArgument, "The storage of a buffer must be aligned and padded to the alignment");
+}
+
+METHAN_API Methan::Buffer::~Buffer()
+{
+    if(m_resource != nullptr) m_resource->deallocate(m_data, m_capacity, Alignment);
+}
+
+METHAN_API Methan::Tensor::Tensor() noexcept
+: m_dtype(DataType::Float32),
+m_offset(0)
+{}
+
+METHAN_API Methan::Tensor::Tensor(DataType type, const Shape& shape, std::pmr::memory_resource* resource)
+: m_dtype(type),
+m_shape(shape),
+m_strides(contiguousStrides(shape)),
+m_offset(0)
+{
+    for(int64_t dim : shape) METHAN_FORCE_ASSERT(dim >= 0, Methan::ExceptionType::IllegalArgument, "The dimensions of a tensor cannot be negative");
+    m_buffer = std::make_shared<Buffer>(static_cast<size_t>(shape.elementCount()) * sizeOf(type), resource);
+}
+
+METHAN_API Methan::Tensor::Tensor(std::shared_ptr<Buffer> buffer, size_t offset, DataType type, const Shape& shape)
+: m_buffer(std::move(buffer)),
+m_dtype(type),
+m_shape(shape),
+m_strides(contiguousStrides(shape)),
+m_offset(static_cast<int64_t>(offset / sizeOf(type)))
+{
+    METHAN_FORCE_ASSERT(m_buffer != nullptr, Methan::ExceptionType::NullPointer, "A tensor cannot be created over a null buffer");
+    for(int64_t dim : shape) METHAN_FORCE_ASSERT(dim >= 0, Methan::ExceptionType::IllegalArgument, "The dimensions of a tensor cannot be negative");
+    METHAN_FORCE_ASSERT(offset % sizeOf(type) == 0, Methan::ExceptionType::IllegalArgument, "The offset of a tensor must be a multiple of the size of its elements");
+    METHAN_FORCE_ASSERT(offset + static_cast<size_t>(shape.elementCount()) * sizeOf(type) <= m_buffer->capacity(), Methan::ExceptionType::IndexOutOfBounds, "The tensor does not fit in the buffer");
+}
+
+METHAN_API Methan::Tensor Methan::Tensor::zeros(DataType type, const Shape& shape, std::pmr::memory_resource* resource)
+{
+    Tensor tensor(type, shape, resource);
+    std::memset(tensor.rawData(), 0, tensor.m_buffer->capacity());
+    return tensor;
+}
+
+METHAN_API Methan::Shape Methan::Tensor::contiguousStrides(const Shape& shape)
+{
+    Shape strides = shape;
+    int64_t stride = 1;
+    for(size_t axis = shape.rank(); axis > 0; --axis)
+    {
+        strides[axis - 1] = stride;
+        stride *= shape[axis - 1];
+    }
+    return strides;
+}
+
+METHAN_API bool Methan::Tensor::isContiguous() const noexcept
+{
+    int64_t expected = 1;
+    for(size_t axis = rank(); axis > 0; --axis)
+    {
+        // The stride of an axis of size 1 does not matter
+        if(m_shape[axis - 1] != 1 && m_strides[axis - 1] != expected) return false;
+        expected *= m_shape[axis - 1];
+    }
+    return true;
+}
+
+METHAN_API Methan::Tensor Methan::Tensor::slice(size_t axis, int64_t begin, int64_t end, int64_t step) const
+{
+    METHAN_FORCE_ASSERT_INDEX(axis, rank());
+    METHAN_FORCE_ASSERT(step > 0, Methan::ExceptionType::IllegalArgument, "The step of a slice must be positive");
+    METHAN_FORCE_ASSERT(0 <= begin && begin <= end && end <= m_shape[axis], Methan::ExceptionType::IndexOutOfBounds, "The slice [" + std::to_string(begin) + ", " + std::to_string(end) + ") is out of bounds of an axis of size " + std::to_string(m_shape[axis]));
+
+    Tensor view = *this;
+    view.m_offset += begin * m_strides[axis];
+    view.m_shape[axis] = (end - begin + step - 1) / step;
+    view.m_strides[axis] *= step;
+    return view;
+}
+
+METHAN_API Methan::Tensor Methan::Tensor::transpose(size_t first, size_t second) const
+{
+    METHAN_FORCE_ASSERT_INDEX(first, rank());
+    METHAN_FORCE_ASSERT_INDEX(second, rank());
+
+    Tensor view = *this;
+    std::swap(view.m_shape[first], view.m_shape[second]);
+    std::swap(view.m_strides[first], view.m_strides[second]);
+    return view;
+}
+
+METHAN_API Methan::Tensor Methan::Tensor::permute(Span<const size_t> order) const
+{
+    METHAN_FORCE_ASSERT(order.size() == rank(), Methan::ExceptionType::IllegalArgument, "The permutation must list every axis of the tensor");
+
+    Tensor view = *this;
+    uint32_t seen = 0;
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+        METHAN_FORCE_ASSERT(order[i] < rank() && !(seen & (1u << order[i])), Methan::ExceptionType::IllegalArgument, "The permutation must list every axis of the tensor exactly once");
+        seen |= 1u << order[i];
+        view.m_shape[i] = m_shape[order[i]];
+        view.m_strides[i] = m_strides[order[i]];
+    }
+    return view;
+}
+
+METHAN_API Methan::Tensor Methan::Tensor::reshape(const Shape& shape) const
+{
+    METHAN_FORCE_ASSERT(shape.elementCount() == elementCount(), Methan::ExceptionType::IllegalArgument, "Cannot reshape a tensor of " + std::to_string(elementCount()) + " elements into " + std::to_string(shape.elementCount()) + " elements");
+    METHAN_FORCE_ASSERT(isContiguous(), Methan::ExceptionType::IllegalState, "Only a contiguous tensor can be reshaped without copy");
+
+    Tensor view = *this;
+    view.m_shape = shape;
+    view.m_strides = contiguousStrides(shape);
+    return view;
+}
+
+METHAN_API Methan::Tensor Methan::Tensor::broadcastTo(const Shape& shape) const
+{
+    METHAN_FORCE_ASSERT(shape.rank() >= rank(), Methan::ExceptionType::IllegalArgument, "Cannot broadcast a tensor to a lower rank");
+
+    // Dimensions are aligned on the right, the missing leading axes are broadcast
+    Tensor view = *this;
+    view.m_shape = shape;
+    view.m_strides = shape;
+    const size_t shift = shape.rank() - rank();
+    for(size_t axis = 0; axis < shape.rank(); ++axis)
+    {
+        if(axis < shift)
+        {
+            view.m_strides[axis] = 0;
+            continue;
+        }
+
+        const int64_t dim = m_shape[axis - shift];
+        METHAN_FORCE_ASSERT(dim == shape[axis] || dim == 1, Methan::ExceptionType::IllegalArgument, "Cannot broadcast a dimension of size " + std::to_string(dim) + " to " + std::to_string(shape[axis]));
+        view.m_strides[axis] = dim == shape[axis] ? m_strides[axis - shift] : 0;
+    }
+    return view;
+}
+
+METHAN_API Methan::Tensor Methan::Tensor::contiguous(std::pmr::memory_resource* resource) const
+{
+    if(isEmpty() || (isContiguous() && isAligned())) return *this;
+    return clone(resource);
+}
+
+METHAN_API Methan::Tensor Methan::Tensor::clone(std::pmr::memory_resource* resource) const
+{
+    if(isEmpty()) return Tensor();
+
+    Tensor copy(m_dtype, m_shape, resource);
+    copy.copyFrom(*this);
+    return copy;
+}
+
+METHAN_API void Methan::Tensor::copyFrom(const Tensor& source)
+{
+    METHAN_FORCE_ASSERT(m_dtype == source.m_dtype, Methan::ExceptionType::IllegalArgument, "Cannot copy a tensor of " + to_string(source.m_dtype) + " into a tensor of " + to_string(m_dtype));
+    METHAN_FORCE_ASSERT(m_shape == source.m_shape, Methan::ExceptionType::IllegalArgument, "Cannot copy a tensor into a tensor of a different shape");
+
+    const size_t size = elementSize();
+    unsigned char* destination = static_cast<unsigned char*>(rawData());
+    const unsigned char* origin = static_cast<const unsigned char*>(source.rawData());
+
+    if(isContiguous() && source.isContiguous())
+    {
+        std::memmove(destination, origin, static_cast<size_t>(elementCount()) * size);
+        return;
+    }
+
+    const size_t innerAxis = rank() - 1;
+    const int64_t rowLength = rank() == 0 ? 1 : m_shape[innerAxis];
+    const int64_t destinationStride = rank() == 0 ? 1 : m_strides[innerAxis];
+    const int64_t sourceStride = rank() == 0 ? 1 : source.m_strides[innerAxis];
+
+    __for_each_row(m_shape, m_strides, source.m_strides, [&](int64_t destinationOffset, int64_t sourceOffset) {
+        unsigned char* to = destination + destinationOffset * static_cast<int64_t>(size);
+        const unsigned char* from = origin + sourceOffset * static_cast<int64_t>(size);
+        if(destinationStride == 1 && sourceStride == 1)
+        {
+            std::memmove(to, from, static_cast<size_t>(rowLength) * size);
+            return;
+        }
+
+        for(int64_t i = 0; i < rowLength; ++i) std::memcpy(to + i * destinationStride * static_cast<int64_t>(size), from + i * sourceStride * static_cast<int64_t>(size), size);
+    });
+}
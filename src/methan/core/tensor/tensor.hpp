@@ -0,0 +1,375 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+
+#include <methan/core/except.hpp>
+#include <methan/core/tensor/dtype.hpp>
+#include <methan/utility/assertion.hpp>
+#include <methan/utility/span.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Fixed capacity list of dimensions (or strides) of a Tensor, it never allocates
+     */
+    class Shape
+    {
+    public:
+        static constexpr size_t MaxRank = 8;
+
+        inline Shape() noexcept
+        : m_dims{},
+        m_rank(0)
+        {}
+
+        inline Shape(std::initializer_list<int64_t> dims)
+        : Shape(Span<const int64_t>(dims.begin(), dims.size()))
+        {}
+
+        inline explicit Shape(Span<const int64_t> dims)
+        : m_dims{},
+        m_rank(dims.size())
+        {
+            METHAN_FORCE_ASSERT(dims.size() <= MaxRank, Methan::ExceptionType::IllegalArgument, "A tensor cannot have more than " + std::to_string(MaxRank) + " dimensions");
+            for(size_t i = 0; i < m_rank; ++i) m_dims[i] = dims[i];
+        }
+
+        inline size_t rank() const noexcept
+        {
+            return m_rank;
+        }
+
+        inline int64_t operator[](size_t axis) const
+        {
+            METHAN_ASSERT_INDEX(axis, m_rank);
+            return m_dims[axis];
+        }
+
+        inline int64_t& operator[](size_t axis)
+        {
+            METHAN_ASSERT_INDEX(axis, m_rank);
+            return m_dims[axis];
+        }
+
+        /**
+         * @brief Product of the dimensions (1 for a scalar)
+         */
+        inline int64_t elementCount() const noexcept
+        {
+            int64_t count = 1;
+            for(size_t i = 0; i < m_rank; ++i) count *= m_dims[i];
+            return count;
+        }
+
+        inline const int64_t* begin() const noexcept
+        {
+            return m_dims.data();
+        }
+
+        inline const int64_t* end() const noexcept
+        {
+            return m_dims.data() + m_rank;
+        }
+
+        inline bool operator==(const Shape& other) const noexcept
+        {
+            if(m_rank != other.m_rank) return false;
+            for(size_t i = 0; i < m_rank; ++i) if(m_dims[i] != other.m_dims[i]) return false;
+            return true;
+        }
+
+        inline bool operator!=(const Shape& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        std::array<int64_t, MaxRank> m_dims;
+        size_t m_rank;
+    };
+
+    namespace details {
+
+        /**
+         * @brief Width of the widest vector register a kernel may use, including the kernels selected at
+         * run time (see methan/core/cpu.hpp)
+         */
+        constexpr size_t kernelVectorWidth() noexcept
+        {
+#if defined(METHAN_DISPATCH_AVX512)
+            return 64;
+#elif defined(METHAN_DISPATCH_AVX2)
+            return METHAN_SIMD_WIDTH > 32 ? METHAN_SIMD_WIDTH : 32;
+#else
+            return METHAN_SIMD_WIDTH;
+#endif
+        }
+
+    }
+
+    /**
+     * @brief Raw storage of one or more tensors. The storage is aligned on `Buffer::Alignment` (the width
+     * of the widest vector register) and its capacity is rounded up to a multiple of the alignment, so
+     * that a kernel can process the last elements of a contiguous tensor with a full vector.
+     */
+    class Buffer
+    {
+    public:
+        static constexpr size_t Alignment = details::kernelVectorWidth() > alignof(std::max_align_t) ? details::kernelVectorWidth() : alignof(std::max_align_t);
+
+        METHAN_API explicit Buffer(size_t size, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        /**
+         * @brief Buffer over a storage it does not own (e.g. a memory mapped file), kept alive by `owner`.
+         * The storage must be aligned on `Alignment` and its size a multiple of it.
+         */
+        METHAN_API Buffer(void* data, size_t size, std::shared_ptr<const void> owner);
+
+        METHAN_API ~Buffer();
+
+        METHAN_DISABLE_COPY_MOVE(Buffer);
+
+        inline void* data() noexcept
+        {
+            return m_data;
+        }
+
+        inline const void* data() const noexcept
+        {
+            return m_data;
+        }
+
+        /**
+         * @brief The requested size (in bytes)
+         */
+        inline size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        /**
+         * @brief The allocated size (in bytes), a multiple of the alignment
+         */
+        inline size_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+    private:
+        // Null when the storage is owned by `m_owner`
+        std::pmr::memory_resource* m_resource;
+        std::shared_ptr<const void> m_owner;
+        void* m_data;
+        size_t m_size;
+        size_t m_capacity;
+    };
+
+    /**
+     * @brief Strided n-dimensional view over a Buffer. Copying a Tensor, or taking a view of it (slice,
+     * transpose, reshape...), shares the underlying buffer without copying the elements; use `clone` for
+     * a deep copy. Strides are expressed in elements and may be zero (broadcast) but not negative.
+     */
+    class Tensor
+    {
+    public:
+        /**
+         * @brief Empty tensor, without storage
+         */
+        METHAN_API Tensor() noexcept;
+
+        /**
+         * @brief Allocate a contiguous (row-major) tensor, the elements are left uninitialized
+         */
+        METHAN_API Tensor(DataType type, const Shape& shape, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        /**
+         * @brief Contiguous tensor over the storage of an existing buffer, starting `offset` bytes into it
+         * (a multiple of the size of an element). The buffer is shared, not copied.
+         */
+        METHAN_API Tensor(std::shared_ptr<Buffer> buffer, size_t offset, DataType type, const Shape& shape);
+
+        /**
+         * @brief Allocate a contiguous tensor whose elements are all set to zero
+         */
+        METHAN_API static Tensor zeros(DataType type, const Shape& shape, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        /**
+         * @brief Row-major strides of a contiguous tensor of the given shape
+         */
+        METHAN_API static Shape contiguousStrides(const Shape& shape);
+
+        inline bool isEmpty() const noexcept
+        {
+            return m_buffer == nullptr;
+        }
+
+        inline DataType dtype() const noexcept
+        {
+            return m_dtype;
+        }
+
+        inline size_t rank() const noexcept
+        {
+            return m_shape.rank();
+        }
+
+        inline const Shape& shape() const noexcept
+        {
+            return m_shape;
+        }
+
+        inline const Shape& strides() const noexcept
+        {
+            return m_strides;
+        }
+
+        inline int64_t dim(size_t axis) const
+        {
+            return m_shape[axis];
+        }
+
+        inline int64_t stride(size_t axis) const
+        {
+            return m_strides[axis];
+        }
+
+        inline int64_t elementCount() const noexcept
+        {
+            return m_shape.elementCount();
+        }
+
+        inline size_t elementSize() const noexcept
+        {
+            return sizeOf(m_dtype);
+        }
+
+        inline const std::shared_ptr<Buffer>& buffer() const noexcept
+        {
+            return m_buffer;
+        }
+
+        /**
+         * @brief Whether or not the elements are laid out in row-major order without gaps
+         */
+        METHAN_API bool isContiguous() const noexcept;
+
+        /**
+         * @brief Whether or not the first element is aligned on `alignment` bytes
+         */
+        inline bool isAligned(size_t alignment = Buffer::Alignment) const noexcept
+        {
+            return reinterpret_cast<uintptr_t>(rawData()) % alignment == 0;
+        }
+
+        inline void* rawData() noexcept
+        {
+            return m_buffer ? static_cast<unsigned char*>(m_buffer->data()) + m_offset * elementSize() : nullptr;
+        }
+
+        inline const void* rawData() const noexcept
+        {
+            return m_buffer ? static_cast<const unsigned char*>(m_buffer->data()) + m_offset * elementSize() : nullptr;
+        }
+
+        template<typename T>
+        inline T* data()
+        {
+            METHAN_ASSERT(DataTypeOf<T>::value == m_dtype, Methan::ExceptionType::BadCastException, "Cannot access a tensor of " + to_string(m_dtype) + " as " + to_string(DataTypeOf<T>::value));
+            return static_cast<T*>(rawData());
+        }
+
+        template<typename T>
+        inline const T* data() const
+        {
+            METHAN_ASSERT(DataTypeOf<T>::value == m_dtype, Methan::ExceptionType::BadCastException, "Cannot access a tensor of " + to_string(m_dtype) + " as " + to_string(DataTypeOf<T>::value));
+            return static_cast<const T*>(rawData());
+        }
+
+        /**
+         * @brief Access the element at the given coordinates
+         */
+        template<typename T>
+        inline T& at(std::initializer_list<int64_t> index)
+        {
+            return data<T>()[__offsetOf(index)];
+        }
+
+        template<typename T>
+        inline const T& at(std::initializer_list<int64_t> index) const
+        {
+            return data<T>()[__offsetOf(index)];
+        }
+
+        /**
+         * @brief View of the elements `begin`, `begin + step`, ... (up to `end` excluded) along the axis
+         */
+        METHAN_API Tensor slice(size_t axis, int64_t begin, int64_t end, int64_t step = 1) const;
+
+        /**
+         * @brief View with the two axes swapped
+         */
+        METHAN_API Tensor transpose(size_t first, size_t second) const;
+
+        /**
+         * @brief View with the axes reordered, axis `i` of the result is the axis `order[i]` of this tensor
+         */
+        METHAN_API Tensor permute(Span<const size_t> order) const;
+
+        inline Tensor permute(std::initializer_list<size_t> order) const
+        {
+            return permute(Span<const size_t>(order.begin(), order.size()));
+        }
+
+        /**
+         * @brief View with a different shape but the same elements. An `IllegalState` exception is raised if
+         * the tensor is not contiguous (see `contiguous`).
+         */
+        METHAN_API Tensor reshape(const Shape& shape) const;
+
+        /**
+         * @brief View repeating the dimensions of size 1 to match the given shape (zero strides)
+         */
+        METHAN_API Tensor broadcastTo(const Shape& shape) const;
+
+        /**
+         * @brief This tensor if it is already contiguous and aligned, otherwise a contiguous copy
+         */
+        METHAN_API Tensor contiguous(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+        /**
+         * @brief Contiguous deep copy of the tensor
+         */
+        METHAN_API Tensor clone(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+        /**
+         * @brief Copy the elements of `source` (same type and shape) into this tensor, whatever their strides
+         */
+        METHAN_API void copyFrom(const Tensor& source);
+
+    private:
+        inline int64_t __offsetOf(std::initializer_list<int64_t> index) const
+        {
+            METHAN_ASSERT(index.size() == rank(), Methan::ExceptionType::IllegalArgument, "The number of coordinates must match the rank of the tensor");
+            int64_t offset = 0;
+            size_t axis = 0;
+            for(int64_t i : index)
+            {
+                METHAN_ASSERT_INDEX(i, m_shape[axis]);
+                offset += i * m_strides[axis++];
+            }
+            return offset;
+        }
+
+        std::shared_ptr<Buffer> m_buffer;
+        DataType m_dtype;
+        Shape m_shape;
+        Shape m_strides;
+        int64_t m_offset;
+    };
+
+}
@@ -0,0 +1,157 @@
+/**
+ * Vector implementation of the elementwise kernels, written once for every instruction set. It must be
+ * included inside an anonymous namespace (so that each instruction set gets its own copy) after the
+ * definition of the vector traits, which provide:
+ *
+ * - `Storage`: type of the elements in memory, `V`: type of a vector, `Width`: elements per vector
+ * - `Double`: whether the computation is done in double precision (otherwise in single precision)
+ * - `load(const Storage*)`, `store(Storage*, V)`: unaligned memory accesses
+ * - `set(double)`: broadcast a constant
+ * - `add`, `sub`, `mul`, `div`, `fma(a, b, c) = a * b + c`, `abs`
+ * - `min(a, b)`, `max(a, b)`: return b if either of them is NaN (as the x86 instructions do)
+ * - `select(a, b, x, y)`: x where a < b, y otherwise
+ * - `round(V)`: round to the nearest integer, `pow2(V)`: 2^n for a small integer n
+ */
+
+template<typename K>
+inline typename K::V __vector_exp(typename K::V x)
+{
+    typedef typename K::V V;
+
+    // exp(x) = 2^n * exp(r) with r = x - n * ln(2) in [-ln(2) / 2, ln(2) / 2]. The input is clamped so that
+    // 2^(n - 1) stays a normal number, the result saturates outside of that range.
+    V y;
+    V n;
+    if constexpr(K::Double)
+    {
+        x = K::min(K::set(709.782712893384), K::max(K::set(-708.0), x));
+        n = K::round(K::mul(x, K::set(1.4426950408889634)));
+        x = K::fma(n, K::set(-6.93145751953125e-1), x);
+        x = K::fma(n, K::set(-1.42860682030941723212e-6), x);
+
+        // Pade approximant (Cephes): exp(r) = 1 + 2 * P(r) / (Q(r) - P(r))
+        const V xx = K::mul(x, x);
+        V p = K::fma(K::set(1.26177193074810590878e-4), xx, K::set(3.02994407707441961300e-2));
+        p = K::mul(x, K::fma(p, xx, K::set(9.99999999999999999910e-1)));
+        V q = K::fma(K::set(3.00198505138664455042e-6), xx, K::set(2.52448340349684104192e-3));
+        q = K::fma(q, xx, K::set(2.27265548208155028766e-1));
+        q = K::fma(q, xx, K::set(2.0));
+        y = K::fma(K::set(2.0), K::div(p, K::sub(q, p)), K::set(1.0));
+    }
+    else
+    {
+        x = K::min(K::set(88.72), K::max(K::set(-86.5), x));
+        n = K::round(K::mul(x, K::set(1.44269504088896341)));
+        x = K::fma(n, K::set(-0.693359375), x);
+        x = K::fma(n, K::set(2.12194440e-4), x);
+
+        // Polynomial (Cephes): exp(r) = 1 + r + r^2 * P(r)
+        V p = K::fma(K::set(1.9875691500e-4), x, K::set(1.3981999507e-3));
+        p = K::fma(p, x, K::set(8.3334519073e-3));
+        p = K::fma(p, x, K::set(4.1665795894e-2));
+        p = K::fma(p, x, K::set(1.6666665459e-1));
+        p = K::fma(p, x, K::set(5.0000001201e-1));
+        y = K::add(K::fma(p, K::mul(x, x), x), K::set(1.0));
+    }
+
+    return K::mul(K::mul(y, K::pow2(K::sub(n, K::set(1.0)))), K::set(2.0));
+}
+
+template<typename K>
+inline typename K::V __vector_tanh(typename K::V x)
+{
+    typedef typename K::V V;
+
+    // tanh(x) = 1 - 2 / (exp(2x) + 1) loses the relative precision near 0, where the series is used instead
+    const V one = K::set(1.0);
+    const V large = K::sub(one, K::div(K::set(2.0), K::add(__vector_exp<K>(K::add(x, x)), one)));
+
+    const V xx = K::mul(x, x);
+    V p = K::fma(K::set(21844.0 / 6081075.0), xx, K::set(-1382.0 / 155925.0));
+    p = K::fma(p, xx, K::set(62.0 / 2835.0));
+    p = K::fma(p, xx, K::set(-17.0 / 315.0));
+    p = K::fma(p, xx, K::set(2.0 / 15.0));
+    p = K::fma(p, xx, K::set(-1.0 / 3.0));
+    const V small = K::fma(K::mul(p, xx), x, x);
+
+    return K::select(K::abs(x), K::set(0.125), small, large);
+}
+
+template<typename K>
+inline typename K::V __vector_sigmoid(typename K::V x)
+{
+    const typename K::V one = K::set(1.0);
+    return K::div(one, K::add(one, __vector_exp<K>(K::sub(K::set(0.0), x))));
+}
+
+/**
+ * @brief Apply `function` on vectors of `count` elements (a multiple of the width)
+ */
+template<typename K, size_t Arity, typename Function>
+inline void __vector_map(const Methan::details::ElementwiseKernelArgs& args, size_t count, Function&& function)
+{
+    typedef typename K::Storage Storage;
+    const Storage* a = static_cast<const Storage*>(args.inputs[0]);
+    const Storage* b = static_cast<const Storage*>(args.inputs[1]);
+    const Storage* c = static_cast<const Storage*>(args.inputs[2]);
+    Storage* out = static_cast<Storage*>(args.output);
+
+    for(size_t i = 0; i < count; i += K::Width)
+    {
+        if constexpr(Arity == 1) K::store(out + i, function(K::load(a + i)));
+        else if constexpr(Arity == 2) K::store(out + i, function(K::load(a + i), K::load(b + i)));
+        else K::store(out + i, function(K::load(a + i), K::load(b + i), K::load(c + i)));
+    }
+}
+
+template<typename K>
+size_t __vector_elementwise(Methan::ElementwiseOp op, const Methan::details::ElementwiseKernelArgs& args)
+{
+    typedef typename K::V V;
+    const size_t count = args.count / K::Width * K::Width;
+
+    switch(op)
+    {
+    case Methan::ElementwiseOp::Add:
+        __vector_map<K, 2>(args, count, [](V a, V b) { return K::add(a, b); });
+        break;
+    case Methan::ElementwiseOp::Sub:
+        __vector_map<K, 2>(args, count, [](V a, V b) { return K::sub(a, b); });
+        break;
+    case Methan::ElementwiseOp::Mul:
+        __vector_map<K, 2>(args, count, [](V a, V b) { return K::mul(a, b); });
+        break;
+    case Methan::ElementwiseOp::Div:
+        __vector_map<K, 2>(args, count, [](V a, V b) { return K::div(a, b); });
+        break;
+    case Methan::ElementwiseOp::Fma:
+        __vector_map<K, 3>(args, count, [](V a, V b, V c) { return K::fma(a, b, c); });
+        break;
+    case Methan::ElementwiseOp::Exp:
+        __vector_map<K, 1>(args, count, [](V a) { return __vector_exp<K>(a); });
+        break;
+    case Methan::ElementwiseOp::Tanh:
+        __vector_map<K, 1>(args, count, [](V a) { return __vector_tanh<K>(a); });
+        break;
+    case Methan::ElementwiseOp::Relu:
+    {
+        const V zero = K::set(0.0);
+        __vector_map<K, 1>(args, count, [zero](V a) { return K::max(zero, a); });
+        break;
+    }
+    case Methan::ElementwiseOp::Sigmoid:
+        __vector_map<K, 1>(args, count, [](V a) { return __vector_sigmoid<K>(a); });
+        break;
+    case Methan::ElementwiseOp::Clamp:
+    {
+        const V lower = K::set(args.lower);
+        const V upper = K::set(args.upper);
+        __vector_map<K, 1>(args, count, [lower, upper](V a) { return K::min(upper, K::max(lower, a)); });
+        break;
+    }
+    default:
+        return 0;
+    }
+
+    return count;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <methan/core/kernels/elementwise_op.hpp>
+
+/**
+ * Entry points of the elementwise kernels of each instruction set. This header is included by the
+ * translation units compiled with extended instruction sets, so it must not define any inline function
+ * (the linker could otherwise keep a copy that the running CPU does not support).
+ */
+
+namespace Methan {
+
+    namespace details {
+
+        /**
+         * @brief Element types supported by the kernels (Float16 is stored as half and computed in float)
+         */
+        enum class ElementwiseType : uint32_t
+        {
+            Float16,
+            Float32,
+            Float64
+        };
+
+        struct ElementwiseKernelArgs
+        {
+            const void* inputs[3];
+            void* output;
+            size_t count;
+            double lower;
+            double upper;
+        };
+
+        /**
+         * @brief Process the largest multiple of the vector width of `args.count` elements and return the
+         * number of elements processed (the remainder is left to the scalar kernel)
+         */
+        typedef size_t (*ElementwiseKernel)(ElementwiseOp op, ElementwiseType type, const ElementwiseKernelArgs& args);
+
+        size_t elementwiseSSE2(ElementwiseOp op, ElementwiseType type, const ElementwiseKernelArgs& args);
+        size_t elementwiseAVX2(ElementwiseOp op, ElementwiseType type, const ElementwiseKernelArgs& args);
+        size_t elementwiseAVX512(ElementwiseOp op, ElementwiseType type, const ElementwiseKernelArgs& args);
+
+    }
+
+}
@@ -0,0 +1,76 @@
+/**
+ * Register-tiled GEMM micro-kernel, written once for every instruction set. It must be included inside an
+ * anonymous namespace after the definition of the vector traits, which provide:
+ *
+ * - `T`: type of the elements, `V`: type of a vector, `Width`: elements per vector
+ * - `zero()`, `set(T)`, `broadcast(const T*)`
+ * - `load(const T*)`, `store(T*, V)`: unaligned memory accesses
+ * - `mul`, `fma(a, b, c) = a * b + c`
+ *
+ * The loops over the tile are unrolled at compile time: with constant indices the accumulators stay in
+ * registers, a loop left rolled by the compiler would keep the whole tile in memory.
+ */
+
+/**
+ * @brief Call `function(std::integral_constant<size_t, I>())` for I in [0, N)
+ */
+template<typename Function, size_t... I>
+inline void __unroll(Function&& function, std::index_sequence<I...>)
+{
+    (function(std::integral_constant<size_t, I>()), ...);
+}
+
+template<size_t N, typename Function>
+inline void __unroll(Function&& function)
+{
+    __unroll(function, std::make_index_sequence<N>());
+}
+
+/**
+ * @brief C = alpha * A * B + beta * C for a tile of MR x (NV * Width) elements. A is packed by columns of MR
+ * elements and B by rows of NV * Width elements (see gemm.cpp), C is row-major. C is not read when beta is 0.
+ */
+template<typename K, size_t MR, size_t NV>
+void __gemm_micro_kernel(size_t k, const void* packedA, const void* packedB, void* output, size_t ldc, const void* alphaPointer, const void* betaPointer)
+{
+    typedef typename K::T T;
+    typedef typename K::V V;
+
+    const T* a = static_cast<const T*>(packedA);
+    const T* b = static_cast<const T*>(packedB);
+    T* c = static_cast<T*>(output);
+    const T alpha = *static_cast<const T*>(alphaPointer);
+    const T beta = *static_cast<const T*>(betaPointer);
+
+    V accumulators[MR][NV];
+    __unroll<MR * NV>([&](auto index) { accumulators[index / NV][index % NV] = K::zero(); });
+
+    for(size_t p = 0; p < k; ++p)
+    {
+        V row[NV];
+        __unroll<NV>([&](auto j) { row[j] = K::load(b + j * K::Width); });
+
+        __unroll<MR>([&](auto i) {
+            const V value = K::broadcast(a + i);
+            __unroll<NV>([&](auto j) { accumulators[i][j] = K::fma(value, row[j], accumulators[i][j]); });
+        });
+
+        a += MR;
+        b += NV * K::Width;
+    }
+
+    const V scale = K::set(alpha);
+    if(beta == T(0))
+    {
+        __unroll<MR * NV>([&](auto index) {
+            K::store(c + (index / NV) * ldc + (index % NV) * K::Width, K::mul(accumulators[index / NV][index % NV], scale));
+        });
+        return;
+    }
+
+    const V previous = K::set(beta);
+    __unroll<MR * NV>([&](auto index) {
+        T* pointer = c + (index / NV) * ldc + (index % NV) * K::Width;
+        K::store(pointer, K::fma(accumulators[index / NV][index % NV], scale, K::mul(K::load(pointer), previous)));
+    });
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility> // std::index_sequence, used by gemm_impl.inl
+
+/**
+ * Micro-kernels of the GEMM for each instruction set. This header is included by the translation units
+ * compiled with extended instruction sets, so it must not define any inline function (see
+ * elementwise_isa.hpp).
+ */
+
+namespace Methan {
+
+    namespace details {
+
+        enum class GemmType : uint32_t
+        {
+            Float32,
+            Float64
+        };
+
+        /**
+         * @brief C = alpha * A * B + beta * C on a tile of `rows` x `columns` elements, see gemm_impl.inl.
+         * `alpha` and `beta` point to values of the element type.
+         */
+        typedef void (*GemmMicroKernel)(size_t k, const void* packedA, const void* packedB, void* c, size_t ldc, const void* alpha, const void* beta);
+
+        struct GemmKernelInfo
+        {
+            GemmMicroKernel kernel;
+            size_t rows;
+            size_t columns;
+        };
+
+        typedef GemmKernelInfo (*GemmKernelQuery)(GemmType type);
+
+        GemmKernelInfo gemmKernelSSE2(GemmType type);
+        GemmKernelInfo gemmKernelAVX2(GemmType type);
+        GemmKernelInfo gemmKernelAVX512(GemmType type);
+
+    }
+
+}
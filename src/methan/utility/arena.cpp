@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <utility>
+
+#include <methan/utility/arena.hpp>
+#include <methan/utility/assertion.hpp>
+
+namespace {
+
+    constexpr size_t MaxArenaBlockSize = size_t(64) * 1024 * 1024;
+
+    inline uintptr_t __align_up(uintptr_t value, size_t alignment) noexcept
+    {
+        return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    }
+
+}
+
+METHAN_API Methan::MonotonicArena::MonotonicArena(size_t initialBlockSize, std::pmr::memory_resource* upstream)
+: m_upstream(upstream),
+m_current(0),
+m_offset(0),
+m_nextBlockSize(std::max<size_t>(initialBlockSize, 64))
+{
+    METHAN_ASSERT_NON_NULL(upstream);
+}
+
+METHAN_API Methan::MonotonicArena::~MonotonicArena()
+{
+    release();
+}
+
+METHAN_API void Methan::MonotonicArena::release() noexcept
+{
+    for(const Block& block : m_blocks) m_upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+    m_blocks.clear();
+    m_current = 0;
+    m_offset = 0;
+}
+
+METHAN_API size_t Methan::MonotonicArena::capacity() const noexcept
+{
+    size_t total = 0;
+    for(const Block& block : m_blocks) total += block.size;
+    return total;
+}
+
+METHAN_API void* Methan::MonotonicArena::do_allocate(size_t bytes, size_t alignment)
+{
+    if(m_current < m_blocks.size())
+    {
+        const Block& block = m_blocks[m_current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        const uintptr_t begin = __align_up(base + m_offset, alignment);
+        if(begin + bytes <= base + block.size)
+        {
+            m_offset = begin + bytes - base;
+            return reinterpret_cast<void*>(begin);
+        }
+    }
+
+    return __allocateFromNextBlock(bytes, alignment);
+}
+
+METHAN_API void Methan::MonotonicArena::do_deallocate(void*, size_t, size_t)
+{
+    // Memory is only reclaimed by reset() or rewind()
+}
+
+METHAN_API bool Methan::MonotonicArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void* Methan::MonotonicArena::__allocateFromNextBlock(size_t bytes, size_t alignment)
+{
+    const size_t required = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+
+    // The blocks after the current one are unused (they were kept by a reset), any of them large enough
+    // can be moved right after the current block
+    const size_t next = m_current < m_blocks.size() ? m_current + 1 : m_blocks.size();
+    size_t found = m_blocks.size();
+    for(size_t i = next; i < m_blocks.size(); ++i)
+    {
+        if(m_blocks[i].size >= required)
+        {
+            found = i;
+            break;
+        }
+    }
+
+    if(found == m_blocks.size())
+    {
+        const size_t size = std::max(m_nextBlockSize, required);
+        m_nextBlockSize = std::min(m_nextBlockSize * 2, MaxArenaBlockSize);
+
+        Block block = { static_cast<unsigned char*>(m_upstream->allocate(size, alignof(std::max_align_t))), size };
+        m_blocks.push_back(block);
+    }
+
+    std::swap(m_blocks[next], m_blocks[found]);
+    m_current = next;
+    m_offset = 0;
+
+    const uintptr_t base = reinterpret_cast<uintptr_t>(m_blocks[m_current].data);
+    const uintptr_t begin = __align_up(base, alignment);
+    m_offset = begin + bytes - base;
+    return reinterpret_cast<void*>(begin);
+}
+
+METHAN_API Methan::PoolResource::PoolResource(size_t blockSize, size_t blockAlign, size_t blocksPerChunk, std::pmr::memory_resource* upstream)
+: m_upstream(upstream),
+m_blockSize(0),
+m_blockAlign(std::max(blockAlign, alignof(FreeBlock))),
+m_blocksPerChunk(std::max<size_t>(blocksPerChunk, 1)),
+m_free(nullptr)
+{
+    METHAN_ASSERT_NON_NULL(upstream);
+    METHAN_FORCE_ASSERT((blockAlign & (blockAlign - 1)) == 0, Methan::ExceptionType::IllegalArgument, "The alignment of the blocks must be a power of two");
+
+    // Every block must be able to hold the free list link and keep the next block aligned
+    m_blockSize = static_cast<size_t>(__align_up(std::max(blockSize, sizeof(FreeBlock)), m_blockAlign));
+}
+
+METHAN_API Methan::PoolResource::~PoolResource()
+{
+    release();
+}
+
+METHAN_API void Methan::PoolResource::release() noexcept
+{
+    for(void* chunk : m_chunks) m_upstream->deallocate(chunk, m_blockSize * m_blocksPerChunk, m_blockAlign);
+    m_chunks.clear();
+    m_free = nullptr;
+}
+
+METHAN_API void* Methan::PoolResource::do_allocate(size_t bytes, size_t alignment)
+{
+    if(!__fits(bytes, alignment)) return m_upstream->allocate(bytes, alignment);
+
+    if(m_free == nullptr)
+    {
+        unsigned char* chunk = static_cast<unsigned char*>(m_upstream->allocate(m_blockSize * m_blocksPerChunk, m_blockAlign));
+        m_chunks.push_back(chunk);
+
+        // Thread the new blocks in address order
+        for(size_t i = m_blocksPerChunk; i > 0; --i)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * m_blockSize);
+            block->next = m_free;
+            m_free = block;
+        }
+    }
+
+    FreeBlock* block = m_free;
+    m_free = block->next;
+    return block;
+}
+
+METHAN_API void Methan::PoolResource::do_deallocate(void* pointer, size_t bytes, size_t alignment)
+{
+    if(!__fits(bytes, alignment))
+    {
+        m_upstream->deallocate(pointer, bytes, alignment);
+        return;
+    }
+
+    FreeBlock* block = static_cast<FreeBlock*>(pointer);
+    block->next = m_free;
+    m_free = block;
+}
+
+METHAN_API bool Methan::PoolResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+METHAN_API Methan::MonotonicArena& Methan::scratchArena()
+{
+    thread_local MonotonicArena arena;
+    return arena;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <methan/core/except.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Monotonic (bump pointer) memory resource. Deallocation is a no-op, the memory is reclaimed
+     * all at once by `reset` or by rewinding to a previously taken marker. Blocks obtained from the upstream
+     * resource are kept across resets so that a steady workload stops allocating after warming up.
+     * The arena is not thread-safe.
+     */
+    class MonotonicArena : public std::pmr::memory_resource
+    {
+    public:
+        /**
+         * @brief Position in the arena, everything allocated after it is released by `rewind`
+         */
+        struct Marker
+        {
+            size_t block;
+            size_t offset;
+        };
+
+        METHAN_API explicit MonotonicArena(size_t initialBlockSize = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        /**
+         * @brief Return every block to the upstream resource
+         */
+        METHAN_API ~MonotonicArena();
+
+        METHAN_DISABLE_COPY_MOVE(MonotonicArena);
+
+        inline Marker mark() const noexcept
+        {
+            return Marker { m_current, m_offset };
+        }
+
+        /**
+         * @brief Release everything that was allocated after the marker was taken. Markers taken after this
+         * one are invalidated.
+         */
+        inline void rewind(const Marker& marker) noexcept
+        {
+            m_current = marker.block;
+            m_offset = marker.offset;
+        }
+
+        /**
+         * @brief Release everything that was allocated from the arena, keeping the blocks for later use
+         */
+        inline void reset() noexcept
+        {
+            rewind(Marker { 0, 0 });
+        }
+
+        /**
+         * @brief Release everything and return the blocks to the upstream resource
+         */
+        METHAN_API void release() noexcept;
+
+        /**
+         * @brief Total size of the blocks owned by the arena
+         */
+        METHAN_API size_t capacity() const noexcept;
+
+        inline std::pmr::memory_resource* upstream() const noexcept
+        {
+            return m_upstream;
+        }
+
+    protected:
+        METHAN_API void* do_allocate(size_t bytes, size_t alignment) override;
+        METHAN_API void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        METHAN_API bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        struct Block
+        {
+            unsigned char* data;
+            size_t size;
+        };
+
+        void* __allocateFromNextBlock(size_t bytes, size_t alignment);
+
+        std::pmr::memory_resource* m_upstream;
+        std::vector<Block> m_blocks;
+        size_t m_current;
+        size_t m_offset;
+        size_t m_nextBlockSize;
+    };
+
+    /**
+     * @brief Memory resource handing out blocks of a single size from a free list. Blocks are carved from
+     * chunks obtained from the upstream resource, which are only returned on `release` or destruction.
+     * Requests that do not fit in a block are forwarded to the upstream resource. The pool is not
+     * thread-safe.
+     */
+    class PoolResource : public std::pmr::memory_resource
+    {
+    public:
+        METHAN_API explicit PoolResource(size_t blockSize, size_t blockAlign = alignof(std::max_align_t), size_t blocksPerChunk = 256, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        METHAN_API ~PoolResource();
+
+        METHAN_DISABLE_COPY_MOVE(PoolResource);
+
+        /**
+         * @brief Return every chunk to the upstream resource, invalidating every block handed out
+         */
+        METHAN_API void release() noexcept;
+
+        inline size_t blockSize() const noexcept
+        {
+            return m_blockSize;
+        }
+
+    protected:
+        METHAN_API void* do_allocate(size_t bytes, size_t alignment) override;
+        METHAN_API void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        METHAN_API bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        inline bool __fits(size_t bytes, size_t alignment) const noexcept
+        {
+            return bytes <= m_blockSize && alignment <= m_blockAlign;
+        }
+
+        std::pmr::memory_resource* m_upstream;
+        size_t m_blockSize;
+        size_t m_blockAlign;
+        size_t m_blocksPerChunk;
+        FreeBlock* m_free;
+        std::vector<void*> m_chunks;
+    };
+
+    /**
+     * @brief Rewind an arena to its state at the construction of the scope when the scope is left
+     */
+    class ArenaScope
+    {
+    public:
+        inline explicit ArenaScope(MonotonicArena& arena) noexcept
+        : m_arena(arena),
+        m_marker(arena.mark())
+        {}
+
+        inline ~ArenaScope()
+        {
+            m_arena.rewind(m_marker);
+        }
+
+        METHAN_DISABLE_COPY_MOVE(ArenaScope);
+
+        inline MonotonicArena& arena() const noexcept
+        {
+            return m_arena;
+        }
+
+    private:
+        MonotonicArena& m_arena;
+        MonotonicArena::Marker m_marker;
+    };
+
+    /**
+     * @brief Arena of the calling thread, used by the library for short-lived scratch memory (such as the
+     * bookkeeping of an Executor run). Users of the scratch arena must take an ArenaScope and release
+     * their memory in a stack-like fashion.
+     */
+    METHAN_API MonotonicArena& scratchArena();
+
+}
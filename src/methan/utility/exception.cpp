@@ -1,18 +1,69 @@
+#include <atomic>
+
 #include <methan/utility/exception.hpp>
 
 METHAN_API Methan::Exception::Exception(const std::string& what, const char* file, size_t line, ExceptionType type)
-: m_file(file),
+: m_message(nullptr),
+m_ownedMessage(what),
+m_file(file),
 m_line(line),
-m_type(type)
+m_type(type),
+m_argumentCount(0)
+{}
+
+METHAN_API const char* Methan::Exception::what() const noexcept
 {
-    m_what = to_string(m_type) + "Exception : " + what + 
-             " [file=\"" + std::string(file) + "\", line=" + std::to_string(line) + "] ";
+    std::shared_ptr<const std::string> description = std::atomic_load(&m_what);
+    if(description == nullptr)
+    {
+        try
+        {
+            const std::shared_ptr<const std::string> built = std::make_shared<const std::string>(__describe());
 
+            // Another thread may have built it meanwhile, its description is the one kept
+            if(std::atomic_compare_exchange_strong(&m_what, &description, built)) description = built;
+        }
+        catch(...)
+        {
+            return message();
+        }
+    }
+    return description->c_str();
 }
 
-METHAN_API const char* Methan::Exception::what() const noexcept
+std::string Methan::Exception::__describe() const
 {
-    return m_what.c_str();
+    std::string description = to_string(m_type) + "Exception : ";
+
+    // Substitute the arguments to the `{}` of the message, in order
+    uint8_t next = 0;
+    for(const char* c = message(); *c != '\0'; ++c)
+    {
+        if(c[0] == '{' && c[1] == '}' && next < m_argumentCount)
+        {
+            const details::ExceptionArgument& argument = m_arguments[next++];
+            switch(argument.kind)
+            {
+            case details::ExceptionArgument::Kind::Signed:
+                description += std::to_string(argument.integer);
+                break;
+            case details::ExceptionArgument::Kind::Unsigned:
+                description += std::to_string(argument.unsignedInteger);
+                break;
+            case details::ExceptionArgument::Kind::String:
+                description += argument.text;
+                break;
+            }
+            ++c;
+        }
+        else
+        {
+            description += *c;
+        }
+    }
+
+    description += " [file=\"" + std::string(m_file) + "\", line=" + std::to_string(m_line) + "] ";
+    return description;
 }
 
 METHAN_API std::string Methan::to_string(ExceptionType type)
@@ -31,6 +82,8 @@ METHAN_API std::string Methan::to_string(ExceptionType type)
         return "IndexOutOfBounds";
     case ExceptionType::BadCastException:
         return "BadCastException";
+    case ExceptionType::ExecutionError:
+        return "ExecutionError";
     default:
         return "Unknown";
     }
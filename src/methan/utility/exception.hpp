@@ -1,13 +1,23 @@
 #pragma once
 
+#include <cstdint>
 #include <exception>
+#include <memory>
 #include <string>
+#include <type_traits>
 
 #include <methan/core/except.hpp>
 
 #define METHAN_THROW_EXCEPTION(what, type)                                     \
     throw Methan::Exception(what, METHAN_EXPAND(__FILE__), METHAN_EXPAND(__LINE__), type)
 
+/**
+ * @brief Throw an exception whose message is a literal where each `{}` is replaced by the next argument (at
+ * most 2 integers, enumerations or strings with static storage duration), when the message is read
+ */
+#define METHAN_THROW_EXCEPTION_FORMAT(what, type, ...)                         \
+    throw Methan::Exception(what, METHAN_EXPAND(__FILE__), METHAN_EXPAND(__LINE__), type, __VA_ARGS__)
+
 #define METHAN_INVALID_STATE                                                   \
     METHAN_THROW_EXCEPTION("No description was provided", Methan::ExceptionType::IllegalState)
 
@@ -24,6 +34,7 @@ namespace Methan {
         AlreadyInitialized,
         IndexOutOfBounds,
         BadCastException,
+        ExecutionError,
         Unknown
     };
 
@@ -36,7 +47,67 @@ namespace Methan {
     METHAN_API std::string to_string(ExceptionType type);
 
     /**
-     * @brief Basic exception class used throughout the methan API
+     * @brief Maximum number of arguments of the message of an exception
+     */
+    constexpr size_t MaxExceptionArguments = 2;
+
+    namespace details {
+
+        /**
+         * @brief Argument of the message of an exception, kept as is until the message is formatted
+         */
+        struct ExceptionArgument
+        {
+            enum class Kind : uint8_t
+            {
+                Signed,
+                Unsigned,
+                String
+            };
+
+            Kind kind;
+            union
+            {
+                int64_t integer;
+                uint64_t unsignedInteger;
+                const char* text;
+            };
+        };
+
+        template<typename T>
+        inline ExceptionArgument makeExceptionArgument(const T& value) noexcept
+        {
+            ExceptionArgument argument;
+            if constexpr(std::is_convertible<const T&, const char*>::value)
+            {
+                const char* text = value;
+                argument.kind = ExceptionArgument::Kind::String;
+                argument.text = text != nullptr ? text : "(null)";
+            }
+            else if constexpr(std::is_enum<T>::value)
+            {
+                argument = makeExceptionArgument(static_cast<typename std::underlying_type<T>::type>(value));
+            }
+            else if constexpr(std::is_integral<T>::value && std::is_signed<T>::value)
+            {
+                argument.kind = ExceptionArgument::Kind::Signed;
+                argument.integer = static_cast<int64_t>(value);
+            }
+            else
+            {
+                static_assert(std::is_integral<T>::value, "The arguments of an exception must be integers, enumerations or strings");
+                argument.kind = ExceptionArgument::Kind::Unsigned;
+                argument.unsignedInteger = static_cast<uint64_t>(value);
+            }
+            return argument;
+        }
+
+    }
+
+    /**
+     * @brief Basic exception class used throughout the methan API. Throwing is cheap: the exception keeps
+     * the message (not copied when it is a literal), its arguments, the file and the line, and only builds
+     * the description returned by `what` the first time it is requested.
      */
     class Exception : public std::exception
     {
@@ -58,6 +129,25 @@ namespace Methan {
          */
         METHAN_API Exception(const std::string& what, const char* file, size_t line, ExceptionType type = ExceptionType::Unknown);
 
+        /**
+         * @brief Create an exception whose description is a literal (kept by address), where each `{}` is
+         * replaced by the next argument when the description is built
+         *
+         * @param args at most MaxExceptionArguments integers, enumerations or strings with static storage
+         * duration
+         */
+        template<size_t N, typename... Args>
+        inline Exception(const char (&what)[N], const char* file, size_t line, ExceptionType type = ExceptionType::Unknown, const Args&... args) noexcept
+        : m_message(what),
+        m_file(file),
+        m_line(line),
+        m_type(type),
+        m_argumentCount(static_cast<uint8_t>(sizeof...(Args))),
+        m_arguments{ details::makeExceptionArgument(args)... }
+        {
+            static_assert(sizeof...(Args) <= MaxExceptionArguments, "Too many arguments for the message of an exception");
+        }
+
         /**
          * @brief Return an enhanced description of the error using the file & line at which the error occured
          * Notice that the pointer is valid as long as the Exception object still alive.
@@ -66,6 +156,14 @@ namespace Methan {
          */
         METHAN_API const char* what() const noexcept override;
 
+        /**
+         * @brief Return the description given when the exception was created, without its arguments
+         */
+        inline const char* message() const noexcept
+        {
+            return m_message != nullptr ? m_message : m_ownedMessage.c_str();
+        }
+
         /**
          * @brief Return the file where the exception occured
          * 
@@ -97,10 +195,19 @@ namespace Methan {
         }
 
     private:
-        std::string m_what;
+        std::string __describe() const;
+
+        // The literal description, null when the description is owned
+        const char* m_message;
+        std::string m_ownedMessage;
         const char* m_file;
         size_t m_line;
         ExceptionType m_type;
+        uint8_t m_argumentCount;
+        details::ExceptionArgument m_arguments[MaxExceptionArguments];
+
+        // Built by the first call to `what`, shared by the copies of the exception
+        mutable std::shared_ptr<const std::string> m_what;
     };
 
 }
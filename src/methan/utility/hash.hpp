@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <methan/core/except.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Mix `value` into the hash `seed`. The multiplication spreads every bit of the value over the
+     * whole word, so that hashes combining small integers (indices, enumerations) do not collide.
+     */
+    inline size_t hash_combine(size_t seed, size_t value) noexcept
+    {
+        uint64_t mixed = (static_cast<uint64_t>(seed) ^ (static_cast<uint64_t>(value) + 0x9E3779B97F4A7C15ull + (static_cast<uint64_t>(seed) << 6) + (static_cast<uint64_t>(seed) >> 2))) * 0xBF58476D1CE4E5B9ull;
+        return static_cast<size_t>(mixed ^ (mixed >> 31));
+    }
+
+    /**
+     * @brief Combine the `std::hash` of every value into `seed`
+     */
+    template<typename... Ts>
+    inline size_t hash_values(size_t seed, const Ts&... values)
+    {
+        ((seed = hash_combine(seed, std::hash<Ts>{}(values))), ...);
+        return seed;
+    }
+
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <methan/core/except.hpp>
+#include <methan/utility/assertion.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Bounded lock-free queue for any number of producers and consumers (Dmitry Vyukov's design).
+     * Every cell carries a sequence number telling whether it is ready to be written or read at a given
+     * position, so that producers and consumers only contend on their own index with a single CAS and
+     * never wait for each other, except on a cell that is being written or read at the same time.
+     *
+     * @tparam T a movable type
+     */
+    template<typename T>
+    class MpmcQueue
+    {
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            inline T* value() noexcept
+            {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
+    public:
+        /**
+         * @param capacity a power of two, at least 2
+         */
+        explicit MpmcQueue(size_t capacity = 1024)
+        : m_cells(new Cell[capacity]),
+        m_mask(capacity - 1),
+        m_enqueue(0),
+        m_dequeue(0)
+        {
+            METHAN_FORCE_ASSERT(capacity >= 2 && (capacity & (capacity - 1)) == 0, Methan::ExceptionType::IllegalArgument, "The capacity of the queue must be a power of two (at least 2)");
+            for(size_t i = 0; i < capacity; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        ~MpmcQueue()
+        {
+            const size_t end = m_enqueue.load(std::memory_order_relaxed);
+            for(size_t position = m_dequeue.load(std::memory_order_relaxed); position != end; ++position)
+            {
+                m_cells[position & m_mask].value()->~T();
+            }
+        }
+
+        METHAN_DISABLE_COPY_MOVE(MpmcQueue);
+
+        /**
+         * @brief Construct an element at the back of the queue
+         *
+         * @return bool false if the queue was full (the arguments are left untouched)
+         */
+        template<typename... Args>
+        inline bool tryEmplace(Args&&... args)
+        {
+            size_t position = m_enqueue.load(std::memory_order_relaxed);
+            Cell* cell;
+            while(true)
+            {
+                cell = &m_cells[position & m_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if(difference == 0)
+                {
+                    if(m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+                }
+                else if(difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = m_enqueue.load(std::memory_order_relaxed);
+                }
+            }
+
+            new(cell->storage) T(std::forward<Args>(args)...);
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline bool tryPush(const T& value)
+        {
+            return tryEmplace(value);
+        }
+
+        inline bool tryPush(T&& value)
+        {
+            return tryEmplace(std::move(value));
+        }
+
+        /**
+         * @brief Move the element at the front of the queue into `value`
+         *
+         * @return bool false if the queue was empty
+         */
+        inline bool tryPop(T& value)
+        {
+            size_t position = m_dequeue.load(std::memory_order_relaxed);
+            Cell* cell;
+            while(true)
+            {
+                cell = &m_cells[position & m_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+                if(difference == 0)
+                {
+                    if(m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+                }
+                else if(difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = m_dequeue.load(std::memory_order_relaxed);
+                }
+            }
+
+            value = std::move(*cell->value());
+            cell->value()->~T();
+            cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline size_t capacity() const noexcept
+        {
+            return m_mask + 1;
+        }
+
+        /**
+         * @brief Approximation of the number of elements in the queue
+         */
+        inline size_t size() const noexcept
+        {
+            const size_t enqueue = m_enqueue.load(std::memory_order_relaxed);
+            const size_t dequeue = m_dequeue.load(std::memory_order_relaxed);
+            return enqueue > dequeue ? enqueue - dequeue : 0;
+        }
+
+        inline bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+    private:
+        const std::unique_ptr<Cell[]> m_cells;
+        const size_t m_mask;
+
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<size_t> m_enqueue;
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<size_t> m_dequeue;
+    };
+
+}
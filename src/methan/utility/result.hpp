@@ -0,0 +1,143 @@
+#pragma once
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <methan/core/except.hpp>
+#include <methan/utility/exception.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Failure of an operation returning a Result: the type of the exception it would have raised and
+     * a description with static storage duration
+     */
+    struct ResultError
+    {
+        ExceptionType type;
+        const char* message;
+    };
+
+    /**
+     * @brief Value of an operation that may fail without raising an exception, for the paths where a
+     * failure is expected (lookups, probing). Either holds a value or a ResultError; `value` raises the
+     * corresponding Methan::Exception when there is none.
+     *
+     * @tparam T the type of the value, possibly an lvalue reference
+     */
+    template<typename T>
+    class Result
+    {
+    public:
+        inline Result(T value)
+        : m_value(std::move(value)),
+        m_error{ ExceptionType::Unknown, nullptr }
+        {}
+
+        inline Result(ResultError error) noexcept
+        : m_error(error)
+        {}
+
+        inline bool ok() const noexcept
+        {
+            return m_value.has_value();
+        }
+
+        inline explicit operator bool() const noexcept
+        {
+            return ok();
+        }
+
+        inline const T& value() const
+        {
+            __check();
+            return *m_value;
+        }
+
+        inline T& value()
+        {
+            __check();
+            return *m_value;
+        }
+
+        inline T valueOr(T fallback) const
+        {
+            return ok() ? *m_value : fallback;
+        }
+
+        /**
+         * @brief Return the error, meaningless when the result holds a value
+         */
+        inline const ResultError& error() const noexcept
+        {
+            return m_error;
+        }
+
+    private:
+        inline void __check() const
+        {
+            if(!ok()) METHAN_THROW_EXCEPTION_FORMAT("{}", m_error.type, m_error.message);
+        }
+
+        std::optional<T> m_value;
+        ResultError m_error;
+    };
+
+    /**
+     * @brief Result referring to a value owned by someone else
+     */
+    template<typename T>
+    class Result<T&>
+    {
+    public:
+        inline Result(T& value) noexcept
+        : m_value(&value),
+        m_error{ ExceptionType::Unknown, nullptr }
+        {}
+
+        inline Result(ResultError error) noexcept
+        : m_value(nullptr),
+        m_error(error)
+        {}
+
+        inline bool ok() const noexcept
+        {
+            return m_value != nullptr;
+        }
+
+        inline explicit operator bool() const noexcept
+        {
+            return ok();
+        }
+
+        inline T& value() const
+        {
+            if(!ok()) METHAN_THROW_EXCEPTION_FORMAT("{}", m_error.type, m_error.message);
+            return *m_value;
+        }
+
+        inline std::remove_const_t<T> valueOr(std::remove_const_t<T> fallback) const
+        {
+            return ok() ? *m_value : fallback;
+        }
+
+        /**
+         * @brief Pointer to the value, null when the result holds an error
+         */
+        inline T* get() const noexcept
+        {
+            return m_value;
+        }
+
+        inline const ResultError& error() const noexcept
+        {
+            return m_error;
+        }
+
+    private:
+        T* m_value;
+        ResultError m_error;
+    };
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include <methan/core/except.hpp>
+#include <methan/utility/assertion.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Non-owning view over a contiguous sequence of elements
+     */
+    template<typename T>
+    class Span
+    {
+    public:
+        typedef T ValueType;
+        typedef T* Iterator;
+
+        constexpr Span() noexcept
+        : m_data(nullptr),
+        m_size(0)
+        {}
+
+        constexpr Span(T* data, size_t size) noexcept
+        : m_data(data),
+        m_size(size)
+        {}
+
+        template<typename U, std::enable_if_t<std::is_convertible<U(*)[], T(*)[]>::value, bool> = true>
+        constexpr Span(const Span<U>& other) noexcept
+        : m_data(other.data()),
+        m_size(other.size())
+        {}
+
+        constexpr T* data() const noexcept
+        {
+            return m_data;
+        }
+
+        constexpr size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        constexpr T* begin() const noexcept
+        {
+            return m_data;
+        }
+
+        constexpr T* end() const noexcept
+        {
+            return m_data + m_size;
+        }
+
+        inline T& operator[](size_t index) const
+        {
+            METHAN_ASSERT_INDEX(index, m_size);
+            return m_data[index];
+        }
+
+        inline Span<T> subspan(size_t offset, size_t count) const
+        {
+            METHAN_ASSERT(offset + count <= m_size, Methan::ExceptionType::IndexOutOfBounds, "The sub-span exceeds the bounds of the span");
+            return Span<T>(m_data + offset, count);
+        }
+
+    private:
+        T* m_data;
+        size_t m_size;
+    };
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+
+#include <methan/core/except.hpp>
+
+#if defined(METHAN_ARCH_X86) && defined(METHAN_COMPILER_MSC)
+#include <intrin.h>
+#elif defined(METHAN_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace Methan {
+
+    /**
+     * @brief Hint the processor that the calling thread is spin-waiting
+     */
+    inline void cpu_relax() noexcept
+    {
+#if defined(METHAN_ARCH_X86)
+        _mm_pause();
+#elif defined(METHAN_ARCH_ARM64) && !defined(METHAN_COMPILER_MSC)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    /**
+     * @brief Exponential backoff used by spin loops. Spins with `cpu_relax` first, then yields the time slice.
+     * `isSaturated` tells the caller when it is time to block instead.
+     */
+    class Backoff
+    {
+    public:
+        static constexpr uint32_t SpinLimit = 6;
+        static constexpr uint32_t YieldLimit = 10;
+
+        constexpr Backoff() noexcept
+        : m_step(0)
+        {}
+
+        inline void pause() noexcept
+        {
+            if(m_step <= SpinLimit)
+            {
+                for(uint32_t i = 0; i < (1u << m_step); ++i) cpu_relax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+
+            if(m_step <= YieldLimit) ++m_step;
+        }
+
+        inline bool isSaturated() const noexcept
+        {
+            return m_step > YieldLimit;
+        }
+
+        inline void reset() noexcept
+        {
+            m_step = 0;
+        }
+
+    private:
+        uint32_t m_step;
+    };
+
+}
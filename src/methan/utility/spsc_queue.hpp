@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <methan/core/except.hpp>
+#include <methan/utility/assertion.hpp>
+
+namespace Methan {
+
+    /**
+     * @brief Bounded lock-free ring for a single producer and a single consumer. The two indices live on
+     * their own cache line next to a copy of the other index, refreshed only when the ring looks full (for
+     * the producer) or empty (for the consumer), so that a transfer usually touches no shared cache line
+     * but the slot itself.
+     *
+     * @tparam T a movable type
+     */
+    template<typename T>
+    class SpscQueue
+    {
+        struct Slot
+        {
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            inline T* value() noexcept
+            {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
+    public:
+        /**
+         * @param capacity a power of two, at least 2
+         */
+        explicit SpscQueue(size_t capacity = 1024)
+        : m_slots(new Slot[capacity]),
+        m_mask(capacity - 1),
+        m_tail(0),
+        m_cachedHead(0),
+        m_head(0),
+        m_cachedTail(0)
+        {
+            METHAN_FORCE_ASSERT(capacity >= 2 && (capacity & (capacity - 1)) == 0, Methan::ExceptionType::IllegalArgument, "The capacity of the queue must be a power of two (at least 2)");
+        }
+
+        ~SpscQueue()
+        {
+            const size_t end = m_tail.load(std::memory_order_relaxed);
+            for(size_t position = m_head.load(std::memory_order_relaxed); position != end; ++position)
+            {
+                m_slots[position & m_mask].value()->~T();
+            }
+        }
+
+        METHAN_DISABLE_COPY_MOVE(SpscQueue);
+
+        /**
+         * @brief Construct an element at the back of the queue (producer only)
+         *
+         * @return bool false if the queue was full (the arguments are left untouched)
+         */
+        template<typename... Args>
+        inline bool tryEmplace(Args&&... args)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if(tail - m_cachedHead > m_mask)
+            {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if(tail - m_cachedHead > m_mask) return false;
+            }
+
+            new(m_slots[tail & m_mask].storage) T(std::forward<Args>(args)...);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline bool tryPush(const T& value)
+        {
+            return tryEmplace(value);
+        }
+
+        inline bool tryPush(T&& value)
+        {
+            return tryEmplace(std::move(value));
+        }
+
+        /**
+         * @brief Move the element at the front of the queue into `value` (consumer only)
+         *
+         * @return bool false if the queue was empty
+         */
+        inline bool tryPop(T& value)
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if(head == m_cachedTail)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if(head == m_cachedTail) return false;
+            }
+
+            T* slot = m_slots[head & m_mask].value();
+            value = std::move(*slot);
+            slot->~T();
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline size_t capacity() const noexcept
+        {
+            return m_mask + 1;
+        }
+
+        /**
+         * @brief Approximation of the number of elements in the queue
+         */
+        inline size_t size() const noexcept
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+        inline bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+    private:
+        const std::unique_ptr<Slot[]> m_slots;
+        const size_t m_mask;
+
+        // Written by the producer
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+        size_t m_cachedHead;
+
+        // Written by the consumer
+        alignas(METHAN_CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+        size_t m_cachedTail;
+    };
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include <methan/core/except.hpp>
+
+#if defined(METHAN_COMPILER_MSC)
+#define __METHAN_PRETTY_FUNCTION_DETAILS                             __FUNCSIG__
+#else
+#define __METHAN_PRETTY_FUNCTION_DETAILS                             __PRETTY_FUNCTION__
+#endif
+
+namespace Methan {
+
+    /**
+     * @brief Identifier of a type, computed at compile time from the name of the type. Unlike
+     * `typeid(T).hash_code()` it does not require RTTI and is identical in every binary built with the
+     * same compiler, which makes it stable across shared-library boundaries.
+     */
+    typedef uint64_t TypeId;
+
+    namespace details {
+
+        template<typename T>
+        constexpr std::string_view raw_type_name() noexcept
+        {
+            return __METHAN_PRETTY_FUNCTION_DETAILS;
+        }
+
+        // The decoration added by the compiler around the type name is measured once with a known type
+        constexpr std::string_view __probe_type_name = raw_type_name<double>();
+        constexpr size_t __probe_prefix = __probe_type_name.find("double");
+        constexpr size_t __probe_suffix = __probe_type_name.size() - __probe_prefix - (sizeof("double") - 1);
+
+        static_assert(__probe_prefix != std::string_view::npos, "Cannot extract the type name from the function signature");
+
+        constexpr uint64_t fnv1a(std::string_view str) noexcept
+        {
+            uint64_t hash = 0xCBF29CE484222325ull;
+            for(char c : str)
+            {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 0x100000001B3ull;
+            }
+            return hash;
+        }
+
+        template<size_t N>
+        struct TypeNameStorage
+        {
+            char data[N + 1];
+        };
+
+        template<size_t N>
+        constexpr TypeNameStorage<N> make_type_name_storage(std::string_view name) noexcept
+        {
+            TypeNameStorage<N> storage{};
+            for(size_t i = 0; i < N; ++i) storage.data[i] = name[i];
+            storage.data[N] = '\0';
+            return storage;
+        }
+
+    }
+
+    /**
+     * @brief Return the human readable name of the type T (as spelled by the compiler)
+     */
+    template<typename T>
+    constexpr std::string_view type_name() noexcept
+    {
+        constexpr std::string_view raw = details::raw_type_name<T>();
+        return raw.substr(details::__probe_prefix, raw.size() - details::__probe_prefix - details::__probe_suffix);
+    }
+
+    /**
+     * @brief Return the name of the type T as a null-terminated string with static storage duration
+     */
+    template<typename T>
+    inline const char* type_name_cstr() noexcept
+    {
+        static constexpr details::TypeNameStorage<type_name<T>().size()> storage = details::make_type_name_storage<type_name<T>().size()>(type_name<T>());
+        return storage.data;
+    }
+
+    /**
+     * @brief Return the identifier of the type T. Notice that two distinct types sharing the same name (e.g.
+     * declared in anonymous namespaces of different translation units) share the same identifier.
+     */
+    template<typename T>
+    constexpr TypeId type_id() noexcept
+    {
+        return details::fnv1a(type_name<T>());
+    }
+
+}
@@ -1,93 +1,361 @@
 #pragma once
 
-#include <type_traits>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include <methan/core/except.hpp>
 #include <methan/utility/assertion.hpp>
+#include <methan/utility/hash.hpp>
+#include <methan/utility/result.hpp>
+#include <methan/utility/typeid.hpp>
 
 
 namespace Methan {
 
-    class Varient
+    namespace details {
+
+        /**
+         * @brief Static table of the operations required to manage a payload owned by a Varient. A single
+         * instance exists per (type, storage) pair, therefore a Varient only holds a pointer to it.
+         */
+        struct VarientVTable
+        {
+            void (*destroy)(void* storage) noexcept;
+            void (*copy)(void* destStorage, const void* srcStorage);
+            void (*move)(void* destStorage, void* srcStorage) noexcept;
+            size_t (*hash)(const void* data);
+            bool (*equal)(const void* data, const void* otherData);
+        };
+
+        typedef void (*VarientCopyFunction)(void*, const void*);
+        typedef size_t (*VarientHashFunction)(const void*);
+        typedef bool (*VarientEqualFunction)(const void*, const void*);
+
+        template<typename T>
+        struct IsInPlaceType : std::false_type {};
+
+        template<typename T>
+        struct IsInPlaceType<std::in_place_type_t<T>> : std::true_type {};
+
+        template<typename T, typename = void>
+        struct IsEqualityComparable : std::false_type {};
+
+        template<typename T>
+        struct IsEqualityComparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+        : std::is_convertible<decltype(std::declval<const T&>() == std::declval<const T&>()), bool> {};
+
+        /**
+         * @brief Hash and equality of the payloads of type T, available when T has both a `std::hash`
+         * specialization and an equality operator
+         */
+        template<typename T>
+        struct VarientComparison
+        {
+            static constexpr bool IsSupported = std::is_invocable_r<size_t, std::hash<T>, const T&>::value && IsEqualityComparable<T>::value;
+
+            static size_t hash(const void* data)
+            {
+                return std::hash<T>{}(*reinterpret_cast<const T*>(data));
+            }
+
+            static bool equal(const void* data, const void* otherData)
+            {
+                return static_cast<bool>(*reinterpret_cast<const T*>(data) == *reinterpret_cast<const T*>(otherData));
+            }
+
+            static constexpr VarientHashFunction hashFunction()
+            {
+                if constexpr (IsSupported) return &hash;
+                else return nullptr;
+            }
+
+            static constexpr VarientEqualFunction equalFunction()
+            {
+                if constexpr (IsSupported) return &equal;
+                else return nullptr;
+            }
+        };
+
+        template<typename T>
+        struct VarientInlineVTable
+        {
+            static void destroy(void* storage) noexcept
+            {
+                reinterpret_cast<T*>(storage)->~T();
+            }
+
+            static void copy(void* destStorage, const void* srcStorage)
+            {
+                new (destStorage) T(*reinterpret_cast<const T*>(srcStorage));
+            }
+
+            static void move(void* destStorage, void* srcStorage) noexcept
+            {
+                new (destStorage) T(std::move(*reinterpret_cast<T*>(srcStorage)));
+                reinterpret_cast<T*>(srcStorage)->~T();
+            }
+
+            static constexpr VarientCopyFunction copyFunction()
+            {
+                if constexpr (std::is_copy_constructible<T>::value) return &copy;
+                else return nullptr;
+            }
+
+            static constexpr VarientVTable value = { &destroy, copyFunction(), &move, VarientComparison<T>::hashFunction(), VarientComparison<T>::equalFunction() };
+        };
+
+        /**
+         * @brief Payloads stored on the heap are allocated from a memory resource, the resource is stored right
+         * after the payload so that the Varient does not have to keep track of it
+         */
+        template<typename T>
+        struct VarientHeapVTable
+        {
+            static constexpr size_t ResourceOffset = (sizeof(T) + alignof(std::pmr::memory_resource*) - 1) & ~(alignof(std::pmr::memory_resource*) - 1);
+            static constexpr size_t BlockSize = ResourceOffset + sizeof(std::pmr::memory_resource*);
+            static constexpr size_t BlockAlign = alignof(T) > alignof(std::pmr::memory_resource*) ? alignof(T) : alignof(std::pmr::memory_resource*);
+
+            template<typename... Args>
+            static T* create(std::pmr::memory_resource* resource, Args&&... args)
+            {
+                unsigned char* block = static_cast<unsigned char*>(resource->allocate(BlockSize, BlockAlign));
+                try
+                {
+                    new (block) T(std::forward<Args>(args)...);
+                }
+                catch(...)
+                {
+                    resource->deallocate(block, BlockSize, BlockAlign);
+                    throw;
+                }
+
+                *reinterpret_cast<std::pmr::memory_resource**>(block + ResourceOffset) = resource;
+                return reinterpret_cast<T*>(block);
+            }
+
+            static void destroy(void* storage) noexcept
+            {
+                T* payload = *reinterpret_cast<T**>(storage);
+                std::pmr::memory_resource* resource = *reinterpret_cast<std::pmr::memory_resource**>(reinterpret_cast<unsigned char*>(payload) + ResourceOffset);
+                payload->~T();
+                resource->deallocate(payload, BlockSize, BlockAlign);
+            }
+
+            static void copy(void* destStorage, const void* srcStorage)
+            {
+                // Like the std::pmr containers, a copy does not inherit the memory resource of the original
+                *reinterpret_cast<T**>(destStorage) = create(std::pmr::get_default_resource(), **reinterpret_cast<T* const*>(srcStorage));
+            }
+
+            static void move(void* destStorage, void* srcStorage) noexcept
+            {
+                *reinterpret_cast<T**>(destStorage) = *reinterpret_cast<T**>(srcStorage);
+            }
+
+            static constexpr VarientCopyFunction copyFunction()
+            {
+                if constexpr (std::is_copy_constructible<T>::value) return &copy;
+                else return nullptr;
+            }
+
+            static constexpr VarientVTable value = { &destroy, copyFunction(), &move, VarientComparison<T>::hashFunction(), VarientComparison<T>::equalFunction() };
+        };
+
+    }
+
+    /**
+     * @brief Type-erased container able to hold either a (const or non-const) pointer that it does not own
+     * or a value. Values that are small enough (see `InlineSize` and `InlineAlign`) and that are
+     * either trivially copyable or nothrow movable are stored inline and never touch the heap.
+     * Move-only values are supported, copying a Varient holding one raises an `IllegalState` exception.
+     * Values stored on the heap are allocated from the default memory resource unless a resource is given
+     * at construction (`std::allocator_arg`), copies always use the default memory resource.
+     *
+     * Varients can be hashed and compared when their payload can: pointers are compared by address and
+     * values whose type has a `std::hash` specialization and an equality operator by value (see `hash`).
+     *
+     * @tparam InlineSize size (in bytes) of the inline storage
+     * @tparam InlineAlign alignment (in bytes) of the inline storage
+     */
+    template<size_t InlineSize, size_t InlineAlign>
+    class BasicVarient
     {
+        static_assert(InlineSize >= sizeof(void*), "The inline storage of a Varient must at least be able to hold a pointer");
+        static_assert(InlineAlign >= alignof(void*) && (InlineAlign & (InlineAlign - 1)) == 0, "The inline alignment of a Varient must be a power of two greater than the alignment of a pointer");
+
         static constexpr uint8_t IsConstant = 0x01;
         static constexpr uint8_t IsDataOwner = 0x02;
+        static constexpr uint8_t IsInline = 0x04;
+        static constexpr uint8_t IsTrivial = 0x08;
+
+        template<typename T>
+        static constexpr bool IsValueType = !std::is_pointer<T>::value &&
+                                            !std::is_same<T, BasicVarient>::value &&
+                                            !std::is_same<T, std::nullptr_t>::value &&
+                                            !std::is_array<T>::value &&
+                                            !details::IsInPlaceType<T>::value &&
+                                            std::is_object<T>::value &&
+                                            std::is_move_constructible<T>::value;
 
     public:
-        inline Varient(std::nullptr_t) noexcept
-        : m_data(nullptr),
-        METHAN_DEBUG_ONLY(m_dataName(nullptr),)
-        m_typeId(0),
-        m_flag(0),
-        m_destructor(nullptr),
-        m_copy(nullptr)
+        /**
+         * @brief Whether or not a payload of type T would be stored in the inline storage
+         */
+        template<typename T>
+        static constexpr bool IsInlined = sizeof(T) <= InlineSize &&
+                                          alignof(T) <= InlineAlign &&
+                                          (std::is_trivially_copyable<T>::value || std::is_nothrow_move_constructible<T>::value);
+
+        inline BasicVarient(std::nullptr_t) noexcept
+        : m_typeId(0),
+        m_vtable(nullptr),
+        m_flag(0)
+        METHAN_DEBUG_ONLY(, m_dataName(nullptr))
+        {
+            m_storage.pointer = nullptr;
+        }
+
+        inline BasicVarient() noexcept
+        : BasicVarient(nullptr)
         {}
 
-        inline Varient(const Varient& other)
-        : m_data(other.m_data),
-        METHAN_DEBUG_ONLY(m_dataName(other.m_dataName),)
-        m_typeId(other.m_typeId),
-        m_flag(other.m_flag),
-        m_destructor(other.m_destructor),
-        m_copy(other.m_copy)
+        inline BasicVarient(const BasicVarient& other)
+        : m_typeId(other.m_typeId),
+        m_vtable(other.m_vtable),
+        m_flag(other.m_flag)
+        METHAN_DEBUG_ONLY(, m_dataName(other.m_dataName))
         {
-            if(m_flag & IsDataOwner) m_copy(&m_data, other.m_data);
+            __copy(other);
+        }
+
+        inline BasicVarient(BasicVarient&& other) noexcept
+        : m_typeId(other.m_typeId),
+        m_vtable(other.m_vtable),
+        m_flag(other.m_flag)
+        METHAN_DEBUG_ONLY(, m_dataName(other.m_dataName))
+        {
+            __move(other);
         }
 
         template<typename T, std::enable_if_t<std::is_pointer<T>::value && std::is_const<std::remove_pointer_t<T>>::value, bool> = true>
-        inline Varient(T constPtr) noexcept
-        : m_data(reinterpret_cast<void*>(const_cast<std::remove_const_t<std::remove_pointer_t<T>>*>(constPtr))),
-        METHAN_DEBUG_ONLY(m_dataName(typeid(T).name()),)
-        m_typeId(typeid(T).hash_code()),
-        m_flag(IsConstant),
-        m_destructor(nullptr),
-        m_copy(nullptr)
-        {}
+        inline BasicVarient(T constPtr) noexcept
+        : m_typeId(type_id<T>()),
+        m_vtable(nullptr),
+        m_flag(IsConstant)
+        METHAN_DEBUG_ONLY(, m_dataName(type_name_cstr<T>()))
+        {
+            m_storage.pointer = reinterpret_cast<void*>(const_cast<std::remove_const_t<std::remove_pointer_t<T>>*>(constPtr));
+        }
 
         template<typename T, std::enable_if_t<std::is_pointer<T>::value && !std::is_const<std::remove_pointer_t<T>>::value, bool> = true>
-        inline Varient(T ptr) noexcept
-        : m_data(reinterpret_cast<void*>(ptr)),
-        METHAN_DEBUG_ONLY(m_dataName(typeid(T).name()),)
-        m_typeId(typeid(T).hash_code()),
-        m_flag(0),
-        m_destructor(nullptr),
-        m_copy(nullptr)
-        {}
+        inline BasicVarient(T ptr) noexcept
+        : m_typeId(type_id<T>()),
+        m_vtable(nullptr),
+        m_flag(0)
+        METHAN_DEBUG_ONLY(, m_dataName(type_name_cstr<T>()))
+        {
+            m_storage.pointer = reinterpret_cast<void*>(ptr);
+        }
 
-        template<typename T, std::enable_if_t<(!std::is_pointer<T>::value) && std::is_copy_constructible<T>::value, bool> = true>
-        inline Varient(const T& ref)
-        : m_data(new T(ref)),
-        METHAN_DEBUG_ONLY(m_dataName(typeid(T).name()),)
-        m_typeId(typeid(T).hash_code()),
-        m_flag(IsDataOwner),
-        m_destructor([](void* _data) { delete reinterpret_cast<T*>(_data); }),
-        m_copy([](void** dest, void* _data) { *dest = new T(*reinterpret_cast<T*>(_data)); })
-        {}
+        template<typename U, typename T = std::decay_t<U>, std::enable_if_t<IsValueType<T>, bool> = true>
+        inline BasicVarient(U&& value)
+        : BasicVarient(nullptr)
+        {
+            __construct<T>(std::pmr::get_default_resource(), std::forward<U>(value));
+        }
+
+        /**
+         * @brief Construct a payload of type T in place from the given arguments
+         */
+        template<typename T, typename... Args, std::enable_if_t<IsValueType<T>, bool> = true>
+        inline explicit BasicVarient(std::in_place_type_t<T>, Args&&... args)
+        : BasicVarient(nullptr)
+        {
+            __construct<T>(std::pmr::get_default_resource(), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Same as above, a payload that is not stored inline is allocated from the given resource
+         * (which must outlive the payload)
+         */
+        template<typename U, typename T = std::decay_t<U>, std::enable_if_t<IsValueType<T>, bool> = true>
+        inline BasicVarient(std::allocator_arg_t, std::pmr::memory_resource* resource, U&& value)
+        : BasicVarient(nullptr)
+        {
+            METHAN_ASSERT_NON_NULL(resource);
+            __construct<T>(resource, std::forward<U>(value));
+        }
+
+        template<typename T, typename... Args, std::enable_if_t<IsValueType<T>, bool> = true>
+        inline explicit BasicVarient(std::allocator_arg_t, std::pmr::memory_resource* resource, std::in_place_type_t<T>, Args&&... args)
+        : BasicVarient(nullptr)
+        {
+            METHAN_ASSERT_NON_NULL(resource);
+            __construct<T>(resource, std::forward<Args>(args)...);
+        }
 
-        inline ~Varient()
+        inline ~BasicVarient()
         {
             __destruct();
         }
 
 
-        inline Varient& operator=(const Varient& other)
+        inline BasicVarient& operator=(const BasicVarient& other)
         {
+            if(this == &other) return *this;
+
+            // Copy first so that the Varient is left untouched if the copy throws
+            BasicVarient copy(other);
+            return *this = std::move(copy);
+        }
+
+        inline BasicVarient& operator=(BasicVarient&& other) noexcept
+        {
+            if(this == &other) return *this;
             __destruct();
 
             METHAN_DEBUG_ONLY(m_dataName = other.m_dataName;)
             m_typeId = other.m_typeId;
+            m_vtable = other.m_vtable;
             m_flag = other.m_flag;
-            m_destructor = other.m_destructor;
-            m_copy = other.m_copy;
-            m_data = other.m_data;
-
-            if(m_flag & IsDataOwner) m_copy(&m_data, other.m_data);
+            __move(other);
 
             return *this;
         }
 
-        
+        /**
+         * @brief Destroy the current payload (if any) and construct a new payload of type T in place
+         *
+         * @return T& a reference to the newly constructed payload
+         */
+        template<typename T, typename... Args, std::enable_if_t<IsValueType<T>, bool> = true>
+        inline T& emplace(Args&&... args)
+        {
+            reset();
+            __construct<T>(std::pmr::get_default_resource(), std::forward<Args>(args)...);
+            return *reinterpret_cast<T*>(__data());
+        }
+
+        /**
+         * @brief Destroy the current payload (if any), leaving the Varient empty
+         */
+        inline void reset() noexcept
+        {
+            __destruct();
+            m_typeId = 0;
+            m_vtable = nullptr;
+            m_flag = 0;
+            m_storage.pointer = nullptr;
+            METHAN_DEBUG_ONLY(m_dataName = nullptr;)
+        }
+
+
         inline bool isEmpty() const noexcept
         {
             return m_typeId == 0x0;
@@ -98,20 +366,75 @@ namespace Methan {
             return !isEmpty();
         }
 
-        inline size_t typeId() const noexcept
+        /**
+         * @brief Whether or not the payload is stored within the Varient itself (no heap allocation)
+         */
+        inline bool isInline() const noexcept
+        {
+            return m_flag & IsInline;
+        }
+
+        /**
+         * @brief Whether or not the payload can be copied (pointers and copy-constructible values)
+         */
+        inline bool isCopyable() const noexcept
+        {
+            return !(m_flag & IsDataOwner) || (m_flag & IsTrivial) || m_vtable->copy != nullptr;
+        }
+
+        inline TypeId typeId() const noexcept
         {
             return m_typeId;
         }
 
+        /**
+         * @brief Whether or not the payload can be hashed (empty Varients, pointers and values whose type has
+         * a `std::hash` specialization and an equality operator)
+         */
+        inline bool isHashable() const noexcept
+        {
+            return !(m_flag & IsDataOwner) || m_vtable->hash != nullptr;
+        }
+
+        /**
+         * @brief Hash of the type and the payload, consistent with `operator==`. An `IllegalState` exception
+         * is raised if the payload is not hashable (see `isHashable`).
+         */
+        inline size_t hash() const
+        {
+            const size_t seed = std::hash<TypeId>{}(m_typeId);
+            if(!(m_flag & IsDataOwner)) return hash_combine(seed, std::hash<const void*>{}(m_storage.pointer));
+
+            METHAN_FORCE_ASSERT(m_vtable->hash != nullptr, Methan::ExceptionType::IllegalState, "Cannot hash a Varient whose payload has no std::hash specialization or equality operator");
+            return hash_combine(seed, m_vtable->hash(__data()));
+        }
+
+        /**
+         * @brief Whether both Varients are empty, point to the same address with the same pointer type, or
+         * hold equal values of the same type. A payload that is not hashable is only equal to itself.
+         */
+        inline bool operator==(const BasicVarient& other) const
+        {
+            if(this == &other) return true;
+            if(m_typeId != other.m_typeId) return false;
+            if(!(m_flag & IsDataOwner)) return m_storage.pointer == other.m_storage.pointer;
+            return m_vtable->equal != nullptr && m_vtable->equal(__data(), other.__data());
+        }
+
+        inline bool operator!=(const BasicVarient& other) const
+        {
+            return !(*this == other);
+        }
+
         template<typename T>
         inline bool is() const noexcept
         {
             if (isEmpty()) return false;
-            if (m_typeId == typeid(T).hash_code()) return true;
+            if (m_typeId == type_id<T>()) return true;
 
             if(std::is_pointer<T>::value && !(m_flag & IsConstant))
             {
-                return m_typeId == typeid(std::remove_const_t<std::remove_pointer_t<T>>*).hash_code();
+                return m_typeId == type_id<std::remove_const_t<std::remove_pointer_t<T>>*>();
             }
 
             return false;
@@ -121,47 +444,156 @@ namespace Methan {
         inline T get() const
         {
             METHAN_ASSERT(isNonEmpty(), Methan::ExceptionType::IllegalArgument, "The call to `get` failed as the Varient is currently empty");
-            METHAN_ASSERT(is<T>(), Methan::ExceptionType::BadCastException, "Cannot cast from type " METHAN_DEBUG_OR_RELEASE("`" + std::string(m_dataName) + "`", + std::to_string(m_typeId) + ) " to type " METHAN_DEBUG_OR_RELEASE("`" + std::string(typeid(T).name()) + "`", + std::to_string(typeid(T).hash_code())));
-            return reinterpret_cast<T>(m_data);
+            METHAN_ASSERT_FORMAT(is<T>(), Methan::ExceptionType::BadCastException, "Cannot cast from type " METHAN_DEBUG_OR_RELEASE("`{}`", "{}") " to type " METHAN_DEBUG_OR_RELEASE("`{}`", "{}"), METHAN_DEBUG_OR_RELEASE(m_dataName, m_typeId), METHAN_DEBUG_OR_RELEASE(type_name_cstr<T>(), type_id<T>()));
+            return reinterpret_cast<T>(m_storage.pointer);
         }
 
         template<typename T, std::enable_if_t<std::is_pointer<T>::value && !std::is_const<std::remove_pointer_t<T>>::value, bool> = true>
         inline T get() const
         {
             METHAN_ASSERT(isNonEmpty(), Methan::ExceptionType::IllegalArgument, "The call to `get` failed as the Varient is currently empty");
-            METHAN_ASSERT(is<T>(), Methan::ExceptionType::BadCastException, "Cannot cast from type " METHAN_DEBUG_OR_RELEASE("`" + std::string(m_dataName) + "`", + std::to_string(m_typeId) + ) " to type " METHAN_DEBUG_OR_RELEASE("`" + std::string(typeid(T).name()) + "`", + std::to_string(typeid(T).hash_code())));
+            METHAN_ASSERT_FORMAT(is<T>(), Methan::ExceptionType::BadCastException, "Cannot cast from type " METHAN_DEBUG_OR_RELEASE("`{}`", "{}") " to type " METHAN_DEBUG_OR_RELEASE("`{}`", "{}"), METHAN_DEBUG_OR_RELEASE(m_dataName, m_typeId), METHAN_DEBUG_OR_RELEASE(type_name_cstr<T>(), type_id<T>()));
             METHAN_ASSERT(!(m_flag & IsConstant), Methan::ExceptionType::BadCastException, "Cannot cast a pointer-to-constant to a pointer-to-non-const");
-            return reinterpret_cast<T>(m_data);
+            return reinterpret_cast<T>(m_storage.pointer);
         }
 
-        template<typename T, std::enable_if_t<(!std::is_pointer<T>::value) && std::is_copy_constructible<T>::value, bool> = true>
+        template<typename T, std::enable_if_t<!std::is_pointer<T>::value, bool> = true>
         inline const T& get() const
         {
             METHAN_ASSERT(isNonEmpty(), Methan::ExceptionType::IllegalArgument, "The call to `get` failed as the Varient is currently empty");
-            METHAN_ASSERT(is<T>(), Methan::ExceptionType::BadCastException, "Cannot cast from type " METHAN_DEBUG_OR_RELEASE("`" + std::string(m_dataName) + "`", + std::to_string(m_typeId) + ) " to type " METHAN_DEBUG_OR_RELEASE("`" + std::string(typeid(T).name()) + "`", + std::to_string(typeid(T).hash_code())));
-            return *reinterpret_cast<T*>(m_data);
+            METHAN_ASSERT_FORMAT(is<T>(), Methan::ExceptionType::BadCastException, "Cannot cast from type " METHAN_DEBUG_OR_RELEASE("`{}`", "{}") " to type " METHAN_DEBUG_OR_RELEASE("`{}`", "{}"), METHAN_DEBUG_OR_RELEASE(m_dataName, m_typeId), METHAN_DEBUG_OR_RELEASE(type_name_cstr<T>(), type_id<T>()));
+            return *reinterpret_cast<const T*>(__data());
         }
 
-        template<typename T, std::enable_if_t<(!std::is_pointer<T>::value) && std::is_copy_constructible<T>::value, bool> = true>
+        template<typename T, std::enable_if_t<!std::is_pointer<T>::value, bool> = true>
         inline T& get()
         {
             METHAN_ASSERT(isNonEmpty(), Methan::ExceptionType::IllegalArgument, "The call to `get` failed as the Varient is currently empty");
-            METHAN_ASSERT(is<T>(), Methan::ExceptionType::BadCastException, "Cannot cast from type " METHAN_DEBUG_OR_RELEASE("`" + std::string(m_dataName) + "`", + std::to_string(m_typeId) + ) " to type " METHAN_DEBUG_OR_RELEASE("`" + std::string(typeid(T).name()) + "`", + std::to_string(typeid(T).hash_code())));
-            return *reinterpret_cast<T*>(m_data);
+            METHAN_ASSERT_FORMAT(is<T>(), Methan::ExceptionType::BadCastException, "Cannot cast from type " METHAN_DEBUG_OR_RELEASE("`{}`", "{}") " to type " METHAN_DEBUG_OR_RELEASE("`{}`", "{}"), METHAN_DEBUG_OR_RELEASE(m_dataName, m_typeId), METHAN_DEBUG_OR_RELEASE(type_name_cstr<T>(), type_id<T>()));
+            return *reinterpret_cast<T*>(__data());
+        }
+
+        /**
+         * @brief Non-throwing counterpart of `get`, failing when the Varient is empty or holds another type
+         */
+        template<typename T, std::enable_if_t<std::is_pointer<T>::value, bool> = true>
+        inline Result<T> tryGet() const noexcept
+        {
+            if(isEmpty()) return ResultError{ Methan::ExceptionType::IllegalArgument, "The Varient is empty" };
+            if(!is<T>()) return ResultError{ Methan::ExceptionType::BadCastException, "The Varient holds another type" };
+            if(!std::is_const<std::remove_pointer_t<T>>::value && (m_flag & IsConstant)) return ResultError{ Methan::ExceptionType::BadCastException, "Cannot cast a pointer-to-constant to a pointer-to-non-const" };
+            return reinterpret_cast<T>(m_storage.pointer);
+        }
+
+        template<typename T, std::enable_if_t<!std::is_pointer<T>::value, bool> = true>
+        inline Result<const T&> tryGet() const noexcept
+        {
+            if(isEmpty()) return ResultError{ Methan::ExceptionType::IllegalArgument, "The Varient is empty" };
+            if(!is<T>()) return ResultError{ Methan::ExceptionType::BadCastException, "The Varient holds another type" };
+            return *reinterpret_cast<const T*>(__data());
+        }
+
+        template<typename T, std::enable_if_t<!std::is_pointer<T>::value, bool> = true>
+        inline Result<T&> tryGet() noexcept
+        {
+            if(isEmpty()) return ResultError{ Methan::ExceptionType::IllegalArgument, "The Varient is empty" };
+            if(!is<T>()) return ResultError{ Methan::ExceptionType::BadCastException, "The Varient holds another type" };
+            return *reinterpret_cast<T*>(__data());
+        }
+
+        /**
+         * @brief Move the payload out of the Varient, leaving the Varient empty
+         *
+         * @return T the payload that was held
+         */
+        template<typename T, std::enable_if_t<!std::is_pointer<T>::value, bool> = true>
+        inline T take()
+        {
+            T value(std::move(get<T>()));
+            reset();
+            return value;
         }
 
     private:
-        inline void __destruct()
+        inline const void* __data() const noexcept
+        {
+            return (m_flag & IsInline) ? static_cast<const void*>(m_storage.buffer) : m_storage.pointer;
+        }
+
+        inline void* __data() noexcept
         {
-            if(m_flag & IsDataOwner) m_destructor(m_data);
+            return (m_flag & IsInline) ? static_cast<void*>(m_storage.buffer) : m_storage.pointer;
         }
 
-        size_t m_typeId;
-        void* m_data;
+        template<typename T, typename... Args>
+        inline void __construct(std::pmr::memory_resource* resource, Args&&... args)
+        {
+            if constexpr (IsInlined<T>)
+            {
+                (void) resource;
+                new (m_storage.buffer) T(std::forward<Args>(args)...);
+                m_flag = IsDataOwner | IsInline;
+                m_vtable = &details::VarientInlineVTable<T>::value;
+
+                // Trivial payloads are copied and moved with memcpy and never destroyed, their vtable is only
+                // used to hash and compare them
+                if constexpr (std::is_trivially_copyable<T>::value) m_flag |= IsTrivial;
+            }
+            else
+            {
+                m_storage.pointer = details::VarientHeapVTable<T>::create(resource, std::forward<Args>(args)...);
+                m_flag = IsDataOwner;
+                m_vtable = &details::VarientHeapVTable<T>::value;
+            }
+
+            m_typeId = type_id<T>();
+            METHAN_DEBUG_ONLY(m_dataName = type_name_cstr<T>();)
+        }
+
+        inline void __copy(const BasicVarient& other)
+        {
+            if(m_flag & IsTrivial) std::memcpy(m_storage.buffer, other.m_storage.buffer, InlineSize);
+            else if(m_flag & IsDataOwner)
+            {
+                METHAN_FORCE_ASSERT(m_vtable->copy != nullptr, Methan::ExceptionType::IllegalState, "Cannot copy a Varient holding a move-only payload");
+                m_vtable->copy(&m_storage, &other.m_storage);
+            }
+            else m_storage.pointer = other.m_storage.pointer;
+        }
+
+        inline void __move(BasicVarient& other) noexcept
+        {
+            if(m_flag & IsTrivial) std::memcpy(m_storage.buffer, other.m_storage.buffer, InlineSize);
+            else if(m_flag & IsDataOwner) m_vtable->move(&m_storage, &other.m_storage);
+            else m_storage.pointer = other.m_storage.pointer;
+
+            // The payload now belongs to this Varient, the other one must not release it
+            other.m_vtable = nullptr;
+            other.reset();
+        }
+
+        inline void __destruct() noexcept
+        {
+            if(m_vtable && !(m_flag & IsTrivial)) m_vtable->destroy(&m_storage);
+        }
+
+        union Storage
+        {
+            void* pointer;
+            alignas(InlineAlign) unsigned char buffer[InlineSize];
+        };
+
+        Storage m_storage;
+        TypeId m_typeId;
+        const details::VarientVTable* m_vtable;
         uint8_t m_flag;
-        std::function<void(void*)> m_destructor;
-        std::function<void(void**, void*)> m_copy;
         METHAN_DEBUG_ONLY(const char* m_dataName;)
     };
 
+    /**
+     * @brief The Varient used throughout the Methan API, its inline storage can be configured through the
+     * `METHAN_VARIENT_INLINE_SIZE` and `METHAN_VARIENT_INLINE_ALIGN` cmake variables.
+     */
+    typedef BasicVarient<METHAN_VARIENT_INLINE_SIZE, METHAN_VARIENT_INLINE_ALIGN> Varient;
+
 }
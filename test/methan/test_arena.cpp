@@ -0,0 +1,199 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/graph/graph.hpp>
+#include <methan/utility/arena.hpp>
+#include <methan/utility/varient.hpp>
+
+namespace {
+
+    /**
+     * @brief Forward to the default resource while counting the live allocations
+     */
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocations = 0;
+        size_t deallocations = 0;
+
+        inline size_t live() const noexcept
+        {
+            return allocations - deallocations;
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::get_default_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override
+        {
+            ++deallocations;
+            std::pmr::get_default_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    inline bool __is_aligned(const void* pointer, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(pointer) % alignment == 0;
+    }
+
+}
+
+TEST_CASE("MonotonicArena bump allocate and reuse its blocks", "[arena]") {
+    CountingResource upstream;
+    {
+        Methan::MonotonicArena arena(1024, &upstream);
+
+        void* a = arena.allocate(10, 1);
+        void* b = arena.allocate(64, 64);
+        void* c = arena.allocate(8, 8);
+        REQUIRE(__is_aligned(b, 64));
+        REQUIRE(__is_aligned(c, 8));
+        REQUIRE(static_cast<char*>(b) >= static_cast<char*>(a) + 10);
+        REQUIRE(upstream.allocations == 1);
+
+        // Larger than a block, over-aligned
+        void* large = arena.allocate(4096, 256);
+        REQUIRE(__is_aligned(large, 256));
+        REQUIRE(upstream.allocations == 2);
+
+        const size_t capacity = arena.capacity();
+        for(size_t round = 0; round < 8; ++round)
+        {
+            arena.reset();
+            for(size_t i = 0; i < 64; ++i) REQUIRE(arena.allocate(64, 16) != nullptr);
+        }
+        REQUIRE(arena.capacity() == capacity);
+        REQUIRE(upstream.allocations == 2);
+
+        arena.reset();
+        void* first = arena.allocate(32, 16);
+        Methan::MonotonicArena::Marker marker = arena.mark();
+        void* second = arena.allocate(32, 16);
+        arena.rewind(marker);
+        REQUIRE(arena.allocate(32, 16) == second);
+        REQUIRE(first != second);
+    }
+    REQUIRE(upstream.live() == 0);
+}
+
+TEST_CASE("ArenaScope release the memory allocated within the scope", "[arena]") {
+    Methan::MonotonicArena& arena = Methan::scratchArena();
+    Methan::MonotonicArena::Marker before = arena.mark();
+    {
+        Methan::ArenaScope scope(arena);
+        std::pmr::vector<int> values(&scope.arena());
+        for(int i = 0; i < 1000; ++i) values.push_back(i);
+        REQUIRE(values[999] == 999);
+    }
+
+    Methan::MonotonicArena::Marker after = arena.mark();
+    REQUIRE(after.block == before.block);
+    REQUIRE(after.offset == before.offset);
+}
+
+TEST_CASE("PoolResource recycle its blocks", "[arena]") {
+    CountingResource upstream;
+    {
+        Methan::PoolResource pool(24, 16, 4, &upstream);
+        REQUIRE(pool.blockSize() == 32);
+
+        std::array<void*, 4> blocks;
+        for(void*& block : blocks)
+        {
+            block = pool.allocate(24, 8);
+            REQUIRE(__is_aligned(block, 16));
+        }
+        REQUIRE(upstream.allocations == 1);
+
+        pool.deallocate(blocks[2], 24, 8);
+        REQUIRE(pool.allocate(16, 16) == blocks[2]);
+
+        // A fifth block needs a new chunk, requests that do not fit are forwarded
+        REQUIRE(pool.allocate(8, 8) != nullptr);
+        REQUIRE(upstream.allocations == 2);
+        void* large = pool.allocate(100, 8);
+        REQUIRE(upstream.allocations == 3);
+        pool.deallocate(large, 100, 8);
+        REQUIRE(upstream.live() == 2);
+    }
+    REQUIRE(upstream.live() == 0);
+}
+
+TEST_CASE("Varient payloads can be allocated from a memory resource", "[arena]") {
+    CountingResource upstream;
+    {
+        Methan::Varient small(std::allocator_arg, &upstream, 42);
+        REQUIRE(small.isInline());
+        REQUIRE(upstream.allocations == 0);
+
+        Methan::Varient large(std::allocator_arg, &upstream, std::in_place_type<std::array<double, 16>>);
+        REQUIRE(!large.isInline());
+        REQUIRE(upstream.live() == 1);
+        large.get<std::array<double, 16>>()[3] = 2.0;
+
+        // A copy goes to the default resource, a move keeps the block
+        Methan::Varient copy(large);
+        REQUIRE(upstream.live() == 1);
+        REQUIRE(copy.get<std::array<double, 16>>()[3] == 2.0);
+
+        Methan::Varient moved(std::move(large));
+        REQUIRE(upstream.live() == 1);
+        REQUIRE(moved.get<std::array<double, 16>>()[3] == 2.0);
+
+        moved.reset();
+        REQUIRE(upstream.live() == 0);
+
+        Methan::Varient text(std::allocator_arg, &upstream, std::string(100, 'x'));
+        REQUIRE(text.get<std::string>().size() == 100);
+    }
+    REQUIRE(upstream.live() == 0);
+}
+
+TEST_CASE("Graph can be built in an arena", "[arena]") {
+    CountingResource upstream;
+    Methan::MonotonicArena arena(4096, &upstream);
+
+    for(size_t round = 0; round < 4; ++round)
+    {
+        {
+            Methan::Graph graph(&arena);
+            REQUIRE(graph.resource() == &arena);
+
+            Methan::NodeHandle previous = graph.addNode(Methan::OpCode::Input);
+            for(size_t i = 0; i < 1000; ++i)
+            {
+                previous = graph.addNode(Methan::OpCode::Custom, {previous}, Methan::Varient(std::allocator_arg, &arena, std::string(64, 'a')));
+            }
+            REQUIRE(graph.topologicalOrder().size() == 1001);
+            REQUIRE(graph.inputs(previous).size() == 1);
+        }
+        arena.reset();
+    }
+
+    // After the first round every graph fits in the blocks kept by the arena
+    const size_t allocations = upstream.allocations;
+    {
+        Methan::Graph graph(&arena);
+        Methan::NodeHandle previous = graph.addNode(Methan::OpCode::Input);
+        for(size_t i = 0; i < 1000; ++i) previous = graph.addNode(Methan::OpCode::Custom, {previous});
+    }
+    REQUIRE(upstream.allocations == allocations);
+}
@@ -1,5 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <string>
+
 #include <methan/core/configuration.hpp>
 #ifndef METHAN_DEBUG
 #define METHAN_DEBUG
@@ -34,3 +36,34 @@ TEST_CASE("Testing the assertion", "[macro]") {
     CHECK_NOTHROW([]() { METHAN_FORCE_ASSERT_NON_NULL((void*) 0x05); }());
     CHECK_NOTHROW([]() { METHAN_FORCE_ASSERT_NULL(nullptr); }());
 }
+
+TEST_CASE("Exception build their description when it is read", "[macro]") {
+    try {
+        METHAN_FORCE_ASSERT_INDEX(115, 115);
+    }
+    catch (Methan::Exception& e) {
+        const std::string expected = "IndexOutOfBoundsException : The given index is out of bounds (115 should be less than 115). [file=\"" + std::string(__FILE__) + "\", line=" + std::to_string(__LINE__ - 3) + "] ";
+        REQUIRE(std::string(e.message()) == "The given index is out of bounds ({} should be less than {}).");
+        REQUIRE(std::string(e.what()) == expected);
+        REQUIRE(e.what() == e.what());
+
+        // The copies share the description
+        const Methan::Exception copy = e;
+        REQUIRE(copy.what() == e.what());
+    }
+
+    try {
+        METHAN_THROW_EXCEPTION_FORMAT("{} of {} {}", Methan::ExceptionType::IllegalState, -3, "nodes");
+    }
+    catch (Methan::Exception& e) {
+        REQUIRE(std::string(e.what()).find("IllegalStateException : -3 of nodes {} [file=") == 0);
+    }
+
+    try {
+        METHAN_THROW_EXCEPTION(std::string("Owned ") + "message", Methan::ExceptionType::IllegalArgument);
+    }
+    catch (Methan::Exception& e) {
+        REQUIRE(std::string(e.message()) == "Owned message");
+        REQUIRE(std::string(e.what()).find("IllegalArgumentException : Owned message [file=") == 0);
+    }
+}
@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/compiled_graph.hpp>
+
+#include "testing.hpp"
+
+TEST_CASE("Compiled graphs compute the same tensors as the evaluator", "[compiled]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 3;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    // Two residual layers and a custom reduction, plus a branch that is not requested
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle unused = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle layer = x;
+    for(uint32_t i = 0; i < 2; ++i)
+    {
+        Methan::NodeHandle w = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::random({16, 16}, i + 1));
+        Methan::NodeHandle product = graph.addNode(Methan::OpCode::MatMul, {layer, w}, Methan::MatMulPayload{ 0.5, false, i == 1 });
+        Methan::NodeHandle activated = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Tanh, {product});
+        layer = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {activated, layer});
+    }
+    Methan::NodeHandle total = graph.addNode(Methan::OpCode::Custom, {layer}, Methan::CustomOperation([](Methan::Span<const Methan::Tensor> inputs) {
+        Methan::Tensor result = Methan::Tensor::zeros(Methan::DataType::Float32, {1});
+        for(int64_t i = 0; i < inputs[0].elementCount(); ++i) result.data<float>()[0] += inputs[0].data<float>()[i];
+        return result;
+    }));
+    Methan::NodeHandle scaled = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Mul, {layer, total});
+    Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Exp, {unused});
+
+    for(bool concurrent : { false, true })
+    {
+        INFO("Concurrent " << concurrent);
+        Methan::CompileOptions compileOptions;
+        compileOptions.concurrent = concurrent;
+        const Methan::CompiledGraph compiled = Methan::compile(graph, { { x, Methan::Testing::random({8, 16}, 0) }, { unused, Methan::Testing::random({3}, 0) } }, { scaled, total, x }, compileOptions);
+        REQUIRE(compiled.isConcurrent() == concurrent);
+        REQUIRE(compiled.inputCount() == 2);
+        REQUIRE(compiled.outputCount() == 3);
+
+        // The unused branch is not compiled, the planned intermediates share the slab
+        REQUIRE(compiled.instructions().size() == 8);
+        REQUIRE((compiled.memoryPlan().slabSize > 0) == !concurrent);
+
+        // The frame is reused across runs with different values
+        Methan::ExecutionFrame frame(compiled);
+        for(uint32_t seed = 10; seed < 13; ++seed)
+        {
+            const Methan::Tensor input = Methan::Testing::random({8, 16}, seed);
+            const std::vector<Methan::Tensor> expected = evaluator.run(graph, { { x, input }, { unused, input } }, { scaled, total });
+
+            const Methan::Tensor inputs[] = { input, Methan::Tensor() };
+            Methan::Tensor outputs[3];
+            compiled.run(Methan::Span<const Methan::Tensor>(inputs, 2), Methan::Span<Methan::Tensor>(outputs, 3), frame, pool);
+            REQUIRE(Methan::Testing::identical(outputs[0], expected[0]));
+            REQUIRE(Methan::Testing::identical(outputs[1], expected[1]));
+            REQUIRE(outputs[2].rawData() == input.rawData());
+        }
+
+        const std::vector<Methan::Tensor> results = compiled.run({ Methan::Testing::random({8, 16}, 20), Methan::Tensor() }, pool);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0].shape() == Methan::Shape({8, 16}));
+    }
+}
+
+TEST_CASE("Compiled graphs report invalid graphs and runs", "[compiled]") {
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle y = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle sum = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {x, y});
+    Methan::NodeHandle wrong = graph.addNode(Methan::OpCode::Elementwise, {x}, 3.0f);
+    Methan::NodeHandle missing = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Sub, {x});
+    Methan::NodeHandle failing = graph.addNode(Methan::OpCode::Custom, {sum}, Methan::CustomOperation([](Methan::Span<const Methan::Tensor>) -> Methan::Tensor {
+        throw std::runtime_error("failure");
+    }));
+
+    const Methan::Tensor input = Methan::Testing::random({4}, 1);
+    REQUIRE_THROWS_AS(Methan::compile(graph, { { x, input } }, { sum }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::compile(graph, { { x, input }, { y, input } }, { wrong }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::compile(graph, { { x, input }, { y, input } }, { missing }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::compile(graph, { { sum, input } }, { sum }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::compile(graph, { { x, input }, { y, Methan::Testing::random({3}, 2) } }, { sum }), Methan::Exception);
+
+    const Methan::CompiledGraph compiled = Methan::compile(graph, { { x, input }, { y, input } }, { sum });
+    REQUIRE_THROWS_AS(compiled.run({ input }), Methan::Exception);
+    REQUIRE_THROWS_AS(compiled.run({ input, Methan::Testing::random({5}, 3) }), Methan::Exception);
+    REQUIRE(compiled.run({ input, input })[0].data<float>()[3] == 2.0f * input.data<float>()[3]);
+
+    const Methan::CompiledGraph other = Methan::compile(graph, { { x, input }, { y, input } }, { sum });
+    Methan::ExecutionFrame frame(other);
+    Methan::Tensor output;
+    const Methan::Tensor inputs[] = { input, input };
+    REQUIRE_THROWS_AS(compiled.run(Methan::Span<const Methan::Tensor>(inputs, 2), Methan::Span<Methan::Tensor>(&output, 1), frame), Methan::Exception);
+
+    // The exceptions of the nodes are rethrown, the frame can be used again
+    for(bool concurrent : { false, true })
+    {
+        Methan::CompileOptions options;
+        options.concurrent = concurrent;
+        const Methan::CompiledGraph throwing = Methan::compile(graph, { { x, input }, { y, input } }, { failing, sum }, options);
+        Methan::ExecutionFrame throwingFrame(throwing);
+        Methan::Tensor outputs[2];
+        REQUIRE_THROWS_AS(throwing.run(Methan::Span<const Methan::Tensor>(inputs, 2), Methan::Span<Methan::Tensor>(outputs, 2), throwingFrame), Methan::Exception);
+        REQUIRE_THROWS_AS(throwing.run(Methan::Span<const Methan::Tensor>(inputs, 2), Methan::Span<Methan::Tensor>(outputs, 2), throwingFrame), Methan::Exception);
+    }
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/cpu.hpp>
+
+namespace {
+
+    int __scalar() { return 0; }
+    int __sse2() { return 1; }
+    int __avx512() { return 3; }
+
+}
+
+TEST_CASE("CPU features are consistent with the compilation flags", "[cpu]") {
+    Methan::CpuFeatures features = Methan::cpuFeatures();
+    REQUIRE(features == Methan::cpuFeatures());
+
+    // The program would not run if the CPU lacked an extension it was compiled for
+#if defined(METHAN_SUPPORT_SSE2)
+    REQUIRE(features >= Methan::CpuFeature::SSE2);
+    REQUIRE(Methan::supportedIsaLevel() >= Methan::IsaLevel::SSE2);
+#endif
+#if defined(METHAN_SUPPORT_AVX2)
+    REQUIRE(features >= (Methan::CpuFeature::AVX | Methan::CpuFeature::AVX2));
+#endif
+#if defined(METHAN_SUPPORT_AVX512F)
+    REQUIRE(features >= Methan::CpuFeature::AVX512F);
+#endif
+
+    if(features >= Methan::CpuFeature::AVX512F) REQUIRE(features >= Methan::CpuFeature::AVX2);
+    if(Methan::supportedIsaLevel() >= Methan::IsaLevel::AVX2) REQUIRE(features >= (Methan::CpuFeature::AVX2 | Methan::CpuFeature::FMA | Methan::CpuFeature::F16C));
+
+    INFO("Detected: " << Methan::to_string(features) << " (level " << Methan::to_string(Methan::supportedIsaLevel()) << ")");
+    REQUIRE(Methan::to_string(Methan::CpuFeature::SSE2 | Methan::CpuFeature::AVX2) == "sse2 avx2");
+}
+
+TEST_CASE("Dispatch select the best implementation of the current level", "[cpu]") {
+    typedef int (*Function)();
+    constexpr Methan::Dispatch<Function> dispatch = { &__scalar, &__sse2, nullptr, &__avx512 };
+
+    REQUIRE(dispatch.resolve(Methan::IsaLevel::Scalar) == &__scalar);
+    REQUIRE(dispatch.resolve(Methan::IsaLevel::SSE2) == &__sse2);
+    REQUIRE(dispatch.resolve(Methan::IsaLevel::AVX2) == &__sse2);
+    REQUIRE(dispatch.resolve(Methan::IsaLevel::AVX512) == &__avx512);
+
+    const Methan::IsaLevel initial = Methan::isaLevel();
+    REQUIRE(initial <= Methan::supportedIsaLevel());
+
+    REQUIRE(Methan::setIsaLevel(Methan::IsaLevel::Scalar) == Methan::IsaLevel::Scalar);
+    REQUIRE(dispatch()() == 0);
+
+    // Requesting more than the CPU supports is clamped
+    REQUIRE(Methan::setIsaLevel(Methan::IsaLevel::AVX512) == Methan::supportedIsaLevel());
+    REQUIRE(Methan::isaLevel() == Methan::supportedIsaLevel());
+
+    Methan::setIsaLevel(initial);
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/passes/cse.hpp>
+
+#include "testing.hpp"
+
+TEST_CASE("Common subexpressions are computed once", "[cse]") {
+    // exp(x + w) * exp(w + x) + relu(x) * relu(y), with w given twice
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle y = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle w = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({4}, 0.5f));
+    Methan::NodeHandle copyOfW = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({4}, 0.5f));
+    Methan::NodeHandle first = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {x, w});
+    Methan::NodeHandle second = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {copyOfW, x});
+    Methan::NodeHandle expFirst = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Exp, {first});
+    Methan::NodeHandle expSecond = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Exp, {second});
+    Methan::NodeHandle product = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Mul, {expFirst, expSecond});
+    Methan::NodeHandle reluX = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Relu, {x});
+    Methan::NodeHandle reluY = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Relu, {y});
+    Methan::NodeHandle gate = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Mul, {reluX, reluY});
+    Methan::NodeHandle result = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {product, gate});
+    graph.setAttribute(first, Methan::AttributeKey::Name, std::string("first"));
+    graph.setAttribute(second, Methan::AttributeKey::Name, std::string("second"));
+
+    const Methan::RewrittenGraph simplified = Methan::eliminateCommonSubexpressions(graph);
+    REQUIRE(simplified.graph.nodeCount() == graph.nodeCount() - 3);
+    REQUIRE(simplified.map(w) == simplified.map(copyOfW));
+    REQUIRE(simplified.map(first) == simplified.map(second));
+    REQUIRE(simplified.map(expFirst) == simplified.map(expSecond));
+    REQUIRE(simplified.map(x) != simplified.map(y));
+    REQUIRE(simplified.map(reluX) != simplified.map(reluY));
+    REQUIRE(simplified.graph.attribute(simplified.map(first), Methan::AttributeKey::Name)->get<std::string>() == "first");
+
+    Methan::Evaluator evaluator;
+    const Methan::Tensor input = Methan::Testing::filled({4}, 1.0f);
+    const Methan::Tensor other = Methan::Testing::filled({4}, 2.0f);
+    const std::vector<Methan::Tensor> expected = evaluator.run(graph, { { x, input }, { y, other } }, { result });
+    const std::vector<Methan::Tensor> actual = evaluator.run(simplified.graph, { { simplified.map(x), input }, { simplified.map(y), other } }, { simplified.map(result) });
+    for(int64_t i = 0; i < 4; ++i) REQUIRE(actual[0].data<float>()[i] == expected[0].data<float>()[i]);
+}
+
+TEST_CASE("Nodes that differ are not merged", "[cse]") {
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle w = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({4}, 0.5f));
+    Methan::NodeHandle v = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({4}, -0.5f));
+    Methan::NodeHandle scalar = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({1}, 0.5f));
+
+    // Non commutative operations, different parameters, attributes and custom operations
+    Methan::NodeHandle sub = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Sub, {x, w});
+    Methan::NodeHandle reversed = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Sub, {w, x});
+    Methan::NodeHandle clamp = graph.addNode(Methan::OpCode::Elementwise, {x}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Clamp, { 0.0, 1.0 } });
+    Methan::NodeHandle wider = graph.addNode(Methan::OpCode::Elementwise, {x}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Clamp, { 0.0, 2.0 } });
+    Methan::NodeHandle cheap = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Exp, {x});
+    Methan::NodeHandle expensive = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Exp, {x});
+    graph.setAttribute(cheap, Methan::AttributeKey::Cost, 1.0);
+    graph.setAttribute(expensive, Methan::AttributeKey::Cost, 2.0);
+    const Methan::CustomOperation identity = [](Methan::Span<const Methan::Tensor> inputs) { return inputs[0]; };
+    Methan::NodeHandle custom = graph.addNode(Methan::OpCode::Custom, {x}, identity);
+    Methan::NodeHandle sameCustom = graph.addNode(Methan::OpCode::Custom, {x}, identity);
+    Methan::NodeHandle input = graph.addNode(Methan::OpCode::Input);
+
+    const Methan::RewrittenGraph simplified = Methan::eliminateCommonSubexpressions(graph);
+    REQUIRE(simplified.graph.nodeCount() == graph.nodeCount());
+    REQUIRE(simplified.map(w) != simplified.map(v));
+    REQUIRE(simplified.map(w) != simplified.map(scalar));
+    REQUIRE(simplified.map(sub) != simplified.map(reversed));
+    REQUIRE(simplified.map(clamp) != simplified.map(wider));
+    REQUIRE(simplified.map(cheap) != simplified.map(expensive));
+    REQUIRE(simplified.map(custom) != simplified.map(sameCustom));
+    REQUIRE(simplified.map(x) != simplified.map(input));
+
+    // Payloads are compared by value, operands of fused programs included
+    Methan::Graph fused;
+    Methan::NodeHandle a = fused.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle b = fused.addNode(Methan::OpCode::Input);
+    const Methan::FusedElementwisePayload program{ { { Methan::ElementwiseOp::Sub, {}, { 0, 1, 7 } }, { Methan::ElementwiseOp::Exp, {}, { 2, 0, 0 } } } };
+    const Methan::FusedElementwisePayload sameProgram{ { { Methan::ElementwiseOp::Sub, {}, { 0, 1, 0 } }, { Methan::ElementwiseOp::Exp, {}, { 2, 5, 5 } } } };
+    const Methan::FusedElementwisePayload otherProgram{ { { Methan::ElementwiseOp::Sub, {}, { 1, 0, 0 } }, { Methan::ElementwiseOp::Exp, {}, { 2, 0, 0 } } } };
+    Methan::NodeHandle p = fused.addNode(Methan::OpCode::FusedElementwise, {a, b}, program);
+    Methan::NodeHandle q = fused.addNode(Methan::OpCode::FusedElementwise, {a, b}, sameProgram);
+    Methan::NodeHandle r = fused.addNode(Methan::OpCode::FusedElementwise, {a, b}, otherProgram);
+    Methan::NodeHandle m = fused.addNode(Methan::OpCode::MatMul, {p, q});
+    Methan::NodeHandle n = fused.addNode(Methan::OpCode::MatMul, {p, q}, Methan::MatMulPayload());
+    Methan::NodeHandle t = fused.addNode(Methan::OpCode::MatMul, {p, q}, Methan::MatMulPayload{ 1.0, true, false });
+
+    const Methan::RewrittenGraph merged = Methan::eliminateCommonSubexpressions(fused);
+    REQUIRE(merged.map(p) == merged.map(q));
+    REQUIRE(merged.map(p) != merged.map(r));
+    REQUIRE(merged.map(n) != merged.map(t));
+    REQUIRE(merged.map(m) != merged.map(n));
+}
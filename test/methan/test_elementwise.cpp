@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/cpu.hpp>
+#include <methan/core/kernels/elementwise.hpp>
+
+namespace {
+
+    const Methan::ElementwiseOp __operations[] = {
+        Methan::ElementwiseOp::Add, Methan::ElementwiseOp::Sub, Methan::ElementwiseOp::Mul, Methan::ElementwiseOp::Div,
+        Methan::ElementwiseOp::Fma, Methan::ElementwiseOp::Exp, Methan::ElementwiseOp::Tanh, Methan::ElementwiseOp::Relu,
+        Methan::ElementwiseOp::Sigmoid, Methan::ElementwiseOp::Clamp
+    };
+
+    double __reference(Methan::ElementwiseOp op, double a, double b, double c)
+    {
+        switch(op)
+        {
+        case Methan::ElementwiseOp::Add: return a + b;
+        case Methan::ElementwiseOp::Sub: return a - b;
+        case Methan::ElementwiseOp::Mul: return a * b;
+        case Methan::ElementwiseOp::Div: return a / b;
+        case Methan::ElementwiseOp::Fma: return a * b + c;
+        case Methan::ElementwiseOp::Exp: return std::exp(a);
+        case Methan::ElementwiseOp::Tanh: return std::tanh(a);
+        case Methan::ElementwiseOp::Relu: return a < 0.0 ? 0.0 : a;
+        case Methan::ElementwiseOp::Sigmoid: return 1.0 / (1.0 + std::exp(-a));
+        case Methan::ElementwiseOp::Clamp: return a < -1.5 ? -1.5 : (a > 2.0 ? 2.0 : a);
+        }
+        return 0.0;
+    }
+
+    double __tolerance(Methan::DataType type)
+    {
+        switch(type)
+        {
+        case Methan::DataType::Float16: return 2e-3;
+        case Methan::DataType::Float32: return 2e-6;
+        default: return 1e-13;
+        }
+    }
+
+    template<typename T>
+    double __get(const void* data, size_t i)
+    {
+        if constexpr(std::is_same<T, Methan::Half>::value) return Methan::toFloat(static_cast<const T*>(data)[i]);
+        else return static_cast<const T*>(data)[i];
+    }
+
+    template<typename T>
+    void __set(void* data, size_t i, double value)
+    {
+        if constexpr(std::is_same<T, Methan::Half>::value) static_cast<T*>(data)[i] = Methan::toHalf(static_cast<float>(value));
+        else static_cast<T*>(data)[i] = static_cast<T>(value);
+    }
+
+    /**
+     * @brief Run every operation at the current level and compare with the reference, return the number of
+     * elements out of tolerance
+     */
+    template<typename T>
+    size_t __check_operations(size_t count)
+    {
+        const Methan::DataType type = Methan::DataTypeOf<T>::value;
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> distribution(-4.0, 4.0);
+
+        std::vector<T> inputs[3] = { std::vector<T>(count), std::vector<T>(count), std::vector<T>(count) };
+        std::vector<T> output(count);
+        for(auto& input : inputs)
+        {
+            for(size_t i = 0; i < count; ++i)
+            {
+                // Keep the divisors away from 0, include values close to 0 for tanh
+                double value = distribution(generator);
+                if(i % 7 == 0) value *= 1e-3;
+                if(&input == &inputs[1] && std::abs(value) < 0.5) value += 1.0;
+                __set<T>(input.data(), i, value);
+            }
+        }
+
+        Methan::ElementwiseParams params;
+        params.lower = -1.5;
+        params.upper = 2.0;
+
+        size_t failures = 0;
+        for(Methan::ElementwiseOp op : __operations)
+        {
+            const void* pointers[3] = { inputs[0].data(), inputs[1].data(), inputs[2].data() };
+            Methan::elementwise(op, type, count, Methan::Span<const void* const>(pointers, Methan::arity(op)), output.data(), params);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const double expected = __reference(op, __get<T>(inputs[0].data(), i), __get<T>(inputs[1].data(), i), __get<T>(inputs[2].data(), i));
+                const double scale = std::abs(expected) > 1.0 ? std::abs(expected) : 1.0;
+                if(std::abs(__get<T>(output.data(), i) - expected) > __tolerance(type) * scale) ++failures;
+            }
+        }
+        return failures;
+    }
+
+}
+
+TEST_CASE("Half precision conversions are exact and round to nearest even", "[elementwise]") {
+    for(uint32_t bits = 0; bits < 0x10000; ++bits)
+    {
+        const Methan::Half value = { static_cast<uint16_t>(bits) };
+        const float converted = Methan::toFloat(value);
+        if(std::isnan(converted)) continue;
+        REQUIRE(Methan::toHalf(converted).bits == value.bits);
+    }
+
+    REQUIRE(Methan::toHalf(1.0f).bits == 0x3C00);
+    REQUIRE(Methan::toHalf(-2.0f).bits == 0xC000);
+    REQUIRE(Methan::toHalf(65504.0f).bits == 0x7BFF);
+    REQUIRE(Methan::toHalf(65520.0f).bits == 0x7C00);
+    REQUIRE(Methan::toHalf(std::ldexp(1.0f, -24)).bits == 0x0001);
+    REQUIRE(Methan::toHalf(std::ldexp(1.0f, -26)).bits == 0x0000);
+    REQUIRE(std::isnan(Methan::toFloat(Methan::toHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+    // 1 + 2^-11 is halfway between 1 and the next half, ties go to the even mantissa
+    REQUIRE(Methan::toHalf(1.0f + std::ldexp(1.0f, -11)).bits == 0x3C00);
+    REQUIRE(Methan::toHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)).bits == 0x3C02);
+}
+
+TEST_CASE("Elementwise kernels of every instruction set match the reference", "[elementwise]") {
+    const Methan::IsaLevel initial = Methan::isaLevel();
+
+    for(uint32_t level = 0; level <= static_cast<uint32_t>(Methan::supportedIsaLevel()); ++level)
+    {
+        Methan::setIsaLevel(static_cast<Methan::IsaLevel>(level));
+        INFO("Level " << Methan::to_string(Methan::isaLevel()));
+
+        // Odd counts exercise the scalar tails
+        for(size_t count : { size_t(0), size_t(1), size_t(31), size_t(1037) })
+        {
+            INFO(count << " elements");
+            REQUIRE(__check_operations<float>(count) == 0);
+            REQUIRE(__check_operations<double>(count) == 0);
+            REQUIRE(__check_operations<Methan::Half>(count) == 0);
+        }
+    }
+
+    Methan::setIsaLevel(initial);
+}
+
+TEST_CASE("Elementwise kernels propagate NaN and saturate", "[elementwise]") {
+    const Methan::IsaLevel initial = Methan::isaLevel();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    for(uint32_t level = 0; level <= static_cast<uint32_t>(Methan::supportedIsaLevel()); ++level)
+    {
+        Methan::setIsaLevel(static_cast<Methan::IsaLevel>(level));
+        INFO("Level " << Methan::to_string(Methan::isaLevel()));
+
+        std::vector<float> input(64, nan);
+        std::vector<float> output(64);
+        for(Methan::ElementwiseOp op : { Methan::ElementwiseOp::Exp, Methan::ElementwiseOp::Tanh, Methan::ElementwiseOp::Relu, Methan::ElementwiseOp::Sigmoid, Methan::ElementwiseOp::Clamp })
+        {
+            Methan::elementwise(op, Methan::DataType::Float32, input.size(), { input.data() }, output.data());
+            for(float value : output) REQUIRE(std::isnan(value));
+        }
+
+        std::vector<double> large(64, 1000.0);
+        std::vector<double> result(64);
+        Methan::elementwise(Methan::ElementwiseOp::Tanh, Methan::DataType::Float64, large.size(), { large.data() }, result.data());
+        for(double value : result) REQUIRE(value == 1.0);
+        Methan::elementwise(Methan::ElementwiseOp::Sigmoid, Methan::DataType::Float64, large.size(), { large.data() }, result.data());
+        for(double value : result) REQUIRE(value == 1.0);
+    }
+
+    Methan::setIsaLevel(initial);
+}
+
+TEST_CASE("Elementwise operations on tensors broadcast their inputs", "[elementwise]") {
+    Methan::Tensor matrix(Methan::DataType::Float32, {2, 3});
+    Methan::Tensor row(Methan::DataType::Float32, {3});
+    for(int64_t i = 0; i < 6; ++i) matrix.data<float>()[i] = static_cast<float>(i);
+    for(int64_t i = 0; i < 3; ++i) row.data<float>()[i] = static_cast<float>(10 * (i + 1));
+
+    Methan::Tensor sum = Methan::elementwise(Methan::ElementwiseOp::Add, { matrix, row });
+    REQUIRE(sum.shape() == Methan::Shape({2, 3}));
+    REQUIRE(sum.at<float>({0, 0}) == 10.0f);
+    REQUIRE(sum.at<float>({1, 2}) == 35.0f);
+
+    // Strided inputs and in place output
+    Methan::Tensor transposed = Methan::elementwise(Methan::ElementwiseOp::Relu, { matrix.transpose(0, 1) });
+    REQUIRE(transposed.shape() == Methan::Shape({3, 2}));
+    REQUIRE(transposed.at<float>({2, 1}) == 5.0f);
+    Methan::elementwise(Methan::ElementwiseOp::Mul, { sum, sum }, sum);
+    REQUIRE(sum.at<float>({1, 2}) == 35.0f * 35.0f);
+
+    Methan::Tensor integers(Methan::DataType::Int32, {2, 3});
+    Methan::Tensor doubles(Methan::DataType::Float64, {2, 3});
+    REQUIRE_THROWS_AS(Methan::elementwise(Methan::ElementwiseOp::Add, { matrix }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::elementwise(Methan::ElementwiseOp::Add, { integers, integers }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::elementwise(Methan::ElementwiseOp::Add, { matrix, doubles }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::elementwise(Methan::ElementwiseOp::Add, { matrix, Methan::Tensor(Methan::DataType::Float32, {4}) }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::elementwise(Methan::ElementwiseOp::Add, { matrix, matrix }, transposed), Methan::Exception);
+
+    Methan::ElementwiseParams params;
+    params.lower = 1.0;
+    params.upper = 0.0;
+    REQUIRE_THROWS_AS(Methan::elementwise(Methan::ElementwiseOp::Clamp, { matrix }, params), Methan::Exception);
+}
@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/evaluator.hpp>
+
+#include "testing.hpp"
+
+TEST_CASE("Evaluator computes the tensors of a graph", "[evaluator]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 3;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    // relu(x * W + b) and a custom reduction of it
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle w = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({4, 3}, 0.5f));
+    Methan::NodeHandle bias = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({3}, -1.0f));
+    Methan::NodeHandle product = graph.addNode(Methan::OpCode::MatMul, {x, w});
+    Methan::NodeHandle shifted = graph.addNode(Methan::OpCode::Elementwise, {product, bias}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} });
+    Methan::NodeHandle activated = graph.addNode(Methan::OpCode::Elementwise, {shifted}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Relu, {} });
+    Methan::NodeHandle total = graph.addNode(Methan::OpCode::Custom, {activated}, Methan::CustomOperation([](Methan::Span<const Methan::Tensor> inputs) {
+        Methan::Tensor result = Methan::Tensor::zeros(Methan::DataType::Float32, {1});
+        for(int64_t i = 0; i < inputs[0].elementCount(); ++i) result.data<float>()[0] += inputs[0].data<float>()[i];
+        return result;
+    }));
+
+    // Row 0 gives 4 * 2 * 0.5 - 1 = 3 in every column, row 1 gives -3 (clamped to 0 by relu)
+    Methan::Tensor input(Methan::DataType::Float32, {2, 4});
+    for(int64_t j = 0; j < 4; ++j)
+    {
+        input.at<float>({0, j}) = 2.0f;
+        input.at<float>({1, j}) = -1.0f;
+    }
+
+    std::vector<Methan::Tensor> results = evaluator.run(graph, { { x, input } }, { activated, total });
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0].shape() == Methan::Shape({2, 3}));
+    REQUIRE(results[0].at<float>({0, 2}) == 3.0f);
+    REQUIRE(results[0].at<float>({1, 0}) == 0.0f);
+    REQUIRE(results[1].at<float>({0}) == 9.0f);
+
+    // The transposes of the payload are applied to the operands
+    Methan::NodeHandle gram = graph.addNode(Methan::OpCode::MatMul, {x, x}, Methan::MatMulPayload{ 1.0, false, true });
+    results = evaluator.run(graph, { { x, input } }, { gram });
+    REQUIRE(results[0].shape() == Methan::Shape({2, 2}));
+    REQUIRE(results[0].at<float>({0, 1}) == -8.0f);
+}
+
+TEST_CASE("Evaluator reports invalid graphs", "[evaluator]") {
+    Methan::Evaluator evaluator;
+
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle y = graph.addNode(Methan::OpCode::Elementwise, {x}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Exp, {} });
+    Methan::NodeHandle wrong = graph.addNode(Methan::OpCode::Constant, {}, 3.0f);
+
+    REQUIRE_THROWS_AS(evaluator.run(graph, {}, { y }), Methan::Exception);
+    REQUIRE_THROWS_AS(evaluator.run(graph, { { y, Methan::Testing::filled({2}, 1.0f) } }, { y }), Methan::Exception);
+    REQUIRE_THROWS_AS(evaluator.run(graph, { { x, Methan::Testing::filled({2}, 1.0f) } }, { wrong }), Methan::Exception);
+
+    Methan::Graph valid;
+    Methan::NodeHandle input = valid.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle exp = valid.addNode(Methan::OpCode::Elementwise, {input}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Exp, {} });
+    std::vector<Methan::Tensor> results = evaluator.run(valid, { { input, Methan::Testing::filled({5}, 0.0f) } }, { exp });
+    for(int64_t i = 0; i < 5; ++i) REQUIRE(results[0].data<float>()[i] == 1.0f);
+}
@@ -0,0 +1,206 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/executor.hpp>
+
+namespace {
+
+    struct CountingJob : public Methan::Job
+    {
+        std::atomic<size_t>* counter;
+        Methan::WaitGroup* group;
+    };
+
+    void __count(Methan::Job* job)
+    {
+        CountingJob* self = static_cast<CountingJob*>(job);
+        self->counter->fetch_add(1);
+        self->group->done();
+    }
+
+    Methan::Graph __layered_graph(size_t width, size_t depth)
+    {
+        Methan::Graph graph;
+        std::vector<Methan::NodeHandle> previous;
+        for(size_t i = 0; i < width; ++i) previous.push_back(graph.addNode(Methan::OpCode::Input));
+
+        for(size_t d = 1; d < depth; ++d)
+        {
+            std::vector<Methan::NodeHandle> layer;
+            for(size_t i = 0; i < width; ++i)
+            {
+                layer.push_back(graph.addNode(Methan::OpCode::Custom, {previous[i], previous[(i + 1) % width]}));
+            }
+            previous = layer;
+        }
+
+        return graph;
+    }
+
+}
+
+TEST_CASE("ThreadPool execute submitted jobs", "[execution]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 4;
+    Methan::ThreadPool pool(options);
+    REQUIRE(pool.workerCount() == 4);
+    REQUIRE(pool.currentWorkerIndex() == -1);
+
+    std::atomic<size_t> counter(0);
+    Methan::WaitGroup group(1000);
+    std::vector<CountingJob> jobs(1000);
+    for(CountingJob& job : jobs)
+    {
+        job.execute = &__count;
+        job.counter = &counter;
+        job.group = &group;
+        pool.submit(&job);
+    }
+
+    pool.wait(group);
+    REQUIRE(counter.load() == 1000);
+}
+
+TEST_CASE("Executor run every node after its inputs", "[execution]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 4;
+    Methan::ThreadPool pool(options);
+    Methan::Executor executor(pool);
+
+    Methan::Graph graph = __layered_graph(64, 32);
+    std::unique_ptr<std::atomic<size_t>[]> finished(new std::atomic<size_t>[graph.nodeCount()]);
+    std::atomic<size_t> clock(1);
+    for(size_t i = 0; i < graph.nodeCount(); ++i) finished[i].store(0);
+
+    std::atomic<bool> orderViolated(false);
+    for(size_t run = 0; run < 8; ++run)
+    {
+        executor.setPolicy(static_cast<Methan::SchedulePolicy>(run % 4));
+        for(size_t i = 0; i < graph.nodeCount(); ++i) finished[i].store(0);
+        executor.run(graph, [&](Methan::NodeHandle node) {
+            for(Methan::NodeIndex input : graph.inputs(node))
+            {
+                if(finished[input].load() == 0) orderViolated.store(true);
+            }
+            finished[Methan::Graph::index(node)].store(clock.fetch_add(1));
+        });
+
+        for(size_t i = 0; i < graph.nodeCount(); ++i) REQUIRE(finished[i].load() != 0);
+    }
+
+    REQUIRE(!orderViolated.load());
+}
+
+TEST_CASE("Executor propagate exceptions", "[execution]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    Methan::Executor executor(pool);
+    Methan::Graph graph = __layered_graph(8, 8);
+
+    try
+    {
+        executor.run(graph, [](Methan::NodeHandle node) {
+            if(Methan::Graph::index(node) == 20) METHAN_THROW_EXCEPTION("Failure", Methan::ExceptionType::IllegalArgument);
+        });
+        FAIL("The exception was not propagated");
+    }
+    catch(const Methan::Exception& e)
+    {
+        REQUIRE(e.type() == Methan::ExceptionType::IllegalArgument);
+    }
+
+    try
+    {
+        executor.run(graph, [](Methan::NodeHandle) { throw std::runtime_error("failure"); });
+        FAIL("The exception was not propagated");
+    }
+    catch(const Methan::Exception& e)
+    {
+        REQUIRE(e.type() == Methan::ExceptionType::ExecutionError);
+    }
+
+    graph.addEdge(Methan::Graph::handle(63), Methan::Graph::handle(10));
+    REQUIRE_THROWS_AS(executor.run(graph, [](Methan::NodeHandle) {}), Methan::Exception);
+}
+
+TEST_CASE("Critical path lengths account for the cost of the nodes", "[execution]") {
+    Methan::Graph graph;
+    Methan::NodeHandle a = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Custom, {a});
+    Methan::NodeHandle c = graph.addNode(Methan::OpCode::Custom, {a});
+    Methan::NodeHandle d = graph.addNode(Methan::OpCode::Custom, {b, c});
+    graph.setAttribute(b, Methan::AttributeKey::Cost, 5.0);
+    graph.setAttribute(c, Methan::AttributeKey::Cost, 2);
+    graph.setAttribute(d, Methan::AttributeKey::Cost, 0.5f);
+
+    REQUIRE(Methan::nodeCost(graph, a) == 1.0);
+    REQUIRE(Methan::nodeCost(graph, c) == 2.0);
+
+    std::vector<double> lengths = Methan::criticalPathLengths(graph);
+    REQUIRE(lengths[Methan::Graph::index(d)] == 0.5);
+    REQUIRE(lengths[Methan::Graph::index(c)] == 2.5);
+    REQUIRE(lengths[Methan::Graph::index(b)] == 5.5);
+    REQUIRE(lengths[Methan::Graph::index(a)] == 6.5);
+
+    graph.setAttribute(a, Methan::AttributeKey::Cost, std::string("expensive"));
+    REQUIRE_THROWS_AS(Methan::nodeCost(graph, a), Methan::Exception);
+}
+
+TEST_CASE("Executor dispatch ready nodes according to the policy", "[execution]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 1;
+    Methan::ThreadPool pool(options);
+    Methan::Executor executor(pool);
+
+    // Four independent nodes and a chain of three nodes
+    Methan::Graph graph;
+    for(size_t i = 0; i < 4; ++i) graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle head = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle middle = graph.addNode(Methan::OpCode::Custom, {head});
+    Methan::NodeHandle tail = graph.addNode(Methan::OpCode::Custom, {middle});
+    graph.setAttribute(tail, Methan::AttributeKey::Cost, 3.0);
+
+    auto order = [&](Methan::SchedulePolicy policy) {
+        std::vector<Methan::NodeIndex> nodes;
+        executor.setPolicy(policy);
+        executor.run(graph, [&](Methan::NodeHandle node) { nodes.push_back(Methan::Graph::index(node)); });
+        return nodes;
+    };
+
+    REQUIRE(order(Methan::SchedulePolicy::Fifo) == std::vector<Methan::NodeIndex>({0, 1, 2, 3, 4, 5, 6}));
+    REQUIRE(order(Methan::SchedulePolicy::Lifo) == std::vector<Methan::NodeIndex>({4, 5, 6, 3, 2, 1, 0}));
+    REQUIRE(order(Methan::SchedulePolicy::CriticalPath) == std::vector<Methan::NodeIndex>({4, 5, 6, 0, 1, 2, 3}));
+}
+
+TEST_CASE("Executor support nested runs and pinned workers", "[execution]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    options.pinWorkers = true;
+    options.cpus = {0};
+    Methan::ThreadPool pool(options);
+    Methan::Executor executor(pool);
+
+    Methan::Graph outer = __layered_graph(4, 4);
+    Methan::Graph inner = __layered_graph(16, 4);
+    std::atomic<size_t> innerCount(0);
+    inner.isAcyclic();
+    std::atomic<size_t> outsideCount(0);
+
+    executor.run(outer, [&](Methan::NodeHandle) {
+        if(pool.currentWorkerIndex() < 0) outsideCount.fetch_add(1);
+        executor.run(inner, [&](Methan::NodeHandle) { innerCount.fetch_add(1); });
+    });
+
+    REQUIRE(outsideCount.load() == 0);
+    REQUIRE(innerCount.load() == outer.nodeCount() * inner.nodeCount());
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/passes/folding.hpp>
+
+#include "testing.hpp"
+
+TEST_CASE("Constant subtrees are evaluated once", "[folding]") {
+    // x * (W * W^T) + exp(b) - b, where only x is an input
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle w = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({3, 2}, 0.5f));
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({3}, 0.0f));
+    Methan::NodeHandle gram = graph.addNode(Methan::OpCode::MatMul, {w, w}, Methan::MatMulPayload{ 1.0, false, true });
+    Methan::NodeHandle product = graph.addNode(Methan::OpCode::MatMul, {x, gram});
+    Methan::NodeHandle exp = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Exp, {b});
+    Methan::NodeHandle shift = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Sub, {exp, b});
+    Methan::NodeHandle result = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {product, shift});
+    graph.setAttribute(shift, Methan::AttributeKey::Name, std::string("shift"));
+    graph.setAttribute(shift, Methan::AttributeKey::Cost, 10.0);
+
+    const Methan::RewrittenGraph folded = Methan::foldConstants(graph, { result });
+
+    // W and b are only consumed by folded nodes, exp(b) is consumed by shift
+    REQUIRE(folded.map(w) == nullptr);
+    REQUIRE(folded.map(b) == nullptr);
+    REQUIRE(folded.map(exp) == nullptr);
+    REQUIRE(folded.graph.nodeCount() == 5);
+    REQUIRE(folded.graph.op(folded.map(gram)) == Methan::OpCode::Constant);
+    REQUIRE(folded.graph.op(folded.map(shift)) == Methan::OpCode::Constant);
+    REQUIRE(folded.graph.op(folded.map(product)) == Methan::OpCode::MatMul);
+    REQUIRE(folded.graph.attribute(folded.map(shift), Methan::AttributeKey::Name)->get<std::string>() == "shift");
+    REQUIRE(!folded.graph.hasAttribute(folded.map(shift), Methan::AttributeKey::Cost));
+
+    const Methan::Tensor& constant = folded.graph.payload(folded.map(shift)).get<Methan::Tensor>();
+    REQUIRE(constant.shape() == Methan::Shape({3}));
+    REQUIRE(constant.data<float>()[2] == 1.0f);
+
+    Methan::Evaluator evaluator;
+    const Methan::Tensor input = Methan::Testing::filled({2, 3}, 2.0f);
+    const std::vector<Methan::Tensor> expected = evaluator.run(graph, { { x, input } }, { result });
+    const std::vector<Methan::Tensor> actual = evaluator.run(folded.graph, { { folded.map(x), input } }, { folded.map(result) });
+    REQUIRE(actual[0].shape() == Methan::Shape({2, 3}));
+    for(int64_t i = 0; i < 6; ++i) REQUIRE(actual[0].data<float>()[i] == expected[0].data<float>()[i]);
+}
+
+TEST_CASE("Constant folding keeps the outputs and the invalid nodes", "[folding]") {
+    Methan::Graph graph;
+    Methan::NodeHandle a = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({2}, 1.0f));
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::filled({3}, 1.0f));
+    Methan::NodeHandle scalar = graph.addNode(Methan::OpCode::Constant, {}, 2.0f);
+    Methan::NodeHandle clamp = graph.addNode(Methan::OpCode::Elementwise, {a}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Clamp, { -1.0, 0.5 } });
+    Methan::NodeHandle relu = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Relu, {clamp});
+    Methan::NodeHandle mismatch = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {a, b});
+    Methan::NodeHandle wrong = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Relu, {scalar});
+    Methan::NodeHandle custom = graph.addNode(Methan::OpCode::Custom, {a}, Methan::CustomOperation([](Methan::Span<const Methan::Tensor> inputs) { return inputs[0]; }));
+
+    const Methan::RewrittenGraph folded = Methan::foldConstants(graph, { clamp, relu, mismatch, wrong, custom });
+
+    // The requested intermediate value is kept, a is still consumed by nodes that are not folded
+    REQUIRE(folded.graph.op(folded.map(clamp)) == Methan::OpCode::Constant);
+    REQUIRE(folded.graph.op(folded.map(relu)) == Methan::OpCode::Constant);
+    REQUIRE(folded.graph.payload(folded.map(clamp)).get<Methan::Tensor>().data<float>()[1] == 0.5f);
+    REQUIRE(folded.graph.payload(folded.map(relu)).get<Methan::Tensor>().data<float>()[1] == 0.5f);
+    REQUIRE(folded.map(a) != nullptr);
+    REQUIRE(folded.graph.op(folded.map(mismatch)) == Methan::OpCode::Elementwise);
+    REQUIRE(folded.graph.op(folded.map(wrong)) == Methan::OpCode::Elementwise);
+    REQUIRE(folded.graph.op(folded.map(custom)) == Methan::OpCode::Custom);
+
+    Methan::Evaluator evaluator;
+    REQUIRE_THROWS_AS(evaluator.run(folded.graph, {}, { folded.map(mismatch) }), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::foldConstants(graph, { nullptr }), Methan::Exception);
+}
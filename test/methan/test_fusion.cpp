@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/passes/fusion.hpp>
+
+#include "testing.hpp"
+
+namespace {
+
+    size_t __count(const Methan::Graph& graph, Methan::OpCode op)
+    {
+        size_t count = 0;
+        for(size_t i = 0; i < graph.nodeCount(); ++i) count += graph.op(Methan::Graph::handle(static_cast<Methan::NodeIndex>(i))) == op;
+        return count;
+    }
+
+}
+
+TEST_CASE("Elementwise programs match the operations applied one by one", "[fusion]") {
+    // sigmoid(clamp(x * y + bias, -1, 1) * scale) - x, over several blocks and a partial one
+    const Methan::Tensor x = Methan::Testing::random({37, 129}, 1, 2.0f);
+    const Methan::Tensor y = Methan::Testing::random({37, 129}, 2, 2.0f);
+    const Methan::Tensor bias = Methan::Testing::random({129}, 3, 2.0f);
+    const Methan::Tensor scale = Methan::Testing::random({1}, 4, 2.0f);
+    const Methan::ElementwiseParams bounds = { -1.0, 1.0 };
+
+    const Methan::ElementwiseInstruction program[] = {
+        { Methan::ElementwiseOp::Fma, {}, { 0, 1, 2 } },
+        { Methan::ElementwiseOp::Clamp, bounds, { 4 } },
+        { Methan::ElementwiseOp::Mul, {}, { 5, 3 } },
+        { Methan::ElementwiseOp::Sigmoid, {}, { 6 } },
+        { Methan::ElementwiseOp::Sub, {}, { 7, 0 } }
+    };
+    const Methan::Tensor inputs[] = { x, y, bias, scale };
+    const Methan::Tensor fused = Methan::elementwise(Methan::Span<const Methan::ElementwiseInstruction>(program, 5), Methan::Span<const Methan::Tensor>(inputs, 4));
+
+    Methan::Tensor expected = Methan::elementwise(Methan::ElementwiseOp::Fma, { x, y, bias });
+    expected = Methan::elementwise(Methan::ElementwiseOp::Clamp, { expected }, bounds);
+    expected = Methan::elementwise(Methan::ElementwiseOp::Mul, { expected, scale });
+    expected = Methan::elementwise(Methan::ElementwiseOp::Sigmoid, { expected });
+    expected = Methan::elementwise(Methan::ElementwiseOp::Sub, { expected, x });
+    REQUIRE(Methan::Testing::identical(fused, expected));
+
+    // Input broadcast along an inner dimension (materialized) and the same value read twice
+    const Methan::Tensor column = Methan::Testing::random({37, 1}, 5, 2.0f);
+    const Methan::ElementwiseInstruction squares[] = {
+        { Methan::ElementwiseOp::Add, {}, { 0, 1 } },
+        { Methan::ElementwiseOp::Mul, {}, { 2, 2 } }
+    };
+    const Methan::Tensor operands[] = { x, column };
+    const Methan::Tensor sum = Methan::elementwise(Methan::ElementwiseOp::Add, { x, column });
+    REQUIRE(Methan::Testing::identical(Methan::elementwise(Methan::Span<const Methan::ElementwiseInstruction>(squares, 2), Methan::Span<const Methan::Tensor>(operands, 2)),
+                        Methan::elementwise(Methan::ElementwiseOp::Mul, { sum, sum })));
+
+    // Intermediate results smaller than the result are computed one by one
+    const Methan::ElementwiseInstruction shifted[] = {
+        { Methan::ElementwiseOp::Exp, {}, { 1 } },
+        { Methan::ElementwiseOp::Add, {}, { 0, 2 } }
+    };
+    const Methan::Tensor mixed[] = { x, bias };
+    REQUIRE(Methan::Testing::identical(Methan::elementwise(Methan::Span<const Methan::ElementwiseInstruction>(shifted, 2), Methan::Span<const Methan::Tensor>(mixed, 2)),
+                        Methan::elementwise(Methan::ElementwiseOp::Add, { x, Methan::elementwise(Methan::ElementwiseOp::Exp, { bias }) })));
+
+    const Methan::ElementwiseInstruction undefined[] = { { Methan::ElementwiseOp::Add, {}, { 0, 2 } } };
+    REQUIRE_THROWS_AS(Methan::elementwise(Methan::Span<const Methan::ElementwiseInstruction>(undefined, 1), Methan::Span<const Methan::Tensor>(mixed, 2)), Methan::Exception);
+}
+
+TEST_CASE("Chains of elementwise nodes are fused", "[fusion]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    // out = sigmoid(relu(x * W + b)) + exp(x * W + b) * 2, where the product is read twice
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle w = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::random({16, 24}, 6, 2.0f));
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::random({24}, 7, 2.0f));
+    Methan::NodeHandle two = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::random({1}, 8, 2.0f));
+    Methan::NodeHandle product = graph.addNode(Methan::OpCode::MatMul, {x, w});
+    Methan::NodeHandle shifted = graph.addNode(Methan::OpCode::Elementwise, {product, b}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} });
+    Methan::NodeHandle relu = graph.addNode(Methan::OpCode::Elementwise, {shifted}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Relu, {} });
+    Methan::NodeHandle sigmoid = graph.addNode(Methan::OpCode::Elementwise, {relu}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Sigmoid, {} });
+    Methan::NodeHandle exp = graph.addNode(Methan::OpCode::Elementwise, {shifted}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Exp, {} });
+    Methan::NodeHandle scaled = graph.addNode(Methan::OpCode::Elementwise, {exp, two}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Mul, {} });
+    Methan::NodeHandle out = graph.addNode(Methan::OpCode::Elementwise, {sigmoid, scaled}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} });
+    graph.setAttribute(out, Methan::AttributeKey::Name, std::string("out"));
+
+    const Methan::Tensor input = Methan::Testing::random({8, 16}, 9, 2.0f);
+    const Methan::Tensor expected = evaluator.run(graph, { { x, input } }, { out })[0];
+
+    // `shifted` has two consumers: it is kept and the two branches are fused with `out`
+    Methan::RewrittenGraph fused = Methan::fuseElementwise(graph, { out });
+    REQUIRE(__count(fused.graph, Methan::OpCode::Elementwise) == 1);
+    REQUIRE(__count(fused.graph, Methan::OpCode::FusedElementwise) == 1);
+    REQUIRE(fused.graph.nodeCount() == 7);
+    REQUIRE(fused.map(relu) == nullptr);
+    REQUIRE(fused.graph.op(fused.map(out)) == Methan::OpCode::FusedElementwise);
+    REQUIRE(fused.graph.payload(fused.map(out)).get<Methan::FusedElementwisePayload>().program.size() == 5);
+    REQUIRE(fused.graph.attribute(fused.map(out), Methan::AttributeKey::Name)->get<std::string>() == "out");
+    REQUIRE(Methan::Testing::identical(evaluator.run(fused.graph, { { fused.map(x), input } }, { fused.map(out) })[0], expected));
+
+    // Requested values are kept, fusing the result again merges the fused nodes
+    Methan::RewrittenGraph partial = Methan::fuseElementwise(graph, { relu, out });
+    REQUIRE(partial.map(relu) != nullptr);
+    REQUIRE(__count(partial.graph, Methan::OpCode::Elementwise) == 2);
+    REQUIRE(__count(partial.graph, Methan::OpCode::FusedElementwise) == 1);
+    std::vector<Methan::Tensor> results = evaluator.run(partial.graph, { { partial.map(x), input } }, { partial.map(out), partial.map(relu) });
+    REQUIRE(Methan::Testing::identical(results[0], expected));
+    REQUIRE(Methan::Testing::identical(results[1], evaluator.run(graph, { { x, input } }, { relu })[0]));
+
+    Methan::RewrittenGraph merged = Methan::fuseElementwise(partial.graph, { partial.map(out) });
+    REQUIRE(__count(merged.graph, Methan::OpCode::Elementwise) == 1);
+    REQUIRE(merged.graph.payload(merged.map(partial.map(out))).get<Methan::FusedElementwisePayload>().program.size() == 5);
+    REQUIRE(Methan::Testing::identical(evaluator.run(merged.graph, { { merged.map(partial.map(x)), input } }, { merged.map(partial.map(out)) })[0], expected));
+}
+
+TEST_CASE("Invalid elementwise nodes are not fused", "[fusion]") {
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle wrong = graph.addNode(Methan::OpCode::Elementwise, {x}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} });
+    Methan::NodeHandle exp = graph.addNode(Methan::OpCode::Elementwise, {wrong}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Exp, {} });
+
+    Methan::RewrittenGraph fused = Methan::fuseElementwise(graph, { exp });
+    REQUIRE(__count(fused.graph, Methan::OpCode::FusedElementwise) == 0);
+    REQUIRE(fused.graph.nodeCount() == 3);
+
+    Methan::Evaluator evaluator;
+    REQUIRE_THROWS_AS(evaluator.run(fused.graph, { { fused.map(x), Methan::Testing::random({4}, 10, 2.0f) } }, { fused.map(exp) }), Methan::Exception);
+}
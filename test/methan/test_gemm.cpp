@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/cpu.hpp>
+#include <methan/core/kernels/gemm.hpp>
+
+namespace {
+
+    struct Case
+    {
+        size_t m, n, k;
+        bool transposeA, transposeB;
+        double alpha, beta;
+    };
+
+    /**
+     * @brief Compare the GEMM with the naive product, return the number of elements out of tolerance
+     */
+    template<typename T>
+    size_t __check_gemm(const Case& test, Methan::ThreadPool& pool)
+    {
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+        std::vector<T> a(test.m * test.k), b(test.k * test.n), c(test.m * test.n);
+        for(T& value : a) value = static_cast<T>(distribution(generator));
+        for(T& value : b) value = static_cast<T>(distribution(generator));
+        for(T& value : c) value = static_cast<T>(distribution(generator));
+        const std::vector<T> initial = c;
+
+        // A transposed operand is stored k x m (resp. n x k) and described by swapped strides
+        const int64_t rowStrideA = test.transposeA ? 1 : static_cast<int64_t>(test.k);
+        const int64_t columnStrideA = test.transposeA ? static_cast<int64_t>(test.m) : 1;
+        const int64_t rowStrideB = test.transposeB ? 1 : static_cast<int64_t>(test.n);
+        const int64_t columnStrideB = test.transposeB ? static_cast<int64_t>(test.k) : 1;
+
+        Methan::gemm(Methan::DataTypeOf<T>::value, test.m, test.n, test.k,
+                     test.alpha, a.data(), rowStrideA, columnStrideA,
+                     b.data(), rowStrideB, columnStrideB,
+                     test.beta, c.data(), static_cast<int64_t>(test.n), pool);
+
+        const double tolerance = sizeof(T) == 4 ? 1e-5 : 1e-12;
+        size_t failures = 0;
+        for(size_t i = 0; i < test.m; ++i)
+        {
+            for(size_t j = 0; j < test.n; ++j)
+            {
+                double expected = test.beta * static_cast<double>(initial[i * test.n + j]);
+                for(size_t p = 0; p < test.k; ++p)
+                {
+                    const double x = static_cast<double>(a[static_cast<int64_t>(i) * rowStrideA + static_cast<int64_t>(p) * columnStrideA]);
+                    const double y = static_cast<double>(b[static_cast<int64_t>(p) * rowStrideB + static_cast<int64_t>(j) * columnStrideB]);
+                    expected += test.alpha * x * y;
+                }
+                const double scale = 1.0 + std::sqrt(static_cast<double>(test.k));
+                if(std::abs(static_cast<double>(c[i * test.n + j]) - expected) > tolerance * scale) ++failures;
+            }
+        }
+        return failures;
+    }
+
+}
+
+TEST_CASE("GEMM of every instruction set matches the naive product", "[gemm]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 4;
+    Methan::ThreadPool pool(options);
+    const Methan::IsaLevel initial = Methan::isaLevel();
+
+    const Case cases[] = {
+        { 1, 1, 1, false, false, 1.0, 0.0 },
+        { 7, 13, 5, false, false, 1.0, 0.0 },
+        { 33, 17, 65, true, false, 0.5, 1.0 },
+        { 12, 32, 300, false, true, 1.0, -2.0 },
+        { 150, 130, 140, false, false, 1.0, 0.0 },
+        { 150, 130, 140, true, true, 2.0, 0.5 },
+        { 64, 1000, 20, false, false, 1.0, 0.0 },
+        { 9, 11, 0, false, false, 1.0, 3.0 }
+    };
+
+    for(uint32_t level = 0; level <= static_cast<uint32_t>(Methan::supportedIsaLevel()); ++level)
+    {
+        Methan::setIsaLevel(static_cast<Methan::IsaLevel>(level));
+        INFO("Level " << Methan::to_string(Methan::isaLevel()));
+
+        for(const Case& test : cases)
+        {
+            INFO(test.m << "x" << test.n << "x" << test.k << " transposed " << test.transposeA << test.transposeB);
+            REQUIRE(__check_gemm<float>(test, pool) == 0);
+            REQUIRE(__check_gemm<double>(test, pool) == 0);
+        }
+    }
+
+    Methan::setIsaLevel(initial);
+}
+
+TEST_CASE("Matrix multiplication of tensors", "[gemm]") {
+    Methan::Tensor a(Methan::DataType::Float64, {2, 3});
+    Methan::Tensor b(Methan::DataType::Float64, {3, 2});
+    for(int64_t i = 0; i < 6; ++i)
+    {
+        a.data<double>()[i] = static_cast<double>(i + 1);
+        b.data<double>()[i] = static_cast<double>(6 - i);
+    }
+
+    // [1 2 3; 4 5 6] * [6 5; 4 3; 2 1]
+    Methan::Tensor c = Methan::matmul(a, b);
+    REQUIRE(c.shape() == Methan::Shape({2, 2}));
+    REQUIRE(c.at<double>({0, 0}) == 20.0);
+    REQUIRE(c.at<double>({0, 1}) == 14.0);
+    REQUIRE(c.at<double>({1, 0}) == 56.0);
+    REQUIRE(c.at<double>({1, 1}) == 41.0);
+
+    // Transposed views are multiplied without copy
+    Methan::Tensor gram = Methan::matmul(a.transpose(0, 1), a);
+    REQUIRE(gram.shape() == Methan::Shape({3, 3}));
+    REQUIRE(gram.at<double>({2, 2}) == 45.0);
+    REQUIRE(gram.at<double>({0, 1}) == 22.0);
+
+    REQUIRE_THROWS_AS(Methan::matmul(a, a), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::matmul(a, Methan::Tensor(Methan::DataType::Float32, {3, 2})), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::matmul(Methan::Tensor(Methan::DataType::Int32, {2, 2}), Methan::Tensor(Methan::DataType::Int32, {2, 2})), Methan::Exception);
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/graph/graph.hpp>
+
+TEST_CASE("Graph store nodes and their inputs in order", "[graph]") {
+    Methan::Graph graph;
+    Methan::NodeHandle a = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Constant, {}, 3.0f);
+    Methan::NodeHandle c = graph.addNode(Methan::OpCode::Custom, {b, a});
+    Methan::NodeHandle d = graph.addNode(Methan::OpCode::Custom, {c});
+    graph.addEdge(a, d);
+
+    REQUIRE(graph.nodeCount() == 4);
+    REQUIRE(graph.edgeCount() == 4);
+    REQUIRE(graph.op(b) == Methan::OpCode::Constant);
+    REQUIRE(graph.payload(b).get<float>() == 3.0f);
+    REQUIRE(graph.payload(a).isEmpty());
+
+    Methan::Span<const Methan::NodeIndex> inputs = graph.inputs(c);
+    REQUIRE(inputs.size() == 2);
+    REQUIRE(inputs[0] == Methan::Graph::index(b));
+    REQUIRE(inputs[1] == Methan::Graph::index(a));
+
+    REQUIRE(graph.inDegree(d) == 2);
+    REQUIRE(graph.outDegree(a) == 2);
+    REQUIRE(graph.outDegree(d) == 0);
+    REQUIRE(graph.outputs(a)[0] == Methan::Graph::index(c));
+    REQUIRE(graph.outputs(a)[1] == Methan::Graph::index(d));
+}
+
+TEST_CASE("Graph attributes can be attached and replaced", "[graph]") {
+    Methan::Graph graph;
+    Methan::NodeHandle a = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Input);
+
+    REQUIRE(!graph.hasAttribute(a, Methan::AttributeKey::Name));
+    graph.setAttribute(a, Methan::AttributeKey::Name, std::string("first"));
+    graph.setAttribute(b, Methan::AttributeKey::Name, std::string("second"));
+    graph.setAttribute(a, Methan::AttributeKey::User, 12);
+    graph.setAttribute(a, Methan::AttributeKey::Name, std::string("renamed"));
+
+    REQUIRE(graph.attribute(a, Methan::AttributeKey::Name)->get<std::string>() == "renamed");
+    REQUIRE(graph.attribute(b, Methan::AttributeKey::Name)->get<std::string>() == "second");
+    REQUIRE(graph.attribute(a, Methan::AttributeKey::User)->get<int>() == 12);
+    REQUIRE(graph.attribute(b, Methan::AttributeKey::User) == nullptr);
+
+    // Looked up without raising when missing or of another type
+    REQUIRE(graph.attributeAs<int>(a, Methan::AttributeKey::User).value() == 12);
+    REQUIRE(graph.attributeAs<int>(b, Methan::AttributeKey::User).valueOr(-1) == -1);
+    REQUIRE(graph.attributeAs<int>(b, Methan::AttributeKey::User).error().type == Methan::ExceptionType::IllegalArgument);
+    REQUIRE(graph.attributeAs<float>(a, Methan::AttributeKey::User).error().type == Methan::ExceptionType::BadCastException);
+    REQUIRE_THROWS_AS(graph.attributeAs<float>(a, Methan::AttributeKey::User).value(), Methan::Exception);
+}
+
+TEST_CASE("Graph can be sorted topologically", "[graph]") {
+    Methan::Graph graph;
+    Methan::NodeHandle a = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle c = graph.addNode(Methan::OpCode::Custom, {a, b});
+    Methan::NodeHandle d = graph.addNode(Methan::OpCode::Custom, {c, a});
+
+    std::vector<Methan::NodeIndex> order = graph.topologicalOrder();
+    std::vector<size_t> position(order.size());
+    for(size_t i = 0; i < order.size(); ++i) position[order[i]] = i;
+
+    REQUIRE(order.size() == 4);
+    REQUIRE(position[Methan::Graph::index(a)] < position[Methan::Graph::index(c)]);
+    REQUIRE(position[Methan::Graph::index(b)] < position[Methan::Graph::index(c)]);
+    REQUIRE(position[Methan::Graph::index(c)] < position[Methan::Graph::index(d)]);
+
+    graph.addEdge(d, a);
+    REQUIRE_THROWS_AS(graph.topologicalOrder(), Methan::Exception);
+}
+
+TEST_CASE("Graph handle a million nodes", "[graph]") {
+    constexpr size_t count = 1000000;
+
+    Methan::Graph graph;
+    graph.reserve(count, 2 * count);
+    Methan::NodeHandle root = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle previous = root;
+    for(size_t i = 1; i < count; ++i)
+    {
+        previous = graph.addNode(Methan::OpCode::Custom, {previous, root});
+    }
+
+    REQUIRE(graph.nodeCount() == count);
+    REQUIRE(graph.outDegree(root) == count); // the first node consumes the root twice
+    REQUIRE(graph.topologicalOrder().back() == Methan::Graph::index(previous));
+}
@@ -0,0 +1,196 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/io/graph_file.hpp>
+
+#include "testing.hpp"
+
+namespace {
+
+    /**
+     * @brief Image of the file written for the graph, in an aligned buffer
+     */
+    std::shared_ptr<Methan::Buffer> __image(const Methan::Graph& graph)
+    {
+        std::ostringstream stream;
+        Methan::saveGraph(graph, stream);
+        const std::string bytes = stream.str();
+        std::shared_ptr<Methan::Buffer> image = std::make_shared<Methan::Buffer>(bytes.size());
+        std::memcpy(image->data(), bytes.data(), bytes.size());
+        return image;
+    }
+
+}
+
+TEST_CASE("Graph files are mapped and used in place", "[graph_file]") {
+    Methan::Graph graph;
+    const Methan::Tensor weights = Methan::Testing::random({ 6, 5 }, 7);
+    const Methan::Tensor bias = Methan::Testing::random({ 4, 5 }, 11);
+
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle w = graph.addNode(Methan::OpCode::Constant, {}, weights);
+    Methan::NodeHandle b = graph.addNode(Methan::OpCode::Constant, {}, bias.transpose(0, 1).transpose(0, 1));
+    Methan::NodeHandle product = graph.addNode(Methan::OpCode::MatMul, {x, w}, Methan::MatMulPayload{ 0.5, false, false });
+    Methan::NodeHandle sum = graph.addNode(Methan::OpCode::Elementwise, {product, b}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} });
+    Methan::NodeHandle clamped = graph.addNode(Methan::OpCode::Elementwise, {sum}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Clamp, { -0.25, 0.25 } });
+    Methan::FusedElementwisePayload program;
+    program.program.push_back(Methan::ElementwiseInstruction{ Methan::ElementwiseOp::Tanh, {}, { 0, 0, 0 } });
+    program.program.push_back(Methan::ElementwiseInstruction{ Methan::ElementwiseOp::Mul, {}, { 1, 0, 0 } });
+    Methan::NodeHandle fused = graph.addNode(Methan::OpCode::FusedElementwise, {clamped}, program);
+
+    graph.setAttribute(x, Methan::AttributeKey::Name, std::string("input"));
+    graph.setAttribute(x, Methan::AttributeKey::Cost, 2.5);
+    graph.setAttribute(product, Methan::AttributeKey::Cost, 40);
+    graph.setAttribute(fused, Methan::AttributeKey::User, true);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "methan_test_graph_file.bin").string();
+    Methan::saveGraph(graph, path);
+    REQUIRE(std::filesystem::file_size(path) % Methan::GraphFileAlignment == 0);
+
+    Methan::Graph loaded;
+    Methan::Tensor mapped;
+    {
+        const Methan::GraphFile file = Methan::GraphFile::open(path);
+        REQUIRE(file.nodeCount() == graph.nodeCount());
+        REQUIRE(file.edgeCount() == graph.edgeCount());
+        REQUIRE(file.tensorCount() == 2);
+
+        // The tables and tensors are read from the mapping
+        const unsigned char* begin = static_cast<const unsigned char*>(file.image()->data());
+        const unsigned char* end = begin + file.image()->size();
+        for(Methan::NodeIndex node = 0; node < graph.nodeCount(); ++node)
+        {
+            const Methan::NodeHandle handle = Methan::Graph::handle(node);
+            REQUIRE(file.op(node) == graph.op(handle));
+            REQUIRE(std::vector<Methan::NodeIndex>(file.inputs(node).begin(), file.inputs(node).end()) == std::vector<Methan::NodeIndex>(graph.inputs(handle).begin(), graph.inputs(handle).end()));
+            REQUIRE(std::vector<Methan::NodeIndex>(file.outputs(node).begin(), file.outputs(node).end()) == std::vector<Methan::NodeIndex>(graph.outputs(handle).begin(), graph.outputs(handle).end()));
+        }
+        REQUIRE(reinterpret_cast<const unsigned char*>(file.inputs(Methan::Graph::index(sum)).data()) >= begin);
+        REQUIRE(reinterpret_cast<const unsigned char*>(file.inputs(Methan::Graph::index(sum)).data()) < end);
+
+        mapped = file.payload(Methan::Graph::index(w)).get<Methan::Tensor>();
+        REQUIRE(Methan::Testing::identical(mapped, weights));
+        REQUIRE(static_cast<const unsigned char*>(mapped.rawData()) >= begin);
+        REQUIRE(static_cast<const unsigned char*>(mapped.rawData()) < end);
+        REQUIRE(mapped.isAligned(Methan::GraphFileAlignment));
+        REQUIRE(Methan::Testing::identical(file.tensor(1), bias));
+
+        REQUIRE(file.attribute(Methan::Graph::index(x), Methan::AttributeKey::Name).get<std::string>() == "input");
+        REQUIRE(file.attribute(Methan::Graph::index(x), Methan::AttributeKey::Cost).get<double>() == 2.5);
+        REQUIRE(file.attribute(Methan::Graph::index(w), Methan::AttributeKey::Cost).isEmpty());
+
+        loaded = file.toGraph();
+    }
+
+    // The mapping outlives the file while its tensors are used
+    REQUIRE(Methan::Testing::identical(mapped, weights));
+    std::filesystem::remove(path);
+
+    REQUIRE(loaded.nodeCount() == graph.nodeCount());
+    REQUIRE(loaded.edgeCount() == graph.edgeCount());
+    REQUIRE(loaded.payload(product).get<Methan::MatMulPayload>() == Methan::MatMulPayload{ 0.5, false, false });
+    REQUIRE(loaded.payload(clamped).get<Methan::ElementwisePayload>() == Methan::ElementwisePayload{ Methan::ElementwiseOp::Clamp, { -0.25, 0.25 } });
+    REQUIRE(loaded.payload(fused).get<Methan::FusedElementwisePayload>() == program);
+    REQUIRE(loaded.payload(x).isEmpty());
+    REQUIRE(loaded.attributeAs<std::string>(x, Methan::AttributeKey::Name).value() == "input");
+    REQUIRE(loaded.attributeAs<int32_t>(product, Methan::AttributeKey::Cost).value() == 40);
+    REQUIRE(loaded.attributeAs<bool>(fused, Methan::AttributeKey::User).value());
+    int order = 0;
+    loaded.forEachAttribute(x, [&](Methan::AttributeKey key, const Methan::Varient&) { REQUIRE(key == (order++ == 0 ? Methan::AttributeKey::Cost : Methan::AttributeKey::Name)); });
+
+    // Both graphs compute the same tensors
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+    const Methan::Tensor input = Methan::Testing::random({ 4, 6 }, 3);
+    const std::vector<Methan::Tensor> expected = evaluator.run(graph, { { x, input } }, { fused });
+    const std::vector<Methan::Tensor> actual = evaluator.run(loaded, { { x, input } }, { fused });
+    REQUIRE(Methan::Testing::identical(expected[0], actual[0]));
+}
+
+TEST_CASE("Graph files reject unsupported values and invalid images", "[graph_file]") {
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    graph.addNode(Methan::OpCode::Elementwise, {x}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Relu, {} });
+
+    // An image in memory is read the same way as a mapping
+    const std::shared_ptr<Methan::Buffer> image = __image(graph);
+    const Methan::GraphFile file(image);
+    REQUIRE(file.nodeCount() == 2);
+    REQUIRE(file.inputs(1).size() == 1);
+    REQUIRE(file.toGraph().payload(Methan::Graph::handle(1)).get<Methan::ElementwisePayload>().op == Methan::ElementwiseOp::Relu);
+
+    // Corrupted headers
+    Methan::details::GraphFileHeader& header = *static_cast<Methan::details::GraphFileHeader*>(image->data());
+    header.version = Methan::GraphFileVersion + 1;
+    REQUIRE_THROWS_AS(Methan::GraphFile(image), Methan::Exception);
+    header.version = Methan::GraphFileVersion;
+    header.nodeCount = 3;
+    REQUIRE_THROWS_AS(Methan::GraphFile(image), Methan::Exception);
+    header.nodeCount = 2;
+    header.magic[0] = 'X';
+    REQUIRE_THROWS_AS(Methan::GraphFile(image), Methan::Exception);
+
+    REQUIRE_THROWS_AS(Methan::GraphFile::open((std::filesystem::temp_directory_path() / "methan_missing_graph_file.bin").string()), Methan::Exception);
+
+    // Values without a representation in the file
+    graph.addNode(Methan::OpCode::Custom, {x}, Methan::CustomOperation([](Methan::Span<const Methan::Tensor> inputs) { return inputs[0]; }));
+    std::ostringstream stream;
+    REQUIRE_THROWS_AS(Methan::saveGraph(graph, stream), Methan::Exception);
+    graph.payload(Methan::Graph::handle(2)) = nullptr;
+    graph.setAttribute(x, Methan::AttributeKey::User, static_cast<const char*>("text"));
+    REQUIRE_THROWS_AS(Methan::saveGraph(graph, stream), Methan::Exception);
+}
+
+TEST_CASE("Graph files read values back with the type they were written with", "[graph_file]") {
+    Methan::Graph graph;
+    const auto add = [&graph](auto value) {
+        Methan::NodeHandle node = graph.addNode(Methan::OpCode::Input);
+        graph.setAttribute(node, Methan::AttributeKey::User, value);
+        return node;
+    };
+    Methan::NodeHandle boolean = add(true);
+    Methan::NodeHandle signedInt = add(std::numeric_limits<int>::min());
+    Methan::NodeHandle unsignedInt = add(std::numeric_limits<unsigned int>::max());
+    Methan::NodeHandle signedLong = add(std::numeric_limits<long>::min());
+    Methan::NodeHandle unsignedLong = add(std::numeric_limits<unsigned long>::max());
+    Methan::NodeHandle signedLongLong = add(40LL);
+    Methan::NodeHandle unsignedLongLong = add(std::numeric_limits<unsigned long long>::max());
+    Methan::NodeHandle single = add(-0.125f);
+    Methan::NodeHandle real = add(1e300);
+    Methan::NodeHandle text = add(std::string("text"));
+
+    const Methan::Graph loaded = Methan::GraphFile(__image(graph)).toGraph();
+    REQUIRE(loaded.attributeAs<bool>(boolean, Methan::AttributeKey::User).value());
+    REQUIRE(loaded.attributeAs<int>(signedInt, Methan::AttributeKey::User).value() == std::numeric_limits<int>::min());
+    REQUIRE(loaded.attributeAs<unsigned int>(unsignedInt, Methan::AttributeKey::User).value() == std::numeric_limits<unsigned int>::max());
+    REQUIRE(loaded.attributeAs<long>(signedLong, Methan::AttributeKey::User).value() == std::numeric_limits<long>::min());
+    REQUIRE(loaded.attributeAs<unsigned long>(unsignedLong, Methan::AttributeKey::User).value() == std::numeric_limits<unsigned long>::max());
+    REQUIRE(loaded.attributeAs<long long>(signedLongLong, Methan::AttributeKey::User).value() == 40LL);
+    REQUIRE(loaded.attributeAs<unsigned long long>(unsignedLongLong, Methan::AttributeKey::User).value() == std::numeric_limits<unsigned long long>::max());
+    REQUIRE(loaded.attributeAs<float>(single, Methan::AttributeKey::User).value() == -0.125f);
+    REQUIRE(loaded.attributeAs<double>(real, Methan::AttributeKey::User).value() == 1e300);
+    REQUIRE(loaded.attributeAs<std::string>(text, Methan::AttributeKey::User).value() == "text");
+
+    // Types of the same width stay distinct
+    REQUIRE_FALSE(loaded.attributeAs<long>(signedLongLong, Methan::AttributeKey::User).ok());
+    REQUIRE_FALSE(loaded.attributeAs<long long>(signedLong, Methan::AttributeKey::User).ok());
+    REQUIRE_FALSE(loaded.attributeAs<unsigned int>(signedInt, Methan::AttributeKey::User).ok());
+
+    // Other integer types are not written
+    add(static_cast<short>(1));
+    std::ostringstream stream;
+    REQUIRE_THROWS_AS(Methan::saveGraph(graph, stream), Methan::Exception);
+}
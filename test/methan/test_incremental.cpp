@@ -0,0 +1,147 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/incremental.hpp>
+
+#include "testing.hpp"
+
+TEST_CASE("Incremental evaluation only computes the nodes downstream of the changed inputs", "[incremental]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    // Two independent branches joined at the end, the left one ends with a counted custom node (the evaluator
+    // calls it too)
+    uint32_t calls = 0;
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle y = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle w = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::random({8, 8}, 1));
+    Methan::NodeHandle left = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Tanh, {graph.addNode(Methan::OpCode::MatMul, {x, w})});
+    left = graph.addNode(Methan::OpCode::Custom, {left}, Methan::CustomOperation([&calls](Methan::Span<const Methan::Tensor> inputs) {
+        ++calls;
+        return inputs[0].clone();
+    }));
+    Methan::NodeHandle right = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Sigmoid, {Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Mul, {y, y})});
+    Methan::NodeHandle sum = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {left, right});
+
+    Methan::IncrementalEvaluator incremental(graph, pool);
+    Methan::Tensor a = Methan::Testing::random({8, 8}, 2);
+    Methan::Tensor b = Methan::Testing::random({8, 8}, 3);
+    incremental.setInput(x, a);
+    incremental.setInput(y, b);
+
+    std::vector<Methan::Tensor> result = incremental.evaluate({ sum });
+    REQUIRE(incremental.lastComputedCount() == 7);
+    REQUIRE(calls == 1);
+    REQUIRE(Methan::Testing::identical(result[0], evaluator.run(graph, { { x, a }, { y, b } }, { sum })[0]));
+
+    // Nothing changed, nothing is computed
+    result = incremental.evaluate({ sum });
+    REQUIRE(incremental.lastComputedCount() == 0);
+
+    // Only the right branch and the join depend on `y`
+    b = Methan::Testing::random({8, 8}, 4);
+    incremental.setInput(y, b);
+    REQUIRE(incremental.isCached(left));
+    REQUIRE_FALSE(incremental.isCached(right));
+    result = incremental.evaluate({ sum, right });
+    REQUIRE(incremental.lastComputedCount() == 3);
+    REQUIRE(calls == 2);
+    REQUIRE(Methan::Testing::identical(result[0], evaluator.run(graph, { { x, a }, { y, b } }, { sum })[0]));
+
+    // An invalidated custom node is computed again, with what depends on it
+    incremental.invalidate(left);
+    incremental.evaluate({ sum });
+    REQUIRE(incremental.lastComputedCount() == 2);
+    REQUIRE(calls == 4);
+
+    // Appended nodes are computed on demand, the cached nodes they consume are reused
+    Methan::NodeHandle scaled = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Mul, {sum, sum});
+    result = incremental.evaluate({ scaled });
+    REQUIRE(incremental.lastComputedCount() == 1);
+    REQUIRE(Methan::Testing::identical(result[0], evaluator.run(graph, { { x, a }, { y, b } }, { scaled })[0]));
+
+    // A new input of an existing node invalidates it
+    Methan::Graph growing;
+    Methan::NodeHandle p = growing.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle q = growing.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle total = growing.addNode(Methan::OpCode::Custom, {p}, Methan::CustomOperation([](Methan::Span<const Methan::Tensor> inputs) {
+        Methan::Tensor result = Methan::Tensor::zeros(Methan::DataType::Float32, {1});
+        for(const Methan::Tensor& input : inputs) result.data<float>()[0] += input.data<float>()[0];
+        return result;
+    }));
+    Methan::IncrementalEvaluator other(growing, pool);
+    Methan::Tensor one = Methan::Tensor::zeros(Methan::DataType::Float32, {1});
+    one.data<float>()[0] = 1.0f;
+    other.setInput(p, one);
+    other.setInput(q, one);
+    REQUIRE(other.evaluate({ total })[0].data<float>()[0] == 1.0f);
+    growing.addEdge(q, total);
+    REQUIRE(other.evaluate({ total })[0].data<float>()[0] == 2.0f);
+
+    // Errors
+    Methan::IncrementalEvaluator unbound(graph, pool);
+    REQUIRE_THROWS_AS(unbound.evaluate({ sum }), Methan::Exception);
+    REQUIRE_THROWS_AS(unbound.setInput(sum, a), Methan::Exception);
+    REQUIRE_THROWS_AS(unbound.evict(x), Methan::Exception);
+    REQUIRE_THROWS_AS(unbound.evaluate({ Methan::Graph::handle(1000) }), Methan::Exception);
+}
+
+TEST_CASE("Incremental evaluation keeps the cache within its memory budget", "[incremental]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    // A chain of 6 nodes of 1 KiB each
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    std::vector<Methan::NodeHandle> chain;
+    Methan::NodeHandle node = x;
+    for(uint32_t i = 0; i < 6; ++i)
+    {
+        node = Methan::Testing::elementwise(graph, i % 2 == 0 ? Methan::ElementwiseOp::Tanh : Methan::ElementwiseOp::Sigmoid, {node});
+        chain.push_back(node);
+    }
+
+    Methan::IncrementalEvaluator incremental(graph, pool);
+    Methan::Tensor input = Methan::Testing::random({256}, 5);
+    incremental.setInput(x, input);
+    incremental.evaluate({ node });
+    REQUIRE(incremental.cachedBytes() == 6 * 1024);
+
+    // The least recently used nodes are evicted first, the pinned ones never
+    incremental.pin(chain[1]);
+    incremental.evaluate({ chain[2] });
+    incremental.setMemoryBudget(3 * 1024);
+    REQUIRE(incremental.cachedBytes() <= 3 * 1024);
+    REQUIRE(incremental.isCached(chain[1]));
+    REQUIRE(incremental.isCached(chain[2]));
+    REQUIRE_FALSE(incremental.isCached(chain[0]));
+
+    // The evicted nodes are computed again from the nearest cached node
+    const Methan::Tensor expected = evaluator.run(graph, { { x, input } }, { node })[0];
+    incremental.setMemoryBudget(0);
+    REQUIRE(incremental.cachedBytes() == 1024);
+    REQUIRE(Methan::Testing::identical(incremental.evaluate({ node })[0], expected));
+    REQUIRE(incremental.lastComputedCount() == 4);
+    REQUIRE(incremental.cachedBytes() == 1024);
+
+    incremental.unpin(chain[1]);
+    REQUIRE(incremental.cachedBytes() == 0);
+    incremental.setMemoryBudget(Methan::IncrementalEvaluator::Unlimited);
+    incremental.evaluate({ chain[3] });
+    incremental.evict(chain[1]);
+    REQUIRE(incremental.cachedBytes() == 3 * 1024);
+    incremental.clearCache();
+    REQUIRE(incremental.cachedBytes() == 0);
+    REQUIRE(Methan::Testing::identical(incremental.evaluate({ node })[0], expected));
+    REQUIRE(incremental.lastComputedCount() == 6);
+}
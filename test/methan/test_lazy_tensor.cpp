@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/lazy/lazy_tensor.hpp>
+
+#include "testing.hpp"
+
+namespace {
+
+    bool __close(float a, float b)
+    {
+        return std::abs(a - b) <= 1e-5f * (1.0f + std::abs(b));
+    }
+
+}
+
+TEST_CASE("Lazy tensors record expressions and compute them on evaluation", "[lazy]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    std::shared_ptr<Methan::LazyGraph> graph = Methan::LazyGraph::create(pool);
+
+    const Methan::Tensor a = Methan::Testing::random({4, 8}, 1);
+    const Methan::Tensor b = Methan::Testing::random({8}, 2);
+    const Methan::Tensor w = Methan::Testing::random({8, 8}, 3);
+    Methan::LazyTensor x = graph->input(a);
+    Methan::LazyTensor y = graph->input(b);
+
+    // Nothing is computed until the result is read
+    Methan::LazyTensor layer = tanh(matmul(x, graph->constant(w))) * 0.5 + x;
+    Methan::LazyTensor scaled = -clamp(layer / y, -2.0, 2.0) + 2.0 * sigmoid(y);
+    Methan::LazyTensor accumulated = fma(exp(relu(x)), x, x);
+    accumulated -= 1.0 - x;
+    REQUIRE_FALSE(graph->isEvaluated(layer.node()));
+    REQUIRE(graph->graph().nodeCount() > 10);
+
+    const std::vector<Methan::Tensor> results = graph->eval({ scaled, accumulated });
+    REQUIRE(graph->isEvaluated(scaled.node()));
+    REQUIRE(results[0].shape() == Methan::Shape({4, 8}));
+
+    for(int64_t i = 0; i < 4; ++i)
+    {
+        for(int64_t j = 0; j < 8; ++j)
+        {
+            float product = 0.0f;
+            for(int64_t k = 0; k < 8; ++k) product += a.at<float>({i, k}) * w.at<float>({k, j});
+            const float expectedLayer = std::tanh(product) * 0.5f + a.at<float>({i, j});
+            const float quotient = std::min(2.0f, std::max(-2.0f, expectedLayer / b.data<float>()[j]));
+            const float expectedScaled = -quotient + 2.0f / (1.0f + std::exp(-b.data<float>()[j]));
+            REQUIRE(__close(results[0].at<float>({i, j}), expectedScaled));
+
+            const float v = a.at<float>({i, j});
+            const float expectedAccumulated = std::exp(std::max(v, 0.0f)) * v + v - (1.0f - v);
+            REQUIRE(__close(results[1].at<float>({i, j}), expectedAccumulated));
+        }
+    }
+
+    // The evaluated tensors are reused, reading a tensor evaluates it
+    Methan::Tensor again = scaled;
+    REQUIRE(again.rawData() == results[0].rawData());
+    Methan::Tensor next = (scaled * 2.0).eval();
+    REQUIRE(__close(next.at<float>({1, 2}), 2.0f * results[0].at<float>({1, 2})));
+    REQUIRE(Methan::eval({ layer })[0].shape() == Methan::Shape({4, 8}));
+
+    // Errors
+    std::shared_ptr<Methan::LazyGraph> other = Methan::LazyGraph::create(pool);
+    Methan::LazyTensor z = other->input(a);
+    REQUIRE_THROWS_AS(x + z, Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::LazyTensor() + x, Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::LazyTensor().eval(), Methan::Exception);
+    REQUIRE_THROWS_AS(graph->scalar(1.0, Methan::DataType::Int32), Methan::Exception);
+    REQUIRE_THROWS_AS((matmul(x, y)).eval(), Methan::Exception);
+}
+
+TEST_CASE("Lazy graphs only keep what the live tensors depend on", "[lazy]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    std::shared_ptr<Methan::LazyGraph> graph = Methan::LazyGraph::create(pool);
+
+    const Methan::Tensor a = Methan::Testing::random({16}, 1);
+    const Methan::Tensor b = Methan::Testing::random({16}, 2);
+    Methan::LazyTensor x = graph->input(a);
+    const Methan::LazyTensor y = graph->input(b);
+
+    // The graph and the evaluated tensors stay bounded over the iterations
+    std::vector<float> expected(a.data<float>(), a.data<float>() + 16);
+    const Methan::Tensor first = (x * 0.5 + y).eval();
+    size_t largest = 0;
+    for(size_t i = 0; i < 1000; ++i)
+    {
+        x = x * 0.5 + y;
+        x.eval();
+        largest = std::max(largest, graph->graph().nodeCount());
+        for(size_t j = 0; j < expected.size(); ++j) expected[j] = expected[j] * 0.5f + b.data<float>()[j];
+    }
+    REQUIRE(largest <= 128);
+    REQUIRE(first.buffer().use_count() == 1);
+    const Methan::Tensor last = x;
+    for(size_t j = 0; j < expected.size(); ++j) REQUIRE(__close(last.data<float>()[j], expected[j]));
+
+    // Pending expressions keep what they are computed from, the evaluated nodes become leaves
+    Methan::LazyTensor pending = tanh(x) + exp(y);
+    Methan::LazyTensor dropped = relu(y) * 3.0;
+    dropped = Methan::LazyTensor();
+    graph->compact();
+    REQUIRE(graph->graph().nodeCount() == 5);
+    REQUIRE(graph->isEvaluated(x.node()));
+    REQUIRE(graph->graph().op(x.node()) == Methan::OpCode::Input);
+    REQUIRE_FALSE(graph->isEvaluated(pending.node()));
+    const Methan::Tensor result = pending;
+    for(size_t j = 0; j < expected.size(); ++j) REQUIRE(__close(result.data<float>()[j], std::tanh(expected[j]) + std::exp(b.data<float>()[j])));
+
+    // Copies and moves share the node
+    Methan::LazyTensor copy = pending;
+    Methan::LazyTensor moved = std::move(pending);
+    pending = Methan::LazyTensor();
+    graph->compact();
+    REQUIRE(graph->isEvaluated(copy.node()));
+    REQUIRE(copy.node() == moved.node());
+    REQUIRE(copy.eval().rawData() == result.rawData());
+}
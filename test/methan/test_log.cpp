@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/log.hpp>
+
+namespace {
+
+    struct Captured
+    {
+        Methan::LogLevel level;
+        std::string message;
+    };
+
+    std::mutex g_capturedMutex;
+    std::vector<Captured> g_captured;
+
+    std::vector<Captured> __capture()
+    {
+        Methan::flushLog();
+        std::lock_guard<std::mutex> lock(g_capturedMutex);
+        std::vector<Captured> captured;
+        captured.swap(g_captured);
+        return captured;
+    }
+
+    int __counted(int& count)
+    {
+        return ++count;
+    }
+
+}
+
+TEST_CASE("Log records are formatted by the background thread", "[log]") {
+    const Methan::LogLevel level = Methan::logLevel();
+    Methan::setLogHandler([](Methan::LogLevel level, std::chrono::system_clock::time_point, const std::string& message) {
+        std::lock_guard<std::mutex> lock(g_capturedMutex);
+        g_captured.push_back(Captured{ level, message });
+    });
+    Methan::setLogLevel(Methan::LogLevel::Trace);
+    const uint64_t dropped = Methan::droppedLogCount();
+
+    // The arguments are copied, strings included
+    std::string text = "text";
+    Methan::log(Methan::LogLevel::Info, "{} {} {:.2f} {} {} {}", -3, 7u, 1.2345, true, 'x', text);
+    text = "changed";
+    const char* missing = nullptr;
+    Methan::log(Methan::LogLevel::Error, "{} and {}", missing, "literal");
+    Methan::log(Methan::LogLevel::Warning, "{}", std::string(300, 'a'));
+    Methan::log(Methan::LogLevel::Debug, "{:d}", "not a number");
+
+    std::vector<Captured> captured = __capture();
+    REQUIRE(captured.size() == 4);
+    REQUIRE(captured[0].level == Methan::LogLevel::Info);
+    REQUIRE(captured[0].message == "-3 7 1.23 true x text");
+    REQUIRE(captured[1].level == Methan::LogLevel::Error);
+    REQUIRE(captured[1].message == "(null) and literal");
+    REQUIRE(captured[2].message == std::string(Methan::LogTextCapacity, 'a'));
+    REQUIRE(captured[3].message.find("{:d}") == 0);
+
+    // The records of the threads all arrive, in order for each thread
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([t]() {
+            for(int i = 0; i < 100; ++i) METHAN_LOG(Methan::LogLevel::Info, "{} {}", t, i);
+        });
+    }
+    for(std::thread& thread : threads) thread.join();
+
+    captured = __capture();
+    REQUIRE(captured.size() == 400);
+    std::vector<int> next(4, 0);
+    size_t disordered = 0;
+    for(const Captured& record : captured)
+    {
+        const size_t space = record.message.find(' ');
+        const int thread = std::stoi(record.message.substr(0, space));
+        if(std::stoi(record.message.substr(space + 1)) != next[thread]++) ++disordered;
+    }
+    REQUIRE(disordered == 0);
+    REQUIRE(next == std::vector<int>{ 100, 100, 100, 100 });
+    REQUIRE(Methan::droppedLogCount() == dropped);
+
+    // Filtered at run time, or compiled out with their arguments
+    Methan::setLogLevel(Methan::LogLevel::Warning);
+    REQUIRE_FALSE(Methan::isLogEnabled(Methan::LogLevel::Info));
+    REQUIRE(Methan::isLogEnabled(Methan::LogLevel::Critical));
+    int count = 0;
+    METHAN_LOG(Methan::LogLevel::Info, "{}", __counted(count));
+    METHAN_LOG(Methan::LogLevel::Error, "{}", __counted(count));
+    REQUIRE(count == 1);
+
+    Methan::setLogLevel(Methan::LogLevel::Trace);
+    METHAN_LOG_TRACE("{}", __counted(count));
+    METHAN_LOG_CRITICAL("{}", __counted(count));
+    REQUIRE(count == 1 + (METHAN_LOG_LEVEL <= 0 ? 1 : 0) + (METHAN_LOG_LEVEL <= 5 ? 1 : 0));
+    REQUIRE(__capture().size() == static_cast<size_t>(count));
+
+    Methan::setLogLevel(Methan::LogLevel::Off);
+    REQUIRE_FALSE(Methan::isLogEnabled(Methan::LogLevel::Critical));
+
+    Methan::setLogHandler(nullptr);
+    Methan::setLogLevel(level);
+}
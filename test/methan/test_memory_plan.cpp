@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/evaluator.hpp>
+
+#include "testing.hpp"
+
+namespace {
+
+    /**
+     * @brief Whether two planned tensors that are live at the same time overlap in the slab, unless one is
+     * computed in place over the other
+     */
+    bool __has_conflict(const Methan::Graph& graph, const Methan::MemoryPlan& plan)
+    {
+        const size_t count = graph.nodeCount();
+        std::vector<size_t> positions(count), lastUses(count);
+        for(size_t position = 0; position < count; ++position) positions[plan.order[position]] = position;
+        for(Methan::NodeIndex node = 0; node < count; ++node)
+        {
+            lastUses[node] = positions[node];
+            for(Methan::NodeIndex input : graph.inputs(Methan::Graph::handle(node))) lastUses[input] = std::max(lastUses[input], positions[node]);
+        }
+
+        for(Methan::NodeIndex a = 0; a < count; ++a)
+        {
+            for(Methan::NodeIndex b = a + 1; b < count; ++b)
+            {
+                if(plan.offsets[a] == Methan::MemoryPlan::Unplanned || plan.offsets[b] == Methan::MemoryPlan::Unplanned) continue;
+                if(plan.inPlace[a] == b || plan.inPlace[b] == a) continue;
+
+                const bool live = positions[a] <= lastUses[b] && positions[b] <= lastUses[a];
+                const bool overlap = plan.offsets[a] < plan.offsets[b] + plan.specs[b].byteSize() && plan.offsets[b] < plan.offsets[a] + plan.specs[a].byteSize();
+                if(live && overlap) return true;
+            }
+        }
+        return false;
+    }
+
+}
+
+TEST_CASE("Chains of elementwise nodes are executed in place", "[memory_plan]") {
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle node = x;
+    std::vector<Methan::NodeHandle> chain;
+    for(size_t i = 0; i < 8; ++i)
+    {
+        node = Methan::Testing::elementwise(graph, i % 2 == 0 ? Methan::ElementwiseOp::Tanh : Methan::ElementwiseOp::Relu, {node});
+        chain.push_back(node);
+    }
+    Methan::NodeHandle out = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Exp, {node});
+
+    const Methan::Tensor input = Methan::Testing::random({1000}, 1);
+    Methan::MemoryPlan plan = Methan::planMemory(graph, Methan::Evaluator::inferSpecs(graph, { { x, input } }), { out });
+
+    // The input is not planned, the first node gets its own storage and the others reuse it
+    REQUIRE(!plan.isPlanned(x));
+    REQUIRE(!plan.isPlanned(out));
+    REQUIRE(plan.plannedSize == 8 * 4000);
+    REQUIRE(plan.slabSize == (4000 + Methan::Buffer::Alignment - 1) / Methan::Buffer::Alignment * Methan::Buffer::Alignment);
+    REQUIRE(plan.inPlace[Methan::Graph::index(chain[0])] == Methan::Graph::InvalidIndex);
+    for(size_t i = 1; i < chain.size(); ++i) REQUIRE(plan.inPlace[Methan::Graph::index(chain[i])] == Methan::Graph::index(chain[i - 1]));
+
+    Methan::Evaluator evaluator;
+    const Methan::Tensor expected = evaluator.run(graph, { { x, input } }, { out })[0];
+    REQUIRE(Methan::Testing::identical(evaluator.run(graph, { { x, input } }, { out }, plan)[0], expected));
+}
+
+TEST_CASE("Intermediate tensors share a slab", "[memory_plan]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    // Two layers with a residual connection, the hidden values of the first layer die in the second one
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle w1 = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::random({64, 128}, 2));
+    Methan::NodeHandle w2 = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::random({128, 64}, 3));
+    Methan::NodeHandle b1 = graph.addNode(Methan::OpCode::Constant, {}, Methan::Testing::random({128}, 4));
+    Methan::NodeHandle h = graph.addNode(Methan::OpCode::MatMul, {x, w1});
+    Methan::NodeHandle shifted = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {h, b1});
+    Methan::NodeHandle activated = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Relu, {shifted});
+    Methan::NodeHandle projected = graph.addNode(Methan::OpCode::MatMul, {activated, w2});
+    Methan::NodeHandle residual = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {projected, x});
+    Methan::NodeHandle gram = graph.addNode(Methan::OpCode::MatMul, {residual, residual}, Methan::MatMulPayload{ 1.0, false, true });
+    Methan::NodeHandle identity = graph.addNode(Methan::OpCode::Custom, {gram}, Methan::CustomOperation([](Methan::Span<const Methan::Tensor> inputs) { return inputs[0]; }));
+    Methan::NodeHandle out = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Sigmoid, {identity});
+
+    const Methan::Tensor input = Methan::Testing::random({32, 64}, 5);
+    const std::vector<Methan::TensorSpec> specs = Methan::Evaluator::inferSpecs(graph, { { x, input } });
+    REQUIRE(specs[Methan::Graph::index(gram)].shape == Methan::Shape({32, 32}));
+    REQUIRE(!specs[Methan::Graph::index(identity)].known);
+
+    const Methan::MemoryPlan plan = Methan::planMemory(graph, specs, { out, projected });
+    REQUIRE(plan.isPlanned(h));
+    REQUIRE(plan.isPlanned(gram));
+    REQUIRE(!plan.isPlanned(projected));
+    REQUIRE(plan.inPlace[Methan::Graph::index(shifted)] == Methan::Graph::index(h));
+    REQUIRE(plan.inPlace[Methan::Graph::index(projected)] == Methan::Graph::InvalidIndex);
+    REQUIRE(plan.slabSize < plan.plannedSize);
+    REQUIRE(!__has_conflict(graph, plan));
+
+    const std::vector<Methan::Tensor> expected = evaluator.run(graph, { { x, input } }, { out, projected });
+    const std::vector<Methan::Tensor> planned = evaluator.run(graph, { { x, input } }, { out, projected }, plan);
+    REQUIRE(Methan::Testing::identical(planned[0], expected[0]));
+    REQUIRE(Methan::Testing::identical(planned[1], expected[1]));
+
+    // The plan is only valid for the shapes it was made for, and keeps the requested values
+    REQUIRE_THROWS_AS(evaluator.run(graph, { { x, Methan::Testing::random({16, 64}, 6) } }, { out }, plan), Methan::Exception);
+    REQUIRE_THROWS_AS(evaluator.run(graph, { { x, input } }, { shifted }, plan), Methan::Exception);
+}
+
+TEST_CASE("Memory plans follow the given order", "[memory_plan]") {
+    // Two independent branches: executed one after the other, their tensors can share storage
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle a1 = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Exp, {x});
+    Methan::NodeHandle b1 = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Tanh, {x});
+    Methan::NodeHandle a2 = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Relu, {a1});
+    Methan::NodeHandle b2 = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Relu, {b1});
+    Methan::NodeHandle out = Methan::Testing::elementwise(graph, Methan::ElementwiseOp::Add, {a2, b2});
+
+    const std::vector<Methan::TensorSpec> specs = Methan::Evaluator::inferSpecs(graph, { { x, Methan::Testing::random({256}, 7) } });
+    const Methan::NodeIndex interleaved[] = { 0, 1, 2, 3, 4, 5 };
+    const Methan::NodeIndex invalid[] = { 0, 3, 1, 2, 4, 5 };
+    const Methan::MemoryPlan plan = Methan::planMemory(graph, specs, Methan::Span<const Methan::NodeHandle>(&out, 1), Methan::Span<const Methan::NodeIndex>(interleaved, 6));
+    REQUIRE(plan.slabSize == 2 * 1024);
+    REQUIRE(!__has_conflict(graph, plan));
+
+    REQUIRE_THROWS_AS(Methan::planMemory(graph, specs, Methan::Span<const Methan::NodeHandle>(&out, 1), Methan::Span<const Methan::NodeIndex>(invalid, 6)), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::planMemory(graph, std::vector<Methan::TensorSpec>(2), { out }), Methan::Exception);
+}
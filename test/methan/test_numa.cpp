@@ -0,0 +1,121 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/parallel.hpp>
+#include <methan/core/numa.hpp>
+#include <methan/core/tensor/tensor.hpp>
+
+#if defined(METHAN_OS_LINUX)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+TEST_CASE("The NUMA topology covers the CPUs of the process", "[numa]") {
+    const Methan::NumaTopology& topology = Methan::numaTopology();
+    REQUIRE(topology.nodeCount() >= 1);
+    for(size_t i = 0; i < topology.nodeCount(); ++i)
+    {
+        REQUIRE_FALSE(topology.nodes[i].cpus.empty());
+        for(int cpu : topology.nodes[i].cpus) REQUIRE(topology.nodeOfCpu(cpu) == static_cast<int>(i));
+    }
+    REQUIRE(topology.nodeOfCpu(-1) == -1);
+    REQUIRE(Methan::currentNumaNode() >= 0);
+    REQUIRE(static_cast<size_t>(Methan::currentNumaNode()) < topology.nodeCount());
+
+    // Without sysfs, a single node holds every CPU
+    const Methan::NumaTopology missing = Methan::NumaTopology::detect("/nonexistent/methan/node");
+    REQUIRE(missing.nodeCount() == 1);
+    REQUIRE(missing.nodes[0].cpus == Methan::NumaTopology::uniform().nodes[0].cpus);
+
+#if defined(METHAN_OS_LINUX)
+    // A fake sysfs: the CPUs the process cannot use and the nodes without CPUs are left out
+    const std::vector<int> allowed = Methan::NumaTopology::uniform().nodes[0].cpus;
+    const std::string root = "/tmp/methan_numa_" + std::to_string(getpid());
+    const auto write = [&](const std::string& node, const std::string& cpulist) {
+        mkdir((root + "/" + node).c_str(), 0755);
+        std::ofstream(root + "/" + node + "/cpulist") << cpulist << "\n";
+    };
+    mkdir(root.c_str(), 0755);
+    write("node0", std::to_string(allowed[0]) + "-" + std::to_string(allowed[0]));
+    std::string rest;
+    for(size_t i = 1; i < allowed.size(); ++i) rest += (i > 1 ? "," : "") + std::to_string(allowed[i]);
+    write("node3", rest);
+    write("node1", "100000-100003");
+    write("node2", "");
+    write("nodes", "0");
+
+    const Methan::NumaTopology fake = Methan::NumaTopology::detect(root);
+    REQUIRE(fake.nodeCount() == (allowed.size() > 1 ? 2 : 1));
+    REQUIRE(fake.nodes[0].id == 0);
+    REQUIRE(fake.nodes[0].cpus == std::vector<int>{ allowed[0] });
+    if(allowed.size() > 1)
+    {
+        REQUIRE(fake.nodes[1].id == 3);
+        REQUIRE(fake.nodes[1].cpus == std::vector<int>(allowed.begin() + 1, allowed.end()));
+    }
+
+    for(const char* node : { "node0", "node1", "node2", "node3", "nodes" })
+    {
+        std::remove((root + "/" + node + "/cpulist").c_str());
+        rmdir((root + "/" + node).c_str());
+    }
+    rmdir(root.c_str());
+#endif
+}
+
+TEST_CASE("NUMA-aware pools group their workers by node", "[numa]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 6;
+    options.numaAware = true;
+    options.topology.nodes = { Methan::NumaNode{ 0, { 0, 1, 2 } }, Methan::NumaNode{ 1, { 3, 4, 5 } } };
+    Methan::ThreadPool pool(options);
+
+    REQUIRE(pool.nodeCount() == 2);
+    REQUIRE(pool.workerNode(0) == 0);
+    REQUIRE(pool.workerNode(2) == 0);
+    REQUIRE(pool.workerNode(3) == 1);
+    REQUIRE(pool.workerNode(5) == 1);
+
+    std::atomic<size_t> total{0};
+    Methan::parallel_for(0, 100000, [&](size_t begin, size_t end) { total.fetch_add(end - begin); }, pool);
+    REQUIRE(total.load() == 100000);
+
+    Methan::ThreadPoolOptions plain;
+    plain.workerCount = 2;
+    Methan::ThreadPool flat(plain);
+    REQUIRE(flat.nodeCount() == 1);
+    REQUIRE(flat.workerNode(1) == 0);
+}
+
+TEST_CASE("NumaMemoryResource maps the large allocations", "[numa]") {
+    Methan::NumaMemoryResource local;
+    Methan::NumaMemoryResource first(0, 4096);
+    REQUIRE(local.node() == Methan::NumaMemoryResource::LocalNode);
+
+    for(Methan::NumaMemoryResource* resource : { &local, &first })
+    {
+        for(size_t size : { size_t(64), size_t(4096), size_t(1 << 20) })
+        {
+            void* pointer = resource->allocate(size, 64);
+            REQUIRE(reinterpret_cast<uintptr_t>(pointer) % 64 == 0);
+            std::memset(pointer, 0x5A, size);
+            resource->deallocate(pointer, size, 64);
+        }
+    }
+
+    Methan::Tensor tensor = Methan::Tensor::zeros(Methan::DataType::Float32, { 512, 512 }, &first);
+    tensor.data<float>()[512 * 512 - 1] = 1.0f;
+    REQUIRE(tensor.buffer()->capacity() >= 512 * 512 * 4);
+    REQUIRE(local.is_equal(local));
+    REQUIRE_FALSE(local.is_equal(first));
+    REQUIRE_THROWS_AS(Methan::NumaMemoryResource(static_cast<int>(Methan::numaTopology().nodeCount())), Methan::Exception);
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/parallel.hpp>
+
+TEST_CASE("parallel_for covers the range once, nested calls included", "[parallel]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 3;
+    Methan::ThreadPool pool(options);
+
+    for(size_t count : { size_t(0), size_t(1), size_t(7), size_t(1000), size_t(100000) })
+    {
+        for(size_t grain : { size_t(1), size_t(64) })
+        {
+            std::vector<std::atomic<uint32_t>> hits(count);
+            std::atomic<size_t> chunks{0};
+            std::atomic<size_t> small{0};
+            Methan::parallel_for(0, count, [&](size_t begin, size_t end) {
+                if(end - begin < std::min(grain, count)) small.fetch_add(1);
+                chunks.fetch_add(1);
+                for(size_t i = begin; i < end; ++i) hits[i].fetch_add(1);
+            }, pool, grain);
+
+            for(size_t i = 0; i < count; ++i) REQUIRE(hits[i].load() == 1);
+            REQUIRE(small.load() == 0);
+            REQUIRE(chunks.load() <= std::max<size_t>(1, count / grain));
+        }
+    }
+
+    // Nested loops share the workers
+    std::vector<std::atomic<uint32_t>> hits(64 * 256);
+    Methan::parallel_for(0, 64, [&](size_t begin, size_t end) {
+        for(size_t row = begin; row < end; ++row)
+        {
+            Methan::parallel_for(0, 256, [&](size_t first, size_t last) {
+                for(size_t i = first; i < last; ++i) hits[row * 256 + i].fetch_add(1);
+            }, pool, 16);
+        }
+    }, pool);
+    for(size_t i = 0; i < hits.size(); ++i) REQUIRE(hits[i].load() == 1);
+
+    // Every chunk runs, the exception is rethrown
+    std::atomic<size_t> visited{0};
+    REQUIRE_THROWS_AS(Methan::parallel_for(0, 1000, [&](size_t begin, size_t end) {
+        visited.fetch_add(end - begin);
+        if(begin == 0) throw std::runtime_error("chunk failed");
+    }, pool), std::runtime_error);
+    REQUIRE(visited.load() == 1000);
+}
+
+TEST_CASE("parallel_reduce and parallel_scan combine the chunks in order", "[parallel]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 3;
+    Methan::ThreadPool pool(options);
+
+    std::vector<int64_t> values(100003);
+    for(size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int64_t>(i % 17) - 8;
+    const int64_t expected = std::accumulate(values.begin(), values.end(), int64_t(0));
+
+    const auto sum = [&](size_t begin, size_t end) { return std::accumulate(values.begin() + begin, values.begin() + end, int64_t(0)); };
+    const auto add = [](int64_t a, int64_t b) { return a + b; };
+    REQUIRE(Methan::parallel_reduce(0, values.size(), int64_t(0), sum, add, pool) == expected);
+    REQUIRE(Methan::parallel_reduce(0, values.size(), int64_t(0), sum, add, pool, 50000) == expected);
+    REQUIRE(Methan::parallel_reduce(5, 5, int64_t(42), sum, add, pool) == 42);
+
+    // A combination that is not commutative: the chunks must stay in order
+    const std::vector<size_t> indices = Methan::parallel_reduce(0, 5000, std::vector<size_t>(), [](size_t begin, size_t end) {
+        std::vector<size_t> chunk(end - begin);
+        std::iota(chunk.begin(), chunk.end(), begin);
+        return chunk;
+    }, [](std::vector<size_t> a, std::vector<size_t> b) {
+        a.insert(a.end(), b.begin(), b.end());
+        return a;
+    }, pool);
+    REQUIRE(indices.size() == 5000);
+    for(size_t i = 0; i < indices.size(); ++i) REQUIRE(indices[i] == i);
+
+    // Inclusive prefix sums
+    for(size_t count : { size_t(1), size_t(10), values.size() })
+    {
+        std::vector<int64_t> prefixes(count, 0);
+        const int64_t total = Methan::parallel_scan(0, count, int64_t(0), sum, [&](size_t begin, size_t end, int64_t prefix) {
+            for(size_t i = begin; i < end; ++i) prefixes[i] = prefix += values[i];
+            return prefix;
+        }, add, pool);
+
+        std::vector<int64_t> reference(count);
+        std::partial_sum(values.begin(), values.begin() + count, reference.begin());
+        REQUIRE(prefixes == reference);
+        REQUIRE(total == reference.back());
+    }
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/profiler.hpp>
+
+TEST_CASE("Profiling zones are recorded per thread and exported as a Chrome trace", "[profiler]") {
+    Methan::clearProfile();
+
+    {
+        Methan::ProfileScope outer("outer", 7);
+        Methan::ProfileScope inner("inner");
+    }
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 3; ++t)
+    {
+        threads.emplace_back([]() {
+            for(int i = 0; i < 100; ++i) Methan::ProfileScope scope("worker", i);
+        });
+    }
+    for(std::thread& thread : threads) thread.join();
+
+    std::vector<Methan::ProfileEvent> events = Methan::collectProfile();
+    REQUIRE(events.size() == 302);
+    std::set<uint32_t> workers;
+    size_t outer = 0;
+    for(size_t i = 0; i < events.size(); ++i)
+    {
+        REQUIRE(events[i].begin <= events[i].end);
+        if(i > 0) REQUIRE(events[i - 1].begin <= events[i].begin);
+        if(std::string(events[i].name) == "worker") workers.insert(events[i].thread);
+        if(std::string(events[i].name) == "outer")
+        {
+            ++outer;
+            REQUIRE(events[i].argument == 7);
+        }
+    }
+    REQUIRE(outer == 1);
+    REQUIRE(workers.size() == 3);
+
+    // The inner zone is nested in the outer one, on the same track
+    const auto find = [&](const char* name) {
+        return *std::find_if(events.begin(), events.end(), [&](const Methan::ProfileEvent& event) { return std::string(event.name) == name; });
+    };
+    const Methan::ProfileEvent first = find("outer");
+    const Methan::ProfileEvent second = find("inner");
+    REQUIRE(first.thread == second.thread);
+    REQUIRE(workers.count(first.thread) == 0);
+    REQUIRE(first.begin <= second.begin);
+    REQUIRE(second.end <= first.end);
+    REQUIRE(second.argument == -1);
+
+    std::ostringstream stream;
+    Methan::writeChromeTrace(stream, { first, second, Methan::ProfileEvent{ "quote\"d", -1, first.begin, first.begin + 1500, 4 } });
+    const std::string trace = stream.str();
+    REQUIRE(trace.find("\"traceEvents\":[") != std::string::npos);
+    REQUIRE(trace.find("{\"name\":\"outer\",\"ph\":\"X\",\"pid\":0,\"tid\":" + std::to_string(first.thread) + ",\"ts\":0.000,") != std::string::npos);
+    REQUIRE(trace.find("\"args\":{\"node\":7}") != std::string::npos);
+    REQUIRE(trace.find("{\"name\":\"quote\\\"d\",\"ph\":\"X\",\"pid\":0,\"tid\":4,\"ts\":0.000,\"dur\":1.500}") != std::string::npos);
+
+    // Clearing drops what was recorded, the ring keeps the latest events
+    Methan::clearProfile();
+    REQUIRE(Methan::collectProfile().empty());
+    for(size_t i = 0; i < Methan::ProfileBufferCapacity + 10; ++i) Methan::recordProfileEvent("ring", static_cast<int64_t>(i), i, i);
+    events = Methan::collectProfile();
+    REQUIRE(events.size() == Methan::ProfileBufferCapacity);
+    REQUIRE(events.front().argument == 10);
+    REQUIRE(events.back().argument == static_cast<int64_t>(Methan::ProfileBufferCapacity + 9));
+    Methan::clearProfile();
+}
+
+TEST_CASE("The nodes of a graph run are profiled when the library is built with profiling", "[profiler]") {
+    Methan::ThreadPoolOptions options;
+    options.workerCount = 2;
+    Methan::ThreadPool pool(options);
+    Methan::Evaluator evaluator(pool);
+
+    Methan::Graph graph;
+    Methan::NodeHandle x = graph.addNode(Methan::OpCode::Input);
+    Methan::NodeHandle doubled = graph.addNode(Methan::OpCode::Elementwise, {x, x}, Methan::ElementwisePayload{ Methan::ElementwiseOp::Add, {} });
+    Methan::NodeHandle product = graph.addNode(Methan::OpCode::MatMul, {doubled, x});
+
+    Methan::clearProfile();
+    {
+        METHAN_PROFILE_SCOPE("test");
+        evaluator.run(graph, { { x, Methan::Tensor::zeros(Methan::DataType::Float32, {4, 4}) } }, { product });
+    }
+    const std::vector<Methan::ProfileEvent> events = Methan::collectProfile();
+
+    std::set<std::string> names;
+    std::set<int64_t> nodes;
+    for(const Methan::ProfileEvent& event : events)
+    {
+        names.insert(event.name);
+        if(std::string(event.name) == "Elementwise" || std::string(event.name) == "MatMul") nodes.insert(event.argument);
+    }
+#if defined(METHAN_ENABLE_PROFILING)
+    REQUIRE(names.count("test") == 1);
+    REQUIRE(names.count("Executor::run") == 1);
+    REQUIRE(names.count("Executor::node") == 1);
+    REQUIRE(nodes == std::set<int64_t>{ static_cast<int64_t>(Methan::Graph::index(doubled)), static_cast<int64_t>(Methan::Graph::index(product)) });
+#else
+    REQUIRE(events.empty());
+#endif
+    Methan::clearProfile();
+}
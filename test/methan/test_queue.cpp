@@ -0,0 +1,176 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/utility/mpmc_queue.hpp>
+#include <methan/utility/spsc_queue.hpp>
+
+namespace {
+
+    /**
+     * @brief Element counting its live instances, to check that the queues destroy what they hold
+     */
+    struct Counted
+    {
+        static std::atomic<int64_t> live;
+
+        Counted(uint64_t value = 0) : value(std::make_shared<uint64_t>(value)) { live.fetch_add(1); }
+        Counted(const Counted& other) : value(other.value) { live.fetch_add(1); }
+        Counted(Counted&& other) noexcept : value(std::move(other.value)) { live.fetch_add(1); }
+        Counted& operator=(const Counted&) = default;
+        Counted& operator=(Counted&&) noexcept = default;
+        ~Counted() { live.fetch_sub(1); }
+
+        std::shared_ptr<uint64_t> value;
+    };
+
+    std::atomic<int64_t> Counted::live{0};
+
+    constexpr uint64_t __producer_shift = 32;
+
+}
+
+TEST_CASE("MpmcQueue delivers every element once, in order for each producer", "[queue]") {
+    REQUIRE_THROWS_AS(Methan::MpmcQueue<int>(0), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::MpmcQueue<int>(6), Methan::Exception);
+
+    {
+        Methan::MpmcQueue<Counted> queue(4);
+        REQUIRE(queue.capacity() == 4);
+        REQUIRE(queue.empty());
+        for(uint64_t i = 0; i < 4; ++i) REQUIRE(queue.tryEmplace(i));
+        REQUIRE_FALSE(queue.tryPush(Counted(4)));
+        REQUIRE(queue.size() == 4);
+
+        Counted value;
+        REQUIRE(queue.tryPop(value));
+        REQUIRE(*value.value == 0);
+        REQUIRE(queue.tryPush(Counted(4)));
+        for(uint64_t i = 1; i < 5; ++i)
+        {
+            REQUIRE(queue.tryPop(value));
+            REQUIRE(*value.value == i);
+        }
+        REQUIRE_FALSE(queue.tryPop(value));
+
+        // Left in the queue, destroyed with it
+        REQUIRE(queue.tryEmplace(uint64_t(7)));
+        REQUIRE(queue.tryEmplace(uint64_t(8)));
+    }
+    REQUIRE(Counted::live.load() == 0);
+
+    constexpr size_t producers = 4;
+    constexpr size_t consumers = 4;
+    constexpr uint64_t perProducer = 50000;
+    Methan::MpmcQueue<uint64_t> queue(64);
+
+    std::vector<std::vector<uint64_t>> received(consumers);
+    std::atomic<size_t> remaining{producers * perProducer};
+    std::vector<std::thread> threads;
+    for(size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&queue, p]() {
+            for(uint64_t i = 0; i < perProducer; ++i)
+            {
+                while(!queue.tryPush((uint64_t(p) << __producer_shift) | i)) std::this_thread::yield();
+            }
+        });
+    }
+    for(size_t c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&, c]() {
+            uint64_t value;
+            while(remaining.load(std::memory_order_relaxed) > 0)
+            {
+                if(queue.tryPop(value))
+                {
+                    received[c].push_back(value);
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(std::thread& thread : threads) thread.join();
+
+    // Each consumer sees the elements of a producer in increasing order, and all of them are seen once
+    std::vector<std::vector<uint8_t>> seen(producers, std::vector<uint8_t>(perProducer, 0));
+    size_t disordered = 0;
+    size_t duplicated = 0;
+    for(const std::vector<uint64_t>& values : received)
+    {
+        std::vector<int64_t> last(producers, -1);
+        for(uint64_t value : values)
+        {
+            const size_t producer = static_cast<size_t>(value >> __producer_shift);
+            const int64_t index = static_cast<int64_t>(value & ((uint64_t(1) << __producer_shift) - 1));
+            if(index <= last[producer]) ++disordered;
+            last[producer] = index;
+            if(seen[producer][static_cast<size_t>(index)]++) ++duplicated;
+        }
+    }
+    REQUIRE(disordered == 0);
+    REQUIRE(duplicated == 0);
+    for(const std::vector<uint8_t>& flags : seen)
+    {
+        for(uint8_t flag : flags) REQUIRE(flag == 1);
+    }
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("SpscQueue transfers the elements in order", "[queue]") {
+    REQUIRE_THROWS_AS(Methan::SpscQueue<int>(1), Methan::Exception);
+
+    {
+        Methan::SpscQueue<Counted> queue(2);
+        REQUIRE(queue.tryEmplace(uint64_t(1)));
+        REQUIRE(queue.tryPush(Counted(2)));
+        REQUIRE_FALSE(queue.tryPush(Counted(3)));
+        REQUIRE(queue.size() == 2);
+
+        Counted value;
+        REQUIRE(queue.tryPop(value));
+        REQUIRE(*value.value == 1);
+        REQUIRE(queue.tryPush(Counted(3)));
+    }
+    REQUIRE(Counted::live.load() == 0);
+
+    constexpr uint64_t count = 500000;
+    Methan::SpscQueue<uint64_t> queue(128);
+    std::thread producer([&queue]() {
+        for(uint64_t i = 0; i < count; ++i)
+        {
+            while(!queue.tryPush(i)) std::this_thread::yield();
+        }
+    });
+
+    size_t disordered = 0;
+    uint64_t expected = 0;
+    uint64_t value;
+    while(expected < count)
+    {
+        if(!queue.tryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if(value != expected) ++disordered;
+        ++expected;
+    }
+    producer.join();
+
+    REQUIRE(disordered == 0);
+    REQUIRE(queue.empty());
+    REQUIRE_FALSE(queue.tryPop(value));
+}
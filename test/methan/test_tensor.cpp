@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+
+#include <methan/core/configuration.hpp>
+#ifndef METHAN_DEBUG
+#define METHAN_DEBUG
+#endif
+#include <methan/core/tensor/tensor.hpp>
+
+namespace {
+
+    Methan::Tensor __iota(const Methan::Shape& shape)
+    {
+        Methan::Tensor tensor(Methan::DataType::Float32, shape);
+        float* data = tensor.data<float>();
+        for(int64_t i = 0; i < tensor.elementCount(); ++i) data[i] = static_cast<float>(i);
+        return tensor;
+    }
+
+}
+
+TEST_CASE("Tensor storage is contiguous and aligned", "[tensor]") {
+    Methan::Tensor tensor(Methan::DataType::Float64, {3, 5, 7});
+    REQUIRE(tensor.rank() == 3);
+    REQUIRE(tensor.elementCount() == 105);
+    REQUIRE(tensor.strides() == Methan::Shape({35, 7, 1}));
+    REQUIRE(tensor.isContiguous());
+    REQUIRE(tensor.isAligned(METHAN_SIMD_WIDTH));
+    REQUIRE(tensor.buffer()->size() == 105 * sizeof(double));
+    REQUIRE(tensor.buffer()->capacity() % Methan::Buffer::Alignment == 0);
+    REQUIRE(tensor.buffer()->capacity() >= tensor.buffer()->size());
+
+    Methan::Tensor zeros = Methan::Tensor::zeros(Methan::DataType::Int32, {4, 4});
+    for(int64_t i = 0; i < 16; ++i) REQUIRE(zeros.data<int32_t>()[i] == 0);
+
+    REQUIRE_THROWS_AS(tensor.data<float>(), Methan::Exception);
+    REQUIRE(Methan::Tensor().isEmpty());
+}
+
+TEST_CASE("Tensor views share the storage", "[tensor]") {
+    Methan::Tensor tensor = __iota({4, 6});
+
+    Methan::Tensor row = tensor.slice(0, 1, 2);
+    REQUIRE(row.shape() == Methan::Shape({1, 6}));
+    REQUIRE(row.at<float>({0, 2}) == 8.0f);
+    REQUIRE(row.buffer() == tensor.buffer());
+
+    Methan::Tensor everyOther = tensor.slice(1, 1, 6, 2);
+    REQUIRE(everyOther.shape() == Methan::Shape({4, 3}));
+    REQUIRE(!everyOther.isContiguous());
+    REQUIRE(everyOther.at<float>({2, 1}) == 15.0f);
+
+    everyOther.at<float>({2, 1}) = -1.0f;
+    REQUIRE(tensor.at<float>({2, 3}) == -1.0f);
+
+    Methan::Tensor transposed = tensor.transpose(0, 1);
+    REQUIRE(transposed.shape() == Methan::Shape({6, 4}));
+    REQUIRE(transposed.at<float>({5, 1}) == 11.0f);
+    REQUIRE(!transposed.isContiguous());
+    REQUIRE_THROWS_AS(transposed.reshape({24}), Methan::Exception);
+
+    Methan::Tensor flat = tensor.reshape({2, 12});
+    REQUIRE(flat.at<float>({1, 0}) == 12.0f);
+    REQUIRE(flat.buffer() == tensor.buffer());
+    REQUIRE_THROWS_AS(tensor.reshape({5, 5}), Methan::Exception);
+
+    Methan::Tensor permuted = __iota({2, 3, 4}).permute({2, 0, 1});
+    REQUIRE(permuted.shape() == Methan::Shape({4, 2, 3}));
+    REQUIRE(permuted.at<float>({3, 1, 2}) == 23.0f);
+    REQUIRE_THROWS_AS(permuted.permute({0, 0, 1}), Methan::Exception);
+
+    // Tensors placed in the storage of an existing buffer
+    Methan::Tensor placed(tensor.buffer(), 6 * sizeof(float), Methan::DataType::Float32, {3, 2});
+    REQUIRE(placed.isContiguous());
+    REQUIRE(placed.at<float>({1, 0}) == 8.0f);
+    REQUIRE_THROWS_AS(Methan::Tensor(tensor.buffer(), 2, Methan::DataType::Float32, {2}), Methan::Exception);
+    REQUIRE_THROWS_AS(Methan::Tensor(tensor.buffer(), 0, Methan::DataType::Float64, {64}), Methan::Exception);
+}
+
+TEST_CASE("Tensor can be copied into contiguous storage", "[tensor]") {
+    Methan::Tensor tensor = __iota({3, 4});
+
+    Methan::Tensor same = tensor.contiguous();
+    REQUIRE(same.buffer() == tensor.buffer());
+
+    Methan::Tensor transposed = tensor.transpose(0, 1).contiguous();
+    REQUIRE(transposed.buffer() != tensor.buffer());
+    REQUIRE(transposed.isContiguous());
+    REQUIRE(transposed.isAligned());
+    for(int64_t i = 0; i < 4; ++i)
+    {
+        for(int64_t j = 0; j < 3; ++j) REQUIRE(transposed.at<float>({i, j}) == tensor.at<float>({j, i}));
+    }
+
+    Methan::Tensor column = Methan::Tensor(Methan::DataType::Float32, {3, 1});
+    for(int64_t i = 0; i < 3; ++i) column.at<float>({i, 0}) = static_cast<float>(10 * i);
+    Methan::Tensor broadcast = column.broadcastTo({2, 3, 4});
+    REQUIRE(broadcast.strides() == Methan::Shape({0, 1, 0}));
+    Methan::Tensor expanded = broadcast.clone();
+    REQUIRE(expanded.at<float>({1, 2, 3}) == 20.0f);
+    REQUIRE(expanded.at<float>({0, 1, 0}) == 10.0f);
+    REQUIRE_THROWS_AS(column.broadcastTo({2, 2}), Methan::Exception);
+
+    Methan::Tensor destination = Methan::Tensor::zeros(Methan::DataType::Float32, {4, 3});
+    destination.slice(0, 1, 3).copyFrom(tensor.transpose(0, 1).slice(0, 0, 2));
+    REQUIRE(destination.at<float>({0, 0}) == 0.0f);
+    REQUIRE(destination.at<float>({1, 2}) == 8.0f);
+    REQUIRE(destination.at<float>({2, 1}) == 5.0f);
+}
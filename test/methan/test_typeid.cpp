@@ -0,0 +1,25 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <string>
+
+#include <methan/utility/typeid.hpp>
+
+namespace Foo { struct Bar {}; }
+
+TEST_CASE("Type identifiers are computed at compile time", "[typeid]") {
+    static_assert(Methan::type_id<int>() == Methan::type_id<int>(), "The identifier must be deterministic");
+    static_assert(Methan::type_id<int>() != Methan::type_id<unsigned int>(), "Different types must have different identifiers");
+    static_assert(Methan::type_id<int*>() != Methan::type_id<const int*>(), "Constness of the pointee is part of the type");
+
+    REQUIRE(Methan::type_name<int>() == "int");
+    REQUIRE(Methan::type_name<double>() == "double");
+    REQUIRE(Methan::type_name<Foo::Bar>() == "Foo::Bar");
+    REQUIRE(Methan::type_id<Foo::Bar>() != Methan::type_id<int>());
+}
+
+TEST_CASE("Type names are available as null-terminated strings", "[typeid]") {
+    REQUIRE(strcmp(Methan::type_name_cstr<float>(), "float") == 0);
+    REQUIRE(Methan::type_name_cstr<float>() == Methan::type_name_cstr<float>());
+    REQUIRE(std::string(Methan::type_name_cstr<Foo::Bar>()) == std::string(Methan::type_name<Foo::Bar>()));
+}
@@ -2,6 +2,9 @@
 #include <methan/core/except.hpp>
 
 #include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <methan/core/configuration.hpp>
 #ifndef METHAN_DEBUG
@@ -51,7 +54,7 @@ TEST_CASE("Varient work on non-const pointer", "[class]") {
     REQUIRE(varient.is<const int*>());
     REQUIRE(varient.isNonEmpty());
     REQUIRE(!varient.isEmpty());
-    REQUIRE(varient.typeId() == typeid(int*).hash_code());
+    REQUIRE(varient.typeId() == Methan::type_id<int*>());
     REQUIRE(varient.get<int*>() == &x);
     REQUIRE(varient.get<const int*>() == &x);
     REQUIRE_THROWS_AS(varient.get<float*>(), Methan::Exception);
@@ -67,7 +70,7 @@ TEST_CASE("Varient work on const pointer", "[class]") {
     REQUIRE(!varient.is<char*>());
     REQUIRE(varient.isNonEmpty());
     REQUIRE(!varient.isEmpty());
-    REQUIRE(varient.typeId() == typeid(const char*).hash_code());
+    REQUIRE(varient.typeId() == Methan::type_id<const char*>());
     REQUIRE(varient.get<const char*>() == data);
     REQUIRE_THROWS_AS(varient.get<const float*>(), Methan::Exception);
     REQUIRE_THROWS_AS(varient.get<const char>(), Methan::Exception);
@@ -87,7 +90,7 @@ TEST_CASE("Varient work on reference", "[class]") {
         REQUIRE(varient.isNonEmpty());
         REQUIRE(!varient.isEmpty());
         REQUIRE(varient.get<Foo>().data == 0x6C34A);
-        REQUIRE(varient.typeId() == typeid(Foo).hash_code());
+        REQUIRE(varient.typeId() == Methan::type_id<Foo>());
         varient.get<Foo>().data = 5;
         REQUIRE(varient.get<Foo>().data == 5);
         REQUIRE_THROWS_AS(varient.get<Foo*>(), Methan::Exception);
@@ -108,5 +111,166 @@ TEST_CASE("Varient work non-init", "[class]") {
     REQUIRE(!varient.is<const char*>());
     REQUIRE_THROWS_AS(varient.get<int*>(), Methan::Exception);
     REQUIRE_THROWS_AS(varient.get<float*>(), Methan::Exception);
+    REQUIRE(!varient.tryGet<int*>().ok());
+    REQUIRE(!varient.tryGet<int>().ok());
 }
 
+TEST_CASE("Varient can be read without raising", "[class]") {
+    int data = 5;
+    Methan::Varient pointer(&data);
+    REQUIRE(pointer.tryGet<int*>().value() == &data);
+    REQUIRE(!pointer.tryGet<float*>());
+    REQUIRE(pointer.tryGet<float*>().error().type == Methan::ExceptionType::BadCastException);
+
+    Methan::Varient value(std::string("hello"));
+    REQUIRE(value.tryGet<std::string>().value() == "hello");
+    value.tryGet<std::string>().value() += ", world";
+    REQUIRE(value.get<std::string>() == "hello, world");
+    REQUIRE(value.tryGet<std::string>().get() == &value.get<std::string>());
+
+    const Methan::Varient& constant = value;
+    REQUIRE(constant.tryGet<std::string>().value() == "hello, world");
+    REQUIRE(constant.tryGet<int>().get() == nullptr);
+    REQUIRE(constant.tryGet<int>().valueOr(3) == 3);
+    REQUIRE_THROWS_AS(constant.tryGet<int>().value(), Methan::Exception);
+}
+
+
+TEST_CASE("Varient store small payload inline", "[class]") {
+    static_assert(sizeof(Methan::Varient) <= 64, "A Varient should fit in a single cache line");
+
+    Methan::Varient varient(42);
+    REQUIRE(varient.isInline());
+    REQUIRE(varient.is<int>());
+    REQUIRE(varient.get<int>() == 42);
+
+    Methan::Varient copy(varient);
+    varient.get<int>() = 5;
+    REQUIRE(copy.isInline());
+    REQUIRE(copy.get<int>() == 42);
+    REQUIRE(varient.get<int>() == 5);
+
+    copy = varient;
+    REQUIRE(copy.get<int>() == 5);
+
+    int x = 0;
+    Methan::Varient pointer(&x);
+    REQUIRE(!pointer.isInline());
+}
+
+TEST_CASE("Varient store large payload on the heap", "[class]") {
+    size_t living = 0;
+    size_t copy = 0;
+
+    {
+        Foo foo([&living]() { living--; }, [&living]() { living++; }, [&living, &copy]() { living++; copy++; });
+        foo.data = 12;
+
+        Methan::Varient varient(foo);
+        REQUIRE(!varient.isInline());
+
+        Methan::Varient other(42.0);
+        other = varient;
+        REQUIRE(other.is<Foo>());
+        REQUIRE(other.get<Foo>().data == 12);
+        REQUIRE(&other.get<Foo>() != &varient.get<Foo>());
+
+        other = Methan::Varient(nullptr);
+        REQUIRE(other.isEmpty());
+    }
+
+    REQUIRE(living == 0);
+    REQUIRE(copy == 2);
+}
+
+TEST_CASE("Varient can be moved without copying the payload", "[class]") {
+    size_t living = 0;
+    size_t copy = 0;
+
+    {
+        Foo foo([&living]() { living--; }, [&living]() { living++; }, [&living, &copy]() { living++; copy++; });
+        foo.data = 7;
+
+        Methan::Varient varient(foo);
+        Foo* payload = &varient.get<Foo>();
+
+        Methan::Varient moved(std::move(varient));
+        REQUIRE(varient.isEmpty());
+        REQUIRE(&moved.get<Foo>() == payload);
+
+        Methan::Varient assigned(1);
+        assigned = std::move(moved);
+        REQUIRE(moved.isEmpty());
+        REQUIRE(&assigned.get<Foo>() == payload);
+        REQUIRE(assigned.get<Foo>().data == 7);
+    }
+
+    REQUIRE(living == 0);
+    REQUIRE(copy == 1);
+}
+
+TEST_CASE("Varient support in-place construction and move-only payload", "[class]") {
+    Methan::Varient varient(std::in_place_type<std::unique_ptr<int>>, new int(12));
+    REQUIRE(varient.is<std::unique_ptr<int>>());
+    REQUIRE(varient.isInline());
+    REQUIRE(!varient.isCopyable());
+    REQUIRE(*varient.get<std::unique_ptr<int>>() == 12);
+    REQUIRE_THROWS_AS(Methan::Varient(varient), Methan::Exception);
+
+    Methan::Varient moved(std::move(varient));
+    REQUIRE(varient.isEmpty());
+
+    std::unique_ptr<int> value = moved.take<std::unique_ptr<int>>();
+    REQUIRE(moved.isEmpty());
+    REQUIRE(*value == 12);
+
+    std::vector<float>& buffer = moved.emplace<std::vector<float>>(1024, 1.0f);
+    REQUIRE(moved.is<std::vector<float>>());
+    REQUIRE(buffer.size() == 1024);
+
+    std::vector<float> taken = moved.take<std::vector<float>>();
+    REQUIRE(taken.size() == 1024);
+    REQUIRE(moved.isEmpty());
+
+    Methan::Varient copyable(std::string("hello"));
+    REQUIRE(copyable.isCopyable());
+    REQUIRE(copyable.get<std::string>() == "hello");
+}
+
+TEST_CASE("Varient can be hashed and compared", "[class]") {
+    int x = 1, y = 1;
+    REQUIRE(Methan::Varient() == Methan::Varient(nullptr));
+    REQUIRE(Methan::Varient().hash() == Methan::Varient(nullptr).hash());
+
+    // Pointers are compared by address, values by value
+    REQUIRE(Methan::Varient(&x) == Methan::Varient(&x));
+    REQUIRE(Methan::Varient(&x) != Methan::Varient(&y));
+    REQUIRE(Methan::Varient(&x).hash() == Methan::Varient(&x).hash());
+    REQUIRE(Methan::Varient(3.0f) == Methan::Varient(3.0f));
+    REQUIRE(Methan::Varient(3.0f).hash() == Methan::Varient(3.0f).hash());
+    REQUIRE(Methan::Varient(3.0f) != Methan::Varient(4.0f));
+    REQUIRE(Methan::Varient(3.0f) != Methan::Varient(3.0));
+    REQUIRE(Methan::Varient(3.0f) != Methan::Varient());
+
+    // Payloads that are not trivially copyable
+    Methan::Varient text(std::string(200, 'a'));
+    REQUIRE(text.isHashable());
+    REQUIRE(text == Methan::Varient(std::string(200, 'a')));
+    REQUIRE(text.hash() == Methan::Varient(std::string(200, 'a')).hash());
+    REQUIRE(text != Methan::Varient(std::string(200, 'b')));
+
+    // Payloads without std::hash are only equal to themselves
+    Methan::Varient function(std::function<void()>([]() {}));
+    REQUIRE(!function.isHashable());
+    REQUIRE(function == function);
+    REQUIRE(function != Methan::Varient(function));
+    REQUIRE_THROWS_AS(function.hash(), Methan::Exception);
+
+    // The hash follows the payload when it is copied or moved
+    Methan::Varient value(42);
+    const size_t hash = value.hash();
+    Methan::Varient copy(value);
+    Methan::Varient moved(std::move(copy));
+    REQUIRE(moved == value);
+    REQUIRE(moved.hash() == hash);
+}
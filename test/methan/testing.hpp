@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+
+#include <methan/core/execution/evaluator.hpp>
+#include <methan/core/graph/graph.hpp>
+#include <methan/core/tensor/tensor.hpp>
+
+/**
+ * Helpers shared by the tests of the tensor operations and of the graphs computing them.
+ */
+
+namespace Methan::Testing {
+
+    /**
+     * @brief Float32 tensor of the given shape, uniformly distributed in [-bound, bound] and reproducible from `seed`
+     */
+    inline Tensor random(const Shape& shape, uint32_t seed, float bound = 1.0f)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> distribution(-bound, bound);
+        Tensor tensor(DataType::Float32, shape);
+        for(int64_t i = 0; i < tensor.elementCount(); ++i) tensor.data<float>()[i] = distribution(generator);
+        return tensor;
+    }
+
+    /**
+     * @brief Float32 tensor of the given shape with every element set to `value`
+     */
+    inline Tensor filled(const Shape& shape, float value)
+    {
+        Tensor tensor(DataType::Float32, shape);
+        for(int64_t i = 0; i < tensor.elementCount(); ++i) tensor.data<float>()[i] = value;
+        return tensor;
+    }
+
+    /**
+     * @brief Whether two contiguous tensors have the same shape, type and bytes
+     */
+    inline bool identical(const Tensor& a, const Tensor& b)
+    {
+        return a.shape() == b.shape() && a.dtype() == b.dtype() && std::memcmp(a.rawData(), b.rawData(), static_cast<size_t>(a.elementCount()) * a.elementSize()) == 0;
+    }
+
+    /**
+     * @brief Add an Elementwise node without parameters
+     */
+    inline NodeHandle elementwise(Graph& graph, ElementwiseOp op, std::initializer_list<NodeHandle> inputs)
+    {
+        return graph.addNode(OpCode::Elementwise, inputs, ElementwisePayload{ op, {} });
+    }
+
+}